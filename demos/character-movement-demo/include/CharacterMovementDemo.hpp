@@ -75,7 +75,7 @@ class CharacterMovementDemo
     // update fuction
     void update(float deltaTime);
 
-    // Check if coin is touched
+    // Collect coins the player entered since the last update
     void updateCoin();
 
     // handles player movement controls
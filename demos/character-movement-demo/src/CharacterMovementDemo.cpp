@@ -1,6 +1,8 @@
 #include "CharacterMovementDemo.hpp"
 #include "config.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 // Constants
@@ -226,13 +228,22 @@ void CharacterMovementDemo::update(float deltaTime)
 
 void CharacterMovementDemo::updateCoin()
 {
+    // Collect the coins the player entered during the last world update
+    // Bodies are removed afterwards since removing a body also drops its pending events
+    std::vector<phys::PhysicsBody*> touchedCoins;
+    for (const phys::TriggerEvent& event : m_world.getTriggerEvents())
+    {
+        if (event.type == phys::TriggerEventType::Enter && event.other == m_player)
+            touchedCoins.push_back(event.trigger);
+    }
+
     int collectedCountThisFrame = 0;
 
     m_coins.erase(std::remove_if(m_coins.begin(),
                       m_coins.end(),
-                      [this, &collectedCountThisFrame](Coin& coin)
+                      [this, &collectedCountThisFrame, &touchedCoins](Coin& coin)
                       {
-                          if (coin.body && m_world.checkIfColliding(m_player, coin.body))
+                          if (std::find(touchedCoins.begin(), touchedCoins.end(), coin.body) != touchedCoins.end())
                           {
                               m_world.removeBody(coin.body);
                               ++collectedCountThisFrame;
@@ -267,6 +278,12 @@ void CharacterMovementDemo::updatePlayerMovement(float deltaTime)
     else
         velocity.x = 0;
 
+    // Sweep the player ahead so it stops flush against walls instead of being pushed back out of them
+    phys::ShapeCastHit wallHit;
+    phys::Vector2 horizontalMove = {velocity.x * deltaTime, 0};
+    if (velocity.x != 0 && m_world.shapeCast(m_player, horizontalMove, wallHit) && std::abs(wallHit.normal.x) > 0.7f)
+        velocity.x *= wallHit.fraction;
+
     // Jumping
     if (m_jumpPressed)
     {
@@ -2,7 +2,6 @@
 #define DEMO_HPP
 
 #include <SFML/Graphics.hpp>
-#include <unordered_map>
 #include <random>
 #include "Engine.hpp"
 #include "Timer.hpp"
@@ -34,13 +33,12 @@ class PhysicsEngineDemo
     Timer m_fpsDisplayTimer;
     Timer m_objectSpawnTimer;
 
-    //Map to pair physics bodies with their visuals
-    std::unordered_map<phys::PhysicsBody*, sf::Shape*> m_bodyVisualMap;
+    //Triangles of every body, rebuilt from the world's render state each frame
+    sf::VertexArray m_bodyVertices;
 
     //Random number generators
     std::random_device m_rd;
     std::mt19937 m_gen;
-    std::uniform_int_distribution<int> m_rgbRange;
     std::uniform_real_distribution<float> m_radiusRange;
     std::uniform_real_distribution<float> m_rectSizeRange;
 
@@ -57,6 +55,9 @@ class PhysicsEngineDemo
     //Updates the physics world and visuals
     void update(float deltaTime);
 
+    //Rebuilds the body triangles from the render state of the world
+    void buildBodyVertices();
+
     //Render the visuals
     void render();
 
@@ -8,6 +8,7 @@
 const static int DEFAULT_WINDOW_WIDTH = 1200;
 const static int DEFAULT_WINDOW_HEIGHT = 800;
 const static float PIXELS_PER_METER = 50.0f; //Because the engine works in meters
+const static int CIRCLE_SEGMENTS = 30;
 
 //Helper functions
 //Converts a position in the engine in meters to a position in the window in pixels
@@ -42,6 +43,16 @@ float getEngineRotation(sf::Angle objectRenderRotation)
     return -objectRenderRotation.asRadians();
 }
 
+//Returns a color for a body, the same every frame for the same id
+sf::Color getBodyColor(unsigned int id)
+{
+    //Scramble the id so neighbouring bodies get different colors
+    unsigned int hash = id * 2654435761u;
+    hash ^= hash >> 15;
+
+    return sf::Color(1 + (hash & 0xFF) % 255, 1 + ((hash >> 8) & 0xFF) % 255, 1 + ((hash >> 16) & 0xFF) % 255);
+}
+
 //Constructor
 PhysicsEngineDemo::PhysicsEngineDemo() :
     m_window(sf::VideoMode({DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT}), "Physics Engine Demo"),
@@ -51,8 +62,8 @@ PhysicsEngineDemo::PhysicsEngineDemo() :
     m_world({DEFAULT_WINDOW_WIDTH / PIXELS_PER_METER, DEFAULT_WINDOW_HEIGHT / PIXELS_PER_METER}),
     m_fpsDisplayTimer(0.5f),
     m_objectSpawnTimer(0.01f),
+    m_bodyVertices(sf::PrimitiveType::Triangles),
     m_gen(m_rd()),
-    m_rgbRange(1, 255),
     m_radiusRange(0.1f, 0.5f),
     m_rectSizeRange(0.1f, 1.0f)
 {
@@ -69,6 +80,9 @@ PhysicsEngineDemo::PhysicsEngineDemo() :
     m_objectCountText.setOutlineThickness(1.0f);
     m_objectCountText.setOutlineColor(sf::Color(207, 111, 37));
 
+    //Have the world write the transforms of all bodies after every update
+    m_world.setRenderStateExport(true);
+
     //Instantiate initial static bodies
     instantiateStaticBodies();
 }
@@ -101,14 +115,6 @@ void PhysicsEngineDemo::instantiateStaticBodies()
     phys::StaticBody* rectangle = phys::createStaticRectangle(rectPosition, dimensions);
     m_world.addBody(rectangle);
 
-    //Create a visual for the rectangle and map it to the body
-    sf::RectangleShape* rectVisual =
-        new sf::RectangleShape({dimensions.x * PIXELS_PER_METER, dimensions.y * PIXELS_PER_METER});
-    rectVisual->setFillColor(sf::Color(m_rgbRange(m_gen), m_rgbRange(m_gen), m_rgbRange(m_gen)));
-    rectVisual->setOrigin({dimensions.x / 2 * PIXELS_PER_METER, dimensions.y / 2 * PIXELS_PER_METER});
-    rectVisual->setPosition(getRenderPosition(rectPosition, m_window.getSize()));
-    m_bodyVisualMap[rectangle] = rectVisual;
-
     //Create a static circle
     //Define properties
     phys::Vector2 circlePosition = {2, -2.5};
@@ -117,13 +123,6 @@ void PhysicsEngineDemo::instantiateStaticBodies()
     //Create a physics body and add it to the world
     phys::StaticBody* circle = phys::createStaticCircle(circlePosition, radius);
     m_world.addBody(circle);
-
-    //Create a visual for the circle and map it to the body
-    sf::CircleShape* circleVisual = new sf::CircleShape(radius * PIXELS_PER_METER);
-    circleVisual->setFillColor(sf::Color(m_rgbRange(m_gen), m_rgbRange(m_gen), m_rgbRange(m_gen)));
-    circleVisual->setOrigin({radius * PIXELS_PER_METER, radius * PIXELS_PER_METER});
-    circleVisual->setPosition(getRenderPosition(circlePosition, m_window.getSize()));
-    m_bodyVisualMap[circle] = circleVisual;
 }
 
 //Handles events like window resizing and key presses
@@ -240,22 +239,55 @@ void PhysicsEngineDemo::update(float deltaTime)
     //Update object count text
     m_objectCountText.setString("objects: " + std::to_string(m_world.getBodies().size()));
 
-    //If the engine has deleted bodies, delete the respective visuals
-    std::vector<phys::PhysicsBody*> existingBodies = m_world.getBodies();
-    for (auto it = m_bodyVisualMap.begin(); it != m_bodyVisualMap.end();)
+    //Rebuild visuals from where the bodies are after this update
+    buildBodyVertices();
+}
+
+//Rebuilds the body triangles from the render state of the world
+void PhysicsEngineDemo::buildBodyVertices()
+{
+    const std::vector<phys::RenderInstance>& instances = m_world.acquireRenderState();
+    m_bodyVertices.clear();
+
+    for (const phys::RenderInstance& instance : instances)
     {
-        if (std::find(existingBodies.begin(), existingBodies.end(), it->first) == existingBodies.end())
+        sf::Vector2f center = getRenderPosition({instance.positionX, instance.positionY}, m_window.getSize());
+        sf::Angle rotation = getRenderRotation(instance.rotation);
+        sf::Color color = getBodyColor(instance.id);
+
+        if (instance.shape == static_cast<uint16_t>(phys::ColliderShape::Rectangle) ||
+            instance.shape == static_cast<uint16_t>(phys::ColliderShape::TileMap))
         {
-            //Delete the body-visual pair if the body is no longer in the engine bodies
-            delete it->second;
-            it = m_bodyVisualMap.erase(it);
+            //Two triangles spanning the rotated corners
+            sf::Vector2f extents = {instance.extentX * PIXELS_PER_METER, instance.extentY * PIXELS_PER_METER};
+            sf::Vector2f corners[4] = {center + sf::Vector2f(-extents.x, -extents.y).rotatedBy(rotation),
+                center + sf::Vector2f(extents.x, -extents.y).rotatedBy(rotation),
+                center + sf::Vector2f(extents.x, extents.y).rotatedBy(rotation),
+                center + sf::Vector2f(-extents.x, extents.y).rotatedBy(rotation)};
+
+            m_bodyVertices.append({corners[0], color});
+            m_bodyVertices.append({corners[1], color});
+            m_bodyVertices.append({corners[2], color});
+            m_bodyVertices.append({corners[0], color});
+            m_bodyVertices.append({corners[2], color});
+            m_bodyVertices.append({corners[3], color});
         }
         else
         {
-            //Reposition visual to match where their body is in the world
-            it->second->setPosition(getRenderPosition(it->first->getPosition(), m_window.getSize()));
-            it->second->setRotation(getRenderRotation(it->first->getRotation()));
-            ++it;
+            //Fan of triangles around the center
+            float radius = instance.extentX * PIXELS_PER_METER;
+            sf::Vector2f previous = center + sf::Vector2f(radius, 0);
+
+            for (int segment = 1; segment <= CIRCLE_SEGMENTS; segment++)
+            {
+                sf::Angle angle = sf::degrees(360.0f * segment / CIRCLE_SEGMENTS);
+                sf::Vector2f next = center + sf::Vector2f(radius, angle);
+
+                m_bodyVertices.append({center, color});
+                m_bodyVertices.append({previous, color});
+                m_bodyVertices.append({next, color});
+                previous = next;
+            }
         }
     }
 }
@@ -266,11 +298,8 @@ void PhysicsEngineDemo::render()
     //Clear the window to black
     m_window.clear();
 
-    //Draw object visuals to the screen
-    for (const auto& pair : m_bodyVisualMap)
-    {
-        m_window.draw(*pair.second);
-    }
+    //Draw object visuals to the screen in one draw call
+    m_window.draw(m_bodyVertices);
 
     //Draw text
     m_window.draw(m_fpsText);
@@ -292,15 +321,6 @@ void PhysicsEngineDemo::spawnDynamicCircle()
     phys::DynamicBody* newCircle = phys::createDynamicCircle(engineMousePosition, randRadius);
     m_world.addBody(newCircle);
 
-    //Create a visual for the dynamic body
-    sf::CircleShape* bodyVisual = new sf::CircleShape(randRadius * PIXELS_PER_METER);
-    bodyVisual->setFillColor(sf::Color(m_rgbRange(m_gen), m_rgbRange(m_gen), m_rgbRange(m_gen)));
-    bodyVisual->setOrigin({randRadius * PIXELS_PER_METER, randRadius * PIXELS_PER_METER});
-    bodyVisual->setPosition(getRenderPosition(newCircle->getPosition(), m_window.getSize()));
-
-    //Map body to visual
-    m_bodyVisualMap[newCircle] = bodyVisual;
-
     //Reset spawn cooldown timer
     m_objectSpawnTimer.reset();
 }
@@ -315,21 +335,9 @@ void PhysicsEngineDemo::spawnDynamicRectangle()
     //Create the dynamic rect body in the world
     float randSize = m_rectSizeRange(m_gen);
     phys::Vector2 randDimensions = {randSize, randSize};
-    float randWidth = randDimensions.x;
-    float randHeight = randDimensions.y;
     phys::DynamicBody* newRect = phys::createDynamicRectangle(engineMousePosition, randDimensions);
     m_world.addBody(newRect);
 
-    //Create a rectangle visual for the dynamic body
-    sf::RectangleShape* rectVisual =
-        new sf::RectangleShape({randWidth * PIXELS_PER_METER, randHeight * PIXELS_PER_METER});
-    rectVisual->setFillColor(sf::Color(m_rgbRange(m_gen), m_rgbRange(m_gen), m_rgbRange(m_gen)));
-    rectVisual->setOrigin({randWidth / 2 * PIXELS_PER_METER, randHeight / 2 * PIXELS_PER_METER});
-    rectVisual->setPosition(getRenderPosition(newRect->getPosition(), m_window.getSize()));
-
-    //Map the body to its visual
-    m_bodyVisualMap[newRect] = rectVisual;
-
     //Reset spawn cooldown timer
     m_objectSpawnTimer.reset();
 }
\ No newline at end of file
@@ -8,12 +8,36 @@
 #include "core/PhysicsWorld.hpp"
 #include "core/Vector2.hpp"
 #include "core/WorldBoundary.hpp"
+#include "core/Snapshot.hpp"
+#include "core/RenderBuffer.hpp"
+#include "core/WorldCommand.hpp"
+#include "core/CommandQueue.hpp"
+#include "core/StepThread.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/WorldBatch.hpp"
+#include "core/RegionIndex.hpp"
+#include "core/ChunkStore.hpp"
+#include "core/WorldRecorder.hpp"
+#include "core/WorldReplayer.hpp"
+#include "core/Replication.hpp"
+#include "core/ReplicationEncoder.hpp"
+#include "core/ReplicationDecoder.hpp"
 #include "collisions/AABB.hpp"
 #include "collisions/Collider.hpp"
 #include "collisions/RectCollider.hpp"
 #include "collisions/CircleCollider.hpp"
+#include "collisions/PolygonCollider.hpp"
+#include "collisions/CapsuleCollider.hpp"
+#include "collisions/CompoundCollider.hpp"
+#include "collisions/ChainCollider.hpp"
+#include "collisions/TileMapCollider.hpp"
 #include "collisions/CollisionDetection.hpp"
 #include "collisions/Collision.hpp"
+#include "collisions/DynamicTree.hpp"
+#include "collisions/BroadPhase.hpp"
+#include "collisions/StaticGroup.hpp"
+#include "collisions/TriggerEvent.hpp"
+#include "collisions/Query.hpp"
 #include "physics/PhysicsBody.hpp"
 #include "physics/StaticBody.hpp"
 #include "physics/DynamicBody.hpp"
@@ -72,6 +96,133 @@ namespace phys
      * @return A pointer to the created DynamicBody.
      */
     DynamicBody* createDynamicRectangle(const Vector2& position = {0, 0}, const Vector2& dimensions = {1.0f, 1.0f});
+
+    /**
+     * @brief Creates a static convex polygon body to be added to a physics world.
+     * 
+     * This function dynamically allocates a static body whose collider is the convex hull of the points. A hull
+     * with more than PolygonCollider::MAX_VERTICES vertices is reduced to that many by dropping the vertices
+     * that cut off the least area. The hull is centered on its centroid, so the body sits at
+     * position plus the centroid of the points. The caller is responsible for managing the memory of the
+     * returned object unless it is added to a PhysicsWorld, which will handle its lifetime.
+     * 
+     * @param position The initial position of the polygon in the physics world in meters.
+     * @param points The points of the polygon relative to the position in meters.
+     * @return A pointer to the created StaticBody, or nullptr if the points do not span an area.
+     */
+    StaticBody* createStaticPolygon(const Vector2& position, const std::vector<Vector2>& points);
+
+    /**
+     * @brief Creates a dynamic convex polygon body to be added to a physics world.
+     * 
+     * This function dynamically allocates a dynamic body whose collider is the convex hull of the points. A hull
+     * with more than PolygonCollider::MAX_VERTICES vertices is reduced to that many by dropping the vertices
+     * that cut off the least area. The hull is centered on its centroid, so the body sits at
+     * position plus the centroid of the points. The caller is responsible for managing the memory of the
+     * returned object unless it is added to a PhysicsWorld, which will handle its lifetime.
+     * 
+     * @param position The initial position of the polygon in the physics world in meters.
+     * @param points The points of the polygon relative to the position in meters.
+     * @return A pointer to the created DynamicBody, or nullptr if the points do not span an area.
+     */
+    DynamicBody* createDynamicPolygon(const Vector2& position, const std::vector<Vector2>& points);
+
+    /**
+     * @brief Creates a static capsule body to be added to a physics world.
+     * 
+     * This function dynamically allocates a static capsule body with the specified position, radius and
+     * height. The capsule stands upright until rotated. The caller is responsible for managing the memory of the
+     * returned object unless it is added to a PhysicsWorld, which will handle its lifetime.
+     * 
+     * @param position The initial position of the capsule in the physics world in meters (default: {0, 0}).
+     * @param radius The radius of the rounded ends in meters (default: 0.5f).
+     * @param height The full height including the rounded ends in meters, at least twice the radius (default: 2.0f).
+     * @return A pointer to the created StaticBody.
+     */
+    StaticBody* createStaticCapsule(const Vector2& position = {0, 0}, float radius = 0.5f, float height = 2.0f);
+
+    /**
+     * @brief Creates a dynamic capsule body to be added to a physics world.
+     * 
+     * This function dynamically allocates a dynamic capsule body with the specified position, radius and
+     * height. The capsule stands upright until rotated. The caller is responsible for managing the memory of the
+     * returned object unless it is added to a PhysicsWorld, which will handle its lifetime.
+     * 
+     * @param position The initial position of the capsule in the physics world in meters (default: {0, 0}).
+     * @param radius The radius of the rounded ends in meters (default: 0.5f).
+     * @param height The full height including the rounded ends in meters, at least twice the radius (default: 2.0f).
+     * @return A pointer to the created DynamicBody.
+     */
+    DynamicBody* createDynamicCapsule(const Vector2& position = {0, 0}, float radius = 0.5f, float height = 2.0f);
+
+    /**
+     * @brief Creates a static body from a compound collider to be added to a physics world.
+     * 
+     * This function dynamically allocates a static body that takes ownership of a compound collider whose
+     * children were added at offsets relative to the position. The children are centered on their combined
+     * centroid, so the body sits at position plus that centroid. The caller is responsible for managing the
+     * memory of the returned object unless it is added to a PhysicsWorld, which will handle its lifetime.
+     * 
+     * @param position The initial position of the compound in the physics world in meters.
+     * @param compound The compound collider, deleted if it has no children.
+     * @return A pointer to the created StaticBody, or nullptr if the compound has no children.
+     */
+    StaticBody* createStaticCompound(const Vector2& position, CompoundCollider* compound);
+
+    /**
+     * @brief Creates a dynamic body from a compound collider to be added to a physics world.
+     * 
+     * This function dynamically allocates a dynamic body that takes ownership of a compound collider whose
+     * children were added at offsets relative to the position. The children are centered on their combined
+     * centroid, so the body sits at position plus that centroid and rotates about it. The caller is responsible
+     * for managing the memory of the returned object unless it is added to a PhysicsWorld, which will handle its
+     * lifetime.
+     * 
+     * @param position The initial position of the compound in the physics world in meters.
+     * @param compound The compound collider, deleted if it has no children.
+     * @return A pointer to the created DynamicBody, or nullptr if the compound has no children.
+     */
+    DynamicBody* createDynamicCompound(const Vector2& position, CompoundCollider* compound);
+
+    /**
+     * @brief Creates a static chain body, such as terrain, to be added to a physics world.
+     * 
+     * This function dynamically allocates a static body whose collider is a polyline through the points, one
+     * body in place of a static body per segment. Bodies collide with the side to the left of the direction
+     * from one point to the next, so a chain given left to right is solid from above, and a loop given clockwise
+     * keeps bodies outside. The caller is responsible for managing the memory of the returned object unless it
+     * is added to a PhysicsWorld, which will handle its lifetime.
+     * 
+     * @param position The position of the chain in the physics world in meters.
+     * @param points The points of the chain relative to the position in meters.
+     * @param loop Whether the last point joins back to the first (default: false).
+     * @return A pointer to the created StaticBody, or nullptr if there are too few distinct points.
+     */
+    StaticBody* createStaticChain(const Vector2& position, const std::vector<Vector2>& points, bool loop = false);
+
+    /**
+     * @brief Creates a static tile map body, such as a grid based level, to be added to a physics world.
+     * 
+     * This function dynamically allocates a static body whose collider stores each tile as one bit, in place of a
+     * static body per solid tile. Tiles are given row by row starting from the bottom row, and the position is the
+     * bottom left corner of the grid. Merging joins solid tiles into larger boxes, so bodies touch fewer of them,
+     * at the cost of rebuilding the boxes whenever a tile changes. The caller is responsible for managing the
+     * memory of the returned object unless it is added to a PhysicsWorld, which will handle its lifetime.
+     * 
+     * @param position The position of the bottom left corner of the grid in the physics world in meters.
+     * @param columns The number of tiles across the grid.
+     * @param rows The number of tiles up the grid.
+     * @param tileSize The width and height of each tile in meters.
+     * @param tiles Whether each tile is solid, columns * rows of them.
+     * @param merge Whether solid tiles are merged into larger boxes (default: true).
+     * @return A pointer to the created StaticBody, or nullptr if the grid is empty or the tile count does not match.
+     */
+    StaticBody* createStaticTileMap(const Vector2& position,
+        int columns,
+        int rows,
+        float tileSize,
+        const std::vector<bool>& tiles,
+        bool merge = true);
 }
 
 #endif
\ No newline at end of file
@@ -20,7 +20,83 @@ namespace phys
 
         //Constructor to set mins and maxes
         AABB(const Vector2& min, const Vector2& max) : min(min), max(max) {}
+
+        //Returns true if the boxes overlap or touch
+        bool overlaps(const AABB& other) const
+        {
+            return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y && other.min.y <= max.y;
+        }
+
+        //Returns true if the segment from origin along direction for maxDistance touches the box
+        //Uses the slab method, direction components of zero are handled without dividing
+        bool intersectsRay(const Vector2& origin, const Vector2& direction, float maxDistance) const
+        {
+            float tMin = 0.0f;
+            float tMax = maxDistance;
+
+            const float originAxes[2] = {origin.x, origin.y};
+            const float directionAxes[2] = {direction.x, direction.y};
+            const float minAxes[2] = {min.x, min.y};
+            const float maxAxes[2] = {max.x, max.y};
+
+            for (int axis = 0; axis < 2; axis++)
+            {
+                if (directionAxes[axis] == 0.0f)
+                {
+                    //Parallel to the slab, must start inside it
+                    if (originAxes[axis] < minAxes[axis] || originAxes[axis] > maxAxes[axis])
+                        return false;
+
+                    continue;
+                }
+
+                float invDirection = 1.0f / directionAxes[axis];
+                float t1 = (minAxes[axis] - originAxes[axis]) * invDirection;
+                float t2 = (maxAxes[axis] - originAxes[axis]) * invDirection;
+
+                if (t1 > t2)
+                {
+                    float temp = t1;
+                    t1 = t2;
+                    t2 = temp;
+                }
+
+                tMin = t1 > tMin ? t1 : tMin;
+                tMax = t2 < tMax ? t2 : tMax;
+
+                if (tMin > tMax)
+                    return false;
+            }
+
+            return true;
+        }
+
+        //Returns true if the other box lies completely inside this box
+        bool contains(const AABB& other) const
+        {
+            return min.x <= other.min.x && min.y <= other.min.y && other.max.x <= max.x && other.max.y <= max.y;
+        }
+
+        //Returns the perimeter of the box, used as the cost metric of bounding volume trees
+        float getPerimeter() const
+        {
+            return 2.0f * ((max.x - min.x) + (max.y - min.y));
+        }
+
+        //Returns a copy of the box grown by a margin on every side
+        AABB getExpanded(float margin) const
+        {
+            return AABB({min.x - margin, min.y - margin}, {max.x + margin, max.y + margin});
+        }
+
+        //Returns the smallest box enclosing both boxes
+        static AABB combine(const AABB& boxA, const AABB& boxB)
+        {
+            return AABB({boxA.min.x < boxB.min.x ? boxA.min.x : boxB.min.x,
+                            boxA.min.y < boxB.min.y ? boxA.min.y : boxB.min.y},
+                {boxA.max.x > boxB.max.x ? boxA.max.x : boxB.max.x, boxA.max.y > boxB.max.y ? boxA.max.y : boxB.max.y});
+        }
     };
 }
 
-#endif
\ No newline at end of file
+#endif
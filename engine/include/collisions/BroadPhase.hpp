@@ -0,0 +1,301 @@
+//Class defenition for the broad phase of collision detection
+//Bodies are partitioned into one dynamic tree per collision layer
+//A body only queries the trees of layers it masks, so layer pairs that never interact are never visited
+//Static bodies are kept apart in one immutable static tree per layer, which only moving bodies query
+//Static groups bring their own prebuilt trees, which are searched alongside the layer trees
+
+#ifndef BROAD_PHASE_HPP
+#define BROAD_PHASE_HPP
+
+#include "collisions/AABB.hpp"
+#include "collisions/DynamicTree.hpp"
+#include "collisions/Query.hpp"
+#include "collisions/StaticGroup.hpp"
+#include "collisions/StaticTree.hpp"
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace phys
+{
+    class PhysicsBody;
+
+    //Pair of bodies whose fat AABBs overlap and whose layers and masks allow a collision
+    struct BroadPhasePair
+    {
+        PhysicsBody* bodyA;
+        PhysicsBody* bodyB;
+
+        //Proxy ids of the bodies, the broad phase reports proxyA less than proxyB
+        int proxyA;
+        int proxyB;
+    };
+
+    //Broad phase entry for a single body
+    struct BroadPhaseProxy
+    {
+        //Body the proxy belongs to, null if the proxy is free
+        PhysicsBody* body;
+
+        //Fat box shared by all of the proxy's leaves
+        AABB fatBox;
+
+        //Layers the proxy was inserted with and the leaf id in each layer tree, or the item id in each static tree
+        std::vector<std::pair<unsigned int, int>> leaves;
+
+        //Static bodies never query for pairs
+        bool isStatic;
+
+        //Whether the proxy's leaves are items of the static trees
+        bool inStaticTree;
+
+        //Group whose trees hold the proxy's leaves, null when its leaves are in the layer or static trees
+        const StaticGroup* group;
+
+        //Index in the list of moving proxies, NULL_NODE for static bodies
+        int activeIndex;
+    };
+
+    class BroadPhase
+    {
+      private:
+        //Extra space around a body so small movements do not cause tree updates
+        const float AABB_MARGIN = 0.1f;
+
+        //Static trees are rebuilt once the statics waiting in the layer trees, or the statics removed from the
+        //static trees, reach this fraction of the statics in them, so adding statics one at a time stays cheap
+        const int STATIC_REBUILD_RATIO = 8;
+
+        //One tree per collision layer
+        std::map<unsigned int, DynamicTree> m_layerTrees;
+
+        //One immutable tree per collision layer holding the static bodies
+        std::map<unsigned int, StaticTree> m_staticTrees;
+
+        //Proxies of bodies that can move, the only ones refit and queried for pairs every update
+        std::vector<int> m_activeProxies;
+
+        //Static bodies in the static trees, removed from them since they were built, and waiting in the layer trees
+        int m_builtStatics;
+        int m_removedStatics;
+        int m_pendingStatics;
+
+        //All proxies, indexed by proxy id
+        std::vector<BroadPhaseProxy> m_proxies;
+
+        //Ids of free proxies to reuse
+        std::vector<int> m_freeProxies;
+
+        //Attached static groups, owned by whoever attached them
+        std::vector<const StaticGroup*> m_groups;
+
+        //Takes a free proxy for a body and stores its id on the body
+        int allocateProxy(PhysicsBody* body);
+
+        //Inserts a proxy into the trees of its body's current layers
+        void insertLeaves(int proxyId);
+
+        //Removes a proxy from all of its layer trees
+        void removeLeaves(int proxyId);
+
+        //Returns a proxy to the free list and clears the proxy id of its body
+        void freeProxy(int proxyId);
+
+        //Builds the static trees over every static body outside of groups, moving waiting ones out of the layer trees
+        void rebuildStaticTrees();
+
+        //Returns true if a layer is the first of the searched layers the body's proxy is on
+        bool isFirstSearchedLayer(const PhysicsBody* body, unsigned int layer, const QueryFilter& filter) const;
+
+        //Returns true if the proxy's layers no longer match its body's collider
+        bool layersChanged(const BroadPhaseProxy& proxy) const;
+
+        //Calls function(tree, layer) for every layer and group tree on the filtered layers, stops when it returns false
+        //Without filter layers, the layer trees, static trees and group trees are each visited in increasing layer
+        //order, otherwise every kind of tree is visited for one filter layer at a time
+        template <typename Function>
+        void forEachLayerTree(const QueryFilter& filter, Function&& function) const;
+
+      public:
+        //Constructor to create an empty broad phase
+        BroadPhase();
+
+        //Adds a body to the broad phase and stores the proxy id on the body
+        //Static bodies wait in the layer trees until enough of them were added to rebuild the static trees
+        //They must not move or change layers while in the broad phase, remove and add them again instead
+        void addBody(PhysicsBody* body);
+
+        //Adds many bodies at once, building empty layer trees in a single pass and rebuilding the static trees once
+        void addBodies(const std::vector<PhysicsBody*>& bodies);
+
+        //Removes a body from the broad phase
+        void removeBody(PhysicsBody* body);
+
+        //Attaches a group's bodies with the group's prebuilt trees, no tree is changed
+        //The group must stay alive and unchanged until it is detached or the broad phase is cleared
+        void attachGroup(const StaticGroup* group);
+
+        //Detaches a group's bodies, does nothing if the group is not attached
+        void detachGroup(const StaticGroup* group);
+
+        //Removes every body and detaches every group from the broad phase
+        void clear();
+
+        //Refits moving proxies whose bodies moved out of their fat boxes or changed layers
+        //Rebuilds the static trees first when enough statics were added or removed since they were built
+        void update();
+
+        //Moves every fat box by -shift, call after all bodies were moved by the same amount
+        //The trees of attached groups are not moved, shift the groups themselves
+        void shiftOrigin(const Vector2& shift);
+
+        //Fills pairs with every potentially colliding pair of bodies, sorted by proxy ids
+        void findPairs(std::vector<BroadPhasePair>& pairs) const;
+
+        //Returns the number of bodies in the broad phase
+        int getProxyCount() const;
+
+        //Returns the tree of a layer, null if no body is on that layer
+        const DynamicTree* getLayerTree(unsigned int layer) const;
+
+        //Returns the static tree of a layer, null if no static body was built into one on that layer
+        const StaticTree* getStaticTree(unsigned int layer) const;
+
+        //Calls callback(body) for bodies on the filtered layers whose fat box overlaps the box
+        //The callback returns false to stop the query early
+        //Bodies on several searched layers may be reported more than once
+        template <typename Callback>
+        void query(const AABB& box, const QueryFilter& filter, Callback&& callback) const;
+
+        //Same as query, but bodies on several searched layers are only reported from the first of them searched
+        //Nothing is remembered about the bodies already reported, so each body costs the same however many are found
+        template <typename Callback>
+        void queryOnce(const AABB& box, const QueryFilter& filter, Callback&& callback) const;
+
+        //Calls callback(body, maxDistance) for bodies on the filtered layers whose fat box the ray touches
+        //The callback returns the distance to clip the ray to, 0 stops the cast
+        //Bodies on several searched layers may be reported more than once
+        template <typename Callback>
+        void rayCast(const Vector2& origin,
+            const Vector2& direction,
+            float maxDistance,
+            const QueryFilter& filter,
+            Callback&& callback) const;
+    };
+
+    template <typename Function>
+    void BroadPhase::forEachLayerTree(const QueryFilter& filter, Function&& function) const
+    {
+        //Search every layer when no layers are given
+        if (filter.getLayers().empty())
+        {
+            for (const auto& layerTree : m_layerTrees)
+            {
+                if (!function(layerTree.second, layerTree.first))
+                    return;
+            }
+
+            for (const auto& staticTree : m_staticTrees)
+            {
+                if (!function(staticTree.second, staticTree.first))
+                    return;
+            }
+
+            for (const StaticGroup* group : m_groups)
+            {
+                for (const auto& layerTree : group->getLayerTrees())
+                {
+                    if (!function(layerTree.second, layerTree.first))
+                        return;
+                }
+            }
+
+            return;
+        }
+
+        for (unsigned int layer : filter.getLayers())
+        {
+            auto it = m_layerTrees.find(layer);
+            if (it != m_layerTrees.end() && !function(it->second, layer))
+                return;
+
+            auto staticIt = m_staticTrees.find(layer);
+            if (staticIt != m_staticTrees.end() && !function(staticIt->second, layer))
+                return;
+
+            for (const StaticGroup* group : m_groups)
+            {
+                const StaticTree* tree = group->getLayerTree(layer);
+                if (tree && !function(*tree, layer))
+                    return;
+            }
+        }
+    }
+
+    template <typename Callback>
+    void BroadPhase::query(const AABB& box, const QueryFilter& filter, Callback&& callback) const
+    {
+        bool proceed = true;
+
+        forEachLayerTree(filter,
+            [&](const auto& tree, unsigned int)
+            {
+                tree.query(box,
+                    [&](int leaf)
+                    {
+                        proceed = callback(tree.getBody(leaf));
+                        return proceed;
+                    });
+
+                return proceed;
+            });
+    }
+
+    template <typename Callback>
+    void BroadPhase::queryOnce(const AABB& box, const QueryFilter& filter, Callback&& callback) const
+    {
+        bool proceed = true;
+
+        forEachLayerTree(filter,
+            [&](const auto& tree, unsigned int layer)
+            {
+                tree.query(box,
+                    [&](int leaf)
+                    {
+                        PhysicsBody* body = tree.getBody(leaf);
+                        if (isFirstSearchedLayer(body, layer, filter))
+                            proceed = callback(body);
+
+                        return proceed;
+                    });
+
+                return proceed;
+            });
+    }
+
+    template <typename Callback>
+    void BroadPhase::rayCast(const Vector2& origin,
+        const Vector2& direction,
+        float maxDistance,
+        const QueryFilter& filter,
+        Callback&& callback) const
+    {
+        //Closest hit so far carries over between layer trees
+        forEachLayerTree(filter,
+            [&](const auto& tree, unsigned int)
+            {
+                tree.rayCast(origin,
+                    direction,
+                    maxDistance,
+                    [&](int leaf, float distance)
+                    {
+                        maxDistance = callback(tree.getBody(leaf), distance);
+                        return maxDistance;
+                    });
+
+                return maxDistance > 0.0f;
+            });
+    }
+}
+
+#endif
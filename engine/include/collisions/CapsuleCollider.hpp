@@ -0,0 +1,55 @@
+//Class defenition for capsule shape colliders
+//A segment along the local y axis rounded by a radius, upright when not rotated
+//The segment end points are kept in world space, refreshed whenever the collider moves or rotates
+
+#ifndef CAPSULE_COLLIDER_HPP
+#define CAPSULE_COLLIDER_HPP
+
+#include "collisions/Collider.hpp"
+
+namespace phys
+{
+    class CapsuleCollider : public Collider
+    {
+      private:
+        //Radius of the rounded ends and distance of the sides from the segment
+        float m_radius;
+
+        //Full height from the top of one end to the bottom of the other, at least twice the radius
+        float m_height;
+
+        //Segment end points with the collider's position and rotation applied
+        Vector2 m_pointA;
+        Vector2 m_pointB;
+
+        //Update AABB mins and maxes, and the segment end points
+        virtual void updateAABB() override;
+
+      public:
+        //Constructor to set radius, height and collider type
+        //Heights under twice the radius are raised to it, which makes a circle
+        CapsuleCollider(float radius, float height, ColliderType colliderType);
+
+        //Getters for member variables
+        float getRadius() const;
+        float getHeight() const;
+
+        //Returns half the length of the segment between the centers of the rounded ends
+        float getHalfLength() const;
+
+        //Returns the segment end points, point A below point B when not rotated
+        const Vector2& getPointA() const;
+        const Vector2& getPointB() const;
+
+        //Returns the area of the rectangle between the ends and the two half discs
+        float getArea() const;
+
+        //Returns the rotational inertia about the center for a mass of 1
+        float getUnitInertia() const;
+
+        //Setters for member variables
+        void setDimensions(float newRadius, float newHeight);
+    };
+}
+
+#endif
@@ -0,0 +1,183 @@
+//Class defenition for chain colliders, a polyline of segments meant for static terrain
+//Bodies collide with the side to the left of the direction from one point to the next, so a chain given left to
+//right is solid from above, and pass through from the other side
+//Each segment knows the vertices before and after it, so bodies slide across joints without catching on them
+//A small hierarchy over runs of consecutive segments finds the few segments near a box
+
+#ifndef CHAIN_COLLIDER_HPP
+#define CHAIN_COLLIDER_HPP
+
+#include "collisions/Collider.hpp"
+#include "collisions/DynamicTree.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace phys
+{
+    //Node of a chain collider's segment hierarchy
+    struct ChainNode
+    {
+        //Box in world space enclosing every segment below the node
+        AABB box;
+
+        //First segment of a leaf, or the second child of an internal node
+        int index;
+
+        //Number of segments in a leaf, 0 for internal nodes
+        int count;
+    };
+
+    class ChainCollider : public Collider
+    {
+      public:
+        //Most segments stored in one leaf
+        static const int MAX_LEAF_SEGMENTS = 4;
+
+      private:
+        //Points as given relative to the body position, with repeated points dropped
+        //Giving these points again rebuilds exactly the same chain
+        std::vector<Vector2> m_points;
+
+        //Points with the collider's position and rotation applied
+        std::vector<Vector2> m_vertices;
+
+        //Whether the last point joins back to the first
+        bool m_loop;
+
+        //Hierarchy nodes in depth first order, the root is node 0
+        //Consecutive segments lie close together, so each node covers a run of them and nothing is sorted
+        std::vector<ChainNode> m_nodes;
+
+        //Distance of the farthest point from the collider position
+        float m_radius;
+
+        //Update AABB mins and maxes, the world vertices and the hierarchy boxes
+        virtual void updateAABB() override;
+
+        //Builds the subtree over segments [first, first + count), returns the index of its root
+        int buildNode(int first, int count);
+
+      public:
+        //Constructor to set points, whether the chain is a loop, and collider type
+        //Points are relative to the body position, a chain needs two points and a loop three, check getSegmentCount
+        ChainCollider(const std::vector<Vector2>& points, bool loop, ColliderType colliderType);
+
+        //Getters for member variables
+        int getPointCount() const;
+        const std::vector<Vector2>& getPoints() const;
+        const std::vector<Vector2>& getVertices() const;
+        bool isLoop() const;
+        float getRadius() const;
+
+        //Returns the number of segments, one fewer than the points unless the chain is a loop
+        int getSegmentCount() const;
+
+        //Returns the world space end points of a segment
+        void getSegment(int index, Vector2& start, Vector2& end) const;
+
+        //Returns the vertex before a segment's start, false at the start of a chain that is not a loop
+        bool getPreviousVertex(int index, Vector2& vertex) const;
+
+        //Returns the vertex after a segment's end, false at the end of a chain that is not a loop
+        bool getNextVertex(int index, Vector2& vertex) const;
+
+        //Replaces the points of the chain
+        void setPoints(const std::vector<Vector2>& points, bool loop);
+
+        //Calls callback(segment) for every segment whose box overlaps a box in world space
+        //The callback returns false to stop the query early
+        template <typename Callback>
+        void querySegments(const AABB& box, Callback&& callback) const;
+
+        //Calls callback(segment, maxDistance) for every segment whose box the ray touches
+        //Direction must be normalized, the callback returns the distance to clip the ray to
+        //Returning maxDistance continues unchanged, returning 0 stops the cast
+        template <typename Callback>
+        void rayCastSegments(
+            const Vector2& origin, const Vector2& direction, float maxDistance, Callback&& callback) const;
+    };
+
+    template <typename Callback>
+    void ChainCollider::querySegments(const AABB& box, Callback&& callback) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        int stack[TREE_STACK_SIZE];
+        int count = 0;
+        stack[count++] = 0;
+
+        while (count > 0)
+        {
+            int nodeId = stack[--count];
+            const ChainNode& node = m_nodes[nodeId];
+
+            if (!node.box.overlaps(box))
+                continue;
+
+            if (node.count > 0)
+            {
+                for (int segment = node.index; segment < node.index + node.count; segment++)
+                {
+                    Vector2 start;
+                    Vector2 end;
+                    getSegment(segment, start, end);
+
+                    AABB segmentBox(
+                        {std::min(start.x, end.x), std::min(start.y, end.y)},
+                        {std::max(start.x, end.x), std::max(start.y, end.y)});
+
+                    if (segmentBox.overlaps(box) && !callback(segment))
+                        return;
+                }
+            }
+            else if (count + 2 <= TREE_STACK_SIZE)
+            {
+                stack[count++] = node.index;
+                stack[count++] = nodeId + 1;
+            }
+        }
+    }
+
+    template <typename Callback>
+    void ChainCollider::rayCastSegments(
+        const Vector2& origin, const Vector2& direction, float maxDistance, Callback&& callback) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        int stack[TREE_STACK_SIZE];
+        int count = 0;
+        stack[count++] = 0;
+
+        while (count > 0)
+        {
+            int nodeId = stack[--count];
+            const ChainNode& node = m_nodes[nodeId];
+
+            //Nodes beyond the closest hit so far are skipped
+            if (!node.box.intersectsRay(origin, direction, maxDistance))
+                continue;
+
+            if (node.count > 0)
+            {
+                for (int segment = node.index; segment < node.index + node.count; segment++)
+                {
+                    float clipDistance = callback(segment, maxDistance);
+                    if (clipDistance <= 0.0f)
+                        return;
+
+                    if (clipDistance < maxDistance)
+                        maxDistance = clipDistance;
+                }
+            }
+            else if (count + 2 <= TREE_STACK_SIZE)
+            {
+                stack[count++] = node.index;
+                stack[count++] = nodeId + 1;
+            }
+        }
+    }
+}
+
+#endif
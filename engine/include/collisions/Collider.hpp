@@ -16,9 +16,17 @@ namespace phys
     enum class ColliderShape
     {
         Rectangle,
-        Circle
+        Circle,
+        Polygon,
+        Capsule,
+        Compound,
+        Chain,
+        TileMap
     };
 
+    //Number of collider shapes, the size of each side of the tables of per shape pair functions
+    const int COLLIDER_SHAPE_COUNT = 7;
+
     enum class ColliderType
     {
         Solid,
@@ -82,9 +90,12 @@ namespace phys
         void setPosition(const Vector2& newPosition);
         void setRotation(float newRotation);
         void setOffset(const Vector2& newOffest);
-        void setParent(PhysicsBody* newParent);
+        virtual void setParent(PhysicsBody* newParent);
         void setType(ColliderType newType);
 
+        //Sets position and rotation together, updating the AABB once
+        void setTransform(const Vector2& newPosition, float newRotation);
+
         //Collision layers and masks
         const std::vector<unsigned int>& getCollisionLayers() const;
         const std::vector<unsigned int>& getCollisionMasks() const;
@@ -19,6 +19,9 @@ namespace phys
         std::vector<Vector2> contactPoints;
         int contactCount;
 
+        //Constructor for a collision filled in later, so one can be reused across checks
+        Collision() : bodyA(nullptr), bodyB(nullptr), penDepth(0.0f), contactCount(0) {}
+
         Collision(PhysicsBody* bodyA,
             PhysicsBody* bodyB,
             const Vector2& normal,
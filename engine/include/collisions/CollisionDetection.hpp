@@ -7,7 +7,14 @@
 #include "collisions/AABB.hpp"
 #include "collisions/RectCollider.hpp"
 #include "collisions/CircleCollider.hpp"
+#include "collisions/PolygonCollider.hpp"
+#include "collisions/CapsuleCollider.hpp"
+#include "collisions/CompoundCollider.hpp"
+#include "collisions/ChainCollider.hpp"
+#include "collisions/TileMapCollider.hpp"
 #include "collisions/Collision.hpp"
+#include "collisions/Query.hpp"
+#include "collisions/SimplexCache.hpp"
 #include <vector>
 
 namespace phys
@@ -22,6 +29,23 @@ namespace phys
         Projection(float min, float max) : min(min), max(max) {}
     };
 
+    //Convex polygon in world space, counter clockwise with the outward normal of the edge starting at each vertex
+    //Rectangles and polygon colliders both fill one, so every pair of them shares one collision routine
+    struct ConvexPolygon
+    {
+        Vector2 vertices[PolygonCollider::MAX_VERTICES];
+        Vector2 normals[PolygonCollider::MAX_VERTICES];
+        int count;
+    };
+
+    //Convex shape as a core polygon grown by a radius, a circle is a one vertex core and a capsule a two vertex one
+    //Every convex collider fills one, so GJK and EPA collide any pair of them through the support points of the cores
+    struct SupportShape
+    {
+        ConvexPolygon core;
+        float radius;
+    };
+
     namespace CollisionDetection
     {
         //Checks layers and masks of colliders to see if they should collide
@@ -30,24 +54,102 @@ namespace phys
         //Checks if two AABBs are overlapping
         bool checkAABBvsAABB(const AABB& boxA, const AABB& boxB);
 
-        //Calculate collision between two polygons using SAT
-        Collision* checkPolygonCollision(RectCollider* polygonA, RectCollider* polygonB);
+        //Fills a convex polygon from a rectangle or polygon collider, returns false for other shapes
+        bool makeConvexPolygon(const Collider* collider, ConvexPolygon& polygon);
 
-        //Calculate collision between a circle and polygon using SAT
-        Collision* checkCirclePolygonCollision(CircleCollider* circle, RectCollider* polygon);
+        //Fills a support shape from a circle, capsule, rectangle or polygon collider, returns false for other shapes
+        bool makeSupportShape(const Collider* collider, SupportShape& shape);
 
-        //Returns the min and max of a polygon projected onto an axis
-        const Projection projectPolygonOntoAxis(const std::vector<Vector2>& vertices, const Vector2& axis);
+        //Returns the index of the core vertex furthest along a direction
+        int findSupportVertex(const ConvexPolygon& core, const Vector2& direction);
+
+        //Finds the closest points between the cores of two support shapes with GJK, starting from a cached simplex
+        //Returns the distance between the cores, zero when they overlap, and leaves the final simplex in the cache
+        float findCoreDistance(const SupportShape& shapeA,
+            const SupportShape& shapeB,
+            SimplexCache& cache,
+            Vector2& pointA,
+            Vector2& pointB);
+
+        //Calculate collision between any two circles, capsules, rectangles or polygons
+        //Dispatch only uses it for pairs of shapes with no specialised routine
+        //GJK finds the closest points of cores that are apart
+        //EPA finds the face of the deepest overlap of cores that are not
+        //Features lying along each other are clipped into two contact points
+        //The cache may be null, a world passes one per pair so the query starts where the last one finished
+        Collision* checkConvexCollision(Collider* colliderA, Collider* colliderB, SimplexCache* cache = nullptr);
+
+        //Calculate collision between two rectangles or polygons using SAT
+        Collision* checkPolygonCollision(Collider* polygonA, Collider* polygonB);
+
+        //Calculate collision between a circle and a rectangle or polygon
+        Collision* checkCirclePolygonCollision(CircleCollider* circle, Collider* polygon);
+
+        //Calculate collision between two capsules from the closest points of their segments
+        //Capsules lying side by side get two contact points
+        Collision* checkCapsuleCollision(CapsuleCollider* capsuleA, CapsuleCollider* capsuleB);
 
-        //Returns the min and max of a circle projected onto an axis
-        const Projection projectCircleOntoAxis(const Vector2& center, float radius, const Vector2& axis);
+        //Calculate collision between a capsule and a circle from the closest point of the segment to the center
+        Collision* checkCapsuleCircleCollision(CapsuleCollider* capsule, CircleCollider* circle);
 
-        //Find closest point on polygon to circle center, returns the index
-        int findClosestPointToCenter(const Vector2& center, const std::vector<Vector2>& vertices);
+        //Calculate collision between a capsule and a rectangle or polygon
+        //Faces of the polygon and both sides of the segment are the axes, closest features cover the rounded ends
+        Collision* checkCapsulePolygonCollision(CapsuleCollider* capsule, Collider* polygon);
+
+        //Adds the collisions between a chain and a collider, one for each touching segment near it
+        //Normals point from the chain to the collider, chains do not collide with each other
+        void checkChainCollision(ChainCollider* chain, Collider* collider, std::vector<Collision*>& collisions);
+
+        //Calculate collision between one segment of a chain and a circle, rectangle, polygon or capsule
+        //Only the front of the segment collides, and the normal only turns away from the segment's own normal
+        //around corners the neighbouring segments leave exposed, so bodies do not catch on joints
+        Collision* checkChainSegmentCollision(ChainCollider* chain, int segment, Collider* collider);
+
+        //Adds the collisions between a tile map and a collider, one for each box of solid tiles under it
+        //Normals point from the tile map to the collider, tile maps do not collide with chains or each other
+        //Contacts through a face covered by neighbouring tiles are dropped, so bodies slide over the seams
+        void checkTileMapCollision(TileMapCollider* map, Collider* collider, std::vector<Collision*>& collisions);
+
+        //Returns the largest distance of polygon B in front of a face of polygon A and the index of that face
+        //Stops at the first face that separates the polygons
+        float findMaxSeparation(const ConvexPolygon& polygonA, const ConvexPolygon& polygonB, int& edge);
+
+        //Returns the min and max of a polygon projected onto an axis
+        const Projection projectPolygonOntoAxis(const Vector2* vertices, int count, const Vector2& axis);
 
         //Sorts into respective function based on body shapes
+        //Compounds and chains report their deepest collision
         Collision* checkCollision(PhysicsBody* bodyA, PhysicsBody* bodyB);
 
+        //Adds every collision between two bodies, one for each touching pair of children of compounds
+        //and for each touching segment of chains
+        //Convex pairs going through GJK keep their simplex in the cache table between calls when one is given
+        void checkCollisions(PhysicsBody* bodyA,
+            PhysicsBody* bodyB,
+            std::vector<Collision*>& collisions,
+            SimplexCacheTable* caches = nullptr);
+
+        //Adds the collisions between colliders, descending into the children of compounds near the other collider
+        //and the segments of chains
+        void checkCompoundCollision(Collider* colliderA,
+            Collider* colliderB,
+            std::vector<Collision*>& collisions,
+            SimplexCacheTable* caches = nullptr);
+
+        //Adds the collisions between two colliders of the shapes it was looked up for
+        typedef void (*PairFunction)(Collider* colliderA,
+            Collider* colliderB,
+            std::vector<Collision*>& collisions,
+            SimplexCacheTable* caches);
+
+        //Returns the function colliding a pair of shapes from a table indexed by both shapes
+        //Callers with many pairs of the same shapes look it up once and call it for each of them
+        PairFunction findPairFunction(ColliderShape shapeA, ColliderShape shapeB);
+
+        //Sorts into respective function based on collider shapes, neither may be a compound, chain or tile map
+        //Pairs with a specialised routine use it, any other pair goes through checkConvexCollision with the cache
+        Collision* checkColliderCollision(Collider* colliderA, Collider* colliderB, SimplexCache* cache = nullptr);
+
         //Calculate collision between two circle colliders
         Collision* checkCircleCollision(CircleCollider* circleA, CircleCollider* circleB);
 
@@ -55,15 +157,151 @@ namespace phys
         std::vector<Vector2> findCircleContactPoints(
             const Vector2& centerA, float radiusA, const Vector2& centerB, const Vector2& normal);
 
-        //Find contact point between a circle and polygon
-        std::vector<Vector2> findCirclePolygonContactPoints(
-            const Vector2& circleCenter, float circleRadius, const std::vector<Vector2>& polygonVertices);
+        //Find contact points by clipping the incident polygon's edge most facing a face of the reference polygon
+        //Points lie halfway between the surfaces, at most two are found
+        void findPolygonContactPoints(const ConvexPolygon& reference,
+            int edge,
+            const ConvexPolygon& incident,
+            std::vector<Vector2>& contactPoints);
 
-        //Find contact points between two polygons
-        std::vector<Vector2> findPolygonContactPoints(std::vector<Vector2>& verticesA, std::vector<Vector2>& verticesB);
+        //Finds the point on a polygon's boundary closest to a point and the outward normal there
+        //Returns the distance to the polygon, negative when the point lies inside
+        float findClosestPointOnPolygon(
+            const ConvexPolygon& polygon, const Vector2& point, Vector2& closest, Vector2& normal);
 
         //Find closest point on a segment to another point
         const Vector2 findClosestPointOnSegment(const Vector2& point, const Vector2& vertexA, const Vector2& vertexB);
+
+        //Finds the closest points between two segments, returns the squared distance between them
+        float findClosestPointsOnSegments(const Vector2& startA,
+            const Vector2& endA,
+            const Vector2& startB,
+            const Vector2& endB,
+            Vector2& closestA,
+            Vector2& closestB);
+
+        //Finds the closest points between a segment and a polygon, returns the distance between them
+        //Returns zero when the segment crosses or lies inside the polygon
+        float findSegmentPolygonDistance(const Vector2& start,
+            const Vector2& end,
+            const ConvexPolygon& polygon,
+            Vector2& onSegment,
+            Vector2& onPolygon);
+
+        //Returns true if a collider overlaps an axis aligned box, sorting by shape
+        bool checkColliderOverlapsAABB(const Collider* collider, const AABB& box);
+
+        //Returns true if a point lies inside a collider, sorting by shape
+        bool checkColliderContainsPoint(const Collider* collider, const Vector2& point);
+
+        //Returns true if a collider overlaps a circle, sorting by shape
+        bool checkColliderOverlapsCircle(const Collider* collider, const Vector2& center, float radius);
+
+        //Sweeps a collider along a displacement against another collider
+        //Sorts into respective function based on shapes
+        //Rotation is held fixed during the sweep, chains are hit from their front side only
+        //Tile maps are hit through their boxes of solid tiles, but are never swept themselves
+        bool shapeCastCollider(
+            const Collider* shape, const Vector2& displacement, const Collider* target, ShapeCastHit& hit);
+
+        //Sweeps a circle against a circle by casting its center against the summed radii
+        bool shapeCastCircleCircle(const Vector2& center,
+            float radius,
+            const Vector2& displacement,
+            const CircleCollider* target,
+            ShapeCastHit& hit);
+
+        //Sweeps a circle against a rectangle by casting its center against the rectangle rounded by the radius
+        bool shapeCastCircleRect(const Vector2& center,
+            float radius,
+            const Vector2& displacement,
+            const RectCollider* target,
+            ShapeCastHit& hit);
+
+        //Sweeps a circle against a polygon by casting its center against the edges pushed out by the radius
+        //and circles around the vertices
+        bool shapeCastCirclePolygon(const Vector2& center,
+            float radius,
+            const Vector2& displacement,
+            const PolygonCollider* target,
+            ShapeCastHit& hit);
+
+        //Sweeps a circle against a capsule by casting its center against the capsule grown by the radius
+        bool shapeCastCircleCapsule(const Vector2& center,
+            float radius,
+            const Vector2& displacement,
+            const CapsuleCollider* target,
+            ShapeCastHit& hit);
+
+        //Sweeps a circle against the front of the segments of a chain
+        bool shapeCastCircleChain(const Vector2& center,
+            float radius,
+            const Vector2& displacement,
+            const ChainCollider* target,
+            ShapeCastHit& hit);
+
+        //Sweeps a circle, capsule, rectangle or polygon against another by conservative advancement on their
+        //GJK distance, used for pairs involving a capsule that have no closed form
+        //The shapes stop a small skin apart, so the fraction is slightly short of the exact time of impact
+        bool shapeCastConvex(
+            const Collider* shape, const Vector2& displacement, const Collider* target, ShapeCastHit& hit);
+
+        //Sweeps a capsule, rectangle or polygon against the front of the segments of a chain
+        //Each segment near the sweep is a two vertex core swept against with shapeCastConvex's method
+        bool shapeCastConvexChain(
+            const Collider* shape, const Vector2& displacement, const ChainCollider* target, ShapeCastHit& hit);
+
+        //Sweeps a rectangle or polygon against a rectangle or polygon using the separating axis theorem over time
+        bool shapeCastPolygonPolygon(
+            const Collider* shape, const Vector2& displacement, const Collider* target, ShapeCastHit& hit);
+
+        //Converts a world point into a rectangle's local space, rectangle center at the origin
+        const Vector2 toRectLocalSpace(const RectCollider* rect, const Vector2& point);
+
+        //Casts a ray against a collider by sorting into respective function based on shape
+        //Direction must be normalized, rays starting inside a collider do not hit it
+        bool rayCastCollider(
+            const Vector2& origin, const Vector2& direction, float maxDistance, const Collider* collider, RayHit& hit);
+
+        //Casts a ray against a circle collider
+        bool rayCastCircle(const Vector2& origin,
+            const Vector2& direction,
+            float maxDistance,
+            const CircleCollider* circle,
+            RayHit& hit);
+
+        //Casts a ray against a rotated rectangle collider using slabs in the rectangle's local space
+        bool rayCastRect(
+            const Vector2& origin, const Vector2& direction, float maxDistance, const RectCollider* rect, RayHit& hit);
+
+        //Casts a ray against a polygon collider by clipping it to the side of every edge
+        bool rayCastPolygon(const Vector2& origin,
+            const Vector2& direction,
+            float maxDistance,
+            const PolygonCollider* polygon,
+            RayHit& hit);
+
+        //Casts a ray against a capsule collider, a box around the segment and circles at its ends
+        bool rayCastCapsule(const Vector2& origin,
+            const Vector2& direction,
+            float maxDistance,
+            const CapsuleCollider* capsule,
+            RayHit& hit);
+
+        //Casts a ray against the front of the segments of a chain collider, rays from behind pass through
+        bool rayCastChain(const Vector2& origin,
+            const Vector2& direction,
+            float maxDistance,
+            const ChainCollider* chain,
+            RayHit& hit);
+
+        //Casts a ray against a tile map collider by stepping through the tiles along it
+        //A ray starting in solid tiles passes out of them before it can hit any
+        bool rayCastTileMap(const Vector2& origin,
+            const Vector2& direction,
+            float maxDistance,
+            const TileMapCollider* map,
+            RayHit& hit);
     }
 }
 
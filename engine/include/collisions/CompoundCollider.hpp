@@ -0,0 +1,151 @@
+//Class defenition for compound colliders made of several child shapes
+//Children are placed at an offset and rotation relative to the body, and are centered on their combined centroid
+//A small bounding volume hierarchy over the children in the body's local space finds the children near a box,
+//so only those take part in the narrow phase
+
+#ifndef COMPOUND_COLLIDER_HPP
+#define COMPOUND_COLLIDER_HPP
+
+#include "collisions/Collider.hpp"
+#include "collisions/DynamicTree.hpp"
+#include <cmath>
+#include <vector>
+
+namespace phys
+{
+    //Node of a compound collider's child hierarchy
+    struct CompoundNode
+    {
+        //Box in local space enclosing every child below the node
+        AABB box;
+
+        //First entry of a leaf in the child order, or the second child of an internal node
+        int index;
+
+        //Number of children in a leaf, 0 for internal nodes
+        int count;
+    };
+
+    class CompoundCollider : public Collider
+    {
+      private:
+        //Most children stored in one leaf
+        static const int MAX_LEAF_CHILDREN = 2;
+
+        //Child colliders, owned by the compound
+        std::vector<Collider*> m_children;
+
+        //Offsets and rotations of the children as given, relative to the body before centering
+        //Giving these again rebuilds exactly the same compound
+        std::vector<Vector2> m_childOffsets;
+        std::vector<float> m_childRotations;
+
+        //Boxes of the children in local space, centered on the centroid and not rotated by the body
+        std::vector<AABB> m_childBoxes;
+
+        //Hierarchy nodes in depth first order, the root is node 0
+        std::vector<CompoundNode> m_nodes;
+
+        //Child indices in leaf order
+        std::vector<int> m_childOrder;
+
+        //Centroid of the children as given, they were moved by it so the centroid lies on the collider position
+        Vector2 m_centroid;
+
+        float m_area;
+
+        //Rotational inertia about the centroid for a mass of 1
+        float m_unitInertia;
+
+        //Distance of the farthest point of any child from the collider position
+        float m_radius;
+
+        //Rotation of the collider, kept for moving boxes into local space
+        float m_cos;
+        float m_sin;
+
+        //Update AABB mins and maxes, and the positions and rotations of every child
+        virtual void updateAABB() override;
+
+        //Recomputes the centroid, mass properties, local boxes and hierarchy after the children change
+        void rebuild();
+
+        //Builds the subtree over m_childOrder[first, first + count), returns the index of its root
+        int buildNode(int first, int count);
+
+      public:
+        //Constructor to create a compound without children
+        CompoundCollider(ColliderType colliderType);
+
+        //Destructor to delete the children
+        virtual ~CompoundCollider() override;
+
+        //Adds a child at an offset and rotation relative to the body, the compound takes ownership of it
+        //Returns false and leaves the child to the caller if it is a compound, chain or tile map itself
+        bool addChild(Collider* child, const Vector2& offset, float rotation = 0.0f);
+
+        //Getters for member variables
+        int getChildCount() const;
+        Collider* getChild(int index) const;
+        const Vector2& getChildOffset(int index) const;
+        float getChildRotation(int index) const;
+        const Vector2& getCentroid() const;
+        float getArea() const;
+        float getUnitInertia() const;
+        float getRadius() const;
+
+        //Children share the body of the compound
+        virtual void setParent(PhysicsBody* newParent) override;
+
+        //Calls callback(child) for every child whose box overlaps a box in world space
+        //The callback returns false to stop the query early
+        template <typename Callback>
+        void queryChildren(const AABB& box, Callback&& callback) const;
+    };
+
+    template <typename Callback>
+    void CompoundCollider::queryChildren(const AABB& box, Callback&& callback) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        //Box in local space, grown to enclose the world box rotated against the collider
+        Vector2 center = (box.min + box.max) / 2.0f - m_position;
+        Vector2 half = (box.max - box.min) / 2.0f;
+        Vector2 localCenter = {center.x * m_cos + center.y * m_sin, -center.x * m_sin + center.y * m_cos};
+        Vector2 localHalf = {half.x * std::abs(m_cos) + half.y * std::abs(m_sin),
+            half.x * std::abs(m_sin) + half.y * std::abs(m_cos)};
+        AABB localBox(localCenter - localHalf, localCenter + localHalf);
+
+        int stack[TREE_STACK_SIZE];
+        int count = 0;
+        stack[count++] = 0;
+
+        while (count > 0)
+        {
+            int nodeId = stack[--count];
+            const CompoundNode& node = m_nodes[nodeId];
+
+            if (!node.box.overlaps(localBox))
+                continue;
+
+            if (node.count > 0)
+            {
+                for (int entry = node.index; entry < node.index + node.count; entry++)
+                {
+                    //The child's own world box is tighter than the grown local one
+                    Collider* child = m_children[m_childOrder[entry]];
+                    if (child->getAABB().overlaps(box) && !callback(child))
+                        return;
+                }
+            }
+            else if (count + 2 <= TREE_STACK_SIZE)
+            {
+                stack[count++] = node.index;
+                stack[count++] = nodeId + 1;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,186 @@
+//Class defenition for a dynamic bounding volume tree of AABBs
+//Leaves hold fattened AABBs of physics bodies so small movements do not require tree updates
+//Used by the broad phase to find overlapping bodies without testing every pair
+
+#ifndef DYNAMIC_TREE_HPP
+#define DYNAMIC_TREE_HPP
+
+#include "collisions/AABB.hpp"
+#include <vector>
+
+namespace phys
+{
+    class PhysicsBody;
+
+    //Sentinel value for a missing node
+    const int NULL_NODE = -1;
+
+    //Maximum depth of the traversal stack, enough for any balanced tree
+    const int TREE_STACK_SIZE = 256;
+
+    //Node of the tree, leaves store bodies and internal nodes enclose their children
+    struct TreeNode
+    {
+        //Enlarged box enclosing the body or both children
+        AABB box;
+
+        //Body stored in the leaf, null for internal nodes
+        PhysicsBody* body;
+
+        //Parent node, or the next free node when in the free list
+        int parent;
+
+        //Children, both NULL_NODE for leaves
+        int child1;
+        int child2;
+
+        //Height of the subtree, 0 for leaves and -1 for free nodes
+        int height;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    class DynamicTree
+    {
+      private:
+        //Pool of nodes, freed nodes are linked through their parent index
+        std::vector<TreeNode> m_nodes;
+
+        //Root of the tree
+        int m_root;
+
+        //Head of the free node list
+        int m_freeList;
+
+        //Number of leaves in the tree
+        int m_leafCount;
+
+        //Takes a node from the free list, growing the pool when empty
+        int allocateNode();
+
+        //Returns a node to the free list
+        void freeNode(int nodeId);
+
+        //Inserts a leaf by descending along the cheapest perimeter path
+        void insertLeaf(int leaf);
+
+        //Detaches a leaf and collapses its parent
+        void removeLeaf(int leaf);
+
+        //Performs a rotation at the node if it is unbalanced, returns the new subtree root
+        int balance(int nodeId);
+
+        //Builds a subtree over leaves by splitting them at the median of the widest axis, returns its root
+        int buildTopDown(int* leaves, int count);
+
+      public:
+        //Constructor to create an empty tree
+        DynamicTree();
+
+        //Creates a leaf for a body with the given fat box, returns the proxy id
+        int createProxy(const AABB& fatBox, PhysicsBody* body);
+
+        //Creates leaves for many bodies at once and writes their proxy ids
+        //An empty tree is built top down in one pass, otherwise the leaves are inserted one by one
+        void createProxies(const AABB* fatBoxes, PhysicsBody* const* bodies, int count, int* proxyIds);
+
+        //Removes a leaf from the tree
+        void destroyProxy(int proxyId);
+
+        //Moves a leaf to a new fat box
+        void moveProxy(int proxyId, const AABB& fatBox);
+
+        //Moves every box by -shift without changing the structure of the tree
+        void shiftOrigin(const Vector2& shift);
+
+        //Getters for leaf data
+        PhysicsBody* getBody(int proxyId) const;
+        const AABB& getFatAABB(int proxyId) const;
+
+        //Returns the number of leaves in the tree
+        int getLeafCount() const;
+
+        //Returns the height of the tree, 0 when empty
+        int getHeight() const;
+
+        //Calls callback(proxyId) for every leaf whose box overlaps the query box
+        //The callback returns false to stop the query early
+        template <typename Callback>
+        void query(const AABB& box, Callback&& callback) const;
+
+        //Calls callback(proxyId, maxDistance) for every leaf whose box the ray touches
+        //Direction must be normalized, the callback returns the distance to clip the ray to
+        //Returning maxDistance continues unchanged, returning 0 stops the cast
+        template <typename Callback>
+        void rayCast(const Vector2& origin, const Vector2& direction, float maxDistance, Callback&& callback) const;
+    };
+
+    template <typename Callback>
+    void DynamicTree::query(const AABB& box, Callback&& callback) const
+    {
+        if (m_root == NULL_NODE)
+            return;
+
+        //Fixed size stack so queries never allocate
+        int stack[TREE_STACK_SIZE];
+        int count = 0;
+        stack[count++] = m_root;
+
+        while (count > 0)
+        {
+            const TreeNode& node = m_nodes[stack[--count]];
+
+            if (!node.box.overlaps(box))
+                continue;
+
+            if (node.isLeaf())
+            {
+                if (!callback(static_cast<int>(&node - m_nodes.data())))
+                    return;
+            }
+            else if (count + 2 <= TREE_STACK_SIZE)
+            {
+                stack[count++] = node.child1;
+                stack[count++] = node.child2;
+            }
+        }
+    }
+
+    template <typename Callback>
+    void DynamicTree::rayCast(
+        const Vector2& origin, const Vector2& direction, float maxDistance, Callback&& callback) const
+    {
+        if (m_root == NULL_NODE)
+            return;
+
+        int stack[TREE_STACK_SIZE];
+        int count = 0;
+        stack[count++] = m_root;
+
+        while (count > 0)
+        {
+            const TreeNode& node = m_nodes[stack[--count]];
+
+            //Nodes beyond the closest hit so far are skipped
+            if (!node.box.intersectsRay(origin, direction, maxDistance))
+                continue;
+
+            if (node.isLeaf())
+            {
+                float clipDistance = callback(static_cast<int>(&node - m_nodes.data()), maxDistance);
+                if (clipDistance <= 0.0f)
+                    return;
+
+                if (clipDistance < maxDistance)
+                    maxDistance = clipDistance;
+            }
+            else if (count + 2 <= TREE_STACK_SIZE)
+            {
+                stack[count++] = node.child1;
+                stack[count++] = node.child2;
+            }
+        }
+    }
+}
+
+#endif
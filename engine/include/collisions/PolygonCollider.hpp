@@ -0,0 +1,73 @@
+//Class defenition for convex polygon shape colliders
+//Up to MAX_VERTICES vertices, kept counter clockwise with their edge normals
+//Any number of points may be given, a hull with more vertices is reduced by dropping the vertices cutting off
+//the least area
+//Vertices and normals are also kept in world space, refreshed whenever the collider moves or rotates
+
+#ifndef POLYGON_COLLIDER_HPP
+#define POLYGON_COLLIDER_HPP
+
+#include "collisions/Collider.hpp"
+#include <vector>
+
+namespace phys
+{
+    class PolygonCollider : public Collider
+    {
+      public:
+        //Most vertices a polygon can have, larger hulls are reduced to this many
+        static const int MAX_VERTICES = 8;
+
+      private:
+        //Convex hull of the points as given after any reduction, counter clockwise from the leftmost point
+        //Giving these points again rebuilds exactly the same polygon
+        Vector2 m_points[MAX_VERTICES];
+
+        //Vertices relative to the collider position and the outward normals of the edges starting at them
+        Vector2 m_localVertices[MAX_VERTICES];
+        Vector2 m_localNormals[MAX_VERTICES];
+
+        //Vertices and normals with the collider's position and rotation applied
+        Vector2 m_vertices[MAX_VERTICES];
+        Vector2 m_normals[MAX_VERTICES];
+
+        int m_vertexCount;
+
+        //Centroid of the points as given, they were moved by it so the centroid lies on the collider position
+        Vector2 m_centroid;
+
+        float m_area;
+
+        //Rotational inertia about the centroid for a mass of 1
+        float m_unitInertia;
+
+        //Distance of the farthest vertex from the collider position
+        float m_radius;
+
+        //Update AABB mins and maxes, and the world vertices and normals
+        virtual void updateAABB() override;
+
+      public:
+        //Constructor to set vertices and collider type
+        //Points are relative to the body position, their convex hull becomes the polygon
+        //The polygon needs three points not on one line, check getVertexCount
+        PolygonCollider(const std::vector<Vector2>& points, ColliderType colliderType);
+
+        //Getters for member variables
+        int getVertexCount() const;
+        const Vector2* getPoints() const;
+        const Vector2* getLocalVertices() const;
+        const Vector2* getVertices() const;
+        const Vector2* getNormals() const;
+        const Vector2& getCentroid() const;
+        float getArea() const;
+        float getUnitInertia() const;
+        float getRadius() const;
+
+        //Replaces the polygon with the convex hull of the points, centered on its centroid
+        //Hulls of more than MAX_VERTICES vertices are reduced to MAX_VERTICES
+        void setVertices(const std::vector<Vector2>& points);
+    };
+}
+
+#endif
@@ -0,0 +1,75 @@
+//Defenitions of structs used to query a physics world
+//Rays, hit results, and filters selecting which colliders a query considers
+
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include "core/Vector2.hpp"
+#include <vector>
+
+namespace phys
+{
+    class PhysicsBody;
+
+    //Ray or segment starting at origin, extending along direction for maxDistance meters
+    struct Ray
+    {
+        Vector2 origin;
+
+        //Direction of the ray, does not need to be normalized
+        Vector2 direction;
+
+        float maxDistance;
+    };
+
+    //Result of a ray cast against a collider
+    struct RayHit
+    {
+        //Body that was hit, null if nothing was hit
+        PhysicsBody* body;
+
+        //Point on the collider surface where the ray entered
+        Vector2 point;
+
+        //Surface normal at the hit point, pointing out of the collider
+        Vector2 normal;
+
+        //Distance along the ray to the hit point in meters
+        float distance;
+    };
+
+    //Result of sweeping a collider along a displacement
+    struct ShapeCastHit
+    {
+        //Body that was hit first, null if nothing was hit
+        PhysicsBody* body;
+
+        //Point of first contact
+        Vector2 point;
+
+        //Surface normal of the hit body at the contact, pointing towards the swept shape
+        Vector2 normal;
+
+        //Fraction of the displacement travelled before contact, 0 if the shape started overlapping
+        float fraction;
+    };
+
+    //Selects which colliders a query considers
+    struct QueryFilter
+    {
+        //Collision layers to search, every layer when empty
+        std::vector<unsigned int> layers;
+
+        //Layers kept elsewhere, such as a collider's masks, searched instead of layers when set
+        //Referenced rather than copied so a filter built every frame does not allocate, must outlive the query
+        const std::vector<unsigned int>* layerSpan = nullptr;
+
+        //Whether trigger colliders are reported
+        bool includeTriggers = false;
+
+        //Returns the layers to search
+        const std::vector<unsigned int>& getLayers() const { return layerSpan ? *layerSpan : layers; }
+    };
+}
+
+#endif
@@ -0,0 +1,71 @@
+//Class defenition for the simplex caches kept between steps for pairs of convex colliders
+//GJK starts from the simplex it finished with the last time it met the same pair, so a resting contact
+//is confirmed in one or two iterations instead of rebuilding the simplex from a single vertex
+//Caches only decide where GJK starts, never what it finds, so a stale or missing entry just costs iterations
+
+#ifndef SIMPLEX_CACHE_HPP
+#define SIMPLEX_CACHE_HPP
+
+#include "collisions/Collider.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+namespace phys
+{
+    //Vertices of the simplex a query finished with, as indices into the vertices of each shape's core
+    struct SimplexCache
+    {
+        int count;
+        uint8_t indexA[3];
+        uint8_t indexB[3];
+
+        //GJK and EPA iterations the last query took
+        int iterations;
+
+        SimplexCache() : count(0), indexA{0, 0, 0}, indexB{0, 0, 0}, iterations(0) {}
+    };
+
+    class SimplexCacheTable
+    {
+      private:
+        //Cache of one pair and the step it was last looked up in
+        struct Entry
+        {
+            SimplexCache cache;
+            uint32_t step;
+        };
+
+        //Hashes a pair of colliders
+        struct PairHash
+        {
+            size_t operator()(const std::pair<const Collider*, const Collider*>& pair) const;
+        };
+
+        //Caches by the pair of colliders they were looked up with, in that order
+        std::unordered_map<std::pair<const Collider*, const Collider*>, Entry, PairHash> m_entries;
+
+        //Counts steps so entries that went unused can be dropped
+        uint32_t m_step;
+
+      public:
+        //Constructor to create an empty table
+        SimplexCacheTable();
+
+        //Returns the cache of a pair of colliders, adding an empty one if the pair has none
+        //Pairs are told apart by order, so a pair looked up the other way round gets its own cache
+        SimplexCache* find(const Collider* colliderA, const Collider* colliderB);
+
+        //Starts a step, dropping the caches of pairs that were not looked up during the last one
+        void beginStep();
+
+        //Removes every cache
+        void clear();
+
+        //Returns the number of cached pairs
+        size_t getSize() const;
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+//Class defenition for a group of static bodies with their broad phase trees built ahead of time
+//A group is attached to a broad phase as a whole, so its bodies are never inserted into the trees one by one
+
+#ifndef STATIC_GROUP_HPP
+#define STATIC_GROUP_HPP
+
+#include "collisions/AABB.hpp"
+#include "collisions/StaticTree.hpp"
+#include <map>
+#include <vector>
+
+namespace phys
+{
+    class PhysicsBody;
+
+    class StaticGroup
+    {
+      private:
+        //Bodies of the group, owned by it
+        std::vector<PhysicsBody*> m_bodies;
+
+        //One tree per collision layer, holding the tight boxes of the bodies on that layer
+        std::map<unsigned int, StaticTree> m_layerTrees;
+
+        //Box enclosing every body
+        AABB m_bounds;
+
+      public:
+        //Constructor to create an empty group
+        StaticGroup();
+
+        //Destructor to delete the bodies
+        ~StaticGroup();
+
+        StaticGroup(const StaticGroup&) = delete;
+        StaticGroup& operator=(const StaticGroup&) = delete;
+
+        //Takes ownership of the bodies and builds the layer trees over them
+        //Returns false and takes nothing if the group was already built or a body is not static
+        bool build(const std::vector<PhysicsBody*>& bodies);
+
+        //Moves every body and box by -shift, call when the origin of the world moves
+        void shiftOrigin(const Vector2& shift);
+
+        //Returns the bodies of the group
+        const std::vector<PhysicsBody*>& getBodies() const;
+
+        //Returns the trees of every layer
+        const std::map<unsigned int, StaticTree>& getLayerTrees() const;
+
+        //Returns the tree of a layer, null if no body is on that layer
+        const StaticTree* getLayerTree(unsigned int layer) const;
+
+        //Returns the box enclosing every body
+        const AABB& getBounds() const;
+    };
+}
+
+#endif
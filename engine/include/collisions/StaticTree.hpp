@@ -0,0 +1,179 @@
+//Class defenition for an immutable bounding volume hierarchy of static bodies
+//The tree is built once over a fixed set of boxes with the binned surface area heuristic and stored flat in
+//depth first order, so the first child of a node is the next node and traversals mostly walk memory forward
+
+#ifndef STATIC_TREE_HPP
+#define STATIC_TREE_HPP
+
+#include "collisions/AABB.hpp"
+#include "collisions/DynamicTree.hpp"
+#include <vector>
+
+namespace phys
+{
+    class PhysicsBody;
+
+    //Node of a static tree
+    struct StaticTreeNode
+    {
+        //Box enclosing every item below the node
+        AABB box;
+
+        //First item of a leaf, or the second child of an internal node
+        int index;
+
+        //Number of items in a leaf, 0 for internal nodes
+        int count;
+    };
+
+    class StaticTree
+    {
+      private:
+        //Most items stored in one leaf
+        static const int MAX_LEAF_ITEMS = 4;
+
+        //Number of bins item centers are sorted into when choosing a split
+        static const int BIN_COUNT = 16;
+
+        //Depth from which nodes are split at the median, keeping the tree within the traversal stack
+        static const int MEDIAN_SPLIT_DEPTH = 48;
+
+        //Nodes in depth first order, the root is node 0
+        std::vector<StaticTreeNode> m_nodes;
+
+        //Items in leaf order, the boxes are kept apart from the bodies so leaves are tested without touching bodies
+        std::vector<AABB> m_boxes;
+        std::vector<PhysicsBody*> m_bodies;
+
+        //Number of removed items, whose bodies are null
+        int m_removedCount;
+
+        //Builds the subtree over order[first, first + count), returns the index of its root
+        int buildNode(std::vector<int>& order,
+            const std::vector<Vector2>& centers,
+            const AABB* boxes,
+            int first,
+            int count,
+            int depth);
+
+      public:
+        //Constructor to create an empty tree
+        StaticTree();
+
+        //Replaces the tree with one built over the boxes, the bodies are reported by queries
+        void build(const AABB* boxes, PhysicsBody* const* bodies, int count);
+
+        //Removes every item
+        void clear();
+
+        //Removes an item so it is never reported again, the tree keeps its shape until it is rebuilt
+        void removeItem(int item);
+
+        //Moves every box by -shift
+        void shiftOrigin(const Vector2& shift);
+
+        //Getters for item data, the body is null for removed items
+        PhysicsBody* getBody(int item) const;
+        const AABB& getAABB(int item) const;
+
+        //Returns the number of items, including removed ones
+        int getItemCount() const;
+
+        //Returns the number of removed items
+        int getRemovedCount() const;
+
+        //Returns the number of nodes
+        int getNodeCount() const;
+
+        //Calls callback(item) for every item whose box overlaps the query box
+        //The callback returns false to stop the query early
+        template <typename Callback>
+        void query(const AABB& box, Callback&& callback) const;
+
+        //Calls callback(item, maxDistance) for every item whose box the ray touches
+        //Direction must be normalized, the callback returns the distance to clip the ray to
+        //Returning maxDistance continues unchanged, returning 0 stops the cast
+        template <typename Callback>
+        void rayCast(const Vector2& origin, const Vector2& direction, float maxDistance, Callback&& callback) const;
+    };
+
+    template <typename Callback>
+    void StaticTree::query(const AABB& box, Callback&& callback) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        int stack[TREE_STACK_SIZE];
+        int count = 0;
+        stack[count++] = 0;
+
+        while (count > 0)
+        {
+            int nodeId = stack[--count];
+            const StaticTreeNode& node = m_nodes[nodeId];
+
+            if (!node.box.overlaps(box))
+                continue;
+
+            if (node.count > 0)
+            {
+                for (int item = node.index; item < node.index + node.count; item++)
+                {
+                    if (m_bodies[item] && m_boxes[item].overlaps(box) && !callback(item))
+                        return;
+                }
+            }
+            else if (count + 2 <= TREE_STACK_SIZE)
+            {
+                //First child on top so it is visited next, right after its parent in memory
+                stack[count++] = node.index;
+                stack[count++] = nodeId + 1;
+            }
+        }
+    }
+
+    template <typename Callback>
+    void StaticTree::rayCast(
+        const Vector2& origin, const Vector2& direction, float maxDistance, Callback&& callback) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        int stack[TREE_STACK_SIZE];
+        int count = 0;
+        stack[count++] = 0;
+
+        while (count > 0)
+        {
+            int nodeId = stack[--count];
+            const StaticTreeNode& node = m_nodes[nodeId];
+
+            //Nodes beyond the closest hit so far are skipped
+            if (!node.box.intersectsRay(origin, direction, maxDistance))
+                continue;
+
+            if (node.count > 0)
+            {
+                for (int item = node.index; item < node.index + node.count; item++)
+                {
+                    if (!m_bodies[item] || !m_boxes[item].intersectsRay(origin, direction, maxDistance))
+                        continue;
+
+                    float clipDistance = callback(item, maxDistance);
+                    if (clipDistance <= 0.0f)
+                        return;
+
+                    if (clipDistance < maxDistance)
+                        maxDistance = clipDistance;
+                }
+            }
+            else if (count + 2 <= TREE_STACK_SIZE)
+            {
+                stack[count++] = node.index;
+                stack[count++] = nodeId + 1;
+            }
+        }
+    }
+}
+
+#endif
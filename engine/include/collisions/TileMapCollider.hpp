@@ -0,0 +1,156 @@
+//Class defenition for tile map colliders, a grid of square solid or empty tiles for static levels
+//Tiles are stored one bit each, counted in columns to the right and rows up from the collider position
+//Solid tiles may be merged greedily into larger boxes, so a flat floor touches a body with one box instead of many
+//A body only looks up the tiles under its AABB, so the cost does not grow with the size of the map
+
+#ifndef TILE_MAP_COLLIDER_HPP
+#define TILE_MAP_COLLIDER_HPP
+
+#include "collisions/Collider.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace phys
+{
+    //Box of solid tiles, in tiles from the bottom left corner of the map
+    struct TileBox
+    {
+        int column;
+        int row;
+        int width;
+        int height;
+    };
+
+    class TileMapCollider : public Collider
+    {
+      private:
+        int m_columns;
+        int m_rows;
+        float m_tileSize;
+
+        //One bit per tile, row by row from the bottom, set for solid tiles
+        std::vector<uint64_t> m_tiles;
+
+        //Whether solid tiles are merged into larger boxes
+        bool m_merged;
+
+        //Merged boxes, in order of their bottom left tile
+        std::vector<TileBox> m_boxes;
+
+        //Boxes covering each row sorted by column, the entries of row r are [m_rowStarts[r], m_rowStarts[r + 1])
+        std::vector<int> m_rowStarts;
+        std::vector<int> m_rowBoxes;
+
+        //Rotation of the collider, kept for moving boxes into local space
+        float m_cos;
+        float m_sin;
+
+        //Update AABB mins and maxes around the whole grid
+        virtual void updateAABB() override;
+
+        //Rebuilds the merged boxes after the tiles change
+        void mergeTiles();
+
+        //Finds the tiles under a box in world space, returns false if it misses the grid
+        bool findTileRange(const AABB& box, int& firstColumn, int& firstRow, int& lastColumn, int& lastRow) const;
+
+      public:
+        //Constructor to set the grid size, tile size, whether tiles are merged, and collider type
+        //Every tile starts empty
+        TileMapCollider(int columns, int rows, float tileSize, bool merged, ColliderType colliderType);
+
+        //Getters for member variables
+        int getColumns() const;
+        int getRows() const;
+        float getTileSize() const;
+        bool isMerged() const;
+
+        //Returns the number of boxes the solid tiles form, one per tile unless merged
+        int getBoxCount() const;
+
+        //Distance of the farthest corner of the grid from the collider position
+        float getRadius() const;
+
+        //Returns true if a tile is solid, tiles outside the grid are empty
+        bool isSolid(int column, int row) const;
+
+        //Sets one tile, rebuilding the merged boxes, so prefer setTiles when changing many
+        void setSolid(int column, int row, bool solid);
+
+        //Replaces every tile, row by row from the bottom, returns false if the count does not match the grid
+        bool setTiles(const std::vector<bool>& tiles);
+
+        //Returns the world space corners of the grid
+        const std::vector<Vector2> calculateCorners() const;
+
+        //Returns a box of tiles in the grid's space, in meters from the bottom left corner
+        const AABB getLocalBounds(const TileBox& box) const;
+
+        //Returns a world space direction in the grid's space, and back
+        const Vector2 toLocalDirection(const Vector2& direction) const;
+        const Vector2 toWorldDirection(const Vector2& direction) const;
+
+        //Returns true if the face of a box along a local axis direction is covered by solid tiles
+        //everywhere beside a region in world space
+        //Bodies never reach such a face from outside, so contacts through it come from seams or sinking in deep
+        bool isFaceCovered(const TileBox& box, const Vector2& localDirection, const AABB& region) const;
+
+        //Calls callback(box) for every box of solid tiles under a box in world space
+        //The callback returns false to stop the query early
+        template <typename Callback>
+        void queryBoxes(const AABB& box, Callback&& callback) const;
+    };
+
+    template <typename Callback>
+    void TileMapCollider::queryBoxes(const AABB& box, Callback&& callback) const
+    {
+        int firstColumn;
+        int firstRow;
+        int lastColumn;
+        int lastRow;
+
+        if (!findTileRange(box, firstColumn, firstRow, lastColumn, lastRow))
+            return;
+
+        if (!m_merged)
+        {
+            for (int row = firstRow; row <= lastRow; row++)
+            {
+                for (int column = firstColumn; column <= lastColumn; column++)
+                {
+                    if (isSolid(column, row) && !callback(TileBox{column, row, 1, 1}))
+                        return;
+                }
+            }
+
+            return;
+        }
+
+        for (int row = firstRow; row <= lastRow; row++)
+        {
+            //Boxes in a row do not overlap, so sorting by column also sorts their last columns
+            auto first = m_rowBoxes.begin() + m_rowStarts[row];
+            auto last = m_rowBoxes.begin() + m_rowStarts[row + 1];
+            auto entry = std::lower_bound(first,
+                last,
+                firstColumn,
+                [this](int boxIndex, int column)
+                {
+                    const TileBox& rowBox = m_boxes[boxIndex];
+                    return rowBox.column + rowBox.width <= column;
+                });
+
+            for (; entry != last && m_boxes[*entry].column <= lastColumn; entry++)
+            {
+                //Boxes spanning several rows are reported once, from the lowest row searched
+                const TileBox& tileBox = m_boxes[*entry];
+                if (std::max(tileBox.row, firstRow) == row && !callback(tileBox))
+                    return;
+            }
+        }
+    }
+}
+
+#endif
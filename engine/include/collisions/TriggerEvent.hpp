@@ -0,0 +1,29 @@
+//Defenition of TriggerEvent struct reported when a body starts or stops overlapping a trigger collider
+
+#ifndef TRIGGER_EVENT_HPP
+#define TRIGGER_EVENT_HPP
+
+#include "physics/PhysicsBody.hpp"
+
+namespace phys
+{
+    enum class TriggerEventType
+    {
+        Enter,
+        Exit
+    };
+
+    struct TriggerEvent
+    {
+        //Body with the trigger collider, bodyA of the pair if both are triggers
+        PhysicsBody* trigger;
+
+        //Body that entered or exited the trigger
+        PhysicsBody* other;
+
+        //Whether the overlap started or ended this update
+        TriggerEventType type;
+    };
+}
+
+#endif
@@ -0,0 +1,99 @@
+//Class defenition for streaming static geometry around a focus area
+//The plane is split into square chunks, each stored as a snapshot file of the static bodies whose centers lie in it
+//Chunks near the focus are loaded as static groups with prebuilt broad phase trees, and unloaded once it moves away
+
+#ifndef CHUNK_STORE_HPP
+#define CHUNK_STORE_HPP
+
+#include "collisions/AABB.hpp"
+#include "collisions/StaticGroup.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace phys
+{
+    class PhysicsWorld;
+    class PhysicsBody;
+
+    //Chunk the store has visited, remembered even when its file does not exist so it is not looked up again
+    struct StaticChunk
+    {
+        //Coordinates of the chunk in chunk units, chunk (0, 0) starts at absolute position (0, 0)
+        int x;
+        int y;
+
+        //Bodies of the chunk, null if the chunk has no file
+        StaticGroup* group;
+    };
+
+    class ChunkStore
+    {
+      private:
+        //World the chunks are added to
+        PhysicsWorld* m_world;
+
+        //Directory holding the chunk files
+        std::string m_directory;
+
+        //Side length of a chunk in meters
+        float m_chunkSize;
+
+        //Distance around the focus within which chunks are loaded
+        float m_loadDistance;
+
+        //Distance around the focus beyond which chunks are unloaded, larger than the load distance
+        //so chunks at the edge are not loaded and unloaded again every time the focus moves a little
+        float m_unloadDistance;
+
+        //Visited chunks by key
+        std::unordered_map<uint64_t, StaticChunk> m_chunks;
+
+        //Packs chunk coordinates into a key
+        static uint64_t makeKey(int x, int y);
+
+        //Returns the coordinate of the chunk holding an absolute position along one axis
+        int getChunkCoordinate(double position) const;
+
+        //Reads a chunk file into a built static group, null if the file is missing or invalid
+        StaticGroup* loadChunk(int x, int y) const;
+
+      public:
+        //Constructor to stream chunks of a given size from a directory into a world
+        ChunkStore(PhysicsWorld& world, const std::string& directory, float chunkSize);
+
+        //Destructor to unload every chunk, the world must still exist
+        ~ChunkStore();
+
+        ChunkStore(const ChunkStore&) = delete;
+        ChunkStore& operator=(const ChunkStore&) = delete;
+
+        //Splits the static bodies into chunks by their centers and writes one snapshot file per chunk
+        //Positions are taken as absolute, other body types are skipped
+        //Returns false if a file could not be written
+        static bool writeChunks(const std::vector<PhysicsBody*>& bodies, const std::string& directory, float chunkSize);
+
+        //Returns the path of a chunk's file
+        static std::string getChunkPath(const std::string& directory, int x, int y);
+
+        //Loads chunks within the load distance of the focus and unloads chunks beyond the unload distance
+        //The focus is relative to the world's origin, returns the number of chunks loaded
+        int update(const AABB& focus);
+
+        //Unloads every chunk
+        void unloadAll();
+
+        //Sets the load and unload distances, the unload distance is raised to the load distance if lower
+        //Bodies are filed by their centers, so the load distance should exceed half the size of the largest body
+        void setDistances(float loadDistance, float unloadDistance);
+
+        //Returns a loaded chunk's group, null if the chunk is not loaded or has no file
+        const StaticGroup* getChunk(int x, int y) const;
+
+        //Returns the number of loaded chunks that have bodies
+        int getLoadedChunkCount() const;
+    };
+}
+
+#endif
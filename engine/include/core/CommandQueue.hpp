@@ -0,0 +1,73 @@
+//Class defenition for a lock free queue of world commands
+//Any number of threads push commands, only the thread updating the world takes them out
+//Follows Dmitry Vyukov's intrusive MPSC queue: a push is one atomic exchange, so producers never wait or retry
+
+#ifndef COMMAND_QUEUE_HPP
+#define COMMAND_QUEUE_HPP
+
+#include "core/WorldCommand.hpp"
+#include <atomic>
+
+namespace phys
+{
+    class CommandQueue
+    {
+      private:
+        struct Node
+        {
+            std::atomic<Node*> next;
+            WorldCommand command;
+        };
+
+        //Newest node, exchanged by every push
+        std::atomic<Node*> m_head;
+
+        //Node whose command was taken last, its successor holds the oldest command, only the consumer touches it
+        Node* m_tail;
+
+      public:
+        //Constructor to create an empty queue
+        CommandQueue();
+
+        //Destructor to free the remaining nodes, commands still queued are dropped
+        ~CommandQueue();
+
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        //Adds a command, safe to call from any number of threads at once
+        void push(const WorldCommand& command);
+
+        //Takes out the oldest command, only one thread may pop at a time
+        //Returns false if the queue is empty, or the oldest command is still being pushed
+        bool pop(WorldCommand& command);
+
+        //Pops every command that was queued when the call started and passes it to apply
+        //Commands pushed meanwhile stay queued, so busy producers cannot keep the consumer draining forever
+        //Returns the number of commands applied
+        template <typename Apply>
+        int drain(Apply&& apply)
+        {
+            Node* last = m_head.load(std::memory_order_acquire);
+            int count = 0;
+
+            while (m_tail != last)
+            {
+                //A producer exchanged the head but has not linked its node yet, the rest waits for the next drain
+                Node* next = m_tail->next.load(std::memory_order_acquire);
+                if (!next)
+                    break;
+
+                delete m_tail;
+                m_tail = next;
+
+                apply(next->command);
+                count++;
+            }
+
+            return count;
+        }
+    };
+}
+
+#endif
@@ -8,20 +8,43 @@
 
 #include "core/Vector2.hpp"
 #include "core/WorldBoundary.hpp"
+#include "core/RenderBuffer.hpp"
+#include "core/CommandQueue.hpp"
+#include "core/RegionIndex.hpp"
 #include "collisions/Collider.hpp"
 #include "collisions/RectCollider.hpp"
 #include "collisions/CircleCollider.hpp"
+#include "collisions/PolygonCollider.hpp"
+#include "collisions/CapsuleCollider.hpp"
+#include "collisions/CompoundCollider.hpp"
+#include "collisions/ChainCollider.hpp"
+#include "collisions/TileMapCollider.hpp"
 #include "collisions/CollisionDetection.hpp"
 #include "collisions/Collision.hpp"
+#include "collisions/BroadPhase.hpp"
+#include "collisions/SimplexCache.hpp"
+#include "collisions/StaticGroup.hpp"
+#include "collisions/TriggerEvent.hpp"
+#include "collisions/Query.hpp"
 #include "physics/PhysicsBody.hpp"
 #include "physics/StaticBody.hpp"
 #include "physics/DynamicBody.hpp"
 #include "physics/CollisionResolution.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace phys
 {
+    class WorldRecorder;
+    class StepThread;
+    class ThreadPool;
+
     class PhysicsWorld
     {
       private:
@@ -34,6 +57,12 @@ namespace phys
         //Gravity scale of the world
         float m_gravityScale;
 
+        //Times collisions are resolved per update, to resolve deep interpenetration
+        const int COLLISION_ITERATIONS = 10;
+
+        //Rays a pool task casts at a time in a batched raycast, smaller batches are cast on the calling thread
+        const size_t RAYCAST_BATCH_RANGE = 64;
+
         //Boolean to control whether physics is processed
         bool m_processPhysics;
 
@@ -43,9 +72,164 @@ namespace phys
         //Boolean to control whether rotational physics is active
         bool m_rotationalPhysics;
 
+        //Boolean to control whether pairs are ordered by body ids and the state hash is updated
+        bool m_deterministic;
+
+        //Id given to the next body added to the world, also reserved from other threads by queueAddBody
+        std::atomic<unsigned int> m_nextBodyId;
+
+        //Hash of all body state after the last update in deterministic mode
+        uint64_t m_stateHash;
+
+        //Recorder logging external mutations, null when not recording
+        WorldRecorder* m_recorder;
+
+        //Boolean to control whether render state is written after every update
+        bool m_exportRenderState;
+
+        //Render state of the bodies, published after every update when exporting
+        RenderBuffer m_renderBuffer;
+
+        //Thread running asynchronous steps, created by the first stepAsync call
+        StepThread* m_stepThread;
+
+        //Commands queued from any thread, drained at the start of every update
+        CommandQueue m_commands;
+
+        //Position of the world origin in double precision, body positions are relative to it
+        double m_originX;
+        double m_originY;
+
+        //Point the simulation is centered on, relative to the origin
+        Vector2 m_focus;
+
+        //Distance of the focus from the origin that moves the origin to it, 0 to never move it
+        float m_rebaseDistance;
+
+        //Regions occupied by bodies, only refiled when asked for while the world has no boundary
+        RegionIndex m_regionIndex;
+
+        //True once bodies may have moved since the region index was last refiled
+        bool m_regionIndexStale;
+
         //List of all physics bodies in the world
         std::vector<PhysicsBody*> m_physicsBodies;
 
+        //Bodies of m_physicsBodies that are not static, in the same order, so per update passes skip static bodies
+        std::vector<PhysicsBody*> m_movingBodies;
+
+        //Groups of static bodies in the world, owned by whoever added them
+        std::vector<StaticGroup*> m_staticGroups;
+
+        //Broad phase partitioning bodies by collision layer
+        BroadPhase m_broadPhase;
+
+        //Potentially colliding pairs found by the broad phase this frame
+        std::vector<BroadPhasePair> m_pairs;
+
+        //Run of m_pairs sharing a pair of shapes, with the function that collides them
+        struct PairGroup
+        {
+            size_t first;
+            size_t last;
+            CollisionDetection::PairFunction function;
+        };
+
+        //Groups of m_pairs in order of their shapes, so the narrow phase runs one routine over each group in turn
+        std::vector<PairGroup> m_pairGroups;
+
+        //Pairs being grouped, swapped with m_pairs once grouped
+        std::vector<BroadPhasePair> m_groupedPairs;
+
+        //Collisions of the pair being resolved, compounds give one for each touching pair of children
+        std::vector<Collision*> m_pairCollisions;
+
+        //GJK simplices of the pairs checked last step without a specialised routine, so lasting contacts start
+        //from where they finished
+        SimplexCacheTable m_simplexCaches;
+
+        //Pairs currently overlapping where at least one collider is a trigger, sorted by body ids
+        std::vector<BroadPhasePair> m_triggerOverlaps;
+
+        //Trigger overlaps found this frame, swapped with m_triggerOverlaps after comparing
+        std::vector<BroadPhasePair> m_newTriggerOverlaps;
+
+        //Trigger enter and exit events generated by the last collision update
+        std::vector<TriggerEvent> m_triggerEvents;
+
+        //Dynamic bodies whose fat boxes reach beyond a boundary edge, with the edge, sorted by body id
+        std::vector<std::pair<PhysicsBody*, int>> m_boundaryCandidates;
+
+        //Boxes of dynamic bodies for the batched boundary pass, with the bodies in the same order
+        BoundaryBatch m_boundaryBatch;
+        std::vector<DynamicBody*> m_boundaryBodies;
+
+        //Edge contact reused by every boundary check, so its contact points are allocated once
+        Collision m_edgeCollision;
+
+        //Bodies the boundary deletes this update, sorted by id
+        std::vector<PhysicsBody*> m_deletedBodies;
+
+        //Deletes bodies that moved beyond the boundary
+        //Collidable edges are solved with the other contacts in updateCollisions, unless collisions are off
+        void updateBoundary();
+
+        //Checks every dynamic body against the boundary in one batched pass over their packed AABBs
+        //Used when collisions are not processed, so the broad phase is not refit and no solver runs
+        void enforceBoundaryBatch();
+
+        //Queries the broad phase with the region beyond every edge to find the boundary candidates
+        void findBoundaryCandidates();
+
+        //Resolves collisions between the boundary candidates and the edges they cross
+        void resolveBoundaryCollisions();
+
+        //Finds trigger overlaps among the broad phase pairs and emits enter and exit events
+        void updateTriggers();
+
+        //Casts a normalized ray through the broad phase, keeping the closest hit
+        bool castClosestRay(const Vector2& origin,
+            const Vector2& direction,
+            float maxDistance,
+            const QueryFilter& filter,
+            RayHit& hit) const;
+
+        //Adds a body that already has its id, keeping the body lists in id order
+        void insertBody(PhysicsBody* body);
+
+        //Moves the next id past a body id, without handing out an id queueAddBody reserved meanwhile
+        void raiseNextBodyId(unsigned int id);
+
+        //Deletes a body and forgets everything the world tracked about it, without recording the removal
+        void eraseBody(std::vector<PhysicsBody*>::iterator it);
+
+        //Forgets trigger overlaps and pending events involving bodies sorted by id
+        void forgetTriggerState(const std::vector<PhysicsBody*>& bodies);
+
+        //Deletes many bodies and forgets everything the world tracked about them, in one pass over the body list
+        //The bodies must be sorted by id, the removals are not recorded
+        void eraseBodies(const std::vector<PhysicsBody*>& bodies);
+
+        //Deletes every body and forgets all pairs and trigger state
+        void clearBodies();
+
+        //Attaches a group whose bodies have their ids to the broad phase and records it
+        void attachStaticGroup(StaticGroup* group);
+
+        //Applies the commands queued before the update started, in the order they were queued
+        void applyCommands();
+
+        //Applies one queued command
+        void applyCommand(const WorldCommand& command);
+
+        //Keeps only pairs whose tight AABBs overlap and orders them by body ids
+        //Fat boxes depend on how bodies moved in the past, so they must not decide which pairs are solved
+        void makePairsDeterministic();
+
+        //Sorts pairs by the shapes of their colliders and finds the groups sharing a pair of shapes
+        //The sort is stable, so pairs keep their order within a group
+        void groupPairsByShape();
+
       public:
         //Constructor to set world boundary dimensions
         PhysicsWorld(const Vector2& boundaryDimensions);
@@ -59,17 +243,103 @@ namespace phys
         //Sets the type of the world boundaries
         void setBoundaryType(BoundaryType newType);
 
+        //Sets the point the simulation is centered on, like the camera or the player, relative to the origin
+        void setFocus(const Vector2& focus);
+        const Vector2& getFocus() const;
+
+        //Sets how far the focus may get from the origin before the origin is moved near it at the start of an update
+        //Positions near the origin are the most precise, so contacts around the focus stay accurate in large worlds
+        //The origin moves by whole regions of the region index, pass 0 to never move it
+        void setRebaseDistance(float distance);
+
+        //Moves the origin of the world by shift, moving every body and the focus by -shift
+        //The origin plus a body's position, its absolute position, stays the same
+        //Returns false and does nothing unless the boundary type is None, since a boundary is centered on the origin
+        bool rebaseOrigin(const Vector2& shift);
+
+        //Returns the position of the origin in double precision
+        double getOriginX() const;
+        double getOriginY() const;
+
+        //Returns the index of regions occupied by bodies, empty unless the boundary type is None
+        //The index is refiled here rather than every update, so worlds that never ask for it pay nothing
+        const RegionIndex& getRegionIndex();
+
+        //Sets the side length of the regions in the region index, which is rebuilt when next asked for
+        void setRegionSize(float regionSize);
+
         //Adds a physics body to the world
         void addBody(PhysicsBody* body);
 
+        //Adds a body that keeps the id it already has, moving the next id past it
+        //Used to restore recorded bodies, the id must not belong to any other body in the world
+        void restoreBody(PhysicsBody* body);
+
         //Removes a physics body from the world
         void removeBody(PhysicsBody* body);
 
+        //Adds a group of static bodies whose broad phase trees were built ahead of time, without inserting them
+        //The bodies get new ids and take part in collisions and queries, but not in snapshots, render state
+        //or the region index. Recordings log the whole group, so replays attach it again
+        //Returns false if the group is already in the world
+        //The world does not take ownership, remove the group before deleting it
+        bool addStaticGroup(StaticGroup* group);
+
+        //Adds a group of static bodies that keep the ids they already have, moving the next id past them
+        //Used to restore recorded groups, the ids must not belong to any other body in the world
+        bool restoreStaticGroup(StaticGroup* group);
+
+        //Removes a group of static bodies without deleting it, does nothing if it is not in the world
+        void removeStaticGroup(StaticGroup* group);
+
+        //Returns the static groups in the world
+        const std::vector<StaticGroup*>& getStaticGroups() const;
+
+        //Returns the body with the given id, null if it is not in the world
+        PhysicsBody* getBody(unsigned int id) const;
+
+        //Applies a force to a dynamic body, returns false for other body types
+        //Use these instead of the body's own functions so recordings capture the change
+        bool applyForce(PhysicsBody* body, const Vector2& force);
+
+        //Applies an impulse to a dynamic body, changing its velocity at once, returns false for other body types
+        bool applyImpulse(PhysicsBody* body, const Vector2& impulse);
+
+        //Sets the velocity of a dynamic body, returns false for other body types
+        bool setVelocity(PhysicsBody* body, const Vector2& velocity);
+
         //Updates physics bodies in the world, processes physics, and handles collisions
         //Parameter: time since last update call
         //Calls processPhysics and processCollisions functions
         void update(float deltaTime);
 
+        //Runs update on a thread owned by the world and returns a future that is ready once it has finished
+        //Waits for the previous asynchronous step first, so at most one step runs at a time
+        //While a step runs, only queue commands and read the render state, which is exported concurrently
+        std::shared_future<void> stepAsync(float deltaTime);
+
+        //Waits for the last asynchronous step to finish, after which the world may be used directly again
+        void waitForStep();
+
+        //Queue functions can be called from any thread, even while a step runs, and never block
+        //The commands are applied in order at the start of the next update
+
+        //Queues a body to be added, the world takes ownership of it immediately
+        //Returns the id reserved for the body, so commands for it can be queued right after
+        unsigned int queueAddBody(PhysicsBody* body);
+
+        //Queues the removal of the body with the given id
+        void queueRemoveBody(unsigned int id);
+
+        //Queues a force on the dynamic body with the given id
+        void queueForce(unsigned int id, const Vector2& force);
+
+        //Queues an impulse on the dynamic body with the given id
+        void queueImpulse(unsigned int id, const Vector2& impulse);
+
+        //Queues setting the velocity of the dynamic body with the given id
+        void queueVelocity(unsigned int id, const Vector2& velocity);
+
         //Updates physics bodies and applies gravity
         void updatePhysics(float deltaTime);
 
@@ -84,6 +354,66 @@ namespace phys
         //Applies force of gravity on a dynamic body
         void applyGravity(DynamicBody* body) const;
 
+        //Returns the trigger enter and exit events generated by the last update
+        //Events are cleared at the start of every collision update
+        const std::vector<TriggerEvent>& getTriggerEvents() const;
+
+        //Returns every pair currently overlapping where at least one collider is a trigger, sorted by body ids
+        const std::vector<BroadPhasePair>& getTriggerOverlaps() const;
+
+        //Casts a ray and fills hit with the closest body it enters
+        //Returns false if nothing was hit within the ray's max distance
+        bool raycast(const Ray& ray, RayHit& hit, const QueryFilter& filter = QueryFilter()) const;
+
+        //Casts a ray and fills hits with every body it enters, sorted by distance
+        //Returns the number of hits
+        int raycastAll(const Ray& ray, std::vector<RayHit>& hits, const QueryFilter& filter = QueryFilter()) const;
+
+        //Casts many rays at once, results[i] holds the closest hit of rays[i] or a null body if nothing was hit
+        //With a pool, ranges of rays are cast by its workers and the calling thread together, so it may be called
+        //from a task of the same pool. Without one, or for a single range, rays are cast on the calling thread
+        //The world must not be modified meanwhile
+        void raycastBatch(const std::vector<Ray>& rays,
+            std::vector<RayHit>& results,
+            const QueryFilter& filter = QueryFilter(),
+            ThreadPool* pool = nullptr) const;
+
+        //Overlap queries write up to maxResults bodies into the caller's buffer and return how many were written
+        //Without exact, bodies are reported when their AABB overlaps the query shape
+        //With exact, bodies are also tested against their collider shape
+
+        //Finds bodies overlapping a region
+        int queryRegion(const AABB& region,
+            PhysicsBody** results,
+            int maxResults,
+            const QueryFilter& filter = QueryFilter(),
+            bool exact = false) const;
+
+        //Finds bodies under a point
+        int queryPoint(const Vector2& point,
+            PhysicsBody** results,
+            int maxResults,
+            const QueryFilter& filter = QueryFilter(),
+            bool exact = false) const;
+
+        //Finds bodies overlapping a circle
+        int queryCircle(const Vector2& center,
+            float radius,
+            PhysicsBody** results,
+            int maxResults,
+            const QueryFilter& filter = QueryFilter(),
+            bool exact = false) const;
+
+        //Sweeps a collider from its current position along a displacement and fills hit with the first body touched
+        //The collider's own parent body is ignored, returns false if the whole displacement is free
+        bool shapeCast(const Collider* shape,
+            const Vector2& displacement,
+            ShapeCastHit& hit,
+            const QueryFilter& filter = QueryFilter()) const;
+
+        //Sweeps a body's collider along a displacement, only hitting bodies on layers the collider masks
+        bool shapeCast(const PhysicsBody* body, const Vector2& displacement, ShapeCastHit& hit) const;
+
         //Return true if given physics bodies are colliding
         //Must be called in between processPhysics and processCollisions
         bool checkIfColliding(PhysicsBody* bodyA, PhysicsBody* bodyB);
@@ -102,12 +432,62 @@ namespace phys
         //Parameter: true to enable, false to disable
         void setRotationalPhysics(bool rotationalPhysics);
 
+        //Enables or disables deterministic mode
+        //Pairs are solved in body id order, so results do not depend on broad phase history,
+        //and the state hash is updated after every update
+        //Parameter: true to enable, false to disable
+        void setDeterministic(bool deterministic);
+
+        //Returns a 64 bit hash of the id, position, rotation and velocities of every body
+        //Equal worlds produce equal hashes, compare them to detect divergence between runs
+        uint64_t calculateStateHash() const;
+
+        //Returns the state hash calculated at the end of the last update in deterministic mode
+        uint64_t getStateHash() const;
+
         //Sets the gravity scale of the world
         //Parameter: a non-negative scale factor
         void setGravityScale(float newScaleValue);
 
+        //Writes the whole world state into a binary snapshot, replacing the buffer's contents
+        void writeSnapshot(std::vector<unsigned char>& buffer) const;
+
+        //Replaces the world state with a snapshot held in memory
+        //The data must be 8 byte aligned, returns false and leaves the world untouched if it is invalid
+        bool readSnapshot(const void* data, size_t size);
+
+        //Saves the world state to a snapshot file, returns false if the file could not be written
+        bool saveSnapshot(const std::string& path) const;
+
+        //Replaces the world state with a snapshot file, memory mapping it where supported
+        //Returns false and leaves the world untouched if the file is missing or invalid
+        bool loadSnapshot(const std::string& path);
+
+        //Sets the recorder that logs bodies added and removed, forces, velocities and updates
+        //Called by WorldRecorder, pass null to stop recording
+        void setRecorder(WorldRecorder* recorder);
+
+        //Enables or disables writing the render state after every update
+        //Parameter: true to enable, false to disable
+        void setRenderStateExport(bool exportRenderState);
+
+        //Enables or disables reading the render state from another thread while the world updates
+        //Must not be called while the render state is being acquired
+        //Parameter: true to enable, false to disable
+        void setRenderStateConcurrent(bool concurrent);
+
+        //Writes the transform and extents of every body into instances in one pass, in id order
+        void writeRenderState(std::vector<RenderInstance>& instances) const;
+
+        //Returns the render state published by the newest update, valid until the next acquire
+        //With concurrent render state, one other thread may call this while the world updates
+        const std::vector<RenderInstance>& acquireRenderState();
+
         //Returns the vector of physics bodies in the world
         const std::vector<PhysicsBody*>& getBodies() const;
+
+        //Returns the broad phase of the world
+        const BroadPhase& getBroadPhase() const;
     };
 }
 
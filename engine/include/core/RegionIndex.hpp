@@ -0,0 +1,81 @@
+//Class defenition for a sparse spatial hash of the regions bodies occupy
+//The plane is split into square regions and only regions holding at least one body are stored,
+//so memory and update cost follow the occupied area instead of the extent of the world
+
+#ifndef REGION_INDEX_HPP
+#define REGION_INDEX_HPP
+
+#include "collisions/AABB.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace phys
+{
+    class PhysicsBody;
+
+    //Square area of the plane and the bodies whose centers lie in it
+    struct Region
+    {
+        //Coordinates of the region in region units, region (0, 0) starts at the origin
+        int x;
+        int y;
+
+        //Bodies filed under the region, in no particular order
+        std::vector<PhysicsBody*> bodies;
+    };
+
+    class RegionIndex
+    {
+      private:
+        //Side length of a region in meters
+        float m_regionSize;
+
+        //Occupied regions by key
+        std::unordered_map<uint64_t, Region> m_regions;
+
+        //Key of the region each body is filed under
+        std::unordered_map<const PhysicsBody*, uint64_t> m_bodyRegions;
+
+        //Packs region coordinates into a key
+        static uint64_t makeKey(int x, int y);
+
+        //Takes a body out of a region, dropping the region once it is empty
+        void detach(const PhysicsBody* body, uint64_t key);
+
+      public:
+        //Constructor to set the side length of a region
+        RegionIndex(float regionSize = 64.0f);
+
+        //Files every body under the region its center lies in, moving only bodies that changed region
+        void update(const std::vector<PhysicsBody*>& bodies);
+
+        //Removes a body from the index, does nothing if it is not filed
+        void removeBody(const PhysicsBody* body);
+
+        //Removes every body and region
+        void clear();
+
+        //Moves every region by whole regions, call after the positions of all bodies were shifted by the same amount
+        void shift(int regionsX, int regionsY);
+
+        //Returns the coordinates of the region holding a point
+        void getRegionCoordinates(const Vector2& point, int& x, int& y) const;
+
+        //Returns the occupied region at the coordinates, null if no body is in it
+        const Region* getRegion(int x, int y) const;
+
+        //Fills regions with the occupied regions overlapping an area and returns how many were found
+        //Bodies are filed by their centers, pad the area by the largest body extent to find bodies reaching into it
+        int queryRegions(const AABB& area, std::vector<const Region*>& regions) const;
+
+        //Changes the side length of a region, clearing the index
+        void setRegionSize(float regionSize);
+        float getRegionSize() const;
+
+        //Returns the number of occupied regions
+        size_t getRegionCount() const;
+    };
+}
+
+#endif
@@ -0,0 +1,83 @@
+//Class defenition for packed render state published by a physics world
+//The world writes one instance per body in a single linear pass after each update
+//Renderers can upload the instances directly as an instance buffer
+
+#ifndef RENDER_BUFFER_HPP
+#define RENDER_BUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace phys
+{
+    //Transform and shape of one body, tightly packed for uploading
+    struct RenderInstance
+    {
+        //Id of the body in its world
+        uint32_t id;
+
+        //ColliderShape and BodyType of the body
+        uint16_t shape;
+        uint16_t bodyType;
+
+        float positionX;
+        float positionY;
+
+        //Rotation in radians
+        float rotation;
+
+        //Half width and half height of rectangles, the radius in both for circles and the bounding radius for polygons,
+        //compounds and chains
+        //Radius and half height for capsules, half width and height of the grid for tile maps, placed at its center
+        float extentX;
+        float extentY;
+    };
+
+    class RenderBuffer
+    {
+      private:
+        //One slot each for the writer, the reader, and handing over between them
+        static const int SLOT_COUNT = 3;
+
+        //Set on the shared slot when it holds instances the reader has not taken yet
+        static const int FRESH = 1 << 2;
+
+        //Instance lists, only slot 0 is used when not concurrent
+        std::vector<RenderInstance> m_slots[SLOT_COUNT];
+
+        //Slot owned by the writer
+        int m_writeSlot;
+
+        //Slot owned by the reader
+        int m_readSlot;
+
+        //Slot handed between writer and reader, with the FRESH flag
+        std::atomic<int> m_sharedSlot;
+
+        //Whether a reader on another thread takes instances while the world writes new ones
+        bool m_concurrent;
+
+      public:
+        //Constructor to create an empty, non concurrent buffer
+        RenderBuffer();
+
+        //Enables or disables concurrent reading, clears all slots
+        //Must not be called while another thread is acquiring
+        //Parameter: true when the reader runs on a different thread than the world update
+        void setConcurrent(bool concurrent);
+        bool isConcurrent() const;
+
+        //Returns the list to fill with the next instances, only the world calls this
+        std::vector<RenderInstance>& getWriteSlot();
+
+        //Makes the written instances available to the reader
+        void publish();
+
+        //Returns the newest published instances, stays valid until the next acquire
+        //Only one thread may acquire at a time
+        const std::vector<RenderInstance>& acquire();
+    };
+}
+
+#endif
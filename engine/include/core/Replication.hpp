@@ -0,0 +1,113 @@
+//Shared defenitions for replicating physics world state over a network
+//Body state is quantized to fixed precision and sent as deltas against a state the receiver acknowledged
+//Packets are byte aligned: varints for counts and ids, zigzag varints for signed deltas
+
+#ifndef REPLICATION_HPP
+#define REPLICATION_HPP
+
+#include "core/Vector2.hpp"
+#include "collisions/Collider.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace phys
+{
+    //Precision of replicated values, encoder and decoder must use the same settings
+    struct ReplicationSettings
+    {
+        //Smallest position change in meters that is replicated
+        float positionPrecision = 0.001f;
+
+        //Smallest rotation change in radians that is replicated
+        float rotationPrecision = 0.0001f;
+
+        //Smallest velocity change in meters per second and radians per second that is replicated
+        float velocityPrecision = 0.001f;
+
+        //Number of past states kept as possible baselines
+        int historySize = 32;
+    };
+
+    //Dequantized state of a replicated body
+    struct ReplicatedBody
+    {
+        unsigned int id;
+        ColliderShape shape;
+
+        //Width and height of rectangles, radius in x for circles and the bounding radius in x for polygons,
+        //compounds and chains, radius and full height of capsules, width and height of the grid for tile maps
+        Vector2 extents;
+
+        Vector2 position;
+        float rotation;
+        Vector2 velocity;
+        float angularVelocity;
+    };
+
+    namespace Replication
+    {
+        //Bits of a body entry's mask, each set bit is followed by its value in this order
+        const uint8_t POSITION_X = 1 << 0;
+        const uint8_t POSITION_Y = 1 << 1;
+        const uint8_t ROTATION = 1 << 2;
+        const uint8_t VELOCITY_X = 1 << 3;
+        const uint8_t VELOCITY_Y = 1 << 4;
+        const uint8_t ANGULAR_VELOCITY = 1 << 5;
+
+        //Shape and extents follow, set for new bodies and when the extents change
+        const uint8_t SHAPE = 1 << 6;
+
+        //Body no longer exists, nothing follows
+        const uint8_t REMOVED = 1 << 7;
+
+        //Number of quantized values per body
+        const int VALUE_COUNT = 6;
+
+        //Quantized values are clamped so deltas between any two of them fit in 32 bits
+        const int32_t MAX_QUANTIZED = 1073741823;
+
+        //Quantized state of a body as it was sent or received
+        struct QuantizedBody
+        {
+            unsigned int id;
+            uint8_t shape;
+            float extentX;
+            float extentY;
+
+            //Position x and y, rotation, velocity x and y, angular velocity
+            int32_t values[VALUE_COUNT];
+        };
+
+        //Quantized state of the whole world tagged with the sequence of the packet that carried it
+        struct QuantizedState
+        {
+            uint32_t sequence;
+            std::vector<QuantizedBody> bodies;
+        };
+
+        //Converts a value to a whole number of precision steps
+        int32_t quantize(float value, float precision);
+
+        //Converts a whole number of precision steps back to a value
+        float dequantize(int32_t value, float precision);
+
+        //Returns the rotation wrapped into [-pi, pi) so spinning bodies keep small values
+        float wrapAngle(float radians);
+
+        //Appends an unsigned varint, 7 bits per byte with the high bit marking continuation
+        void writeVarint(std::vector<unsigned char>& buffer, uint32_t value);
+
+        //Appends a signed value zigzag encoded so small magnitudes stay short
+        void writeZigzag(std::vector<unsigned char>& buffer, int32_t value);
+
+        //Appends the raw bytes of a float
+        void writeFloat(std::vector<unsigned char>& buffer, float value);
+
+        //Readers advance the cursor and return false if the data ends or the value is malformed
+        bool readVarint(const unsigned char* data, int size, int& cursor, uint32_t& value);
+        bool readZigzag(const unsigned char* data, int size, int& cursor, int32_t& value);
+        bool readFloat(const unsigned char* data, int size, int& cursor, float& value);
+    }
+}
+
+#endif
@@ -0,0 +1,42 @@
+//Class defenition for decoding physics world state written by a ReplicationEncoder
+//Keeps recent decoded states so packets encoded against any of them can be applied
+
+#ifndef REPLICATION_DECODER_HPP
+#define REPLICATION_DECODER_HPP
+
+#include "core/Replication.hpp"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace phys
+{
+    class ReplicationDecoder
+    {
+      private:
+        //Precision of replicated values
+        ReplicationSettings m_settings;
+
+        //Recently decoded states, oldest first
+        std::deque<Replication::QuantizedState> m_history;
+
+        //Dequantized bodies of the newest state, sorted by id
+        std::vector<ReplicatedBody> m_bodies;
+
+      public:
+        //Constructor to set the precision of replicated values, must match the encoder
+        ReplicationDecoder(const ReplicationSettings& settings = ReplicationSettings());
+
+        //Applies a packet on top of the state it was encoded against
+        //Returns false if the packet is malformed, older than the newest state, or its baseline is no longer known
+        bool decode(const unsigned char* data, int size);
+
+        //Returns the sequence of the newest decoded packet, send it back to the encoder as an acknowledgement
+        uint32_t getSequence() const;
+
+        //Returns the bodies of the newest decoded state, sorted by id
+        const std::vector<ReplicatedBody>& getBodies() const;
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+//Class defenition for encoding physics world state for one network receiver
+//Each packet holds only the bodies whose quantized state differs from the last state the receiver acknowledged
+
+#ifndef REPLICATION_ENCODER_HPP
+#define REPLICATION_ENCODER_HPP
+
+#include "core/Replication.hpp"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace phys
+{
+    class PhysicsWorld;
+
+    class ReplicationEncoder
+    {
+      private:
+        //Precision of replicated values
+        ReplicationSettings m_settings;
+
+        //States sent but not yet superseded by an acknowledgement, oldest first
+        std::deque<Replication::QuantizedState> m_history;
+
+        //Sequence of the last packet written
+        uint32_t m_sequence;
+
+        //Sequence of the newest state the receiver acknowledged, 0 if none
+        uint32_t m_acknowledged;
+
+        //Packet under construction
+        std::vector<unsigned char> m_packet;
+
+        //Entries of the packet under construction
+        std::vector<unsigned char> m_entries;
+
+        //Quantizes every body in the world, in id order
+        void captureState(const PhysicsWorld& world, std::vector<Replication::QuantizedBody>& bodies) const;
+
+      public:
+        //Constructor to set the precision of replicated values
+        ReplicationEncoder(const ReplicationSettings& settings = ReplicationSettings());
+
+        //Writes a packet with the world's changes since the acknowledged state into the buffer
+        //Returns the number of bytes written, or -1 if the packet does not fit in the capacity
+        int encode(const PhysicsWorld& world, unsigned char* buffer, int capacity);
+
+        //Marks a packet as received, later packets are encoded against its state
+        void acknowledge(uint32_t sequence);
+
+        //Returns the sequence of the last packet written
+        uint32_t getSequence() const;
+
+        //Returns the sequence of the newest acknowledged packet, 0 if none
+        uint32_t getAcknowledged() const;
+    };
+}
+
+#endif
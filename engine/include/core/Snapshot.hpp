@@ -0,0 +1,171 @@
+//Binary snapshot format for saving and restoring physics worlds
+//The file is a flat little endian image: a header, an array of fixed size body records, a layer table,
+//then a shape table for colliders described by more than a few numbers
+//Every section is 8 byte aligned so a memory mapped file can be read in place without parsing
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "physics/PhysicsBody.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace phys
+{
+    namespace Snapshot
+    {
+        //Identifies snapshot files, "PWSN" read as a little endian integer
+        const uint32_t MAGIC = 0x4E535750;
+
+        //Bumped whenever the layout changes, older versions are rejected
+        const uint32_t VERSION = 4;
+
+        //First bytes of every snapshot
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+
+            //Total size of the snapshot in bytes
+            uint64_t size;
+
+            //Byte offsets and element counts of the body records, layer table and shape table
+            uint64_t bodiesOffset;
+            uint64_t layersOffset;
+            uint64_t shapesOffset;
+            uint32_t bodyCount;
+            uint32_t layerCount;
+            uint32_t shapeCount;
+
+            //World settings
+            float gravityScale;
+            float boundaryWidth;
+            float boundaryHeight;
+            uint32_t boundaryType;
+            uint8_t processPhysics;
+            uint8_t processCollisions;
+            uint8_t rotationalPhysics;
+            uint8_t deterministic;
+
+            //Id given to the next body added to the world
+            uint32_t nextBodyId;
+
+            //Position of the world origin, body positions are relative to it
+            double originX;
+            double originY;
+        };
+
+        //Complete state of one body and its collider
+        struct BodyRecord
+        {
+            uint8_t bodyType;
+            uint8_t colliderShape;
+            uint8_t colliderType;
+            uint8_t affectedByGravity;
+
+            //Id of the body in its world
+            uint32_t id;
+
+            float positionX;
+            float positionY;
+            float rotation;
+
+            //Dynamic body state, zero for static bodies
+            float velocityX;
+            float velocityY;
+            float angularVelocity;
+            float forceX;
+            float forceY;
+            float accelerationX;
+            float accelerationY;
+            float restitution;
+            float mass;
+
+            //Width and height of rectangles, radius in dimensionX for circles, radius and height for capsules
+            //1 in dimensionX for chains that loop, columns and rows for tile maps
+            float dimensionX;
+            float dimensionY;
+
+            float offsetX;
+            float offsetY;
+
+            //Index of the collider's layers in the layer table, its masks follow directly after
+            uint32_t layersIndex;
+            uint16_t layerCount;
+            uint16_t maskCount;
+
+            //Index and count of the collider's floats in the shape table, the x and y of each point for polygons
+            //and chains
+            //For compounds the child count, then for each child its shape, offset x and y, rotation,
+            //dimensions x and y, point float count and points, with the offsets and rotations as given to the compound
+            //For tile maps the tile size, 1 if tiles are merged, then the tiles row by row from the bottom,
+            //16 to a float with the first tile in the lowest bit
+            uint32_t shapeIndex;
+            uint32_t shapeCount;
+        };
+
+        static_assert(sizeof(Header) % 8 == 0, "Snapshot header must keep the following sections aligned");
+        static_assert(sizeof(BodyRecord) % 4 == 0, "Snapshot body records must stay 4 byte aligned");
+
+        //Returns true if the host stores integers and floats little endian, the only layout snapshots use
+        bool isHostLittleEndian();
+
+        //Fills a record from a body, appending its layers and masks to the layer table and its shape to the shape table
+        void writeBody(const PhysicsBody* body,
+            BodyRecord& record,
+            std::vector<uint32_t>& layerTable,
+            std::vector<float>& shapeTable);
+
+        //Allocates a body from a record with the record's id, the caller owns the returned body
+        //Returns null if the record holds an unknown body type or shape, or indexes beyond a table
+        PhysicsBody* createBody(const BodyRecord& record,
+            const uint32_t* layerTable,
+            uint32_t layerTableSize,
+            const float* shapeTable,
+            uint32_t shapeTableSize);
+
+        //Writes bodies into a snapshot, replacing the buffer's contents
+        //The world settings and origin must already be set in the header, the rest of it is filled in here
+        void write(const std::vector<PhysicsBody*>& bodies, Header& header, std::vector<unsigned char>& buffer);
+
+        //Checks the header and section bounds of a snapshot held in memory
+        //Returns the header, or null if the data is not a valid snapshot of this version
+        const Header* validate(const void* data, size_t size);
+
+        //Read only view of a whole file, memory mapped where the platform supports it
+        class MappedFile
+        {
+          private:
+            //Start and size of the file contents
+            const unsigned char* m_data;
+            size_t m_size;
+
+            //Fallback storage when the file could not be mapped
+            std::vector<unsigned char> m_buffer;
+
+            //Whether m_data points at a mapping that must be unmapped
+            bool m_mapped;
+
+          public:
+            //Constructor to map a file, check isOpen for success
+            MappedFile(const std::string& path);
+
+            //Destructor to release the mapping
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            //Returns true if the file was opened
+            bool isOpen() const;
+
+            //Getters for the file contents
+            const unsigned char* getData() const;
+            size_t getSize() const;
+        };
+    }
+}
+
+#endif
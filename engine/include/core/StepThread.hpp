@@ -0,0 +1,57 @@
+//Class defenition for the background thread a physics world steps on
+//Runs one task at a time and hands back a future that becomes ready once the task has finished
+
+#ifndef STEP_THREAD_HPP
+#define STEP_THREAD_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace phys
+{
+    class StepThread
+    {
+      private:
+        //Guards the pending task and the stop flag
+        std::mutex m_mutex;
+
+        //Wakes the thread when a task is submitted or the thread should stop
+        std::condition_variable m_condition;
+
+        //Task waiting to run, invalid while the thread is idle or running
+        std::packaged_task<void()> m_task;
+
+        //Completion of the last submitted task
+        std::shared_future<void> m_lastTask;
+
+        //Set by the destructor to end the thread
+        bool m_stopping;
+
+        //Thread running the tasks, started last so it sees the other members initialized
+        std::thread m_thread;
+
+        //Waits for tasks and runs them until stopped
+        void run();
+
+      public:
+        //Constructor to start the thread
+        StepThread();
+
+        //Destructor to finish the running task and join the thread
+        ~StepThread();
+
+        StepThread(const StepThread&) = delete;
+        StepThread& operator=(const StepThread&) = delete;
+
+        //Runs a task on the thread, first waiting for the previous one so tasks never overlap
+        std::shared_future<void> submit(std::function<void()> task);
+
+        //Waits for the last submitted task to finish, returns immediately if nothing was submitted
+        void wait();
+    };
+}
+
+#endif
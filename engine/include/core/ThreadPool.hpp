@@ -0,0 +1,82 @@
+//Class defenition for a work stealing thread pool
+//Every worker has its own task queue, workers that run out of tasks steal from the others
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace phys
+{
+    class ThreadPool
+    {
+      private:
+        //Task queue of one worker, the owner takes from the back and thieves from the front
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        //One queue per worker
+        std::vector<WorkerQueue*> m_queues;
+
+        //Worker threads
+        std::vector<std::thread> m_threads;
+
+        //Guards the counters and the stop flag
+        std::mutex m_mutex;
+
+        //Wakes workers when tasks are submitted or the pool stops
+        std::condition_variable m_wake;
+
+        //Wakes threads waiting for all tasks to finish
+        std::condition_variable m_idle;
+
+        //Tasks queued that no worker has claimed yet
+        int m_unclaimed;
+
+        //Tasks submitted that have not finished yet
+        int m_unfinished;
+
+        //Counts submissions to pick the queue of the next task
+        std::atomic<size_t> m_nextQueue;
+
+        //Set by the destructor to end the workers
+        bool m_stopping;
+
+        //Claims tasks and runs them until the pool stops
+        void run(size_t index);
+
+        //Takes a task from the worker's own queue, or steals one from another queue
+        bool takeTask(size_t index, std::function<void()>& task);
+
+      public:
+        //Constructor to start the workers
+        //Parameter: number of worker threads, the hardware thread count if zero or less
+        ThreadPool(int threadCount = 0);
+
+        //Destructor to finish all submitted tasks and join the workers
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        //Queues a task to run on any worker, safe to call from any thread including tasks
+        void submit(std::function<void()> task);
+
+        //Waits until every submitted task has finished
+        void wait();
+
+        //Returns the number of worker threads
+        int getThreadCount() const;
+    };
+}
+
+#endif
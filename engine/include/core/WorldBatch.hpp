@@ -0,0 +1,61 @@
+//Class defenition for stepping many independent physics worlds in parallel
+//Worlds are grouped into tasks by body count so small worlds share a task, and the tasks run on a work stealing pool
+
+#ifndef WORLD_BATCH_HPP
+#define WORLD_BATCH_HPP
+
+#include "core/ThreadPool.hpp"
+#include <vector>
+
+namespace phys
+{
+    class PhysicsWorld;
+
+    class WorldBatch
+    {
+      private:
+        //Tasks aim for at least this many bodies, so scheduling costs little next to stepping
+        static const size_t MIN_TASK_BODIES = 512;
+
+        //Tasks per worker thread when there are enough bodies, leaves room for stealing to even out the end
+        static const size_t TASKS_PER_THREAD = 4;
+
+        //Worlds stepped by the batch, not owned
+        std::vector<PhysicsWorld*> m_worlds;
+
+        //Seconds the last step of each world took, in the same order as the worlds
+        std::vector<float> m_stepTimes;
+
+        //World indices sorted from most to fewest bodies, reused between steps
+        std::vector<size_t> m_order;
+
+        //Threads stepping the worlds
+        ThreadPool m_pool;
+
+      public:
+        //Constructor to create an empty batch
+        //Parameter: number of threads, the hardware thread count if zero or less
+        WorldBatch(int threadCount = 0);
+
+        //Adds a world to be stepped with the batch, the batch does not take ownership
+        void addWorld(PhysicsWorld* world);
+
+        //Removes a world from the batch without deleting it
+        void removeWorld(PhysicsWorld* world);
+
+        //Updates every world once and waits until all have finished
+        //Worlds must not be used from other threads meanwhile
+        void step(float deltaTime);
+
+        //Returns the worlds in the batch
+        const std::vector<PhysicsWorld*>& getWorlds() const;
+
+        //Returns the seconds each world's last step took, indexed like getWorlds
+        const std::vector<float>& getStepTimes() const;
+
+        //Returns the index of the world whose last step took longest, -1 if the batch is empty
+        int getSlowestWorld() const;
+    };
+}
+
+#endif
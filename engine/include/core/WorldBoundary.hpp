@@ -1,21 +1,52 @@
 //Class defenition for world boundary to keep physics bodies within constraints
+//Each edge of the boundary is a static body lying outside the world, like a half plane
+//Only bodies the broad phase finds beyond an edge are checked against it
 
 #ifndef WORLD_BOUNDARY_HPP
 #define WORLD_BOUNDARY_HPP
 
 #include "physics/StaticBody.hpp"
 #include "physics/DynamicBody.hpp"
+#include "collisions/AABB.hpp"
+#include "collisions/Collision.hpp"
+#include <vector>
 
 namespace phys
 {
     enum class BoundaryType
     {
         Collidable,
-        Delete
+        Delete,
+
+        //No boundary, bodies may go anywhere and the world keeps a region index of where they are
+        None
+    };
+
+    //Boxes checked against the boundary in one pass, stored as separate arrays so they can be processed in batches
+    struct BoundaryBatch
+    {
+        std::vector<float> minX;
+        std::vector<float> minY;
+        std::vector<float> maxX;
+        std::vector<float> maxY;
+
+        //Move that brings each box back inside the boundary, zero if it already is
+        std::vector<float> correctionX;
+        std::vector<float> correctionY;
+
+        //1 if the box lies entirely outside the boundary, 0 otherwise
+        std::vector<unsigned char> beyond;
+
+        //Resizes every array to hold count boxes
+        void resize(size_t count);
     };
 
     class WorldBoundary
     {
+      public:
+        //Number of edges, in the order left, right, bottom, top
+        static const int EDGE_COUNT = 4;
+
       private:
         //Minimum boundaries for world
         const float MIN_WORLD_WIDTH = 5.0f;
@@ -32,22 +63,51 @@ namespace phys
         //Objects collide with it, or get deleted when beyond boundary
         BoundaryType m_type;
 
+        //Static bodies standing in for the edges, the solver resolves edge collisions against them
+        StaticBody* m_edges[EDGE_COUNT];
+
+        //Moves and resizes the edge bodies to fit around the world
+        void placeEdges();
+
       public:
         //Constructor to set world width and height and the type of boundary
         WorldBoundary(const Vector2& dimensions, BoundaryType boundaryType);
 
+        //Destructor to delete the edge bodies
+        ~WorldBoundary();
+
+        WorldBoundary(const WorldBoundary&) = delete;
+        WorldBoundary& operator=(const WorldBoundary&) = delete;
+
         //Keeps a body within boundaries when placed or moved
         bool placementEnforce(PhysicsBody* body) const;
 
-        //Keeps a dynamic body within boundaries every frame
-        bool dynamicEnforce(DynamicBody* body) const;
-
         //Checks if a body is on the boundary floor
         bool checkIfOnFloor(const PhysicsBody* body) const;
 
+        //Returns the region beyond an edge, reaching far enough to hold anything that left the world through it
+        //Query the broad phase with it to find the only bodies that can collide with the edge
+        AABB getEdgeRegion(int edge) const;
+
+        //Returns true if the body's AABB lies entirely beyond an edge
+        bool isBeyondEdge(const PhysicsBody* body, int edge) const;
+
+        //Fills collision with the contact between a body and an edge, returns false if the body does not cross it
+        //The body's AABB accounts for its rotation, so rotated rectangles are pushed back by their corners
+        //Nothing is allocated once the collision's contact points have room for two
+        bool checkEdgeCollision(PhysicsBody* body, int edge, Collision& collision) const;
+
+        //Fills the corrections and beyond flags of every box in the batch
+        //Uses SSE2 four boxes at a time where available, with a scalar loop for the rest
+        void enforceBatch(BoundaryBatch& batch) const;
+
+        //Returns the static body standing in for an edge
+        StaticBody* getEdge(int edge) const;
+
         //Getters for member variables
         float getWidth() const;
         float getHeight() const;
+        BoundaryType getType() const;
 
         //Set new world boundary dimensions
         void setDimensions(Vector2& newDimensions);
@@ -0,0 +1,38 @@
+//Struct defenition for mutations queued on a physics world
+//Commands can be queued from any thread and are applied at the start of the next update
+
+#ifndef WORLD_COMMAND_HPP
+#define WORLD_COMMAND_HPP
+
+#include "core/Vector2.hpp"
+#include <cstdint>
+
+namespace phys
+{
+    class PhysicsBody;
+
+    enum class WorldCommandType : uint8_t
+    {
+        AddBody,
+        RemoveBody,
+        ApplyForce,
+        ApplyImpulse,
+        SetVelocity
+    };
+
+    struct WorldCommand
+    {
+        WorldCommandType type;
+
+        //Body to add, the world owns it once the command is queued
+        PhysicsBody* body;
+
+        //Id of the body to remove or change, bodies that are gone by then are skipped
+        unsigned int bodyId;
+
+        //Force, impulse or velocity
+        Vector2 value;
+    };
+}
+
+#endif
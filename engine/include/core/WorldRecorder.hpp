@@ -0,0 +1,125 @@
+//Class defenition for recording physics world sessions
+//A recording is an append only log: a snapshot of the world followed by every external mutation in order
+//Recordings are replayed frame by frame with a WorldReplayer
+
+#ifndef WORLD_RECORDER_HPP
+#define WORLD_RECORDER_HPP
+
+#include "core/Vector2.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace phys
+{
+    class PhysicsWorld;
+    class PhysicsBody;
+    class StaticGroup;
+
+    //Identifies recording files, "PWRL" read as a little endian integer
+    const uint32_t RECORDING_MAGIC = 0x4C525750;
+
+    //Bumped whenever the log layout changes
+    const uint32_t RECORDING_VERSION = 3;
+
+    //First bytes of every recording, the world snapshot follows directly after
+    struct RecordingHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+
+        //Size of the snapshot in bytes
+        uint64_t snapshotSize;
+    };
+
+    //Operation codes of the log, each followed by its payload
+    enum class RecordOp : uint8_t
+    {
+        //Snapshot body record, then its layers and masks
+        AddBody = 1,
+
+        //Body id
+        RemoveBody,
+
+        //Body id, force x and y
+        ApplyForce,
+
+        //Body id, velocity x and y
+        SetVelocity,
+
+        //Delta time, state hash after the update
+        Update,
+
+        //Body id, impulse x and y
+        ApplyImpulse,
+
+        //Shift of the origin x and y
+        RebaseOrigin,
+
+        //Body count, then for each body its snapshot body record, layers and masks, and shape
+        AttachGroup,
+
+        //Id of the group's first body
+        DetachGroup
+    };
+
+    class WorldRecorder
+    {
+      private:
+        //Log file being written
+        std::ofstream m_file;
+
+        //World being recorded, null when not recording
+        PhysicsWorld* m_world;
+
+        //Number of updates recorded
+        unsigned int m_frameCount;
+
+        //Appends raw bytes to the log
+        void write(const void* data, size_t size);
+
+        //Appends an operation with a body id
+        void writeOp(RecordOp op, unsigned int bodyId);
+
+        //Appends a body's snapshot record, layers and masks, and shape
+        void writeBody(const PhysicsBody* body);
+
+      public:
+        //Constructor to create a recorder that is not recording
+        WorldRecorder();
+
+        //Destructor to finish the recording
+        ~WorldRecorder();
+
+        WorldRecorder(const WorldRecorder&) = delete;
+        WorldRecorder& operator=(const WorldRecorder&) = delete;
+
+        //Starts recording a world to a new log file, writing its current state as the first entry
+        //Static groups already in the world are logged right after it
+        //Enables deterministic mode on the world so replays match frame for frame
+        //Returns false if the file could not be created
+        bool open(const std::string& path, PhysicsWorld& world);
+
+        //Stops recording and flushes the log
+        void close();
+
+        //Returns true while recording
+        bool isRecording() const;
+
+        //Returns the number of updates recorded
+        unsigned int getFrameCount() const;
+
+        //Called by the world for every external mutation
+        void recordAddBody(const PhysicsBody* body);
+        void recordRemoveBody(const PhysicsBody* body);
+        void recordApplyForce(const PhysicsBody* body, const Vector2& force);
+        void recordApplyImpulse(const PhysicsBody* body, const Vector2& impulse);
+        void recordSetVelocity(const PhysicsBody* body, const Vector2& velocity);
+        void recordRebaseOrigin(const Vector2& shift);
+        void recordAttachGroup(const StaticGroup* group);
+        void recordDetachGroup(const StaticGroup* group);
+        void recordUpdate(float deltaTime, uint64_t stateHash);
+    };
+}
+
+#endif
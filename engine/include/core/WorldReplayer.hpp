@@ -0,0 +1,84 @@
+//Class defenition for replaying recorded physics world sessions
+//Restores the recorded snapshot into a world and reapplies every logged mutation in order
+//Runs headless at full speed, so recordings double as benchmark workloads
+
+#ifndef WORLD_REPLAYER_HPP
+#define WORLD_REPLAYER_HPP
+
+#include "core/Snapshot.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace phys
+{
+    class PhysicsWorld;
+    class PhysicsBody;
+    class StaticGroup;
+
+    class WorldReplayer
+    {
+      private:
+        //Mapped recording, null when no recording is open
+        Snapshot::MappedFile* m_file;
+
+        //Read position of the next operation in the log
+        size_t m_cursor;
+
+        //Number of updates replayed since start
+        unsigned int m_frame;
+
+        //First frame whose state hash differed from the recording, -1 if none has
+        int m_divergedFrame;
+
+        //Static groups attached by the replay, owned by the replayer and attached to m_groupWorld
+        std::vector<StaticGroup*> m_groups;
+        PhysicsWorld* m_groupWorld;
+
+        //Reads bytes at the cursor and advances it, returns false if the log ends first
+        bool read(void* data, size_t size);
+
+        //Reads a body's record, layers and masks, and shape and creates it, returns null if they are invalid
+        PhysicsBody* readBody();
+
+        //Detaches and deletes the static groups attached by the replay
+        void releaseGroups();
+
+      public:
+        //Constructor to create a replayer with no recording
+        WorldReplayer();
+
+        //Destructor to release the recording and the static groups it attached
+        //The world replayed into must still exist, as with a chunk store
+        ~WorldReplayer();
+
+        WorldReplayer(const WorldReplayer&) = delete;
+        WorldReplayer& operator=(const WorldReplayer&) = delete;
+
+        //Opens a recording file, returns false if it is missing or not a recording
+        bool open(const std::string& path);
+
+        //Replaces the world state with the recorded snapshot and rewinds to the first operation
+        //Static groups attached by an earlier replay are detached and deleted first
+        //Returns false if no recording is open or the snapshot is invalid
+        bool start(PhysicsWorld& world);
+
+        //Applies operations up to and including the next update
+        //Returns false once the recording is finished or an operation is invalid
+        bool step(PhysicsWorld& world);
+
+        //Starts the replay and steps through the whole recording, returns the number of frames replayed
+        unsigned int run(PhysicsWorld& world);
+
+        //Returns true once every operation has been applied
+        bool isFinished() const;
+
+        //Returns the number of updates replayed since start
+        unsigned int getFrame() const;
+
+        //Returns the first frame whose state hash differed from the recording, -1 if the replay matched
+        int getDivergedFrame() const;
+    };
+}
+
+#endif
@@ -10,10 +10,10 @@ namespace phys
 {
     namespace CollisionResolution
     {
-        //Resolves a collision with no rotations by sorting it into respective function based on bodies
+        //Resolves a collision with no rotations by looking up the function for its body types in a table
         void resolveBasicCollision(const Collision& collision);
         
-        //Resolves a collision with rotation by sorting it into respective function based on bodies
+        //Resolves a collision with rotation by looking up the function for its body types in a table
         void resolveAdvancedCollision(const Collision& collision);
 
         //Resolve a collision between a dynamic body and a static body, no rotations
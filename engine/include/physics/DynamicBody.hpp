@@ -43,6 +43,9 @@ namespace phys
         //Applies an external force to the body
         void applyForce(const Vector2& force);
 
+        //Applies an impulse to the body, changing its velocity immediately
+        void applyImpulse(const Vector2& impulse);
+
         //Update the physics of the body in the world
         void update(float deltaTime) override;
 
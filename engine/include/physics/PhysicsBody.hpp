@@ -18,6 +18,9 @@ namespace phys
         ControllableBody
     };
 
+    //Number of body types, the size of each side of the tables of per body type pair functions
+    const int BODY_TYPE_COUNT = 3;
+
     class Collider;
 
     class PhysicsBody
@@ -35,6 +38,12 @@ namespace phys
         //Type of the body (static, dynamic...)
         BodyType m_type;
 
+        //Id of the body's proxy in the world broad phase, -1 when not in a world
+        int m_proxyId;
+
+        //Id assigned by the world when the body is added, never reused and saved in snapshots
+        unsigned int m_id;
+
       public:
         //Constructor
         PhysicsBody(const Vector2& position, Collider* collider, BodyType bodyType);
@@ -56,11 +65,15 @@ namespace phys
         float getRotation() const;
         Collider* getCollider() const;
         BodyType getType() const;
+        int getProxyId() const;
+        unsigned int getId() const;
 
         //Setters for member variables
         void setPosition(const Vector2& newPosition);
         void setRotation(float newRotation);
         void setCollider(Collider* newCollider);
+        void setProxyId(int newProxyId);
+        void setId(unsigned int newId);
     };
 }
 
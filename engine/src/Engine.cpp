@@ -23,4 +23,92 @@ namespace phys
     {
         return new DynamicBody(position, new RectCollider(dimensions, ColliderType::Solid));
     }
+
+    StaticBody* createStaticPolygon(const Vector2& position, const std::vector<Vector2>& points)
+    {
+        PolygonCollider* collider = new PolygonCollider(points, ColliderType::Solid);
+        if (collider->getVertexCount() == 0)
+        {
+            delete collider;
+            return nullptr;
+        }
+
+        return new StaticBody(position + collider->getCentroid(), collider);
+    }
+
+    DynamicBody* createDynamicPolygon(const Vector2& position, const std::vector<Vector2>& points)
+    {
+        PolygonCollider* collider = new PolygonCollider(points, ColliderType::Solid);
+        if (collider->getVertexCount() == 0)
+        {
+            delete collider;
+            return nullptr;
+        }
+
+        return new DynamicBody(position + collider->getCentroid(), collider);
+    }
+
+    StaticBody* createStaticCapsule(const Vector2& position, float radius, float height)
+    {
+        return new StaticBody(position, new CapsuleCollider(radius, height, ColliderType::Solid));
+    }
+
+    DynamicBody* createDynamicCapsule(const Vector2& position, float radius, float height)
+    {
+        return new DynamicBody(position, new CapsuleCollider(radius, height, ColliderType::Solid));
+    }
+
+    StaticBody* createStaticCompound(const Vector2& position, CompoundCollider* compound)
+    {
+        if (compound->getChildCount() == 0)
+        {
+            delete compound;
+            return nullptr;
+        }
+
+        return new StaticBody(position + compound->getCentroid(), compound);
+    }
+
+    DynamicBody* createDynamicCompound(const Vector2& position, CompoundCollider* compound)
+    {
+        if (compound->getChildCount() == 0)
+        {
+            delete compound;
+            return nullptr;
+        }
+
+        return new DynamicBody(position + compound->getCentroid(), compound);
+    }
+
+    StaticBody* createStaticChain(const Vector2& position, const std::vector<Vector2>& points, bool loop)
+    {
+        ChainCollider* collider = new ChainCollider(points, loop, ColliderType::Solid);
+        if (collider->getSegmentCount() == 0)
+        {
+            delete collider;
+            return nullptr;
+        }
+
+        return new StaticBody(position, collider);
+    }
+
+    StaticBody* createStaticTileMap(const Vector2& position,
+        int columns,
+        int rows,
+        float tileSize,
+        const std::vector<bool>& tiles,
+        bool merge)
+    {
+        if (columns <= 0 || rows <= 0 || tileSize <= 0.0f)
+            return nullptr;
+
+        TileMapCollider* collider = new TileMapCollider(columns, rows, tileSize, merge, ColliderType::Solid);
+        if (!collider->setTiles(tiles))
+        {
+            delete collider;
+            return nullptr;
+        }
+
+        return new StaticBody(position, collider);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,491 @@
+//Implementation of the layer partitioned broad phase
+
+#include "collisions/BroadPhase.hpp"
+#include "collisions/CollisionDetection.hpp"
+#include "physics/PhysicsBody.hpp"
+#include <algorithm>
+
+namespace phys
+{
+    //Constructor to create an empty broad phase
+    BroadPhase::BroadPhase() : m_builtStatics(0), m_removedStatics(0), m_pendingStatics(0) {}
+
+    //Adds a body to the broad phase and stores the proxy id on the body
+    void BroadPhase::addBody(PhysicsBody* body)
+    {
+        insertLeaves(allocateProxy(body));
+
+        if (body->getType() == BodyType::StaticBody)
+            m_pendingStatics++;
+    }
+
+    //Adds many bodies at once
+    void BroadPhase::addBodies(const std::vector<PhysicsBody*>& bodies)
+    {
+        //Gather the new proxies of every layer so each tree receives them in one call
+        std::map<unsigned int, std::vector<int>> layerProxies;
+        std::vector<int> proxyIds;
+        bool addedStatics = false;
+
+        for (PhysicsBody* body : bodies)
+        {
+            int proxyId = allocateProxy(body);
+
+            //Static bodies go straight into the static trees
+            if (body->getType() == BodyType::StaticBody)
+            {
+                addedStatics = true;
+                continue;
+            }
+
+            proxyIds.push_back(proxyId);
+
+            for (unsigned int layer : body->getCollider()->getCollisionLayers())
+                layerProxies[layer].push_back(proxyId);
+        }
+
+        std::map<unsigned int, std::vector<int>> layerLeaves;
+        std::vector<AABB> fatBoxes;
+        std::vector<PhysicsBody*> leafBodies;
+
+        for (const auto& layerProxy : layerProxies)
+        {
+            const std::vector<int>& proxies = layerProxy.second;
+
+            fatBoxes.resize(proxies.size());
+            leafBodies.resize(proxies.size());
+
+            for (size_t i = 0; i < proxies.size(); i++)
+            {
+                fatBoxes[i] = m_proxies[proxies[i]].fatBox;
+                leafBodies[i] = m_proxies[proxies[i]].body;
+            }
+
+            std::vector<int>& leaves = layerLeaves[layerProxy.first];
+            leaves.resize(proxies.size());
+
+            m_layerTrees[layerProxy.first].createProxies(
+                fatBoxes.data(), leafBodies.data(), static_cast<int>(proxies.size()), leaves.data());
+        }
+
+        //Hand out the leaves in each collider's layer order, proxies appear in the same order in every layer list
+        std::map<unsigned int, size_t> nextLeaf;
+
+        for (int proxyId : proxyIds)
+        {
+            BroadPhaseProxy& proxy = m_proxies[proxyId];
+
+            for (unsigned int layer : proxy.body->getCollider()->getCollisionLayers())
+                proxy.leaves.emplace_back(layer, layerLeaves[layer][nextLeaf[layer]++]);
+        }
+
+        if (addedStatics)
+            rebuildStaticTrees();
+    }
+
+    //Takes a free proxy for a body and stores its id on the body
+    int BroadPhase::allocateProxy(PhysicsBody* body)
+    {
+        int proxyId;
+        if (!m_freeProxies.empty())
+        {
+            proxyId = m_freeProxies.back();
+            m_freeProxies.pop_back();
+        }
+        else
+        {
+            proxyId = static_cast<int>(m_proxies.size());
+            m_proxies.emplace_back();
+        }
+
+        BroadPhaseProxy& proxy = m_proxies[proxyId];
+        proxy.body = body;
+        proxy.fatBox = body->getCollider()->getAABB().getExpanded(AABB_MARGIN);
+        proxy.isStatic = body->getType() == BodyType::StaticBody;
+        proxy.inStaticTree = false;
+        proxy.group = nullptr;
+        proxy.activeIndex = NULL_NODE;
+
+        if (!proxy.isStatic)
+        {
+            proxy.activeIndex = static_cast<int>(m_activeProxies.size());
+            m_activeProxies.push_back(proxyId);
+        }
+
+        body->setProxyId(proxyId);
+
+        return proxyId;
+    }
+
+    //Removes a body from the broad phase
+    void BroadPhase::removeBody(PhysicsBody* body)
+    {
+        int proxyId = body->getProxyId();
+        if (proxyId == NULL_NODE)
+            return;
+
+        removeLeaves(proxyId);
+        freeProxy(proxyId);
+    }
+
+    //Returns a proxy to the free list and clears the proxy id of its body
+    void BroadPhase::freeProxy(int proxyId)
+    {
+        BroadPhaseProxy& proxy = m_proxies[proxyId];
+
+        //Swap the last moving proxy into the freed slot
+        if (proxy.activeIndex != NULL_NODE)
+        {
+            int lastProxy = m_activeProxies.back();
+            m_activeProxies[proxy.activeIndex] = lastProxy;
+            m_proxies[lastProxy].activeIndex = proxy.activeIndex;
+            m_activeProxies.pop_back();
+        }
+
+        proxy.body->setProxyId(NULL_NODE);
+        proxy.body = nullptr;
+        proxy.group = nullptr;
+        proxy.activeIndex = NULL_NODE;
+        m_freeProxies.push_back(proxyId);
+    }
+
+    //Builds the static trees over every static body outside of groups
+    void BroadPhase::rebuildStaticTrees()
+    {
+        std::map<unsigned int, std::vector<PhysicsBody*>> layerBodies;
+        m_builtStatics = 0;
+
+        for (size_t i = 0; i < m_proxies.size(); i++)
+        {
+            BroadPhaseProxy& proxy = m_proxies[i];
+            if (!proxy.body || !proxy.isStatic || proxy.group)
+                continue;
+
+            //Waiting statics leave the layer trees, built ones get new items below
+            if (proxy.inStaticTree)
+                proxy.leaves.clear();
+            else
+                removeLeaves(static_cast<int>(i));
+
+            proxy.inStaticTree = true;
+            proxy.fatBox = proxy.body->getCollider()->getAABB();
+            m_builtStatics++;
+
+            for (unsigned int layer : proxy.body->getCollider()->getCollisionLayers())
+                layerBodies[layer].push_back(proxy.body);
+        }
+
+        m_staticTrees.clear();
+        m_removedStatics = 0;
+        m_pendingStatics = 0;
+
+        std::vector<AABB> boxes;
+
+        for (const auto& layer : layerBodies)
+        {
+            const std::vector<PhysicsBody*>& treeBodies = layer.second;
+
+            boxes.resize(treeBodies.size());
+            for (size_t i = 0; i < treeBodies.size(); i++)
+                boxes[i] = m_proxies[treeBodies[i]->getProxyId()].fatBox;
+
+            StaticTree& tree = m_staticTrees[layer.first];
+            tree.build(boxes.data(), treeBodies.data(), static_cast<int>(treeBodies.size()));
+
+            //The tree reorders its items, hand them out afterwards
+            for (int item = 0; item < tree.getItemCount(); item++)
+                m_proxies[tree.getBody(item)->getProxyId()].leaves.emplace_back(layer.first, item);
+        }
+    }
+
+    //Attaches a group's bodies with the group's prebuilt trees
+    void BroadPhase::attachGroup(const StaticGroup* group)
+    {
+        if (std::find(m_groups.begin(), m_groups.end(), group) != m_groups.end())
+            return;
+
+        //Proxies let pairs and queries identify the bodies, their leaves stay in the group's trees
+        for (PhysicsBody* body : group->getBodies())
+        {
+            BroadPhaseProxy& proxy = m_proxies[allocateProxy(body)];
+            proxy.fatBox = body->getCollider()->getAABB();
+            proxy.group = group;
+        }
+
+        m_groups.push_back(group);
+    }
+
+    //Detaches a group's bodies
+    void BroadPhase::detachGroup(const StaticGroup* group)
+    {
+        auto it = std::find(m_groups.begin(), m_groups.end(), group);
+        if (it == m_groups.end())
+            return;
+
+        for (PhysicsBody* body : group->getBodies())
+            freeProxy(body->getProxyId());
+
+        m_groups.erase(it);
+    }
+
+    //Removes every body from the broad phase
+    void BroadPhase::clear()
+    {
+        for (BroadPhaseProxy& proxy : m_proxies)
+        {
+            if (proxy.body != nullptr)
+                proxy.body->setProxyId(NULL_NODE);
+        }
+
+        m_layerTrees.clear();
+        m_staticTrees.clear();
+        m_proxies.clear();
+        m_freeProxies.clear();
+        m_activeProxies.clear();
+        m_groups.clear();
+        m_builtStatics = 0;
+        m_removedStatics = 0;
+        m_pendingStatics = 0;
+    }
+
+    //Moves every fat box by -shift
+    void BroadPhase::shiftOrigin(const Vector2& shift)
+    {
+        for (BroadPhaseProxy& proxy : m_proxies)
+        {
+            if (!proxy.body)
+                continue;
+
+            proxy.fatBox.min -= shift;
+            proxy.fatBox.max -= shift;
+        }
+
+        for (auto& layerTree : m_layerTrees)
+            layerTree.second.shiftOrigin(shift);
+
+        for (auto& staticTree : m_staticTrees)
+            staticTree.second.shiftOrigin(shift);
+    }
+
+    //Inserts a proxy into the trees of its body's current layers
+    void BroadPhase::insertLeaves(int proxyId)
+    {
+        BroadPhaseProxy& proxy = m_proxies[proxyId];
+
+        for (unsigned int layer : proxy.body->getCollider()->getCollisionLayers())
+        {
+            int leaf = m_layerTrees[layer].createProxy(proxy.fatBox, proxy.body);
+            proxy.leaves.emplace_back(layer, leaf);
+        }
+    }
+
+    //Removes a proxy from all of its layer trees
+    void BroadPhase::removeLeaves(int proxyId)
+    {
+        BroadPhaseProxy& proxy = m_proxies[proxyId];
+
+        if (proxy.inStaticTree)
+        {
+            //Static trees cannot change shape, the items are only hidden until the next rebuild
+            for (const std::pair<unsigned int, int>& leaf : proxy.leaves)
+                m_staticTrees[leaf.first].removeItem(leaf.second);
+
+            proxy.inStaticTree = false;
+            m_builtStatics--;
+            m_removedStatics++;
+        }
+        else
+        {
+            for (const std::pair<unsigned int, int>& leaf : proxy.leaves)
+                m_layerTrees[leaf.first].destroyProxy(leaf.second);
+
+            if (proxy.isStatic && !proxy.group)
+                m_pendingStatics--;
+        }
+
+        proxy.leaves.clear();
+    }
+
+    //Returns true if a layer is the first of the searched layers the body's proxy is on
+    bool BroadPhase::isFirstSearchedLayer(const PhysicsBody* body, unsigned int layer, const QueryFilter& filter) const
+    {
+        const BroadPhaseProxy& proxy = m_proxies[body->getProxyId()];
+
+        //Group bodies have no leaves of their own, the group's trees follow their colliders' layers
+        const std::vector<unsigned int>& colliderLayers = body->getCollider()->getCollisionLayers();
+        size_t layerCount = proxy.group ? colliderLayers.size() : proxy.leaves.size();
+        if (layerCount <= 1)
+            return true;
+
+        auto getLayer = [&](size_t i) { return proxy.group ? colliderLayers[i] : proxy.leaves[i].first; };
+
+        //Without filter layers, the trees holding the body are searched in increasing layer order
+        if (filter.getLayers().empty())
+        {
+            unsigned int first = getLayer(0);
+            for (size_t i = 1; i < layerCount; i++)
+                first = std::min(first, getLayer(i));
+
+            return layer == first;
+        }
+
+        for (unsigned int searched : filter.getLayers())
+        {
+            for (size_t i = 0; i < layerCount; i++)
+            {
+                if (getLayer(i) == searched)
+                    return layer == searched;
+            }
+        }
+
+        return true;
+    }
+
+    //Returns true if the proxy's layers no longer match its body's collider
+    bool BroadPhase::layersChanged(const BroadPhaseProxy& proxy) const
+    {
+        const std::vector<unsigned int>& layers = proxy.body->getCollider()->getCollisionLayers();
+
+        if (layers.size() != proxy.leaves.size())
+            return true;
+
+        for (size_t i = 0; i < layers.size(); i++)
+        {
+            if (layers[i] != proxy.leaves[i].first)
+                return true;
+        }
+
+        return false;
+    }
+
+    //Refits proxies whose bodies moved out of their fat boxes or changed layers
+    void BroadPhase::update()
+    {
+        if ((m_pendingStatics > 0 && m_pendingStatics * STATIC_REBUILD_RATIO >= m_builtStatics) ||
+            m_removedStatics * STATIC_REBUILD_RATIO > m_builtStatics)
+            rebuildStaticTrees();
+
+        //Static bodies never move, so only moving proxies are visited
+        for (int proxyId : m_activeProxies)
+        {
+            BroadPhaseProxy& proxy = m_proxies[proxyId];
+            const AABB& box = proxy.body->getCollider()->getAABB();
+
+            //Layers changed, move the proxy to the new layer trees
+            if (layersChanged(proxy))
+            {
+                removeLeaves(proxyId);
+                proxy.fatBox = box.getExpanded(AABB_MARGIN);
+                insertLeaves(proxyId);
+                continue;
+            }
+
+            //Body is still inside its fat box, nothing to do
+            if (proxy.fatBox.contains(box))
+                continue;
+
+            proxy.fatBox = box.getExpanded(AABB_MARGIN);
+            for (const std::pair<unsigned int, int>& leaf : proxy.leaves)
+                m_layerTrees[leaf.first].moveProxy(leaf.second, proxy.fatBox);
+        }
+    }
+
+    //Fills pairs with every potentially colliding pair of bodies
+    void BroadPhase::findPairs(std::vector<BroadPhasePair>& pairs) const
+    {
+        pairs.clear();
+
+        //Static bodies are only found by others, so static-static pairs are never generated
+        for (int proxyId : m_activeProxies)
+        {
+            const BroadPhaseProxy& proxy = m_proxies[proxyId];
+            Collider* collider = proxy.body->getCollider();
+
+            auto findTreePairs = [&](const auto& tree)
+            {
+                tree.query(proxy.fatBox,
+                    [&](int leaf)
+                    {
+                        PhysicsBody* other = tree.getBody(leaf);
+                        int otherId = other->getProxyId();
+
+                        if (otherId == proxyId)
+                            return true;
+
+                        //Pairs of non-static bodies are reported by the lower proxy id only
+                        if (!m_proxies[otherId].isStatic && otherId < proxyId)
+                            return true;
+
+                        //Both bodies must mask one of the other's layers
+                        if (!CollisionDetection::shouldCollide(collider, other->getCollider()))
+                            return true;
+
+                        if (proxyId < otherId)
+                            pairs.push_back({proxy.body, other, proxyId, otherId});
+                        else
+                            pairs.push_back({other, proxy.body, otherId, proxyId});
+
+                        return true;
+                    });
+            };
+
+            //Only visit the trees of layers this body masks
+            for (unsigned int mask : collider->getCollisionMasks())
+            {
+                auto treeIt = m_layerTrees.find(mask);
+                if (treeIt != m_layerTrees.end())
+                    findTreePairs(treeIt->second);
+
+                auto staticIt = m_staticTrees.find(mask);
+                if (staticIt != m_staticTrees.end())
+                    findTreePairs(staticIt->second);
+
+                //Most groups are far from the body, their bounds rule them out before their trees are touched
+                for (const StaticGroup* group : m_groups)
+                {
+                    const StaticTree* groupTree = group->getLayerTree(mask);
+                    if (groupTree && CollisionDetection::checkAABBvsAABB(group->getBounds(), proxy.fatBox))
+                        findTreePairs(*groupTree);
+                }
+            }
+        }
+
+        //Bodies on several masked layers are found once per layer, sort and remove duplicates
+        std::sort(pairs.begin(),
+            pairs.end(),
+            [](const BroadPhasePair& a, const BroadPhasePair& b)
+            { return a.proxyA != b.proxyA ? a.proxyA < b.proxyA : a.proxyB < b.proxyB; });
+
+        pairs.erase(std::unique(pairs.begin(),
+                        pairs.end(),
+                        [](const BroadPhasePair& a, const BroadPhasePair& b)
+                        { return a.proxyA == b.proxyA && a.proxyB == b.proxyB; }),
+            pairs.end());
+    }
+
+    //Returns the number of bodies in the broad phase
+    int BroadPhase::getProxyCount() const
+    {
+        return static_cast<int>(m_proxies.size() - m_freeProxies.size());
+    }
+
+    //Returns the tree of a layer, null if no body is on that layer
+    const DynamicTree* BroadPhase::getLayerTree(unsigned int layer) const
+    {
+        auto it = m_layerTrees.find(layer);
+        if (it == m_layerTrees.end())
+            return nullptr;
+
+        return &it->second;
+    }
+
+    //Returns the static tree of a layer
+    const StaticTree* BroadPhase::getStaticTree(unsigned int layer) const
+    {
+        auto it = m_staticTrees.find(layer);
+        if (it == m_staticTrees.end())
+            return nullptr;
+
+        return &it->second;
+    }
+}
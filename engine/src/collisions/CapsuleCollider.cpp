@@ -0,0 +1,95 @@
+//Class implementation for capsule shape colliders
+
+#include "collisions/CapsuleCollider.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace phys
+{
+    //Constructor to set radius, height and collider type
+    CapsuleCollider::CapsuleCollider(float radius, float height, ColliderType colliderType) :
+        Collider(ColliderShape::Capsule, colliderType), m_radius(0), m_height(0)
+    {
+        setDimensions(radius, height);
+    }
+
+    //Getters for member variables
+    float CapsuleCollider::getRadius() const
+    {
+        return m_radius;
+    }
+
+    float CapsuleCollider::getHeight() const
+    {
+        return m_height;
+    }
+
+    //Returns half the length of the segment between the centers of the rounded ends
+    float CapsuleCollider::getHalfLength() const
+    {
+        return m_height / 2.0f - m_radius;
+    }
+
+    const Vector2& CapsuleCollider::getPointA() const
+    {
+        return m_pointA;
+    }
+
+    const Vector2& CapsuleCollider::getPointB() const
+    {
+        return m_pointB;
+    }
+
+    //Returns the area of the rectangle between the ends and the two half discs
+    float CapsuleCollider::getArea() const
+    {
+        const float PI = 3.14159265f;
+
+        return 2.0f * m_radius * getHalfLength() * 2.0f + PI * m_radius * m_radius;
+    }
+
+    //Returns the rotational inertia about the center for a mass of 1
+    float CapsuleCollider::getUnitInertia() const
+    {
+        const float PI = 3.14159265f;
+
+        float radiusSquared = m_radius * m_radius;
+        float halfLength = getHalfLength();
+        float length = halfLength * 2.0f;
+
+        //Rectangle between the segment ends
+        float boxArea = 2.0f * m_radius * length;
+        float boxInertia = boxArea * (4.0f * radiusSquared + length * length) / 12.0f;
+
+        //Two half discs, moved out to the segment ends by the parallel axis theorem
+        float discArea = PI * radiusSquared;
+        float discCentroid = 4.0f * m_radius / (3.0f * PI);
+        float discInertia =
+            discArea * (radiusSquared / 2.0f + halfLength * halfLength + 2.0f * halfLength * discCentroid);
+
+        float area = boxArea + discArea;
+        return area > 0.0f ? (boxInertia + discInertia) / area : 0.0f;
+    }
+
+    //Setters for member variables
+    void CapsuleCollider::setDimensions(float newRadius, float newHeight)
+    {
+        m_radius = std::max(newRadius, 0.0f);
+        m_height = std::max(newHeight, m_radius * 2.0f);
+
+        updateAABB();
+    }
+
+    //Update AABB mins and maxes, and the segment end points
+    void CapsuleCollider::updateAABB()
+    {
+        float halfLength = getHalfLength();
+        Vector2 axis = {-std::sin(m_rotation) * halfLength, std::cos(m_rotation) * halfLength};
+
+        m_pointA = m_position - axis;
+        m_pointB = m_position + axis;
+
+        m_boundingBox.min = {std::min(m_pointA.x, m_pointB.x) - m_radius, std::min(m_pointA.y, m_pointB.y) - m_radius};
+        m_boundingBox.max = {std::max(m_pointA.x, m_pointB.x) + m_radius, std::max(m_pointA.y, m_pointB.y) + m_radius};
+    }
+}
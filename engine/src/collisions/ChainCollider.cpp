@@ -0,0 +1,171 @@
+//Class implementation for chain colliders
+
+#include "collisions/ChainCollider.hpp"
+#include <cmath>
+
+namespace phys
+{
+    //Constructor to set points, whether the chain is a loop, and collider type
+    ChainCollider::ChainCollider(const std::vector<Vector2>& points, bool loop, ColliderType colliderType) :
+        Collider(ColliderShape::Chain, colliderType), m_loop(false), m_radius(0)
+    {
+        setPoints(points, loop);
+    }
+
+    //Getters for member variables
+    int ChainCollider::getPointCount() const
+    {
+        return static_cast<int>(m_points.size());
+    }
+
+    const std::vector<Vector2>& ChainCollider::getPoints() const
+    {
+        return m_points;
+    }
+
+    const std::vector<Vector2>& ChainCollider::getVertices() const
+    {
+        return m_vertices;
+    }
+
+    bool ChainCollider::isLoop() const
+    {
+        return m_loop;
+    }
+
+    float ChainCollider::getRadius() const
+    {
+        return m_radius;
+    }
+
+    //Returns the number of segments, one fewer than the points unless the chain is a loop
+    int ChainCollider::getSegmentCount() const
+    {
+        int pointCount = getPointCount();
+        if (pointCount < 2)
+            return 0;
+
+        return m_loop ? pointCount : pointCount - 1;
+    }
+
+    //Returns the world space end points of a segment
+    void ChainCollider::getSegment(int index, Vector2& start, Vector2& end) const
+    {
+        start = m_vertices[index];
+        end = m_vertices[index + 1 < getPointCount() ? index + 1 : 0];
+    }
+
+    //Returns the vertex before a segment's start, false at the start of a chain that is not a loop
+    bool ChainCollider::getPreviousVertex(int index, Vector2& vertex) const
+    {
+        if (index > 0)
+            vertex = m_vertices[index - 1];
+        else if (m_loop)
+            vertex = m_vertices.back();
+        else
+            return false;
+
+        return true;
+    }
+
+    //Returns the vertex after a segment's end, false at the end of a chain that is not a loop
+    bool ChainCollider::getNextVertex(int index, Vector2& vertex) const
+    {
+        int pointCount = getPointCount();
+
+        if (index + 2 < pointCount)
+            vertex = m_vertices[index + 2];
+        else if (m_loop)
+            vertex = m_vertices[(index + 2) % pointCount];
+        else
+            return false;
+
+        return true;
+    }
+
+    //Replaces the points of the chain
+    void ChainCollider::setPoints(const std::vector<Vector2>& points, bool loop)
+    {
+        m_points.clear();
+        m_loop = loop;
+
+        //Repeated points would make segments without a direction
+        for (const Vector2& point : points)
+        {
+            if (m_points.empty() || (point - m_points.back()).getSquare() > 0.0f)
+                m_points.push_back(point);
+        }
+
+        if (m_loop && m_points.size() > 1 && (m_points.back() - m_points.front()).getSquare() == 0.0f)
+            m_points.pop_back();
+
+        //Too few points for a segment, or for a loop that encloses anything
+        if (m_points.size() < (m_loop ? 3u : 2u))
+            m_points.clear();
+
+        m_radius = 0.0f;
+        for (const Vector2& point : m_points)
+            m_radius = std::max(m_radius, point.getLength());
+
+        updateAABB();
+    }
+
+    //Builds the subtree over segments [first, first + count), returns the index of its root
+    int ChainCollider::buildNode(int first, int count)
+    {
+        int nodeId = static_cast<int>(m_nodes.size());
+        m_nodes.push_back(ChainNode());
+
+        if (count <= MAX_LEAF_SEGMENTS)
+        {
+            Vector2 start;
+            Vector2 end;
+            getSegment(first, start, end);
+
+            AABB box(start, start);
+            for (int segment = first; segment < first + count; segment++)
+            {
+                getSegment(segment, start, end);
+                box = AABB::combine(box, AABB(end, end));
+            }
+
+            m_nodes[nodeId] = {box, first, count};
+            return nodeId;
+        }
+
+        //The first child is the next node, the index points at the second
+        int half = count / 2;
+        buildNode(first, half);
+        int second = buildNode(first + half, count - half);
+
+        m_nodes[nodeId] = {AABB::combine(m_nodes[nodeId + 1].box, m_nodes[second].box), second, 0};
+        return nodeId;
+    }
+
+    //Update AABB mins and maxes, the world vertices and the hierarchy boxes
+    //Chains are static, so rebuilding the boxes whenever one moves costs nothing per step
+    void ChainCollider::updateAABB()
+    {
+        float cos = std::cos(m_rotation);
+        float sin = std::sin(m_rotation);
+
+        m_vertices.resize(m_points.size());
+        for (size_t i = 0; i < m_points.size(); i++)
+        {
+            const Vector2& point = m_points[i];
+            m_vertices[i] = m_position + Vector2(point.x * cos - point.y * sin, point.x * sin + point.y * cos);
+        }
+
+        m_nodes.clear();
+
+        if (getSegmentCount() == 0)
+        {
+            m_boundingBox.min = m_position;
+            m_boundingBox.max = m_position;
+            return;
+        }
+
+        buildNode(0, getSegmentCount());
+        m_boundingBox = m_nodes[0].box;
+    }
+}
@@ -1,6 +1,7 @@
 //Base class implementation for colliders
 
 #include "collisions/Collider.hpp"
+#include <algorithm>
 
 namespace phys
 {
@@ -9,6 +10,7 @@ namespace phys
         m_parent(nullptr),
         m_position({0, 0}),
         m_offset({0, 0}),
+        m_rotation(0),
         m_shape(colliderShape),
         m_type(colliderType),
         m_boundingBox(AABB()),
@@ -24,6 +26,8 @@ namespace phys
     void Collider::rotate(float radians)
     {
         m_rotation += radians;
+
+        updateAABB();
     }
 
     //Getters for member variables
@@ -72,6 +76,17 @@ namespace phys
     void Collider::setRotation(float newRotation)
     {
         m_rotation = newRotation;
+
+        updateAABB();
+    }
+
+    //Sets position and rotation together, updating the AABB once
+    void Collider::setTransform(const Vector2& newPosition, float newRotation)
+    {
+        m_position = newPosition;
+        m_rotation = newRotation;
+
+        updateAABB();
     }
 
     void Collider::setOffset(const Vector2& newOffest)
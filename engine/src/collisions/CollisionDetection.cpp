@@ -8,537 +8,3901 @@ struct Collision;
 
 namespace phys
 {
-    bool CollisionDetection::shouldCollide(Collider* colliderA, Collider* colliderB)
+    //Sweeps a point along a displacement against a box centered at the origin
+    //Returns the fraction of the displacement at entry and the face normal, false if missed or starting inside
+    static bool sweepPointVsBox(const Vector2& origin,
+        const Vector2& displacement,
+        const Vector2& halfExtents,
+        float& fraction,
+        Vector2& normal)
     {
-        //Get layers and masks
-        const std::vector<unsigned int>& aLayers = colliderA->getCollisionLayers();
-        const std::vector<unsigned int>& aMasks = colliderA->getCollisionMasks();
+        const float originAxes[2] = {origin.x, origin.y};
+        const float displacementAxes[2] = {displacement.x, displacement.y};
+        const float halfAxes[2] = {halfExtents.x, halfExtents.y};
 
-        const std::vector<unsigned int>& bLayers = colliderB->getCollisionLayers();
-        const std::vector<unsigned int>& bMasks = colliderB->getCollisionMasks();
+        float tMin = -std::numeric_limits<float>::infinity();
+        float tMax = std::numeric_limits<float>::infinity();
+        int entryAxis = 0;
+        float entrySign = 0.0f;
 
-        bool aWantsCollideB = false;
+        for (int axis = 0; axis < 2; axis++)
+        {
+            if (displacementAxes[axis] == 0.0f)
+            {
+                if (std::abs(originAxes[axis]) > halfAxes[axis])
+                    return false;
 
-        //Check if A wants to collide with B
-        for (unsigned int aMask : aMasks)
+                continue;
+            }
+
+            float t1 = (-halfAxes[axis] - originAxes[axis]) / displacementAxes[axis];
+            float t2 = (halfAxes[axis] - originAxes[axis]) / displacementAxes[axis];
+
+            float sign = -1.0f;
+            if (t1 > t2)
+            {
+                std::swap(t1, t2);
+                sign = 1.0f;
+            }
+
+            if (t1 > tMin)
+            {
+                tMin = t1;
+                entryAxis = axis;
+                entrySign = sign;
+            }
+
+            tMax = std::min(tMax, t2);
+        }
+
+        if (tMin > tMax || tMin < 0.0f || tMin > 1.0f)
+            return false;
+
+        fraction = tMin;
+        normal = entryAxis == 0 ? Vector2(entrySign, 0.0f) : Vector2(0.0f, entrySign);
+
+        return true;
+    }
+
+    //Sweeps a point along a displacement against a circle
+    //Returns the fraction of the displacement at entry and the surface normal, false if missed or starting inside
+    static bool sweepPointVsCircle(const Vector2& origin,
+        const Vector2& displacement,
+        const Vector2& center,
+        float radius,
+        float& fraction,
+        Vector2& normal)
+    {
+        Vector2 centerToOrigin = origin - center;
+
+        //Solve |origin + displacement * t - center| = radius for t
+        float a = displacement.getSquare();
+        float b = centerToOrigin.projectOntoAxis(displacement);
+        float c = centerToOrigin.getSquare() - radius * radius;
+
+        if (a == 0.0f || c <= 0.0f || b > 0.0f)
+            return false;
+
+        float discriminant = b * b - a * c;
+        if (discriminant < 0.0f)
+            return false;
+
+        float t = (-b - std::sqrt(discriminant)) / a;
+        if (t > 1.0f)
+            return false;
+
+        fraction = t;
+        normal = (origin + displacement * t - center) / radius;
+
+        return true;
+    }
+
+    //Returns the point on a capsule's segment closest to another point
+    static Vector2 findClosestPointOnCapsuleSegment(const CapsuleCollider* capsule, const Vector2& point)
+    {
+        const Vector2& start = capsule->getPointA();
+        const Vector2& end = capsule->getPointB();
+
+        if ((end - start).getSquare() == 0.0f)
+            return start;
+
+        return CollisionDetection::findClosestPointOnSegment(point, start, end);
+    }
+
+    //Sweeps a point along a displacement against a segment grown to a radius
+    //The grown segment is the union of a box around it and circles at its ends, swept in the segment's local space
+    //Returns the fraction of the displacement at entry and the surface normal, false if missed or starting inside
+    static bool sweepPointVsSegment(const Vector2& origin,
+        const Vector2& displacement,
+        const Vector2& start,
+        const Vector2& end,
+        float radius,
+        float& fraction,
+        Vector2& normal)
+    {
+        Vector2 axis = end - start;
+        Vector2 closest = axis.getSquare() > 0.0f ? CollisionDetection::findClosestPointOnSegment(origin, start, end)
+                                                  : start;
+
+        if ((origin - closest).getSquare() <= radius * radius)
+            return false;
+
+        //Local y runs along the segment, local x across it
+        float halfLength = axis.getLength() / 2.0f;
+        Vector2 up = halfLength > 0.0f ? axis / (halfLength * 2.0f) : Vector2(0.0f, 1.0f);
+        Vector2 side = {up.y, -up.x};
+
+        Vector2 relative = origin - (start + end) / 2.0f;
+        Vector2 localOrigin = {relative.projectOntoAxis(side), relative.projectOntoAxis(up)};
+        Vector2 localDisplacement = {displacement.projectOntoAxis(side), displacement.projectOntoAxis(up)};
+
+        float bestFraction = std::numeric_limits<float>::infinity();
+        Vector2 localNormal;
+        float partFraction;
+        Vector2 partNormal;
+
+        if (sweepPointVsBox(localOrigin, localDisplacement, {radius, halfLength}, partFraction, partNormal))
         {
-            if (std::find(bLayers.begin(), bLayers.end(), aMask) != bLayers.end())
+            bestFraction = partFraction;
+            localNormal = partNormal;
+        }
+
+        for (float end : {-halfLength, halfLength})
+        {
+            if (sweepPointVsCircle(localOrigin, localDisplacement, {0.0f, end}, radius, partFraction, partNormal) &&
+                partFraction < bestFraction)
             {
-                aWantsCollideB = true;
+                bestFraction = partFraction;
+                localNormal = partNormal;
+            }
+        }
+
+        if (bestFraction > 1.0f)
+            return false;
+
+        fraction = bestFraction;
+        normal = side * localNormal.x + up * localNormal.y;
+
+        return true;
+    }
+
+    //Sweeps a point along a displacement against a capsule grown to a radius
+    static bool sweepPointVsCapsule(const Vector2& origin,
+        const Vector2& displacement,
+        const CapsuleCollider* capsule,
+        float radius,
+        float& fraction,
+        Vector2& normal)
+    {
+        return sweepPointVsSegment(
+            origin, displacement, capsule->getPointA(), capsule->getPointB(), radius, fraction, normal);
+    }
+
+    //Clips a segment to the side of a line where points project onto the normal no further than offset
+    //Returns false if the whole segment lies beyond the line
+    static bool clipSegmentToLine(Vector2 segment[2], const Vector2& normal, float offset)
+    {
+        float distanceA = segment[0].projectOntoAxis(normal) - offset;
+        float distanceB = segment[1].projectOntoAxis(normal) - offset;
+
+        if (distanceA > 0.0f && distanceB > 0.0f)
+            return false;
+
+        if (distanceA > 0.0f)
+            segment[0] = segment[0] + (segment[1] - segment[0]) * (distanceA / (distanceA - distanceB));
+        else if (distanceB > 0.0f)
+            segment[1] = segment[1] + (segment[0] - segment[1]) * (distanceB / (distanceB - distanceA));
+
+        return true;
+    }
+
+    //Largest sine of the angle between a segment and a face for them to count as lying along each other
+    //Contacts between such features are clipped into two points so the bodies rest flat instead of rocking
+    static const float PARALLEL_TOLERANCE = 0.05f;
+
+    //Largest sine of the angle by which a chain contact normal may leave the range its segment allows,
+    //corners turning less than this count as flat
+    static const float CHAIN_ANGLE_TOLERANCE = 0.01f;
+
+    //Returns true if a normal lies on the shorter arc between two unit normals
+    //When both are the same, the normal must point along them
+    static bool isNormalBetween(const Vector2& normal, const Vector2& from, const Vector2& to)
+    {
+        float arc = from.crossProduct(to);
+
+        if (std::abs(arc) < CHAIN_ANGLE_TOLERANCE && from.projectOntoAxis(to) > 0.0f)
+            return std::abs(from.crossProduct(normal)) <= CHAIN_ANGLE_TOLERANCE && normal.projectOntoAxis(from) > 0.0f;
+
+        float sign = arc > 0.0f ? 1.0f : -1.0f;
+        return from.crossProduct(normal) * sign >= -CHAIN_ANGLE_TOLERANCE &&
+               normal.crossProduct(to) * sign >= -CHAIN_ANGLE_TOLERANCE && normal.projectOntoAxis(from + to) > 0.0f;
+    }
+
+    //Finds how far the contact normal of a chain segment may turn away from the segment's normal at each end
+    //Convex corners let it turn to the neighbouring segment's normal and open ends to face along the segment,
+    //flat and concave corners keep it on the segment's normal since the neighbouring segment covers them
+    static void findSegmentNormalBounds(const ChainCollider* chain,
+        int segment,
+        const Vector2& tangent,
+        Vector2& startBound,
+        Vector2& endBound)
+    {
+        Vector2 start;
+        Vector2 end;
+        Vector2 ghost;
+        chain->getSegment(segment, start, end);
+
+        Vector2 normal = {-tangent.y, tangent.x};
+
+        startBound = -tangent;
+        if (chain->getPreviousVertex(segment, ghost))
+        {
+            Vector2 previousTangent = (start - ghost).getNormal();
+            startBound = previousTangent.crossProduct(tangent) < -CHAIN_ANGLE_TOLERANCE
+                             ? Vector2(-previousTangent.y, previousTangent.x)
+                             : normal;
+        }
+
+        endBound = tangent;
+        if (chain->getNextVertex(segment, ghost))
+        {
+            Vector2 nextTangent = (ghost - end).getNormal();
+            endBound = tangent.crossProduct(nextTangent) < -CHAIN_ANGLE_TOLERANCE
+                           ? Vector2(-nextTangent.y, nextTangent.x)
+                           : normal;
+        }
+    }
+
+    //Fills a convex polygon with the corners of an axis aligned box
+    static void makeBoxPolygon(const AABB& box, ConvexPolygon& polygon)
+    {
+        polygon.count = 4;
+        polygon.vertices[0] = box.min;
+        polygon.vertices[1] = {box.max.x, box.min.y};
+        polygon.vertices[2] = box.max;
+        polygon.vertices[3] = {box.min.x, box.max.y};
+        polygon.normals[0] = {0.0f, -1.0f};
+        polygon.normals[1] = {1.0f, 0.0f};
+        polygon.normals[2] = {0.0f, 1.0f};
+        polygon.normals[3] = {-1.0f, 0.0f};
+    }
+
+    //Vertex of a GJK simplex, a point of the difference of two cores and the indices of the core vertices it came from
+    struct SimplexVertex
+    {
+        Vector2 point;
+        float weight;
+        int indexA;
+        int indexB;
+    };
+
+    //Up to three vertices of the difference of two cores, reduced to the ones nearest the origin after each step
+    struct Simplex
+    {
+        SimplexVertex vertices[3];
+        int count;
+    };
+
+    //Most iterations GJK and EPA take, the difference of two cores has few enough vertices to converge well before
+    static const int MAX_GJK_ITERATIONS = 20;
+    static const int MAX_EPA_ITERATIONS = 2 * PolygonCollider::MAX_VERTICES;
+
+    //The difference of two cores has at most as many vertices as both cores together, plus the starting triangle
+    static const int MAX_POLYTOPE_VERTICES = 2 * PolygonCollider::MAX_VERTICES + 3;
+
+    //Makes a simplex vertex from a vertex of each core
+    static SimplexVertex makeSimplexVertex(
+        const SupportShape& shapeA, int indexA, const SupportShape& shapeB, int indexB)
+    {
+        SimplexVertex vertex;
+        vertex.point = shapeB.core.vertices[indexB] - shapeA.core.vertices[indexA];
+        vertex.weight = 1.0f;
+        vertex.indexA = indexA;
+        vertex.indexB = indexB;
+
+        return vertex;
+    }
+
+    //Makes the vertex of the difference of two cores furthest along a direction
+    static SimplexVertex findDifferenceSupport(
+        const SupportShape& shapeA, const SupportShape& shapeB, const Vector2& direction)
+    {
+        return makeSimplexVertex(shapeA,
+            CollisionDetection::findSupportVertex(shapeA.core, -direction),
+            shapeB,
+            CollisionDetection::findSupportVertex(shapeB.core, direction));
+    }
+
+    //Weights a two vertex simplex by the point nearest the origin, dropping a vertex the point does not need
+    static void solveSimplex2(Simplex& simplex)
+    {
+        SimplexVertex& vertexA = simplex.vertices[0];
+        SimplexVertex& vertexB = simplex.vertices[1];
+        Vector2 edge = vertexB.point - vertexA.point;
+
+        //Origin lies beyond the first vertex
+        float weightB = -vertexA.point.projectOntoAxis(edge);
+        if (weightB <= 0.0f)
+        {
+            vertexA.weight = 1.0f;
+            simplex.count = 1;
+            return;
+        }
+
+        //Origin lies beyond the second vertex
+        float weightA = vertexB.point.projectOntoAxis(edge);
+        if (weightA <= 0.0f)
+        {
+            vertexB.weight = 1.0f;
+            vertexA = vertexB;
+            simplex.count = 1;
+            return;
+        }
+
+        vertexA.weight = weightA / (weightA + weightB);
+        vertexB.weight = weightB / (weightA + weightB);
+        simplex.count = 2;
+    }
+
+    //Weights a triangle simplex by the point nearest the origin, dropping the vertices the point does not need
+    //All three are kept when the origin lies inside it
+    static void solveSimplex3(Simplex& simplex)
+    {
+        SimplexVertex& vertexA = simplex.vertices[0];
+        SimplexVertex& vertexB = simplex.vertices[1];
+        SimplexVertex& vertexC = simplex.vertices[2];
+        const Vector2& a = vertexA.point;
+        const Vector2& b = vertexB.point;
+        const Vector2& c = vertexC.point;
+
+        //Barycentric weights of the origin on each edge
+        Vector2 edgeAB = b - a;
+        float edgeABWeightA = b.projectOntoAxis(edgeAB);
+        float edgeABWeightB = -a.projectOntoAxis(edgeAB);
+
+        Vector2 edgeAC = c - a;
+        float edgeACWeightA = c.projectOntoAxis(edgeAC);
+        float edgeACWeightC = -a.projectOntoAxis(edgeAC);
+
+        Vector2 edgeBC = c - b;
+        float edgeBCWeightB = c.projectOntoAxis(edgeBC);
+        float edgeBCWeightC = -b.projectOntoAxis(edgeBC);
+
+        //Barycentric weights of the origin in the triangle
+        float area = edgeAB.crossProduct(edgeAC);
+        float weightA = area * b.crossProduct(c);
+        float weightB = area * c.crossProduct(a);
+        float weightC = area * a.crossProduct(b);
+
+        //Nearest vertex A
+        if (edgeABWeightB <= 0.0f && edgeACWeightC <= 0.0f)
+        {
+            vertexA.weight = 1.0f;
+            simplex.count = 1;
+        }
+
+        //Nearest edge AB
+        else if (edgeABWeightA > 0.0f && edgeABWeightB > 0.0f && weightC <= 0.0f)
+        {
+            vertexA.weight = edgeABWeightA / (edgeABWeightA + edgeABWeightB);
+            vertexB.weight = edgeABWeightB / (edgeABWeightA + edgeABWeightB);
+            simplex.count = 2;
+        }
+
+        //Nearest edge AC
+        else if (edgeACWeightA > 0.0f && edgeACWeightC > 0.0f && weightB <= 0.0f)
+        {
+            vertexA.weight = edgeACWeightA / (edgeACWeightA + edgeACWeightC);
+            vertexC.weight = edgeACWeightC / (edgeACWeightA + edgeACWeightC);
+            vertexB = vertexC;
+            simplex.count = 2;
+        }
+
+        //Nearest vertex B
+        else if (edgeABWeightA <= 0.0f && edgeBCWeightC <= 0.0f)
+        {
+            vertexB.weight = 1.0f;
+            vertexA = vertexB;
+            simplex.count = 1;
+        }
+
+        //Nearest vertex C
+        else if (edgeACWeightA <= 0.0f && edgeBCWeightB <= 0.0f)
+        {
+            vertexC.weight = 1.0f;
+            vertexA = vertexC;
+            simplex.count = 1;
+        }
+
+        //Nearest edge BC
+        else if (edgeBCWeightB > 0.0f && edgeBCWeightC > 0.0f && weightA <= 0.0f)
+        {
+            vertexB.weight = edgeBCWeightB / (edgeBCWeightB + edgeBCWeightC);
+            vertexC.weight = edgeBCWeightC / (edgeBCWeightB + edgeBCWeightC);
+            vertexA = vertexC;
+            simplex.count = 2;
+        }
+
+        //Origin inside the triangle
+        else
+        {
+            float sum = weightA + weightB + weightC;
+            vertexA.weight = weightA / sum;
+            vertexB.weight = weightB / sum;
+            vertexC.weight = weightC / sum;
+            simplex.count = 3;
+        }
+    }
+
+    //Weights the simplex by the point nearest the origin, dropping the vertices the point does not need
+    static void solveSimplex(Simplex& simplex)
+    {
+        if (simplex.count == 2)
+            solveSimplex2(simplex);
+        else if (simplex.count == 3)
+            solveSimplex3(simplex);
+        else
+            simplex.vertices[0].weight = 1.0f;
+    }
+
+    //Direction from the simplex towards the origin, zero when the origin lies on it
+    static Vector2 findSearchDirection(const Simplex& simplex)
+    {
+        const Vector2& a = simplex.vertices[0].point;
+
+        if (simplex.count == 1)
+            return -a;
+
+        //Side of the edge the origin is on
+        Vector2 edge = simplex.vertices[1].point - a;
+        float side = edge.crossProduct(-a);
+
+        if (side > 0.0f)
+            return {-edge.y, edge.x};
+        else if (side < 0.0f)
+            return {edge.y, -edge.x};
+
+        return {0.0f, 0.0f};
+    }
+
+    //Reads the simplex a cache left, starting from the first vertex of both cores when it is empty or stale
+    static void readSimplexCache(
+        const SupportShape& shapeA, const SupportShape& shapeB, const SimplexCache& cache, Simplex& simplex)
+    {
+        simplex.count = 0;
+
+        for (int i = 0; i < cache.count && i < 3; i++)
+        {
+            //Colliders may have changed since, or a new pair may have taken the place of an old one
+            if (cache.indexA[i] >= shapeA.core.count || cache.indexB[i] >= shapeB.core.count)
+            {
+                simplex.count = 0;
                 break;
             }
+
+            simplex.vertices[simplex.count++] = makeSimplexVertex(shapeA, cache.indexA[i], shapeB, cache.indexB[i]);
         }
 
-        //Return false if A does not mask one of B layers
-        if (!aWantsCollideB)
+        //Collapsed simplices cannot be solved, start again from their first vertex
+        if (simplex.count == 2)
+        {
+            if ((simplex.vertices[1].point - simplex.vertices[0].point).getSquare() == 0.0f)
+                simplex.count = 1;
+        }
+        else if (simplex.count == 3)
+        {
+            Vector2 edgeAB = simplex.vertices[1].point - simplex.vertices[0].point;
+            Vector2 edgeAC = simplex.vertices[2].point - simplex.vertices[0].point;
+            float area = edgeAB.crossProduct(edgeAC);
+
+            if (std::abs(area) <= std::numeric_limits<float>::epsilon() * (edgeAB.getSquare() + edgeAC.getSquare()))
+                simplex.count = 1;
+        }
+
+        if (simplex.count == 0)
+        {
+            simplex.vertices[0] = makeSimplexVertex(shapeA, 0, shapeB, 0);
+            simplex.count = 1;
+        }
+    }
+
+    //Finds the closest points of two cores from the weights of the simplex
+    static void findSimplexPoints(const SupportShape& shapeA,
+        const SupportShape& shapeB,
+        const Simplex& simplex,
+        Vector2& pointA,
+        Vector2& pointB)
+    {
+        pointA = {0.0f, 0.0f};
+        pointB = {0.0f, 0.0f};
+
+        for (int i = 0; i < simplex.count; i++)
+        {
+            const SimplexVertex& vertex = simplex.vertices[i];
+            pointA += shapeA.core.vertices[vertex.indexA] * vertex.weight;
+            pointB += shapeB.core.vertices[vertex.indexB] * vertex.weight;
+        }
+
+        //Overlapping cores share the point
+        if (simplex.count == 3)
+            pointB = pointA;
+    }
+
+    //Stores the vertices of a simplex in a cache
+    static void writeSimplexCache(const Simplex& simplex, SimplexCache& cache)
+    {
+        cache.count = simplex.count;
+
+        for (int i = 0; i < simplex.count; i++)
+        {
+            cache.indexA[i] = static_cast<uint8_t>(simplex.vertices[i].indexA);
+            cache.indexB[i] = static_cast<uint8_t>(simplex.vertices[i].indexB);
+        }
+    }
+
+    //Moves the simplex towards the origin until it holds the origin or stops getting closer (GJK)
+    //The simplex is left sorted by vertex indices and solved again, so where it started cannot change the result
+    //Returns the number of iterations taken
+    static int runGJK(const SupportShape& shapeA,
+        const SupportShape& shapeB,
+        const SimplexCache& cache,
+        Simplex& simplex)
+    {
+        readSimplexCache(shapeA, shapeB, cache, simplex);
+
+        int iterations = 0;
+        while (iterations < MAX_GJK_ITERATIONS)
+        {
+            iterations++;
+
+            //Remember the vertices before solving, a support point among them means no progress can be made
+            int lastCount = simplex.count;
+            int lastA[3];
+            int lastB[3];
+            for (int i = 0; i < lastCount; i++)
+            {
+                lastA[i] = simplex.vertices[i].indexA;
+                lastB[i] = simplex.vertices[i].indexB;
+            }
+
+            solveSimplex(simplex);
+
+            //Origin inside the triangle, the cores overlap
+            if (simplex.count == 3)
+                break;
+
+            //Origin on the simplex, the cores touch
+            Vector2 direction = findSearchDirection(simplex);
+            float epsilon = std::numeric_limits<float>::epsilon();
+            if (direction.getSquare() < epsilon * epsilon)
+                break;
+
+            SimplexVertex vertex = findDifferenceSupport(shapeA, shapeB, direction);
+
+            bool repeated = false;
+            for (int i = 0; i < lastCount; i++)
+                repeated = repeated || (lastA[i] == vertex.indexA && lastB[i] == vertex.indexB);
+
+            if (repeated)
+                break;
+
+            simplex.vertices[simplex.count++] = vertex;
+        }
+
+        std::sort(simplex.vertices,
+            simplex.vertices + simplex.count,
+            [](const SimplexVertex& a, const SimplexVertex& b)
+            { return a.indexA != b.indexA ? a.indexA < b.indexA : a.indexB < b.indexB; });
+
+        solveSimplex(simplex);
+
+        return iterations;
+    }
+
+    //Grows the simplex of overlapping cores into the polygon of their difference, always towards the face of it
+    //nearest the origin, until that face is a face of the difference itself (EPA)
+    //Returns the outward normal of the face, which points from core B towards core A, and fills the cache with the
+    //face and the vertex opposite it, a triangle around the origin the next query can start from
+    //Returns false when the difference has no area, as for a point on a segment
+    static bool runEPA(const SupportShape& shapeA,
+        const SupportShape& shapeB,
+        const Simplex& simplex,
+        Vector2& normal,
+        SimplexCache& cache)
+    {
+        SimplexVertex polytope[MAX_POLYTOPE_VERTICES];
+        int count = simplex.count;
+        std::copy(simplex.vertices, simplex.vertices + count, polytope);
+
+        //Touching cores leave a point or an edge, widen it into a triangle
+        if (count == 1)
+        {
+            const Vector2 axes[4] = {{1.0f, 0.0f}, {-1.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, -1.0f}};
+
+            for (const Vector2& axis : axes)
+            {
+                SimplexVertex vertex = findDifferenceSupport(shapeA, shapeB, axis);
+                if ((vertex.point - polytope[0].point).getSquare() > 0.0f)
+                {
+                    polytope[count++] = vertex;
+                    break;
+                }
+            }
+        }
+
+        if (count == 2)
+        {
+            Vector2 edge = polytope[1].point - polytope[0].point;
+            Vector2 sides[2] = {{-edge.y, edge.x}, {edge.y, -edge.x}};
+
+            for (const Vector2& side : sides)
+            {
+                SimplexVertex vertex = findDifferenceSupport(shapeA, shapeB, side);
+                float area = edge.crossProduct(vertex.point - polytope[0].point);
+
+                if (std::abs(area) > std::numeric_limits<float>::epsilon() * edge.getSquare())
+                {
+                    polytope[count++] = vertex;
+                    break;
+                }
+            }
+        }
+
+        if (count < 3)
             return false;
 
-        //Check if B wants to collide with A
-        for (unsigned int bMask : bMasks)
+        //Keep the polytope counter clockwise so edge normals point outwards
+        if ((polytope[1].point - polytope[0].point).crossProduct(polytope[2].point - polytope[0].point) < 0.0f)
+            std::swap(polytope[1], polytope[2]);
+
+        //Outward normal and distance from the origin of the edge starting at each vertex
+        Vector2 edgeNormals[MAX_POLYTOPE_VERTICES];
+        float edgeDistances[MAX_POLYTOPE_VERTICES];
+
+        auto updateEdge = [&polytope, &edgeNormals, &edgeDistances, &count](int i)
         {
-            if (std::find(aLayers.begin(), aLayers.end(), bMask) != aLayers.end())
+            Vector2 edge = polytope[(i + 1) % count].point - polytope[i].point;
+
+            //Edges without length never face the origin
+            if (edge.getSquare() == 0.0f)
             {
-                return true;
+                edgeDistances[i] = std::numeric_limits<float>::infinity();
+                return;
+            }
+
+            edgeNormals[i] = Vector2(edge.y, -edge.x).getNormal();
+            edgeDistances[i] = polytope[i].point.projectOntoAxis(edgeNormals[i]);
+        };
+
+        for (int i = 0; i < count; i++)
+            updateEdge(i);
+
+        int face = 0;
+        for (int iteration = 0; iteration < MAX_EPA_ITERATIONS; iteration++)
+        {
+            cache.iterations++;
+
+            //Face nearest the origin
+            face = 0;
+            for (int i = 1; i < count; i++)
+            {
+                if (edgeDistances[i] < edgeDistances[face])
+                    face = i;
+            }
+
+            normal = edgeNormals[face];
+            float nearestDistance = edgeDistances[face];
+
+            //The face is a face of the difference once nothing lies beyond it
+            SimplexVertex vertex = findDifferenceSupport(shapeA, shapeB, normal);
+
+            bool repeated = false;
+            for (int i = 0; i < count; i++)
+                repeated = repeated || (polytope[i].indexA == vertex.indexA && polytope[i].indexB == vertex.indexB);
+
+            float tolerance = std::numeric_limits<float>::epsilon() * (1.0f + std::abs(nearestDistance));
+            if (repeated || vertex.point.projectOntoAxis(normal) - nearestDistance <= tolerance ||
+                count == MAX_POLYTOPE_VERTICES)
+                break;
+
+            int inserted = face + 1;
+            std::copy_backward(polytope + inserted, polytope + count, polytope + count + 1);
+            std::copy_backward(edgeNormals + inserted, edgeNormals + count, edgeNormals + count + 1);
+            std::copy_backward(edgeDistances + inserted, edgeDistances + count, edgeDistances + count + 1);
+            polytope[inserted] = vertex;
+            count++;
+
+            //GJK may start from points inside the difference, drop any the new vertex leaves in a dent
+            //so the polytope stays convex
+            while (count > 3)
+            {
+                int previous = (inserted + count - 1) % count;
+                int beforePrevious = (inserted + count - 2) % count;
+                int next = (inserted + 1) % count;
+                int afterNext = (inserted + 2) % count;
+
+                int dent = -1;
+                if ((polytope[previous].point - polytope[beforePrevious].point)
+                        .crossProduct(polytope[inserted].point - polytope[previous].point) <= 0.0f)
+                    dent = previous;
+                else if ((polytope[next].point - polytope[inserted].point)
+                             .crossProduct(polytope[afterNext].point - polytope[next].point) <= 0.0f)
+                    dent = next;
+
+                if (dent < 0)
+                    break;
+
+                std::copy(polytope + dent + 1, polytope + count, polytope + dent);
+                std::copy(edgeNormals + dent + 1, edgeNormals + count, edgeNormals + dent);
+                std::copy(edgeDistances + dent + 1, edgeDistances + count, edgeDistances + dent);
+                count--;
+
+                if (dent < inserted)
+                    inserted--;
             }
+
+            //Only the two edges meeting at the new vertex changed
+            updateEdge((inserted + count - 1) % count);
+            updateEdge(inserted);
+        }
+
+        Simplex start;
+        start.vertices[0] = polytope[face];
+        start.vertices[1] = polytope[(face + 1) % count];
+        start.vertices[2] = findDifferenceSupport(shapeA, shapeB, -normal);
+        start.count = 3;
+
+        for (int i = 0; i < 2; i++)
+        {
+            if (start.vertices[i].indexA == start.vertices[2].indexA &&
+                start.vertices[i].indexB == start.vertices[2].indexB)
+                start.count = 2;
+        }
+
+        writeSimplexCache(start, cache);
+
+        return true;
+    }
+
+    //Returns the edge of a core with at least two vertices facing most against a normal
+    static int findIncidentEdge(const ConvexPolygon& core, const Vector2& normal)
+    {
+        int incidentEdge = 0;
+        float minAlignment = std::numeric_limits<float>::infinity();
+
+        for (int i = 0; i < core.count; i++)
+        {
+            float alignment = core.normals[i].projectOntoAxis(normal);
+            if (alignment < minAlignment)
+            {
+                minAlignment = alignment;
+                incidentEdge = i;
+            }
+        }
+
+        return incidentEdge;
+    }
+
+    //Clips the incident core's edge most facing against a face of the reference core to the sides of that face
+    //Points within both radii of the face are kept, halfway between the rounded surfaces
+    static void clipRoundedContactPoints(const SupportShape& reference,
+        int edge,
+        const SupportShape& incident,
+        std::vector<Vector2>& contactPoints)
+    {
+        const Vector2& normal = reference.core.normals[edge];
+        Vector2 segment[2] = {incident.core.vertices[0], incident.core.vertices[0]};
+
+        if (incident.core.count >= 2)
+        {
+            int incidentEdge = findIncidentEdge(incident.core, normal);
+            segment[0] = incident.core.vertices[incidentEdge];
+            segment[1] = incident.core.vertices[(incidentEdge + 1) % incident.core.count];
+        }
+
+        const Vector2& faceStart = reference.core.vertices[edge];
+        const Vector2& faceEnd = reference.core.vertices[(edge + 1) % reference.core.count];
+        Vector2 tangent = (faceEnd - faceStart).getNormal();
+
+        if (!clipSegmentToLine(segment, -tangent, -faceStart.projectOntoAxis(tangent)) ||
+            !clipSegmentToLine(segment, tangent, faceEnd.projectOntoAxis(tangent)))
+            return;
+
+        float faceOffset = faceStart.projectOntoAxis(normal);
+        float reach = reference.radius + incident.radius;
+        int pointCount = incident.core.count >= 2 ? 2 : 1;
+
+        for (int i = 0; i < pointCount; i++)
+        {
+            float separation = segment[i].projectOntoAxis(normal) - faceOffset;
+            if (separation <= reach)
+                contactPoints.push_back(
+                    segment[i] - normal * ((separation + incident.radius - reference.radius) / 2.0f));
+        }
+    }
+
+    //Returns how far core A reaches past core B along a normal pointing from A to B
+    static float findCoreOverlap(const SupportShape& shapeA, const SupportShape& shapeB, const Vector2& normal)
+    {
+        const Vector2& deepestA = shapeA.core.vertices[CollisionDetection::findSupportVertex(shapeA.core, normal)];
+        const Vector2& deepestB = shapeB.core.vertices[CollisionDetection::findSupportVertex(shapeB.core, -normal)];
+
+        return (deepestA - deepestB).projectOntoAxis(normal);
+    }
+
+    //Finds the face of a core most facing along a normal
+    //Returns the alignment of the face's normal with the normal, lower than -1 when the core has no faces
+    static float findFacingEdge(const ConvexPolygon& core, const Vector2& normal, int& edge)
+    {
+        float maxAlignment = -2.0f;
+        edge = 0;
+
+        for (int i = 0; core.count >= 2 && i < core.count; i++)
+        {
+            float alignment = core.normals[i].projectOntoAxis(normal);
+            if (alignment > maxAlignment)
+            {
+                maxAlignment = alignment;
+                edge = i;
+            }
+        }
+
+        return maxAlignment;
+    }
+
+    bool CollisionDetection::shouldCollide(Collider* colliderA, Collider* colliderB)
+    {
+        //Get layers and masks
+        const std::vector<unsigned int>& aLayers = colliderA->getCollisionLayers();
+        const std::vector<unsigned int>& aMasks = colliderA->getCollisionMasks();
+
+        const std::vector<unsigned int>& bLayers = colliderB->getCollisionLayers();
+        const std::vector<unsigned int>& bMasks = colliderB->getCollisionMasks();
+
+        bool aWantsCollideB = false;
+
+        //Check if A wants to collide with B
+        for (unsigned int aMask : aMasks)
+        {
+            if (std::find(bLayers.begin(), bLayers.end(), aMask) != bLayers.end())
+            {
+                aWantsCollideB = true;
+                break;
+            }
+        }
+
+        //Return false if A does not mask one of B layers
+        if (!aWantsCollideB)
+            return false;
+
+        //Check if B wants to collide with A
+        for (unsigned int bMask : bMasks)
+        {
+            if (std::find(aLayers.begin(), aLayers.end(), bMask) != aLayers.end())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //Checks if two AABBs are overlapping
+    bool CollisionDetection::checkAABBvsAABB(const AABB& boxA, const AABB& boxB)
+    {
+        //Get mins and maxes
+        Vector2 minA = boxA.min;
+        Vector2 maxA = boxA.max;
+
+        Vector2 minB = boxB.min;
+        Vector2 maxB = boxB.max;
+
+        //Check for overlap
+        if (maxA.x > minB.x && minA.x < maxB.x && maxA.y > minB.y && minA.y < maxB.y)
+            return true;
+
+        //No overlap
+        return false;
+    }
+
+    //Fills a convex polygon from a rectangle or polygon collider
+    bool CollisionDetection::makeConvexPolygon(const Collider* collider, ConvexPolygon& polygon)
+    {
+        ColliderShape shape = collider->getShape();
+
+        if (shape == ColliderShape::Rectangle)
+        {
+            const RectCollider* rect = static_cast<const RectCollider*>(collider);
+
+            float cos = std::cos(rect->getRotation());
+            float sin = std::sin(rect->getRotation());
+            Vector2 halfWidth = Vector2(cos, sin) * (rect->getWidth() / 2.0f);
+            Vector2 halfHeight = Vector2(-sin, cos) * (rect->getHeight() / 2.0f);
+            const Vector2& center = rect->getPosition();
+
+            polygon.count = 4;
+            polygon.vertices[0] = center - halfWidth - halfHeight;
+            polygon.vertices[1] = center + halfWidth - halfHeight;
+            polygon.vertices[2] = center + halfWidth + halfHeight;
+            polygon.vertices[3] = center - halfWidth + halfHeight;
+            polygon.normals[0] = {sin, -cos};
+            polygon.normals[1] = {cos, sin};
+            polygon.normals[2] = {-sin, cos};
+            polygon.normals[3] = {-cos, -sin};
+
+            return true;
+        }
+
+        else if (shape == ColliderShape::Polygon)
+        {
+            const PolygonCollider* polygonCollider = static_cast<const PolygonCollider*>(collider);
+
+            polygon.count = polygonCollider->getVertexCount();
+            std::copy(polygonCollider->getVertices(), polygonCollider->getVertices() + polygon.count, polygon.vertices);
+            std::copy(polygonCollider->getNormals(), polygonCollider->getNormals() + polygon.count, polygon.normals);
+
+            return polygon.count >= 3;
+        }
+
+        return false;
+    }
+
+    //Fills a support shape from a circle, capsule, rectangle or polygon collider, returns false for other shapes
+    bool CollisionDetection::makeSupportShape(const Collider* collider, SupportShape& shape)
+    {
+        ColliderShape colliderShape = collider->getShape();
+        shape.radius = 0.0f;
+
+        if (colliderShape == ColliderShape::Circle)
+        {
+            const CircleCollider* circle = static_cast<const CircleCollider*>(collider);
+
+            shape.core.count = 1;
+            shape.core.vertices[0] = circle->getPosition();
+            shape.radius = circle->getRadius();
+
+            return true;
+        }
+
+        else if (colliderShape == ColliderShape::Capsule)
+        {
+            const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+            Vector2 axis = capsule->getPointB() - capsule->getPointA();
+
+            shape.core.count = 1;
+            shape.core.vertices[0] = capsule->getPointA();
+            shape.radius = capsule->getRadius();
+
+            //A capsule without length is a circle
+            if (axis.getSquare() == 0.0f)
+                return true;
+
+            //Both sides of the segment are faces, as for a polygon with two vertices
+            Vector2 tangent = axis.getNormal();
+            shape.core.count = 2;
+            shape.core.vertices[1] = capsule->getPointB();
+            shape.core.normals[0] = {tangent.y, -tangent.x};
+            shape.core.normals[1] = {-tangent.y, tangent.x};
+
+            return true;
+        }
+
+        return makeConvexPolygon(collider, shape.core);
+    }
+
+    //Returns the index of the core vertex furthest along a direction
+    int CollisionDetection::findSupportVertex(const ConvexPolygon& core, const Vector2& direction)
+    {
+        int support = 0;
+        float maxProjection = core.vertices[0].projectOntoAxis(direction);
+
+        for (int i = 1; i < core.count; i++)
+        {
+            float projection = core.vertices[i].projectOntoAxis(direction);
+            if (projection > maxProjection)
+            {
+                maxProjection = projection;
+                support = i;
+            }
+        }
+
+        return support;
+    }
+
+    //Finds the closest points between the cores of two support shapes with GJK, starting from a cached simplex
+    float CollisionDetection::findCoreDistance(
+        const SupportShape& shapeA, const SupportShape& shapeB, SimplexCache& cache, Vector2& pointA, Vector2& pointB)
+    {
+        Simplex simplex;
+        cache.iterations = runGJK(shapeA, shapeB, cache, simplex);
+        writeSimplexCache(simplex, cache);
+
+        findSimplexPoints(shapeA, shapeB, simplex, pointA, pointB);
+
+        return simplex.count == 3 ? 0.0f : (pointB - pointA).getLength();
+    }
+
+    //Calculate collision between any two circles, capsules, rectangles or polygons
+    Collision* CollisionDetection::checkConvexCollision(Collider* colliderA, Collider* colliderB, SimplexCache* cache)
+    {
+        SupportShape shapeA;
+        SupportShape shapeB;
+
+        if (!makeSupportShape(colliderA, shapeA) || !makeSupportShape(colliderB, shapeB))
+            return nullptr;
+
+        SimplexCache localCache;
+        SimplexCache& simplexCache = cache ? *cache : localCache;
+
+        Simplex simplex;
+        simplexCache.iterations = runGJK(shapeA, shapeB, simplexCache, simplex);
+        writeSimplexCache(simplex, simplexCache);
+
+        Vector2 pointA;
+        Vector2 pointB;
+        findSimplexPoints(shapeA, shapeB, simplex, pointA, pointB);
+
+        float reach = shapeA.radius + shapeB.radius;
+        float distance = simplex.count == 3 ? 0.0f : (pointB - pointA).getLength();
+
+        if (distance > reach)
+            return nullptr;
+
+        //Cores closer than this count as overlapping, the direction between their closest points is mostly rounding
+        const float TOUCH_DISTANCE = 0.0001f;
+
+        Vector2 normal;
+        float penDepth;
+        std::vector<Vector2> contactPoints;
+
+        if (distance > TOUCH_DISTANCE)
+        {
+            //Cores are apart and only their rounding overlaps, along the line between their closest points
+            normal = (pointB - pointA) / distance;
+            penDepth = reach - distance;
+
+            //Features lying along each other touch along a segment, clip them into two points so the bodies rest flat
+            int edgeA;
+            int edgeB;
+            float alignmentA = findFacingEdge(shapeA.core, normal, edgeA);
+            float alignmentB = findFacingEdge(shapeB.core, -normal, edgeB);
+
+            bool referenceOnB = alignmentB > alignmentA;
+            int edge = referenceOnB ? edgeB : edgeA;
+            const SupportShape& reference = referenceOnB ? shapeB : shapeA;
+            const SupportShape& incident = referenceOnB ? shapeA : shapeB;
+
+            if (std::max(alignmentA, alignmentB) >= -1.0f && incident.core.count >= 2)
+            {
+                const Vector2& faceNormal = reference.core.normals[edge];
+                const Vector2& incidentNormal = incident.core.normals[findIncidentEdge(incident.core, faceNormal)];
+
+                if (std::abs(faceNormal.crossProduct(normal)) < PARALLEL_TOLERANCE &&
+                    std::abs(faceNormal.crossProduct(incidentNormal)) < PARALLEL_TOLERANCE)
+                    clipRoundedContactPoints(reference, edge, incident, contactPoints);
+            }
+
+            //Rounded end or corner against a feature, one point halfway between the surfaces
+            if (contactPoints.empty())
+                contactPoints.push_back((pointA + normal * shapeA.radius + pointB - normal * shapeB.radius) / 2.0f);
+        }
+        else
+        {
+            //Cores overlap, every face of their difference lies along a face of one of them,
+            //so the face EPA finds is snapped to that core face and the depth measured along it exactly
+            Vector2 differenceNormal;
+            Vector2 approximate = {0.0f, 1.0f};
+
+            if (runEPA(shapeA, shapeB, simplex, differenceNormal, simplexCache))
+                approximate = -differenceNormal;
+
+            int edgeA;
+            int edgeB;
+            float alignmentA = findFacingEdge(shapeA.core, approximate, edgeA);
+            float alignmentB = findFacingEdge(shapeB.core, -approximate, edgeB);
+
+            //Both cores may have a face along the normal, or nearly so, measure the depth along each
+            //and prefer the face of A unless B's is clearly shallower, as for polygon pairs
+            const float FACE_TOLERANCE = 0.0005f;
+            float minAlignment = std::max(alignmentA, alignmentB) - PARALLEL_TOLERANCE * PARALLEL_TOLERANCE;
+
+            float depthA = std::numeric_limits<float>::infinity();
+            float depthB = std::numeric_limits<float>::infinity();
+
+            if (alignmentA >= -1.0f && alignmentA >= minAlignment)
+                depthA = findCoreOverlap(shapeA, shapeB, shapeA.core.normals[edgeA]);
+            if (alignmentB >= -1.0f && alignmentB >= minAlignment)
+                depthB = findCoreOverlap(shapeA, shapeB, -shapeB.core.normals[edgeB]);
+
+            bool hasFace = depthA < std::numeric_limits<float>::infinity() ||
+                           depthB < std::numeric_limits<float>::infinity();
+            bool referenceOnB = depthB + FACE_TOLERANCE < depthA;
+
+            //Two points have no faces, as for circles on the same center
+            if (!hasFace)
+            {
+                normal = approximate;
+                penDepth = findCoreOverlap(shapeA, shapeB, normal) + reach;
+            }
+            else
+            {
+                normal = referenceOnB ? -shapeB.core.normals[edgeB] : shapeA.core.normals[edgeA];
+                penDepth = (referenceOnB ? depthB : depthA) + reach;
+            }
+
+            if (penDepth < 0.0f)
+                return nullptr;
+
+            if (hasFace)
+            {
+                if (referenceOnB)
+                    clipRoundedContactPoints(shapeB, edgeB, shapeA, contactPoints);
+                else
+                    clipRoundedContactPoints(shapeA, edgeA, shapeB, contactPoints);
+            }
+
+            //Rounding can clip away every point of a barely touching feature, use the deepest point of B
+            if (contactPoints.empty())
+            {
+                const Vector2& deepestB = shapeB.core.vertices[findSupportVertex(shapeB.core, -normal)];
+                contactPoints.push_back(deepestB - normal * shapeB.radius + normal * (penDepth / 2.0f));
+            }
+        }
+
+        //Normal points from collider A to collider B
+        int contactCount = contactPoints.size();
+        return new Collision(
+            colliderA->getParent(), colliderB->getParent(), normal, penDepth, contactPoints, contactCount);
+    }
+
+    //Checks if two polygons are intersecting using seperating axis theorem
+    Collision* CollisionDetection::checkPolygonCollision(Collider* polygonA, Collider* polygonB)
+    {
+        ConvexPolygon shapeA;
+        ConvexPolygon shapeB;
+
+        if (!makeConvexPolygon(polygonA, shapeA) || !makeConvexPolygon(polygonB, shapeB))
+            return nullptr;
+
+        //Check against normals of polygon A, then polygon B, stopping at the first separating axis
+        int edgeA;
+        float separationA = findMaxSeparation(shapeA, shapeB, edgeA);
+        if (separationA > 0.0f)
+            return nullptr;
+
+        int edgeB;
+        float separationB = findMaxSeparation(shapeB, shapeA, edgeB);
+        if (separationB > 0.0f)
+            return nullptr;
+
+        //Prefer the face of polygon A unless B's is clearly shallower, so the reference face does not flip every frame
+        const float FACE_TOLERANCE = 0.0005f;
+
+        Vector2 normal;
+        float penDepth;
+        std::vector<Vector2> contactPoints;
+
+        if (separationB > separationA + FACE_TOLERANCE)
+        {
+            findPolygonContactPoints(shapeB, edgeB, shapeA, contactPoints);
+            normal = -shapeB.normals[edgeB];
+            penDepth = -separationB;
+        }
+        else
+        {
+            findPolygonContactPoints(shapeA, edgeA, shapeB, contactPoints);
+            normal = shapeA.normals[edgeA];
+            penDepth = -separationA;
+        }
+
+        //Rounding can clip away both points of a barely touching edge
+        if (contactPoints.empty())
+            return nullptr;
+
+        //Return collision object with data if collision was found
+        int contactCount = contactPoints.size();
+        return new Collision(
+            polygonA->getParent(), polygonB->getParent(), normal, penDepth, contactPoints, contactCount);
+    }
+
+    //Checks if circle and polygon are intersecting
+    Collision* CollisionDetection::checkCirclePolygonCollision(CircleCollider* circle, Collider* polygon)
+    {
+        ConvexPolygon shape;
+        if (!makeConvexPolygon(polygon, shape))
+            return nullptr;
+
+        Vector2 center = circle->getPosition();
+        float radius = circle->getRadius();
+
+        Vector2 closest;
+        Vector2 outward;
+        float distance = findClosestPointOnPolygon(shape, center, closest, outward);
+
+        if (distance > radius)
+            return nullptr;
+
+        //Normal points from circle to polygon, against the polygon's outward normal
+        std::vector<Vector2> contactPoints = {closest};
+        return new Collision(circle->getParent(), polygon->getParent(), -outward, radius - distance, contactPoints, 1);
+    }
+
+    //Checks if two capsules are intersecting from the closest points of their segments
+    Collision* CollisionDetection::checkCapsuleCollision(CapsuleCollider* capsuleA, CapsuleCollider* capsuleB)
+    {
+        const Vector2& startA = capsuleA->getPointA();
+        const Vector2& endA = capsuleA->getPointB();
+        const Vector2& startB = capsuleB->getPointA();
+        const Vector2& endB = capsuleB->getPointB();
+
+        float radiusA = capsuleA->getRadius();
+        float radiusB = capsuleB->getRadius();
+        float sumRadii = radiusA + radiusB;
+
+        Vector2 closestA;
+        Vector2 closestB;
+        float distanceSquared = findClosestPointsOnSegments(startA, endA, startB, endB, closestA, closestB);
+
+        if (distanceSquared > sumRadii * sumRadii)
+            return nullptr;
+
+        float distance = std::sqrt(distanceSquared);
+        Vector2 axisA = endA - startA;
+        Vector2 axisB = endB - startB;
+        Vector2 normal;
+        float penDepth = sumRadii - distance;
+
+        //Closest points of crossing segments only differ by rounding, so test the crossing directly
+        bool crossing = axisA.crossProduct(startB - startA) * axisA.crossProduct(endB - startA) < 0.0f &&
+                        axisB.crossProduct(startA - startB) * axisB.crossProduct(endA - startB) < 0.0f;
+
+        if (distance > 0.0f && !crossing)
+            normal = (closestB - closestA) / distance;
+        else
+        {
+            //Crossing segments have no direction between them, push B out along the side of either segment
+            //that needs the least movement, the sides bound the difference of the two segments
+            penDepth = std::numeric_limits<float>::infinity();
+            normal = {0.0f, 1.0f};
+
+            for (const Vector2& axis : {axisA, axisB})
+            {
+                if (axis.getSquare() == 0.0f)
+                    continue;
+
+                Vector2 side = Vector2(axis.y, -axis.x).getNormal();
+
+                for (float sign : {1.0f, -1.0f})
+                {
+                    Vector2 direction = side * sign;
+                    float reachA = std::max(startA.projectOntoAxis(direction), endA.projectOntoAxis(direction));
+                    float reachB = std::min(startB.projectOntoAxis(direction), endB.projectOntoAxis(direction));
+                    float depth = reachA - reachB + sumRadii;
+
+                    if (depth < penDepth)
+                    {
+                        penDepth = depth;
+                        normal = direction;
+                    }
+                }
+            }
+
+            //Both capsules are circles on the same point
+            if (penDepth == std::numeric_limits<float>::infinity())
+                penDepth = sumRadii;
+        }
+
+        std::vector<Vector2> contactPoints;
+
+        //Segments lying side by side touch along the overlap of their lengths, clip B's segment to A's ends
+        if (!crossing && distance > 0.0f && axisA.getSquare() > 0.0f && axisB.getSquare() > 0.0f &&
+            std::abs(axisA.getNormal().crossProduct(axisB.getNormal())) < PARALLEL_TOLERANCE)
+        {
+            Vector2 tangent = axisA.getNormal();
+            Vector2 segment[2] = {startB, endB};
+
+            if (clipSegmentToLine(segment, -tangent, -startA.projectOntoAxis(tangent)) &&
+                clipSegmentToLine(segment, tangent, endA.projectOntoAxis(tangent)))
+            {
+                //Points halfway between the surfaces
+                for (const Vector2& point : segment)
+                {
+                    float separation = (point - startA).projectOntoAxis(normal);
+                    if (separation <= sumRadii)
+                        contactPoints.push_back(point - normal * ((separation - radiusA + radiusB) / 2.0f));
+                }
+            }
+        }
+
+        if (contactPoints.empty())
+            contactPoints.push_back((closestA + normal * radiusA + closestB - normal * radiusB) / 2.0f);
+
+        int contactCount = contactPoints.size();
+        return new Collision(
+            capsuleA->getParent(), capsuleB->getParent(), normal, penDepth, contactPoints, contactCount);
+    }
+
+    //Checks if a capsule and a circle are intersecting from the closest point of the segment to the center
+    Collision* CollisionDetection::checkCapsuleCircleCollision(CapsuleCollider* capsule, CircleCollider* circle)
+    {
+        const Vector2& start = capsule->getPointA();
+        const Vector2& end = capsule->getPointB();
+        Vector2 center = circle->getPosition();
+
+        float sumRadii = capsule->getRadius() + circle->getRadius();
+
+        Vector2 axis = end - start;
+        Vector2 closest = axis.getSquare() > 0.0f ? findClosestPointOnSegment(center, start, end) : start;
+        Vector2 offset = center - closest;
+        float distanceSquared = offset.getSquare();
+
+        if (distanceSquared > sumRadii * sumRadii)
+            return nullptr;
+
+        //Center on the segment, push the circle out along the capsule's side
+        float distance = std::sqrt(distanceSquared);
+        Vector2 normal;
+
+        if (distance > 0.0f)
+            normal = offset / distance;
+        else if (axis.getSquare() > 0.0f)
+            normal = Vector2(axis.y, -axis.x).getNormal();
+        else
+            normal = {0.0f, 1.0f};
+
+        //Normal points from capsule to circle
+        std::vector<Vector2> contactPoints = {closest + normal * capsule->getRadius()};
+        return new Collision(
+            capsule->getParent(), circle->getParent(), normal, sumRadii - distance, contactPoints, 1);
+    }
+
+    //Checks if a capsule and a rectangle or polygon are intersecting
+    //The segment is a two vertex polygon with a face on either side, tested against the polygon's faces like SAT
+    Collision* CollisionDetection::checkCapsulePolygonCollision(CapsuleCollider* capsule, Collider* polygon)
+    {
+        ConvexPolygon shape;
+        if (!makeConvexPolygon(polygon, shape))
+            return nullptr;
+
+        const Vector2 segment[2] = {capsule->getPointA(), capsule->getPointB()};
+        float radius = capsule->getRadius();
+
+        //Polygon face the segment lies furthest in front of
+        int edge = 0;
+        float faceSeparation = -std::numeric_limits<float>::infinity();
+
+        for (int i = 0; i < shape.count; i++)
+        {
+            const Vector2& faceNormal = shape.normals[i];
+            float separation = std::min((segment[0] - shape.vertices[i]).projectOntoAxis(faceNormal),
+                (segment[1] - shape.vertices[i]).projectOntoAxis(faceNormal));
+
+            if (separation > faceSeparation)
+            {
+                faceSeparation = separation;
+                edge = i;
+            }
+
+            //Too far in front of a face for the radius to reach
+            if (faceSeparation > radius)
+                return nullptr;
+        }
+
+        //Side of the segment the polygon lies furthest in front of, a capsule without length has no sides
+        Vector2 axis = segment[1] - segment[0];
+        Vector2 tangent;
+        Vector2 sideNormal;
+        float sideSeparation = -std::numeric_limits<float>::infinity();
+
+        if (axis.getSquare() > 0.0f)
+        {
+            tangent = axis.getNormal();
+
+            for (int side = 0; side < 2; side++)
+            {
+                Vector2 normal = side == 0 ? Vector2(tangent.y, -tangent.x) : Vector2(-tangent.y, tangent.x);
+
+                float separation = std::numeric_limits<float>::infinity();
+                for (int i = 0; i < shape.count; i++)
+                    separation = std::min(separation, (shape.vertices[i] - segment[0]).projectOntoAxis(normal));
+
+                if (separation > sideSeparation)
+                {
+                    sideSeparation = separation;
+                    sideNormal = normal;
+                }
+            }
+
+            if (sideSeparation > radius)
+                return nullptr;
+        }
+
+        //Prefer the polygon's face so the reference does not flip every frame, as for polygon pairs
+        const float FACE_TOLERANCE = 0.0005f;
+        bool faceReference = faceSeparation + FACE_TOLERANCE >= sideSeparation;
+
+        //Edge of the polygon facing most against the capsule's side
+        int incidentEdge = 0;
+        if (!faceReference)
+        {
+            float minAlignment = std::numeric_limits<float>::infinity();
+
+            for (int i = 0; i < shape.count; i++)
+            {
+                float alignment = shape.normals[i].projectOntoAxis(sideNormal);
+                if (alignment < minAlignment)
+                {
+                    minAlignment = alignment;
+                    incidentEdge = i;
+                }
+            }
+        }
+
+        //Segment and polygon cores are apart, the rounding reaches across only near the closest features
+        bool separated = std::max(faceSeparation, sideSeparation) > 0.0f;
+        Vector2 onSegment;
+        Vector2 onPolygon;
+        float distance = 0.0f;
+
+        if (separated)
+        {
+            distance = findSegmentPolygonDistance(segment[0], segment[1], shape, onSegment, onPolygon);
+            if (distance > radius)
+                return nullptr;
+        }
+
+        //Clipping finds the two points of a capsule lying along a face, or of a face lying along the capsule
+        bool parallel =
+            axis.getSquare() > 0.0f &&
+            std::abs((faceReference ? shape.normals[edge] : shape.normals[incidentEdge]).projectOntoAxis(tangent)) <
+                PARALLEL_TOLERANCE;
+
+        Vector2 normal;
+        float penDepth;
+        std::vector<Vector2> contactPoints;
+
+        if (!separated || parallel)
+        {
+            if (faceReference)
+            {
+                //Cut the segment off at both sides of the face, keep points within the radius of it
+                const Vector2& faceNormal = shape.normals[edge];
+                const Vector2& faceStart = shape.vertices[edge];
+                const Vector2& faceEnd = shape.vertices[(edge + 1) % shape.count];
+                Vector2 faceTangent = (faceEnd - faceStart).getNormal();
+                Vector2 clipped[2] = {segment[0], segment[1]};
+
+                normal = -faceNormal;
+                penDepth = radius - faceSeparation;
+
+                if (clipSegmentToLine(clipped, -faceTangent, -faceStart.projectOntoAxis(faceTangent)) &&
+                    clipSegmentToLine(clipped, faceTangent, faceEnd.projectOntoAxis(faceTangent)))
+                {
+                    for (const Vector2& point : clipped)
+                    {
+                        float separation = (point - faceStart).projectOntoAxis(faceNormal);
+                        if (separation <= radius)
+                            contactPoints.push_back(point - faceNormal * ((separation + radius) / 2.0f));
+                    }
+                }
+            }
+            else
+            {
+                //Cut the polygon's incident edge off at both ends of the segment, keep points within the radius
+                Vector2 clipped[2] = {
+                    shape.vertices[incidentEdge], shape.vertices[(incidentEdge + 1) % shape.count]};
+
+                normal = sideNormal;
+                penDepth = radius - sideSeparation;
+
+                if (clipSegmentToLine(clipped, -tangent, -segment[0].projectOntoAxis(tangent)) &&
+                    clipSegmentToLine(clipped, tangent, segment[1].projectOntoAxis(tangent)))
+                {
+                    for (const Vector2& point : clipped)
+                    {
+                        float separation = (point - segment[0]).projectOntoAxis(sideNormal);
+                        if (separation <= radius)
+                            contactPoints.push_back(point - sideNormal * ((separation - radius) / 2.0f));
+                    }
+                }
+            }
+        }
+
+        //Rounded end or corner against a feature, one point halfway between the surfaces
+        if (contactPoints.empty())
+        {
+            if (!separated)
+                return nullptr;
+
+            normal = distance > 0.0f ? (onPolygon - onSegment) / distance : -shape.normals[edge];
+            penDepth = radius - distance;
+            contactPoints.push_back((onSegment + normal * radius + onPolygon) / 2.0f);
+        }
+
+        //Normal points from capsule to polygon
+        int contactCount = contactPoints.size();
+        return new Collision(
+            capsule->getParent(), polygon->getParent(), normal, penDepth, contactPoints, contactCount);
+    }
+
+    //Adds the collisions between a chain and a collider, one for each touching segment near it
+    void CollisionDetection::checkChainCollision(
+        ChainCollider* chain, Collider* collider, std::vector<Collision*>& collisions)
+    {
+        if (collider->getShape() == ColliderShape::Chain || collider->getShape() == ColliderShape::TileMap)
+            return;
+
+        chain->querySegments(collider->getAABB(),
+            [chain, collider, &collisions](int segment)
+            {
+                Collision* collision = checkChainSegmentCollision(chain, segment, collider);
+                if (collision)
+                    collisions.push_back(collision);
+
+                return true;
+            });
+    }
+
+    //Makes a rectangle covering a box in a tile map's space, belonging to the tile map's body
+    static RectCollider makeTileRect(const TileMapCollider* map, const AABB& localBounds)
+    {
+        RectCollider rect(localBounds.max - localBounds.min, ColliderType::Solid);
+        rect.setParent(map->getParent());
+        rect.setTransform(map->getPosition() + map->toWorldDirection((localBounds.min + localBounds.max) / 2.0f),
+            map->getRotation());
+
+        return rect;
+    }
+
+    //Adds the collisions between a tile map and a collider, one for each box of solid tiles under it
+    void CollisionDetection::checkTileMapCollision(
+        TileMapCollider* map, Collider* collider, std::vector<Collision*>& collisions)
+    {
+        if (collider->getShape() == ColliderShape::Chain || collider->getShape() == ColliderShape::TileMap)
+            return;
+
+        //Growing a box through a face by more than the collider's size means it can never be pushed out that way
+        const AABB& region = collider->getAABB();
+        float growth = (region.max.x - region.min.x) + (region.max.y - region.min.y) + map->getTileSize();
+
+        map->queryBoxes(region,
+            [map, collider, &region, growth, &collisions](const TileBox& box)
+            {
+                AABB bounds = map->getLocalBounds(box);
+
+                //Pushing the collider out through a face covered by other tiles would snag it on the seam,
+                //or push it further in, so the box is grown through that face as if joined to the tiles behind it
+                //A box covered on every side is left to the boxes around it
+                for (int attempt = 0; attempt < 4; attempt++)
+                {
+                    RectCollider tile = makeTileRect(map, bounds);
+                    Collision* collision = checkColliderCollision(&tile, collider);
+                    if (!collision)
+                        return true;
+
+                    //Some routines report the collider first, turn those to point from the tile map
+                    if (collision->bodyA != map->getParent())
+                    {
+                        std::swap(collision->bodyA, collision->bodyB);
+                        collision->normal = -collision->normal;
+                    }
+
+                    Vector2 localNormal = map->toLocalDirection(collision->normal);
+                    if (!map->isFaceCovered(box, localNormal, region))
+                    {
+                        collisions.push_back(collision);
+                        return true;
+                    }
+
+                    delete collision;
+
+                    bool alongX = std::abs(localNormal.x) >= std::abs(localNormal.y);
+                    if (alongX && localNormal.x > 0.0f)
+                        bounds.max.x += growth;
+                    else if (alongX)
+                        bounds.min.x -= growth;
+                    else if (localNormal.y > 0.0f)
+                        bounds.max.y += growth;
+                    else
+                        bounds.min.y -= growth;
+                }
+
+                return true;
+            });
+    }
+
+    //Checks if a collider touches the front of one segment of a chain
+    Collision* CollisionDetection::checkChainSegmentCollision(ChainCollider* chain, int segment, Collider* collider)
+    {
+        Vector2 start;
+        Vector2 end;
+        chain->getSegment(segment, start, end);
+
+        Vector2 tangent = (end - start).getNormal();
+        Vector2 faceNormal = {-tangent.y, tangent.x};
+
+        //One sided, bodies centered behind the segment pass through it
+        if ((collider->getPosition() - start).projectOntoAxis(faceNormal) < 0.0f)
+            return nullptr;
+
+        Vector2 startBound;
+        Vector2 endBound;
+        findSegmentNormalBounds(chain, segment, tangent, startBound, endBound);
+
+        ColliderShape shape = collider->getShape();
+        Vector2 normal = faceNormal;
+        float penDepth = 0.0f;
+        std::vector<Vector2> contactPoints;
+
+        //Circles and capsules are a point or a segment grown by a radius
+        if (shape == ColliderShape::Circle || shape == ColliderShape::Capsule)
+        {
+            Vector2 core[2];
+            int coreCount = 1;
+            float radius;
+
+            if (shape == ColliderShape::Circle)
+            {
+                core[0] = collider->getPosition();
+                core[1] = core[0];
+                radius = static_cast<CircleCollider*>(collider)->getRadius();
+            }
+            else
+            {
+                CapsuleCollider* capsule = static_cast<CapsuleCollider*>(collider);
+                core[0] = capsule->getPointA();
+                core[1] = capsule->getPointB();
+                coreCount = 2;
+                radius = capsule->getRadius();
+            }
+
+            Vector2 onSegment;
+            Vector2 onCore = core[0];
+            float distanceSquared;
+
+            if (coreCount == 1)
+            {
+                onSegment = findClosestPointOnSegment(core[0], start, end);
+                distanceSquared = (core[0] - onSegment).getSquare();
+            }
+            else
+                distanceSquared = findClosestPointsOnSegments(start, end, core[0], core[1], onSegment, onCore);
+
+            if (distanceSquared > radius * radius)
+                return nullptr;
+
+            //Closest to an end of the segment, the normal only turns around the corner as far as it is exposed
+            float along = (onSegment - start).projectOntoAxis(tangent);
+            float distance = std::sqrt(distanceSquared);
+            bool corner = distance > 0.0f && (along <= 0.0f || along >= (end - start).getLength());
+            Vector2 cornerNormal;
+
+            if (corner)
+            {
+                cornerNormal = (onCore - onSegment) / distance;
+
+                bool exposed = along <= 0.0f ? isNormalBetween(cornerNormal, startBound, faceNormal)
+                                             : isNormalBetween(cornerNormal, faceNormal, endBound);
+                if (!exposed)
+                    return nullptr;
+            }
+
+            //Against the face, the core cut off at the segment's ends with points within the radius kept
+            if (!corner || isNormalBetween(cornerNormal, faceNormal, faceNormal))
+            {
+                Vector2 clipped[2] = {core[0], core[1]};
+
+                if (clipSegmentToLine(clipped, -tangent, -start.projectOntoAxis(tangent)) &&
+                    clipSegmentToLine(clipped, tangent, end.projectOntoAxis(tangent)))
+                {
+                    for (int i = 0; i < coreCount; i++)
+                    {
+                        float separation = (clipped[i] - start).projectOntoAxis(faceNormal);
+                        if (separation <= radius)
+                        {
+                            penDepth = std::max(penDepth, radius - separation);
+                            contactPoints.push_back(clipped[i] - faceNormal * ((separation + radius) / 2.0f));
+                        }
+                    }
+                }
+            }
+
+            //Around the corner, one point halfway between the surfaces
+            if (contactPoints.empty())
+            {
+                if (!corner)
+                    return nullptr;
+
+                normal = cornerNormal;
+                penDepth = radius - distance;
+                contactPoints.push_back((onSegment + onCore - cornerNormal * radius) / 2.0f);
+            }
+        }
+
+        //Rectangles and polygons against the segment's front face and their own faces
+        else
+        {
+            ConvexPolygon polygon;
+            if (!makeConvexPolygon(collider, polygon))
+                return nullptr;
+
+            float faceSeparation = std::numeric_limits<float>::infinity();
+            for (int i = 0; i < polygon.count; i++)
+                faceSeparation = std::min(faceSeparation, (polygon.vertices[i] - start).projectOntoAxis(faceNormal));
+
+            if (faceSeparation > 0.0f)
+                return nullptr;
+
+            //A polygon face only becomes the reference where it pushes the polygon out around an exposed corner
+            int edge = -1;
+            float edgeSeparation = -std::numeric_limits<float>::infinity();
+
+            for (int i = 0; i < polygon.count; i++)
+            {
+                const Vector2& edgeNormal = polygon.normals[i];
+                float separation = std::min((start - polygon.vertices[i]).projectOntoAxis(edgeNormal),
+                    (end - polygon.vertices[i]).projectOntoAxis(edgeNormal));
+
+                if (separation > 0.0f)
+                    return nullptr;
+
+                if (separation > edgeSeparation && (isNormalBetween(-edgeNormal, startBound, faceNormal) ||
+                                                       isNormalBetween(-edgeNormal, faceNormal, endBound)))
+                {
+                    edgeSeparation = separation;
+                    edge = i;
+                }
+            }
+
+            //Prefer the segment's face so the reference does not flip every frame, as for polygon pairs
+            const float FACE_TOLERANCE = 0.0005f;
+
+            if (edge >= 0 && edgeSeparation > faceSeparation + FACE_TOLERANCE)
+            {
+                //Cut the segment off at both sides of the polygon's face, keep points behind it
+                const Vector2& edgeNormal = polygon.normals[edge];
+                const Vector2& edgeStart = polygon.vertices[edge];
+                const Vector2& edgeEnd = polygon.vertices[(edge + 1) % polygon.count];
+                Vector2 edgeTangent = (edgeEnd - edgeStart).getNormal();
+                Vector2 clipped[2] = {start, end};
+
+                normal = -edgeNormal;
+
+                if (clipSegmentToLine(clipped, -edgeTangent, -edgeStart.projectOntoAxis(edgeTangent)) &&
+                    clipSegmentToLine(clipped, edgeTangent, edgeEnd.projectOntoAxis(edgeTangent)))
+                {
+                    for (const Vector2& point : clipped)
+                    {
+                        float separation = (point - edgeStart).projectOntoAxis(edgeNormal);
+                        if (separation <= 0.0f)
+                        {
+                            penDepth = std::max(penDepth, -separation);
+                            contactPoints.push_back(point - edgeNormal * (separation / 2.0f));
+                        }
+                    }
+                }
+            }
+            else
+            {
+                //Cut the polygon's edge facing most against the segment off at the segment's ends
+                //Depth comes from the points kept, so parts of the polygon past a joint do not count
+                int incidentEdge = 0;
+                float minAlignment = std::numeric_limits<float>::infinity();
+
+                for (int i = 0; i < polygon.count; i++)
+                {
+                    float alignment = polygon.normals[i].projectOntoAxis(faceNormal);
+                    if (alignment < minAlignment)
+                    {
+                        minAlignment = alignment;
+                        incidentEdge = i;
+                    }
+                }
+
+                Vector2 clipped[2] = {
+                    polygon.vertices[incidentEdge], polygon.vertices[(incidentEdge + 1) % polygon.count]};
+
+                if (clipSegmentToLine(clipped, -tangent, -start.projectOntoAxis(tangent)) &&
+                    clipSegmentToLine(clipped, tangent, end.projectOntoAxis(tangent)))
+                {
+                    for (const Vector2& point : clipped)
+                    {
+                        float separation = (point - start).projectOntoAxis(faceNormal);
+                        if (separation <= 0.0f)
+                        {
+                            penDepth = std::max(penDepth, -separation);
+                            contactPoints.push_back(point - faceNormal * (separation / 2.0f));
+                        }
+                    }
+                }
+            }
+        }
+
+        if (contactPoints.empty())
+            return nullptr;
+
+        //Normal points from chain to collider
+        int contactCount = contactPoints.size();
+        return new Collision(chain->getParent(), collider->getParent(), normal, penDepth, contactPoints, contactCount);
+    }
+
+    //Returns the largest distance of polygon B in front of a face of polygon A
+    float CollisionDetection::findMaxSeparation(const ConvexPolygon& polygonA, const ConvexPolygon& polygonB, int& edge)
+    {
+        float maxSeparation = -std::numeric_limits<float>::infinity();
+        edge = 0;
+
+        for (int i = 0; i < polygonA.count; i++)
+        {
+            const Vector2& normal = polygonA.normals[i];
+            const Vector2& vertex = polygonA.vertices[i];
+
+            //Deepest vertex of B along the face normal
+            float separation = std::numeric_limits<float>::infinity();
+            for (int j = 0; j < polygonB.count; j++)
+                separation = std::min(separation, normal.projectOntoAxis(polygonB.vertices[j] - vertex));
+
+            if (separation > maxSeparation)
+            {
+                maxSeparation = separation;
+                edge = i;
+            }
+
+            //A separating axis, no need to check the rest
+            if (maxSeparation > 0.0f)
+                break;
+        }
+
+        return maxSeparation;
+    }
+
+    //Returns the min and max of verticies projected onto an axis in a Vector2 struct
+    const Projection CollisionDetection::projectPolygonOntoAxis(const Vector2* vertices, int count, const Vector2& axis)
+    {
+        float min = std::numeric_limits<float>::infinity();
+        float max = -std::numeric_limits<float>::infinity();
+
+        for (int i = 0; i < count; i++)
+        {
+            float projection = vertices[i].projectOntoAxis(axis);
+
+            if (projection < min)
+                min = projection;
+
+            if (projection > max)
+                max = projection;
+        }
+
+        return {min, max};
+    }
+
+    //Sorts into respective function based on body shapes
+    Collision* CollisionDetection::checkCollision(PhysicsBody* bodyA, PhysicsBody* bodyB)
+    {
+        //Get colliders
+        Collider* colliderA = bodyA->getCollider();
+        Collider* colliderB = bodyB->getCollider();
+
+        //Check if they should collide based on layers and masks
+        if (!shouldCollide(colliderA, colliderB))
+            return nullptr;
+
+        //Compounds, chains and tile maps may touch in several places
+        ColliderShape shapeA = colliderA->getShape();
+        ColliderShape shapeB = colliderB->getShape();
+        bool multipleA = shapeA == ColliderShape::Compound || shapeA == ColliderShape::Chain ||
+                         shapeA == ColliderShape::TileMap;
+        bool multipleB = shapeB == ColliderShape::Compound || shapeB == ColliderShape::Chain ||
+                         shapeB == ColliderShape::TileMap;
+
+        if (!multipleA && !multipleB)
+            return checkColliderCollision(colliderA, colliderB);
+
+        //Report the deepest of their collisions
+        std::vector<Collision*> collisions;
+        checkCompoundCollision(colliderA, colliderB, collisions);
+
+        Collision* deepest = nullptr;
+        for (Collision* collision : collisions)
+        {
+            if (!deepest || collision->penDepth > deepest->penDepth)
+                std::swap(deepest, collision);
+
+            delete collision;
+        }
+
+        return deepest;
+    }
+
+    //Adds every collision between two bodies, one for each touching pair of children of compounds
+    void CollisionDetection::checkCollisions(
+        PhysicsBody* bodyA, PhysicsBody* bodyB, std::vector<Collision*>& collisions, SimplexCacheTable* caches)
+    {
+        Collider* colliderA = bodyA->getCollider();
+        Collider* colliderB = bodyB->getCollider();
+
+        if (!shouldCollide(colliderA, colliderB))
+            return;
+
+        checkCompoundCollision(colliderA, colliderB, collisions, caches);
+    }
+
+    //Collides a convex pair whose simplex may be cached, with the cache passed along
+    typedef Collision* (*ConvexPairFunction)(Collider* colliderA, Collider* colliderB, SimplexCache* cache);
+
+    //Functions colliding each pair of shapes, indexed by the shapes of collider A and collider B
+    struct PairTables
+    {
+        CollisionDetection::PairFunction pairs[COLLIDER_SHAPE_COUNT][COLLIDER_SHAPE_COUNT];
+        ConvexPairFunction convexPairs[COLLIDER_SHAPE_COUNT][COLLIDER_SHAPE_COUNT];
+    };
+
+    //Circle pairs have a closed form that needs no iterations
+    static Collision* checkCirclePair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkCircleCollision(
+            static_cast<CircleCollider*>(colliderA), static_cast<CircleCollider*>(colliderB));
+    }
+
+    //Rectangles and polygons share one SAT routine
+    static Collision* checkPolygonPair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkPolygonCollision(colliderA, colliderB);
+    }
+
+    //Circle against a rectangle or polygon, the collision is reported from the circle
+    static Collision* checkCirclePolygonPair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkCirclePolygonCollision(static_cast<CircleCollider*>(colliderA), colliderB);
+    }
+
+    static Collision* checkPolygonCirclePair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkCirclePolygonCollision(static_cast<CircleCollider*>(colliderB), colliderA);
+    }
+
+    //Capsule pairs use the closest points of their segments
+    static Collision* checkCapsulePair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkCapsuleCollision(
+            static_cast<CapsuleCollider*>(colliderA), static_cast<CapsuleCollider*>(colliderB));
+    }
+
+    //Capsule against a circle, the collision is reported from the capsule
+    static Collision* checkCapsuleCirclePair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkCapsuleCircleCollision(
+            static_cast<CapsuleCollider*>(colliderA), static_cast<CircleCollider*>(colliderB));
+    }
+
+    static Collision* checkCircleCapsulePair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkCapsuleCircleCollision(
+            static_cast<CapsuleCollider*>(colliderB), static_cast<CircleCollider*>(colliderA));
+    }
+
+    //Capsule against a rectangle or polygon, the collision is reported from the capsule
+    static Collision* checkCapsulePolygonPair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkCapsulePolygonCollision(static_cast<CapsuleCollider*>(colliderA), colliderB);
+    }
+
+    static Collision* checkPolygonCapsulePair(Collider* colliderA, Collider* colliderB, SimplexCache*)
+    {
+        return CollisionDetection::checkCapsulePolygonCollision(static_cast<CapsuleCollider*>(colliderB), colliderA);
+    }
+
+    //Flips collisions added from collider B's side to point from collider A
+    static void flipCollisions(std::vector<Collision*>& collisions, size_t first)
+    {
+        for (size_t i = first; i < collisions.size(); i++)
+        {
+            std::swap(collisions[i]->bodyA, collisions[i]->bodyB);
+            collisions[i]->normal = -collisions[i]->normal;
+        }
+    }
+
+    //Collides the children of compound A near collider B
+    static void addCompoundACollisions(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable* caches)
+    {
+        static_cast<CompoundCollider*>(colliderA)->queryChildren(colliderB->getAABB(),
+            [colliderB, &collisions, caches](Collider* child)
+            {
+                CollisionDetection::checkCompoundCollision(child, colliderB, collisions, caches);
+                return true;
+            });
+    }
+
+    //Collides the children of compound B near collider A
+    static void addCompoundBCollisions(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable* caches)
+    {
+        static_cast<CompoundCollider*>(colliderB)->queryChildren(colliderA->getAABB(),
+            [colliderA, &collisions, caches](Collider* child)
+            {
+                CollisionDetection::checkCompoundCollision(colliderA, child, collisions, caches);
+                return true;
+            });
+    }
+
+    //Collides the segments of chain A near collider B
+    static void addChainACollisions(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable*)
+    {
+        CollisionDetection::checkChainCollision(static_cast<ChainCollider*>(colliderA), colliderB, collisions);
+    }
+
+    //Collides the segments of chain B near collider A, chain collisions point from the chain so they are flipped
+    static void addChainBCollisions(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable*)
+    {
+        size_t first = collisions.size();
+        CollisionDetection::checkChainCollision(static_cast<ChainCollider*>(colliderB), colliderA, collisions);
+        flipCollisions(collisions, first);
+    }
+
+    //Collides the tiles of tile map A under collider B
+    static void addTileMapACollisions(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable*)
+    {
+        CollisionDetection::checkTileMapCollision(static_cast<TileMapCollider*>(colliderA), colliderB, collisions);
+    }
+
+    //Collides the tiles of tile map B under collider A, tile map collisions point from the map so they are flipped
+    static void addTileMapBCollisions(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable*)
+    {
+        size_t first = collisions.size();
+        CollisionDetection::checkTileMapCollision(static_cast<TileMapCollider*>(colliderB), colliderA, collisions);
+        flipCollisions(collisions, first);
+    }
+
+    //Collides two convex colliders with the routine registered for their shapes
+    static void addConvexCollisions(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable*)
+    {
+        Collision* collision = CollisionDetection::checkColliderCollision(colliderA, colliderB);
+        if (collision)
+            collisions.push_back(collision);
+    }
+
+    //Collides two convex colliders with GJK and EPA, keeping their simplex in the cache table when one is given
+    static void addCachedConvexCollisions(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable* caches)
+    {
+        //Children of compounds are owned by them, so their pairs are as lasting as the bodies'
+        SimplexCache* cache = caches ? caches->find(colliderA, colliderB) : nullptr;
+
+        Collision* collision = CollisionDetection::checkConvexCollision(colliderA, colliderB, cache);
+        if (collision)
+            collisions.push_back(collision);
+    }
+
+    //Fills the tables once, in the order the shapes take precedence
+    //Compounds descend first so their children meet chains and tile maps, then chains, then tile maps
+    //Convex pairs with a specialised routine use it, the rest fall back to GJK and EPA
+    static PairTables makePairTables()
+    {
+        PairTables tables;
+
+        for (int a = 0; a < COLLIDER_SHAPE_COUNT; a++)
+        {
+            for (int b = 0; b < COLLIDER_SHAPE_COUNT; b++)
+                tables.convexPairs[a][b] = CollisionDetection::checkConvexCollision;
+        }
+
+        const int circle = static_cast<int>(ColliderShape::Circle);
+        const int capsule = static_cast<int>(ColliderShape::Capsule);
+        const int polygons[2] = {static_cast<int>(ColliderShape::Rectangle), static_cast<int>(ColliderShape::Polygon)};
+
+        tables.convexPairs[circle][circle] = checkCirclePair;
+        tables.convexPairs[capsule][capsule] = checkCapsulePair;
+        tables.convexPairs[capsule][circle] = checkCapsuleCirclePair;
+        tables.convexPairs[circle][capsule] = checkCircleCapsulePair;
+
+        for (int polygonA : polygons)
+        {
+            for (int polygonB : polygons)
+                tables.convexPairs[polygonA][polygonB] = checkPolygonPair;
+
+            tables.convexPairs[circle][polygonA] = checkCirclePolygonPair;
+            tables.convexPairs[polygonA][circle] = checkPolygonCirclePair;
+            tables.convexPairs[capsule][polygonA] = checkCapsulePolygonPair;
+            tables.convexPairs[polygonA][capsule] = checkPolygonCapsulePair;
+        }
+
+        for (int a = 0; a < COLLIDER_SHAPE_COUNT; a++)
+        {
+            for (int b = 0; b < COLLIDER_SHAPE_COUNT; b++)
+            {
+                ColliderShape shapeA = static_cast<ColliderShape>(a);
+                ColliderShape shapeB = static_cast<ColliderShape>(b);
+
+                CollisionDetection::PairFunction& pair = tables.pairs[a][b];
+
+                if (shapeA == ColliderShape::Compound)
+                    pair = addCompoundACollisions;
+                else if (shapeB == ColliderShape::Compound)
+                    pair = addCompoundBCollisions;
+                else if (shapeA == ColliderShape::Chain)
+                    pair = addChainACollisions;
+                else if (shapeB == ColliderShape::Chain)
+                    pair = addChainBCollisions;
+                else if (shapeA == ColliderShape::TileMap)
+                    pair = addTileMapACollisions;
+                else if (shapeB == ColliderShape::TileMap)
+                    pair = addTileMapBCollisions;
+                else if (tables.convexPairs[a][b] == CollisionDetection::checkConvexCollision)
+                    pair = addCachedConvexCollisions;
+                else
+                    pair = addConvexCollisions;
+            }
+        }
+
+        return tables;
+    }
+
+    //Returns the tables, filled on first use
+    static const PairTables& getPairTables()
+    {
+        static const PairTables tables = makePairTables();
+        return tables;
+    }
+
+    //Returns the function colliding a pair of shapes
+    CollisionDetection::PairFunction CollisionDetection::findPairFunction(ColliderShape shapeA, ColliderShape shapeB)
+    {
+        return getPairTables().pairs[static_cast<int>(shapeA)][static_cast<int>(shapeB)];
+    }
+
+    //Adds the collisions between colliders, descending into the children of compounds near the other collider
+    void CollisionDetection::checkCompoundCollision(
+        Collider* colliderA, Collider* colliderB, std::vector<Collision*>& collisions, SimplexCacheTable* caches)
+    {
+        findPairFunction(colliderA->getShape(), colliderB->getShape())(colliderA, colliderB, collisions, caches);
+    }
+
+    //Sorts into respective function based on collider shapes
+    Collision* CollisionDetection::checkColliderCollision(Collider* colliderA, Collider* colliderB, SimplexCache* cache)
+    {
+        int shapeA = static_cast<int>(colliderA->getShape());
+        int shapeB = static_cast<int>(colliderB->getShape());
+
+        return getPairTables().convexPairs[shapeA][shapeB](colliderA, colliderB, cache);
+    }
+
+    //Calculate collision between two circle colliders
+    Collision* CollisionDetection::checkCircleCollision(CircleCollider* circleA, CircleCollider* circleB)
+    {
+        //Get positions of centers
+        Vector2 circleAPos = circleA->getPosition();
+        Vector2 circleBPos = circleB->getPosition();
+
+        //Get radii
+        float circleARadius = circleA->getRadius();
+        float circleBRadius = circleB->getRadius();
+
+        float sumRadii = circleARadius + circleBRadius;
+
+        //Calculate distance squared between circles
+        Vector2 vectorBetweenCenters = circleAPos.getVectorTo(circleBPos);
+        float distanceSquared = vectorBetweenCenters.getSquare();
+
+        //Check if distance squared is less than sum of radii squared
+        if (distanceSquared <= (sumRadii * sumRadii))
+        {
+            //Get the normal and penetration depth of the collision
+            //Coincident centers have no direction between them, separate them along a fixed axis instead of NaN
+            Vector2 normal = distanceSquared > 0.0f ? circleAPos.getDirectionTo(circleBPos) : Vector2(0.0f, 1.0f);
+            float penDepth = sumRadii - (circleAPos.getVectorTo(circleBPos)).getLength();
+
+            //Find contact points
+            std::vector<Vector2> contactPoints = findCircleContactPoints(circleAPos, circleARadius, circleBPos, normal);
+            int contactCount = contactPoints.size();
+
+            //Return a collision object
+            return new Collision(
+                circleA->getParent(), circleB->getParent(), normal, penDepth, contactPoints, contactCount);
+        }
+
+        //If no collision is detected
+        return nullptr;
+    }
+
+    //Find contact point between two circles
+    std::vector<Vector2> CollisionDetection::findCircleContactPoints(
+        const Vector2& centerA, float radiusA, const Vector2& centerB, const Vector2& normal)
+    {
+        std::vector<Vector2> contactPoints;
+
+        Vector2 contact = centerA + normal * radiusA;
+        contactPoints.push_back(contact);
+
+        return contactPoints;
+    }
+
+    //Find contact points between two polygons by clipping the incident edge to the reference face
+    void CollisionDetection::findPolygonContactPoints(
+        const ConvexPolygon& reference, int edge, const ConvexPolygon& incident, std::vector<Vector2>& contactPoints)
+    {
+        const Vector2& normal = reference.normals[edge];
+
+        //The incident edge faces most against the reference face
+        int incidentEdge = 0;
+        float minAlignment = std::numeric_limits<float>::infinity();
+
+        for (int i = 0; i < incident.count; i++)
+        {
+            float alignment = incident.normals[i].projectOntoAxis(normal);
+            if (alignment < minAlignment)
+            {
+                minAlignment = alignment;
+                incidentEdge = i;
+            }
+        }
+
+        Vector2 segment[2] = {incident.vertices[incidentEdge], incident.vertices[(incidentEdge + 1) % incident.count]};
+
+        const Vector2& faceStart = reference.vertices[edge];
+        const Vector2& faceEnd = reference.vertices[(edge + 1) % reference.count];
+        Vector2 tangent = (faceEnd - faceStart).getNormal();
+
+        //Cut the incident edge off at both sides of the reference face
+        if (!clipSegmentToLine(segment, -tangent, -faceStart.projectOntoAxis(tangent)) ||
+            !clipSegmentToLine(segment, tangent, faceEnd.projectOntoAxis(tangent)))
+            return;
+
+        //Keep the points behind the reference face, moved halfway back to it
+        float faceOffset = faceStart.projectOntoAxis(normal);
+
+        for (const Vector2& point : segment)
+        {
+            float separation = point.projectOntoAxis(normal) - faceOffset;
+            if (separation <= 0.0f)
+                contactPoints.push_back(point - normal * (separation / 2.0f));
+        }
+    }
+
+    //Finds the point on a polygon's boundary closest to a point
+    float CollisionDetection::findClosestPointOnPolygon(
+        const ConvexPolygon& polygon, const Vector2& point, Vector2& closest, Vector2& normal)
+    {
+        //Face the point lies furthest in front of
+        int edge = 0;
+        float maxSeparation = -std::numeric_limits<float>::infinity();
+
+        for (int i = 0; i < polygon.count; i++)
+        {
+            float separation = polygon.normals[i].projectOntoAxis(point - polygon.vertices[i]);
+            if (separation > maxSeparation)
+            {
+                maxSeparation = separation;
+                edge = i;
+            }
+        }
+
+        //Inside, the nearest face is the one with the least depth
+        if (maxSeparation <= 0.0f)
+        {
+            normal = polygon.normals[edge];
+            closest = point - normal * maxSeparation;
+
+            return maxSeparation;
+        }
+
+        //Outside, the closest feature is that face or one of its vertices
+        const Vector2& vertexA = polygon.vertices[edge];
+        const Vector2& vertexB = polygon.vertices[(edge + 1) % polygon.count];
+        closest = findClosestPointOnSegment(point, vertexA, vertexB);
+        Vector2 offset = point - closest;
+        float distance = offset.getLength();
+        normal = distance > 0.0f ? offset / distance : polygon.normals[edge];
+
+        return distance;
+    }
+
+    //Find closest point on a segment to another point
+    const Vector2 CollisionDetection::findClosestPointOnSegment(
+        const Vector2& point, const Vector2& vertexA, const Vector2& vertexB)
+    {
+        Vector2 edge = vertexB - vertexA;
+        Vector2 aToPoint = point - vertexA;
+
+        float projection = aToPoint.projectOntoAxis(edge);
+        float edgeLengthSquared = edge.getSquare();
+        float distance = projection / edgeLengthSquared;
+
+        if (distance < 0)
+        {
+            return vertexA;
+        }
+        else if (distance > 1)
+        {
+            return vertexB;
+        }
+        else
+        {
+            return vertexA + edge * distance;
+        }
+    }
+
+    //Finds the closest points between two segments, returns the squared distance between them
+    float CollisionDetection::findClosestPointsOnSegments(const Vector2& startA,
+        const Vector2& endA,
+        const Vector2& startB,
+        const Vector2& endB,
+        Vector2& closestA,
+        Vector2& closestB)
+    {
+        Vector2 edgeA = endA - startA;
+        Vector2 edgeB = endB - startB;
+        Vector2 startOffset = startA - startB;
+
+        float lengthSquaredA = edgeA.getSquare();
+        float lengthSquaredB = edgeB.getSquare();
+        float projectionB = edgeB.projectOntoAxis(startOffset);
+
+        //Fractions along each segment, found by clamping the closest points of the infinite lines
+        float fractionA = 0.0f;
+        float fractionB = 0.0f;
+
+        if (lengthSquaredA == 0.0f && lengthSquaredB == 0.0f)
+        {
+            //Both segments are points
+        }
+        else if (lengthSquaredA == 0.0f)
+            fractionB = std::clamp(projectionB / lengthSquaredB, 0.0f, 1.0f);
+        else
+        {
+            float projectionA = edgeA.projectOntoAxis(startOffset);
+
+            if (lengthSquaredB == 0.0f)
+                fractionA = std::clamp(-projectionA / lengthSquaredA, 0.0f, 1.0f);
+            else
+            {
+                float alignment = edgeA.projectOntoAxis(edgeB);
+                float denominator = lengthSquaredA * lengthSquaredB - alignment * alignment;
+
+                //Parallel segments pick the start of A, then clamp B to it
+                if (denominator != 0.0f)
+                    fractionA = std::clamp(
+                        (alignment * projectionB - projectionA * lengthSquaredB) / denominator, 0.0f, 1.0f);
+
+                fractionB = (alignment * fractionA + projectionB) / lengthSquaredB;
+
+                //B's point fell off its segment, clamp it and move A's point to match
+                if (fractionB < 0.0f)
+                {
+                    fractionB = 0.0f;
+                    fractionA = std::clamp(-projectionA / lengthSquaredA, 0.0f, 1.0f);
+                }
+                else if (fractionB > 1.0f)
+                {
+                    fractionB = 1.0f;
+                    fractionA = std::clamp((alignment - projectionA) / lengthSquaredA, 0.0f, 1.0f);
+                }
+            }
+        }
+
+        closestA = startA + edgeA * fractionA;
+        closestB = startB + edgeB * fractionB;
+
+        return (closestB - closestA).getSquare();
+    }
+
+    //Finds the closest points between a segment and a polygon
+    float CollisionDetection::findSegmentPolygonDistance(const Vector2& start,
+        const Vector2& end,
+        const ConvexPolygon& polygon,
+        Vector2& onSegment,
+        Vector2& onPolygon)
+    {
+        //A segment starting inside the polygon touches it there
+        bool inside = true;
+        for (int i = 0; i < polygon.count && inside; i++)
+            inside = (start - polygon.vertices[i]).projectOntoAxis(polygon.normals[i]) <= 0.0f;
+
+        if (inside)
+        {
+            onSegment = start;
+            onPolygon = start;
+
+            return 0.0f;
+        }
+
+        //Otherwise the closest points lie on an edge, crossing an edge gives zero
+        float minDistanceSquared = std::numeric_limits<float>::infinity();
+
+        for (int i = 0; i < polygon.count; i++)
+        {
+            Vector2 closestSegment;
+            Vector2 closestEdge;
+            float distanceSquared = findClosestPointsOnSegments(start,
+                end,
+                polygon.vertices[i],
+                polygon.vertices[(i + 1) % polygon.count],
+                closestSegment,
+                closestEdge);
+
+            if (distanceSquared < minDistanceSquared)
+            {
+                minDistanceSquared = distanceSquared;
+                onSegment = closestSegment;
+                onPolygon = closestEdge;
+            }
+        }
+
+        return std::sqrt(minDistanceSquared);
+    }
+
+    //Casts a ray against a collider by sorting into respective function based on shape
+    bool CollisionDetection::rayCastCollider(
+        const Vector2& origin, const Vector2& direction, float maxDistance, const Collider* collider, RayHit& hit)
+    {
+        ColliderShape shape = collider->getShape();
+
+        if (shape == ColliderShape::Circle)
+            return rayCastCircle(origin, direction, maxDistance, static_cast<const CircleCollider*>(collider), hit);
+
+        else if (shape == ColliderShape::Rectangle)
+            return rayCastRect(origin, direction, maxDistance, static_cast<const RectCollider*>(collider), hit);
+
+        else if (shape == ColliderShape::Polygon)
+            return rayCastPolygon(origin, direction, maxDistance, static_cast<const PolygonCollider*>(collider), hit);
+
+        else if (shape == ColliderShape::Capsule)
+            return rayCastCapsule(origin, direction, maxDistance, static_cast<const CapsuleCollider*>(collider), hit);
+
+        //Closest hit among the children
+        else if (shape == ColliderShape::Compound)
+        {
+            const CompoundCollider* compound = static_cast<const CompoundCollider*>(collider);
+            bool found = false;
+
+            for (int i = 0; i < compound->getChildCount(); i++)
+            {
+                const Collider* child = compound->getChild(i);
+                RayHit childHit;
+
+                if (child->getAABB().intersectsRay(origin, direction, maxDistance) &&
+                    rayCastCollider(origin, direction, maxDistance, child, childHit))
+                {
+                    hit = childHit;
+                    maxDistance = childHit.distance;
+                    found = true;
+                }
+            }
+
+            return found;
+        }
+
+        else if (shape == ColliderShape::Chain)
+            return rayCastChain(origin, direction, maxDistance, static_cast<const ChainCollider*>(collider), hit);
+
+        else if (shape == ColliderShape::TileMap)
+            return rayCastTileMap(origin, direction, maxDistance, static_cast<const TileMapCollider*>(collider), hit);
+
+        return false;
+    }
+
+    //Casts a ray against a circle collider
+    bool CollisionDetection::rayCastCircle(
+        const Vector2& origin, const Vector2& direction, float maxDistance, const CircleCollider* circle, RayHit& hit)
+    {
+        Vector2 center = circle->getPosition();
+        float radius = circle->getRadius();
+
+        //Solve |origin + direction * t - center| = radius for t
+        Vector2 centerToOrigin = origin - center;
+        float b = centerToOrigin.projectOntoAxis(direction);
+        float c = centerToOrigin.getSquare() - radius * radius;
+
+        //Starting inside the circle, or outside and pointing away from it
+        if (c <= 0.0f || b > 0.0f)
+            return false;
+
+        float discriminant = b * b - c;
+        if (discriminant < 0.0f)
+            return false;
+
+        float distance = -b - std::sqrt(discriminant);
+        if (distance > maxDistance)
+            return false;
+
+        hit.body = circle->getParent();
+        hit.distance = distance;
+        hit.point = origin + direction * distance;
+        hit.normal = (hit.point - center) / radius;
+
+        return true;
+    }
+
+    //Casts a ray against a rotated rectangle collider using slabs in the rectangle's local space
+    bool CollisionDetection::rayCastRect(
+        const Vector2& origin, const Vector2& direction, float maxDistance, const RectCollider* rect, RayHit& hit)
+    {
+        float cos = std::cos(rect->getRotation());
+        float sin = std::sin(rect->getRotation());
+
+        //Rotate the ray into the rectangle's local space
+        Vector2 relative = origin - rect->getPosition();
+        const float localOrigin[2] = {relative.x * cos + relative.y * sin, -relative.x * sin + relative.y * cos};
+        const float localDirection[2] = {
+            direction.x * cos + direction.y * sin, -direction.x * sin + direction.y * cos};
+        const float halfExtents[2] = {rect->getWidth() / 2.0f, rect->getHeight() / 2.0f};
+
+        float tMin = -std::numeric_limits<float>::infinity();
+        float tMax = std::numeric_limits<float>::infinity();
+        int entryAxis = 0;
+        float entrySign = 0.0f;
+
+        for (int axis = 0; axis < 2; axis++)
+        {
+            if (std::abs(localDirection[axis]) < 1e-8f)
+            {
+                //Parallel to the slab, must start inside it
+                if (std::abs(localOrigin[axis]) > halfExtents[axis])
+                    return false;
+
+                continue;
+            }
+
+            float invDirection = 1.0f / localDirection[axis];
+            float t1 = (-halfExtents[axis] - localOrigin[axis]) * invDirection;
+            float t2 = (halfExtents[axis] - localOrigin[axis]) * invDirection;
+
+            //Entering through the negative face when moving in the positive direction
+            float sign = -1.0f;
+            if (t1 > t2)
+            {
+                std::swap(t1, t2);
+                sign = 1.0f;
+            }
+
+            if (t1 > tMin)
+            {
+                tMin = t1;
+                entryAxis = axis;
+                entrySign = sign;
+            }
+
+            tMax = std::min(tMax, t2);
+
+            if (tMin > tMax)
+                return false;
+        }
+
+        //Starting inside the rectangle, or the rectangle is behind or beyond the ray
+        if (tMin < 0.0f || tMin > maxDistance)
+            return false;
+
+        //Rotate the face normal back into world space
+        Vector2 localNormal = entryAxis == 0 ? Vector2(entrySign, 0.0f) : Vector2(0.0f, entrySign);
+
+        hit.body = rect->getParent();
+        hit.distance = tMin;
+        hit.point = origin + direction * tMin;
+        hit.normal = {localNormal.x * cos - localNormal.y * sin, localNormal.x * sin + localNormal.y * cos};
+
+        return true;
+    }
+
+    //Casts a ray against a polygon collider by clipping it to the side of every edge
+    bool CollisionDetection::rayCastPolygon(const Vector2& origin,
+        const Vector2& direction,
+        float maxDistance,
+        const PolygonCollider* polygon,
+        RayHit& hit)
+    {
+        const Vector2* vertices = polygon->getVertices();
+        const Vector2* normals = polygon->getNormals();
+
+        float lower = 0.0f;
+        float upper = maxDistance;
+        int entryEdge = -1;
+
+        for (int i = 0; i < polygon->getVertexCount(); i++)
+        {
+            //The ray is inside the edge's half plane while distance * denominator stays below numerator
+            float numerator = normals[i].projectOntoAxis(vertices[i] - origin);
+            float denominator = normals[i].projectOntoAxis(direction);
+
+            if (denominator == 0.0f)
+            {
+                //Parallel to the edge, must start inside it
+                if (numerator < 0.0f)
+                    return false;
+            }
+            else if (denominator < 0.0f && numerator < lower * denominator)
+            {
+                lower = numerator / denominator;
+                entryEdge = i;
+            }
+            else if (denominator > 0.0f && numerator < upper * denominator)
+            {
+                upper = numerator / denominator;
+            }
+
+            if (upper < lower)
+                return false;
+        }
+
+        //Starting inside the polygon
+        if (entryEdge < 0)
+            return false;
+
+        hit.body = polygon->getParent();
+        hit.distance = lower;
+        hit.point = origin + direction * lower;
+        hit.normal = normals[entryEdge];
+
+        return true;
+    }
+
+    //Casts a ray against a capsule collider by sweeping its origin against the capsule
+    bool CollisionDetection::rayCastCapsule(const Vector2& origin,
+        const Vector2& direction,
+        float maxDistance,
+        const CapsuleCollider* capsule,
+        RayHit& hit)
+    {
+        float fraction;
+        Vector2 normal;
+
+        if (!sweepPointVsCapsule(origin, direction * maxDistance, capsule, capsule->getRadius(), fraction, normal))
+            return false;
+
+        hit.body = capsule->getParent();
+        hit.distance = fraction * maxDistance;
+        hit.point = origin + direction * hit.distance;
+        hit.normal = normal;
+
+        return true;
+    }
+
+    //Casts a ray against the front of the segments of a chain collider
+    bool CollisionDetection::rayCastChain(const Vector2& origin,
+        const Vector2& direction,
+        float maxDistance,
+        const ChainCollider* chain,
+        RayHit& hit)
+    {
+        bool found = false;
+
+        chain->rayCastSegments(origin,
+            direction,
+            maxDistance,
+            [chain, &origin, &direction, &hit, &found](int segment, float distance)
+            {
+                Vector2 start;
+                Vector2 end;
+                chain->getSegment(segment, start, end);
+
+                Vector2 edge = end - start;
+                Vector2 normal = Vector2(-edge.y, edge.x).getNormal();
+
+                //Parallel or coming from behind
+                float approach = direction.projectOntoAxis(normal);
+                if (approach >= 0.0f)
+                    return distance;
+
+                //Both ends on the same side of the ray's line, found from the vertices alone so the two segments
+                //sharing a vertex agree on which side it lies and a ray through it cannot miss both
+                float startSide = direction.crossProduct(start - origin);
+                float endSide = direction.crossProduct(end - origin);
+                if ((startSide > 0.0f && endSide > 0.0f) || (startSide < 0.0f && endSide < 0.0f))
+                    return distance;
+
+                float hitDistance = (start - origin).projectOntoAxis(normal) / approach;
+                if (hitDistance < 0.0f || hitDistance > distance)
+                    return distance;
+
+                Vector2 point = origin + direction * hitDistance;
+
+                hit.body = chain->getParent();
+                hit.distance = hitDistance;
+                hit.point = point;
+                hit.normal = normal;
+                found = true;
+
+                return hitDistance;
+            });
+
+        return found;
+    }
+
+    //Casts a ray against a tile map collider by stepping through the tiles along it
+    //Walks the grid one tile at a time in the grid's local space, crossing whichever tile edge comes first
+    bool CollisionDetection::rayCastTileMap(const Vector2& origin,
+        const Vector2& direction,
+        float maxDistance,
+        const TileMapCollider* map,
+        RayHit& hit)
+    {
+        float tileSize = map->getTileSize();
+        if (map->getColumns() == 0 || map->getRows() == 0 || tileSize <= 0.0f)
+            return false;
+
+        //Ray in tile units of the grid's local space
+        Vector2 localOrigin = map->toLocalDirection(origin - map->getPosition()) / tileSize;
+        Vector2 localDirection = map->toLocalDirection(direction);
+        float maxTiles = maxDistance / tileSize;
+
+        const float originAxes[2] = {localOrigin.x, localOrigin.y};
+        const float directionAxes[2] = {localDirection.x, localDirection.y};
+        const int tileCounts[2] = {map->getColumns(), map->getRows()};
+
+        //Clip the ray to the grid, remembering the axis it enters through
+        float tEnter = 0.0f;
+        float tExit = maxTiles;
+        int faceAxis = -1;
+
+        for (int axis = 0; axis < 2; axis++)
+        {
+            if (std::abs(directionAxes[axis]) < 1e-8f)
+            {
+                if (originAxes[axis] < 0.0f || originAxes[axis] > tileCounts[axis])
+                    return false;
+
+                continue;
+            }
+
+            float t1 = -originAxes[axis] / directionAxes[axis];
+            float t2 = (tileCounts[axis] - originAxes[axis]) / directionAxes[axis];
+            if (t1 > t2)
+                std::swap(t1, t2);
+
+            if (t1 > tEnter)
+            {
+                tEnter = t1;
+                faceAxis = axis;
+            }
+
+            tExit = std::min(tExit, t2);
+        }
+
+        if (tEnter > tExit)
+            return false;
+
+        //Tile the ray enters, and the distance to the next tile edge along each axis
+        int tile[2];
+        int step[2];
+        float tNext[2];
+        float tDelta[2];
+
+        for (int axis = 0; axis < 2; axis++)
+        {
+            float entry = originAxes[axis] + directionAxes[axis] * tEnter;
+            tile[axis] = std::clamp(static_cast<int>(std::floor(entry)), 0, tileCounts[axis] - 1);
+
+            if (std::abs(directionAxes[axis]) < 1e-8f)
+            {
+                step[axis] = 0;
+                tNext[axis] = std::numeric_limits<float>::infinity();
+                tDelta[axis] = std::numeric_limits<float>::infinity();
+                continue;
+            }
+
+            step[axis] = directionAxes[axis] > 0.0f ? 1 : -1;
+            float edge = static_cast<float>(tile[axis] + (step[axis] > 0 ? 1 : 0));
+            tNext[axis] = (edge - originAxes[axis]) / directionAxes[axis];
+            tDelta[axis] = 1.0f / std::abs(directionAxes[axis]);
+        }
+
+        //Starting inside the grid in solid tiles, those are passed through first
+        bool leavingSolid = faceAxis == -1;
+        float t = tEnter;
+
+        while (true)
+        {
+            if (map->isSolid(tile[0], tile[1]))
+            {
+                if (!leavingSolid)
+                    break;
+            }
+            else
+            {
+                leavingSolid = false;
+            }
+
+            //Cross the nearer tile edge
+            faceAxis = tNext[0] < tNext[1] ? 0 : 1;
+            t = tNext[faceAxis];
+            tile[faceAxis] += step[faceAxis];
+            tNext[faceAxis] += tDelta[faceAxis];
+
+            if (t > tExit || tile[faceAxis] < 0 || tile[faceAxis] >= tileCounts[faceAxis])
+                return false;
+        }
+
+        //Face normal against the direction of travel across the entered edge
+        Vector2 localNormal = faceAxis == 0 ? Vector2(directionAxes[0] > 0.0f ? -1.0f : 1.0f, 0.0f)
+                                            : Vector2(0.0f, directionAxes[1] > 0.0f ? -1.0f : 1.0f);
+
+        hit.body = map->getParent();
+        hit.distance = t * tileSize;
+        hit.point = origin + direction * hit.distance;
+        hit.normal = map->toWorldDirection(localNormal);
+
+        return true;
+    }
+
+    //Returns true if a collider overlaps an axis aligned box
+    bool CollisionDetection::checkColliderOverlapsAABB(const Collider* collider, const AABB& box)
+    {
+        if (!collider->getAABB().overlaps(box))
+            return false;
+
+        ColliderShape shape = collider->getShape();
+
+        //Closest point in the box to the circle center must be within the radius
+        if (shape == ColliderShape::Circle)
+        {
+            const CircleCollider* circle = static_cast<const CircleCollider*>(collider);
+            Vector2 center = circle->getPosition();
+
+            Vector2 closest = {std::clamp(center.x, box.min.x, box.max.x), std::clamp(center.y, box.min.y, box.max.y)};
+            return (center - closest).getSquare() <= circle->getRadius() * circle->getRadius();
+        }
+
+        //World axes were covered by the AABB check, test the rectangle's own axes
+        else if (shape == ColliderShape::Rectangle)
+        {
+            const RectCollider* rect = static_cast<const RectCollider*>(collider);
+
+            float cos = std::cos(rect->getRotation());
+            float sin = std::sin(rect->getRotation());
+            const Vector2 axes[2] = {{cos, sin}, {-sin, cos}};
+            const float halfExtents[2] = {rect->getWidth() / 2.0f, rect->getHeight() / 2.0f};
+
+            Vector2 boxCenter = (box.min + box.max) / 2.0f;
+            Vector2 boxHalf = (box.max - box.min) / 2.0f;
+            Vector2 offset = boxCenter - rect->getPosition();
+
+            for (int i = 0; i < 2; i++)
+            {
+                float boxRadius = boxHalf.x * std::abs(axes[i].x) + boxHalf.y * std::abs(axes[i].y);
+                if (std::abs(offset.projectOntoAxis(axes[i])) > halfExtents[i] + boxRadius)
+                    return false;
+            }
+
+            return true;
+        }
+
+        //World axes were covered by the AABB check, test the polygon's edge normals
+        else if (shape == ColliderShape::Polygon)
+        {
+            const PolygonCollider* polygon = static_cast<const PolygonCollider*>(collider);
+            const Vector2* vertices = polygon->getVertices();
+            const Vector2* normals = polygon->getNormals();
+
+            Vector2 boxCenter = (box.min + box.max) / 2.0f;
+            Vector2 boxHalf = (box.max - box.min) / 2.0f;
+
+            for (int i = 0; i < polygon->getVertexCount(); i++)
+            {
+                float boxRadius = boxHalf.x * std::abs(normals[i].x) + boxHalf.y * std::abs(normals[i].y);
+                if ((boxCenter - vertices[i]).projectOntoAxis(normals[i]) > boxRadius)
+                    return false;
+            }
+
+            return true;
+        }
+
+        //Segment within the radius of the box
+        else if (shape == ColliderShape::Capsule)
+        {
+            const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+
+            ConvexPolygon polygon;
+            makeBoxPolygon(box, polygon);
+
+            Vector2 onSegment;
+            Vector2 onBox;
+            return findSegmentPolygonDistance(capsule->getPointA(), capsule->getPointB(), polygon, onSegment, onBox) <=
+                   capsule->getRadius();
+        }
+
+        //Any child overlapping the box
+        else if (shape == ColliderShape::Compound)
+        {
+            bool overlaps = false;
+            static_cast<const CompoundCollider*>(collider)->queryChildren(box,
+                [&box, &overlaps](const Collider* child)
+                {
+                    overlaps = checkColliderOverlapsAABB(child, box);
+                    return !overlaps;
+                });
+
+            return overlaps;
+        }
+
+        //Any segment crossing or inside the box
+        else if (shape == ColliderShape::Chain)
+        {
+            const ChainCollider* chain = static_cast<const ChainCollider*>(collider);
+
+            ConvexPolygon polygon;
+            makeBoxPolygon(box, polygon);
+
+            bool overlaps = false;
+            chain->querySegments(box,
+                [chain, &polygon, &overlaps](int segment)
+                {
+                    Vector2 start;
+                    Vector2 end;
+                    Vector2 onSegment;
+                    Vector2 onBox;
+                    chain->getSegment(segment, start, end);
+
+                    overlaps = findSegmentPolygonDistance(start, end, polygon, onSegment, onBox) <= 0.0f;
+                    return !overlaps;
+                });
+
+            return overlaps;
+        }
+
+        //Any box of solid tiles overlapping the box
+        else if (shape == ColliderShape::TileMap)
+        {
+            const TileMapCollider* map = static_cast<const TileMapCollider*>(collider);
+
+            bool overlaps = false;
+            map->queryBoxes(box,
+                [map, &box, &overlaps](const TileBox& tileBox)
+                {
+                    RectCollider tile = makeTileRect(map, map->getLocalBounds(tileBox));
+                    overlaps = checkColliderOverlapsAABB(&tile, box);
+                    return !overlaps;
+                });
+
+            return overlaps;
+        }
+
+        return false;
+    }
+
+    //Returns true if a point lies inside a collider
+    bool CollisionDetection::checkColliderContainsPoint(const Collider* collider, const Vector2& point)
+    {
+        ColliderShape shape = collider->getShape();
+
+        if (shape == ColliderShape::Circle)
+        {
+            const CircleCollider* circle = static_cast<const CircleCollider*>(collider);
+            return (point - circle->getPosition()).getSquare() <= circle->getRadius() * circle->getRadius();
+        }
+
+        else if (shape == ColliderShape::Rectangle)
+        {
+            const RectCollider* rect = static_cast<const RectCollider*>(collider);
+            Vector2 local = toRectLocalSpace(rect, point);
+
+            return std::abs(local.x) <= rect->getWidth() / 2.0f && std::abs(local.y) <= rect->getHeight() / 2.0f;
+        }
+
+        //Inside every edge's half plane
+        else if (shape == ColliderShape::Polygon)
+        {
+            const PolygonCollider* polygon = static_cast<const PolygonCollider*>(collider);
+            const Vector2* vertices = polygon->getVertices();
+            const Vector2* normals = polygon->getNormals();
+
+            for (int i = 0; i < polygon->getVertexCount(); i++)
+            {
+                if ((point - vertices[i]).projectOntoAxis(normals[i]) > 0.0f)
+                    return false;
+            }
+
+            return polygon->getVertexCount() > 0;
+        }
+
+        else if (shape == ColliderShape::Capsule)
+        {
+            const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+            Vector2 closest = findClosestPointOnCapsuleSegment(capsule, point);
+
+            return (point - closest).getSquare() <= capsule->getRadius() * capsule->getRadius();
+        }
+
+        //Any child containing the point
+        else if (shape == ColliderShape::Compound)
+        {
+            bool contains = false;
+            static_cast<const CompoundCollider*>(collider)->queryChildren(AABB(point, point),
+                [&point, &contains](const Collider* child)
+                {
+                    contains = checkColliderContainsPoint(child, point);
+                    return !contains;
+                });
+
+            return contains;
+        }
+
+        //Whether the tile under the point is solid
+        else if (shape == ColliderShape::TileMap)
+        {
+            const TileMapCollider* map = static_cast<const TileMapCollider*>(collider);
+            if (map->getTileSize() <= 0.0f)
+                return false;
+
+            //Outside the grid is checked before converting, so far points cannot overflow
+            Vector2 local = map->toLocalDirection(point - map->getPosition()) / map->getTileSize();
+            if (local.x < 0.0f || local.y < 0.0f || local.x >= map->getColumns() || local.y >= map->getRows())
+                return false;
+
+            return map->isSolid(static_cast<int>(local.x), static_cast<int>(local.y));
+        }
+
+        return false;
+    }
+
+    //Returns true if a collider overlaps a circle
+    bool CollisionDetection::checkColliderOverlapsCircle(const Collider* collider, const Vector2& center, float radius)
+    {
+        ColliderShape shape = collider->getShape();
+
+        if (shape == ColliderShape::Circle)
+        {
+            const CircleCollider* circle = static_cast<const CircleCollider*>(collider);
+            float sumRadii = circle->getRadius() + radius;
+
+            return (center - circle->getPosition()).getSquare() <= sumRadii * sumRadii;
+        }
+
+        //Clamp the circle center to the rectangle in local space
+        else if (shape == ColliderShape::Rectangle)
+        {
+            const RectCollider* rect = static_cast<const RectCollider*>(collider);
+            Vector2 local = toRectLocalSpace(rect, center);
+
+            float halfWidth = rect->getWidth() / 2.0f;
+            float halfHeight = rect->getHeight() / 2.0f;
+            Vector2 closest = {
+                std::clamp(local.x, -halfWidth, halfWidth), std::clamp(local.y, -halfHeight, halfHeight)};
+
+            return (local - closest).getSquare() <= radius * radius;
+        }
+
+        else if (shape == ColliderShape::Polygon)
+        {
+            ConvexPolygon polygon;
+            if (!makeConvexPolygon(collider, polygon))
+                return false;
+
+            Vector2 closest;
+            Vector2 normal;
+            return findClosestPointOnPolygon(polygon, center, closest, normal) <= radius;
+        }
+
+        else if (shape == ColliderShape::Capsule)
+        {
+            const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+            Vector2 closest = findClosestPointOnCapsuleSegment(capsule, center);
+            float sumRadii = capsule->getRadius() + radius;
+
+            return (center - closest).getSquare() <= sumRadii * sumRadii;
+        }
+
+        //Any child overlapping the circle
+        else if (shape == ColliderShape::Compound)
+        {
+            bool overlaps = false;
+            AABB circleBox(center - Vector2(radius, radius), center + Vector2(radius, radius));
+
+            static_cast<const CompoundCollider*>(collider)->queryChildren(circleBox,
+                [&center, radius, &overlaps](const Collider* child)
+                {
+                    overlaps = checkColliderOverlapsCircle(child, center, radius);
+                    return !overlaps;
+                });
+
+            return overlaps;
+        }
+
+        //Any segment within the radius of the center
+        else if (shape == ColliderShape::Chain)
+        {
+            const ChainCollider* chain = static_cast<const ChainCollider*>(collider);
+            AABB circleBox(center - Vector2(radius, radius), center + Vector2(radius, radius));
+
+            bool overlaps = false;
+            chain->querySegments(circleBox,
+                [chain, &center, radius, &overlaps](int segment)
+                {
+                    Vector2 start;
+                    Vector2 end;
+                    chain->getSegment(segment, start, end);
+
+                    Vector2 closest = findClosestPointOnSegment(center, start, end);
+                    overlaps = (center - closest).getSquare() <= radius * radius;
+                    return !overlaps;
+                });
+
+            return overlaps;
+        }
+
+        //Any box of solid tiles within the radius of the center
+        else if (shape == ColliderShape::TileMap)
+        {
+            const TileMapCollider* map = static_cast<const TileMapCollider*>(collider);
+            AABB circleBox(center - Vector2(radius, radius), center + Vector2(radius, radius));
+
+            bool overlaps = false;
+            map->queryBoxes(circleBox,
+                [map, &center, radius, &overlaps](const TileBox& tileBox)
+                {
+                    RectCollider tile = makeTileRect(map, map->getLocalBounds(tileBox));
+                    overlaps = checkColliderOverlapsCircle(&tile, center, radius);
+                    return !overlaps;
+                });
+
+            return overlaps;
         }
 
         return false;
     }
 
-    //Checks if two AABBs are overlapping
-    bool CollisionDetection::checkAABBvsAABB(const AABB& boxA, const AABB& boxB)
+    //Converts a world point into a rectangle's local space
+    const Vector2 CollisionDetection::toRectLocalSpace(const RectCollider* rect, const Vector2& point)
     {
-        //Get mins and maxes
-        Vector2 minA = boxA.min;
-        Vector2 maxA = boxA.max;
-
-        Vector2 minB = boxB.min;
-        Vector2 maxB = boxB.max;
-
-        //Check for overlap
-        if (maxA.x > minB.x && minA.x < maxB.x && maxA.y > minB.y && minA.y < maxB.y)
-            return true;
+        float cos = std::cos(rect->getRotation());
+        float sin = std::sin(rect->getRotation());
+        Vector2 relative = point - rect->getPosition();
 
-        //No overlap
-        return false;
+        return {relative.x * cos + relative.y * sin, -relative.x * sin + relative.y * cos};
     }
 
-    //Checks if two polygons are intersecting using seperating axis theorem
-    Collision* CollisionDetection::checkPolygonCollision(RectCollider* polygonA, RectCollider* polygonB)
+    //Gap left between swept shapes at the time of impact, so their cores stay apart and give a normal
+    static const float SWEEP_SKIN = 0.0005f;
+
+    //Most steps a convex sweep takes before giving up on reaching the other shape
+    static const int MAX_SWEEP_ITERATIONS = 20;
+
+    //Sweeps one support shape along a displacement against another by conservative advancement on their GJK distance
+    //Distance under a translation is convex in time, so stepping to where the closest points would meet if they
+    //kept closing at their current rate never passes the first contact
+    //The normal points from the target towards the swept shape and the point lies on the target's surface
+    //Shapes overlapping at the start hit at fraction 0 with the overlap normal when their cores overlap too
+    static bool sweepSupportShapes(const SupportShape& shape,
+        const Vector2& displacement,
+        const SupportShape& target,
+        const Vector2& overlapNormal,
+        float& fraction,
+        Vector2& normal,
+        Vector2& point)
     {
-        //Define variables for collision data
-        float penDepth = std::numeric_limits<float>::infinity();
-        Vector2 normal;
-        std::vector<Vector2> contactPoints;
-        int contactCount = 0;
-
-        //Get vertices of each polygon
-        std::vector<Vector2> verticesA = polygonA->calculateVertcies();
-        std::vector<Vector2> verticesB = polygonB->calculateVertcies();
+        float reach = shape.radius + target.radius;
+        SupportShape moved = shape;
+        SimplexCache cache;
+        float time = 0.0f;
 
-        //Check against normals of polygon A
-        for (int i = 0; i < verticesA.size(); i++)
+        for (int i = 0; i < MAX_SWEEP_ITERATIONS; i++)
         {
-            Vector2 vertexA = verticesA[i];
-            Vector2 vertexB = verticesA[(i + 1) % verticesA.size()];
+            for (int v = 0; v < shape.core.count; v++)
+                moved.core.vertices[v] = shape.core.vertices[v] + displacement * time;
 
-            Vector2 edge = vertexB - vertexA;
-            Vector2 axis = {-edge.y, edge.x};
-            axis = axis.getNormal();
+            Vector2 pointA;
+            Vector2 pointB;
+            float distance = CollisionDetection::findCoreDistance(moved, target, cache, pointA, pointB);
 
-            Projection projectionA = projectPolygonOntoAxis(verticesA, axis);
-            Projection projectionB = projectPolygonOntoAxis(verticesB, axis);
+            if (distance <= reach + SWEEP_SKIN)
+            {
+                fraction = time;
+                normal = distance > 0.0f ? (pointA - pointB) / distance : overlapNormal;
+                point = pointB + normal * target.radius;
 
-            if (projectionA.min > projectionB.max || projectionB.min > projectionA.max)
-                return nullptr;
+                return true;
+            }
 
-            float axisPenDepth = std::min(projectionB.max - projectionA.min, projectionA.max - projectionB.min);
+            //Moving apart along the line between the closest points, the gap never closes
+            Vector2 direction = (pointB - pointA) / distance;
+            float speed = displacement.projectOntoAxis(direction);
+            if (speed <= 0.0f)
+                return false;
 
-            if (axisPenDepth < penDepth)
-            {
-                penDepth = axisPenDepth;
-                normal = axis;
-            }
+            time += (distance - reach - SWEEP_SKIN / 2.0f) / speed;
+            if (time > 1.0f)
+                return false;
         }
 
-        //Check against normals of polygon B
-        for (int i = 0; i < verticesB.size(); i++)
-        {
-            Vector2 vertexA = verticesB[i];
-            Vector2 vertexB = verticesB[(i + 1) % verticesB.size()];
+        return false;
+    }
 
-            Vector2 edge = vertexB - vertexA;
-            Vector2 axis = {-edge.y, edge.x};
-            axis = axis.getNormal();
+    //Sweeps a collider along a displacement against another collider
+    bool CollisionDetection::shapeCastCollider(
+        const Collider* shape, const Vector2& displacement, const Collider* target, ShapeCastHit& hit)
+    {
+        ColliderShape shapeType = shape->getShape();
+        ColliderShape targetType = target->getShape();
 
-            Projection projectionA = projectPolygonOntoAxis(verticesA, axis);
-            Projection projectionB = projectPolygonOntoAxis(verticesB, axis);
+        //Earliest hit of any child of the swept shape, or against any child of the target
+        if (shapeType == ColliderShape::Compound || targetType == ColliderShape::Compound)
+        {
+            const CompoundCollider* compound =
+                static_cast<const CompoundCollider*>(shapeType == ColliderShape::Compound ? shape : target);
+            bool found = false;
 
-            if (projectionA.min > projectionB.max || projectionB.min > projectionA.max)
-                return nullptr;
+            for (int i = 0; i < compound->getChildCount(); i++)
+            {
+                const Collider* child = compound->getChild(i);
+                ShapeCastHit childHit;
 
-            float axisPenDepth = std::min(projectionB.max - projectionA.min, projectionA.max - projectionB.min);
+                bool childFound = shapeType == ColliderShape::Compound
+                                      ? shapeCastCollider(child, displacement, target, childHit)
+                                      : shapeCastCollider(shape, displacement, child, childHit);
 
-            if (axisPenDepth < penDepth)
-            {
-                penDepth = axisPenDepth;
-                normal = axis;
+                if (childFound && (!found || childHit.fraction < hit.fraction))
+                {
+                    hit = childHit;
+                    found = true;
+                }
             }
+
+            return found;
         }
 
-        //Ensure normal points from polygonA to polygonB
-        Vector2 direction = polygonB->getParent()->getPosition() - polygonA->getParent()->getPosition();
-        if (normal.projectOntoAxis(direction) < 0)
-            normal = -normal;
+        //Earliest hit against the boxes of solid tiles the swept shape passes over
+        if (targetType == ColliderShape::TileMap && shapeType != ColliderShape::TileMap)
+        {
+            const TileMapCollider* map = static_cast<const TileMapCollider*>(target);
+            const AABB& box = shape->getAABB();
+            AABB sweptBox = AABB::combine(box, AABB(box.min + displacement, box.max + displacement));
+            bool found = false;
 
-        //Find contact points
-        contactPoints = findPolygonContactPoints(verticesA, verticesB);
-        contactCount = contactPoints.size();
+            map->queryBoxes(sweptBox,
+                [shape, &displacement, map, &hit, &found](const TileBox& tileBox)
+                {
+                    RectCollider tile = makeTileRect(map, map->getLocalBounds(tileBox));
+                    ShapeCastHit tileHit;
 
-        //Return collision object with data if collision was found
-        return new Collision(
-            polygonA->getParent(), polygonB->getParent(), normal, penDepth, contactPoints, contactCount);
-    }
+                    if (shapeCastCollider(shape, displacement, &tile, tileHit) &&
+                        (!found || tileHit.fraction < hit.fraction))
+                    {
+                        hit = tileHit;
+                        found = true;
+                    }
 
-    //Checks if circle and polygon are intersecting using SAT
-    Collision* CollisionDetection::checkCirclePolygonCollision(CircleCollider* circle, RectCollider* polygon)
-    {
-        //Get circle properties and polygon vertices
-        Vector2 center = circle->getPosition();
-        float radius = circle->getRadius();
-        std::vector<Vector2> vertices = polygon->calculateVertcies();
+                    return true;
+                });
 
-        //Define variables for collision data
-        float penDepth = std::numeric_limits<float>::infinity();
-        Vector2 normal;
-        std::vector<Vector2> contactPoints;
-        int contactCount = 0;
+            return found;
+        }
 
-        //Check against normals of polygon
-        for (int i = 0; i < vertices.size(); i++)
-        {
-            Vector2 vertexA = vertices[i];
-            Vector2 vertexB = vertices[(i + 1) % vertices.size()];
+        bool polygonTarget = targetType == ColliderShape::Rectangle || targetType == ColliderShape::Polygon;
 
-            Vector2 edge = vertexB - vertexA;
-            Vector2 axis = {-edge.y, edge.x};
-            axis = axis.getNormal();
+        //Swept shape is a circle
+        if (shapeType == ColliderShape::Circle)
+        {
+            const CircleCollider* circle = static_cast<const CircleCollider*>(shape);
+
+            if (targetType == ColliderShape::Circle)
+                return shapeCastCircleCircle(circle->getPosition(),
+                    circle->getRadius(),
+                    displacement,
+                    static_cast<const CircleCollider*>(target),
+                    hit);
+
+            else if (targetType == ColliderShape::Rectangle)
+                return shapeCastCircleRect(circle->getPosition(),
+                    circle->getRadius(),
+                    displacement,
+                    static_cast<const RectCollider*>(target),
+                    hit);
+
+            else if (targetType == ColliderShape::Polygon)
+                return shapeCastCirclePolygon(circle->getPosition(),
+                    circle->getRadius(),
+                    displacement,
+                    static_cast<const PolygonCollider*>(target),
+                    hit);
+
+            else if (targetType == ColliderShape::Capsule)
+                return shapeCastCircleCapsule(circle->getPosition(),
+                    circle->getRadius(),
+                    displacement,
+                    static_cast<const CapsuleCollider*>(target),
+                    hit);
+
+            else if (targetType == ColliderShape::Chain)
+                return shapeCastCircleChain(circle->getPosition(),
+                    circle->getRadius(),
+                    displacement,
+                    static_cast<const ChainCollider*>(target),
+                    hit);
+        }
 
-            Projection circleProjection = projectCircleOntoAxis(center, radius, axis);
-            Projection polygonProjection = projectPolygonOntoAxis(vertices, axis);
+        //Swept shape is a rectangle or polygon
+        else if (shapeType == ColliderShape::Rectangle || shapeType == ColliderShape::Polygon)
+        {
+            if (polygonTarget)
+                return shapeCastPolygonPolygon(shape, displacement, target, hit);
 
-            if (circleProjection.min > polygonProjection.max || polygonProjection.min > circleProjection.max)
-                return nullptr;
+            else if (targetType == ColliderShape::Capsule)
+                return shapeCastConvex(shape, displacement, target, hit);
 
-            float axisPenDepth =
-                std::min(polygonProjection.max - circleProjection.min, circleProjection.max - polygonProjection.min);
+            else if (targetType == ColliderShape::Chain)
+                return shapeCastConvexChain(shape, displacement, static_cast<const ChainCollider*>(target), hit);
 
-            if (axisPenDepth < penDepth)
+            //Sweep the circle the opposite way against the shape, then flip the result back
+            else if (targetType == ColliderShape::Circle)
             {
-                penDepth = axisPenDepth;
-                normal = axis;
+                const CircleCollider* circle = static_cast<const CircleCollider*>(target);
+
+                ShapeCastHit reversed;
+                bool found = shapeType == ColliderShape::Rectangle
+                                 ? shapeCastCircleRect(circle->getPosition(),
+                                       circle->getRadius(),
+                                       -displacement,
+                                       static_cast<const RectCollider*>(shape),
+                                       reversed)
+                                 : shapeCastCirclePolygon(circle->getPosition(),
+                                       circle->getRadius(),
+                                       -displacement,
+                                       static_cast<const PolygonCollider*>(shape),
+                                       reversed);
+                if (!found)
+                    return false;
+
+                hit.body = circle->getParent();
+                hit.fraction = reversed.fraction;
+                hit.normal = -reversed.normal;
+                hit.point = circle->getPosition() + reversed.normal * -circle->getRadius();
+
+                return true;
             }
         }
 
-        //Check against axis between circle center and closest point
-        int closestIndex = findClosestPointToCenter(center, vertices);
-        Vector2 closestPoint = vertices[closestIndex];
+        //Swept shape is a capsule
+        else if (shapeType == ColliderShape::Capsule && (polygonTarget || targetType == ColliderShape::Capsule))
+        {
+            return shapeCastConvex(shape, displacement, target, hit);
+        }
 
-        Vector2 axis = closestPoint - center;
-        axis = axis.getNormal();
+        else if (shapeType == ColliderShape::Capsule && targetType == ColliderShape::Chain)
+        {
+            return shapeCastConvexChain(shape, displacement, static_cast<const ChainCollider*>(target), hit);
+        }
 
-        Projection circleProjection = projectCircleOntoAxis(center, radius, axis);
-        Projection polygonProjection = projectPolygonOntoAxis(vertices, axis);
+        //Sweep the circle the opposite way against the capsule, then flip the result back
+        else if (shapeType == ColliderShape::Capsule && targetType == ColliderShape::Circle)
+        {
+            const CircleCollider* circle = static_cast<const CircleCollider*>(target);
 
-        if (circleProjection.min > polygonProjection.max || polygonProjection.min > circleProjection.max)
-            return nullptr;
+            ShapeCastHit reversed;
+            if (!shapeCastCircleCapsule(circle->getPosition(),
+                    circle->getRadius(),
+                    -displacement,
+                    static_cast<const CapsuleCollider*>(shape),
+                    reversed))
+                return false;
 
-        float axisPenDepth =
-            std::min(polygonProjection.max - circleProjection.min, circleProjection.max - polygonProjection.min);
+            hit.body = circle->getParent();
+            hit.fraction = reversed.fraction;
+            hit.normal = -reversed.normal;
+            hit.point = circle->getPosition() + reversed.normal * -circle->getRadius();
 
-        if (axisPenDepth < penDepth)
-        {
-            penDepth = axisPenDepth;
-            normal = axis;
+            return true;
         }
 
-        //Ensure normal points from circle to polygon
-        Vector2 direction = polygon->getParent()->getPosition() - circle->getParent()->getPosition();
-        if (normal.projectOntoAxis(direction) < 0)
-            normal = -normal;
-
-        //Find contact points
-        contactPoints = findCirclePolygonContactPoints(center, radius, vertices);
-        contactCount = contactPoints.size();
-
-        //Return a collision object with data if collision was found
-        return new Collision(circle->getParent(), polygon->getParent(), normal, penDepth, contactPoints, contactCount);
+        return false;
     }
 
-    //Returns the min and max of verticies projected onto an axis in a Vector2 struct
-    const Projection CollisionDetection::projectPolygonOntoAxis(
-        const std::vector<Vector2>& vertices, const Vector2& axis)
+    //Sweeps a circle against a circle by casting its center against the summed radii
+    bool CollisionDetection::shapeCastCircleCircle(const Vector2& center,
+        float radius,
+        const Vector2& displacement,
+        const CircleCollider* target,
+        ShapeCastHit& hit)
     {
-        float min = std::numeric_limits<float>::infinity();
-        float max = -std::numeric_limits<float>::infinity();
+        Vector2 targetCenter = target->getPosition();
+        float targetRadius = target->getRadius();
+        float sumRadii = radius + targetRadius;
 
-        for (int i = 0; i < vertices.size(); i++)
-        {
-            Vector2 vertex = vertices[i];
-            float projection = vertex.projectOntoAxis(axis);
+        Vector2 offset = center - targetCenter;
 
-            if (projection < min)
-                min = projection;
+        //Already overlapping
+        if (offset.getSquare() <= sumRadii * sumRadii)
+        {
+            hit.body = target->getParent();
+            hit.fraction = 0.0f;
+            hit.normal = offset.getSquare() > 0.0f ? offset.getNormal() : -displacement.getNormal();
+            hit.point = targetCenter + hit.normal * targetRadius;
 
-            if (projection > max)
-                max = projection;
+            return true;
         }
 
-        return {min, max};
+        float fraction;
+        Vector2 normal;
+        if (!sweepPointVsCircle(center, displacement, targetCenter, sumRadii, fraction, normal))
+            return false;
+
+        hit.body = target->getParent();
+        hit.fraction = fraction;
+        hit.normal = normal;
+        hit.point = targetCenter + normal * targetRadius;
+
+        return true;
     }
 
-    //Returns the min and max of a circle projected onto an axis
-    const Projection CollisionDetection::projectCircleOntoAxis(const Vector2& center, float radius, const Vector2& axis)
+    //Sweeps a circle against a rectangle by casting its center against the rectangle rounded by the radius
+    bool CollisionDetection::shapeCastCircleRect(const Vector2& center,
+        float radius,
+        const Vector2& displacement,
+        const RectCollider* target,
+        ShapeCastHit& hit)
     {
-        Vector2 axisDirection = axis.getNormal();
-        Vector2 directionWithRadius = axisDirection * radius;
+        float cos = std::cos(target->getRotation());
+        float sin = std::sin(target->getRotation());
 
-        Vector2 point1 = center + directionWithRadius;
-        Vector2 point2 = center - directionWithRadius;
+        //Work in the rectangle's local space
+        Vector2 localCenter = toRectLocalSpace(target, center);
+        Vector2 localDisplacement = {
+            displacement.x * cos + displacement.y * sin, -displacement.x * sin + displacement.y * cos};
 
-        float projection1 = point1.projectOntoAxis(axis);
-        float projection2 = point2.projectOntoAxis(axis);
+        float halfWidth = target->getWidth() / 2.0f;
+        float halfHeight = target->getHeight() / 2.0f;
 
-        float min;
-        float max;
+        float bestFraction = std::numeric_limits<float>::infinity();
+        Vector2 localNormal;
 
-        if (projection1 > projection2)
+        //Already overlapping
+        Vector2 closest = {
+            std::clamp(localCenter.x, -halfWidth, halfWidth), std::clamp(localCenter.y, -halfHeight, halfHeight)};
+        Vector2 closestToCenter = localCenter - closest;
+
+        if (closestToCenter.getSquare() <= radius * radius)
         {
-            min = projection2;
-            max = projection1;
+            bestFraction = 0.0f;
+            localNormal = closestToCenter.getSquare() > 0.0f ? closestToCenter.getNormal()
+                                                             : -localDisplacement.getNormal();
         }
         else
         {
-            min = projection1;
-            max = projection2;
-        }
+            //The rounded rectangle is the union of two grown boxes and four corner circles
+            float fraction;
+            Vector2 normal;
 
-        return {min, max};
-    }
+            if (sweepPointVsBox(localCenter, localDisplacement, {halfWidth + radius, halfHeight}, fraction, normal) &&
+                fraction < bestFraction)
+            {
+                bestFraction = fraction;
+                localNormal = normal;
+            }
 
-    //Find closest point on polygon to circle center, returns the index
-    int CollisionDetection::findClosestPointToCenter(const Vector2& center, const std::vector<Vector2>& vertices)
-    {
-        int index = 0;
-        float minDistanceSquared = center.getVectorTo(vertices[0]).getSquare();
+            if (sweepPointVsBox(localCenter, localDisplacement, {halfWidth, halfHeight + radius}, fraction, normal) &&
+                fraction < bestFraction)
+            {
+                bestFraction = fraction;
+                localNormal = normal;
+            }
 
-        for (int i = 1; i < vertices.size(); i++)
-        {
-            float distanceSquared = center.getVectorTo(vertices[i]).getSquare();
-            if (distanceSquared < minDistanceSquared)
+            const Vector2 corners[4] = {
+                {-halfWidth, -halfHeight}, {halfWidth, -halfHeight}, {halfWidth, halfHeight}, {-halfWidth, halfHeight}};
+
+            for (const Vector2& corner : corners)
             {
-                minDistanceSquared = distanceSquared;
-                index = i;
+                if (sweepPointVsCircle(localCenter, localDisplacement, corner, radius, fraction, normal) &&
+                    fraction < bestFraction)
+                {
+                    bestFraction = fraction;
+                    localNormal = normal;
+                }
             }
+
+            if (bestFraction > 1.0f)
+                return false;
         }
 
-        return index;
+        //Contact lies one radius behind the circle center along the normal
+        Vector2 localPoint = localCenter + localDisplacement * bestFraction - localNormal * radius;
+
+        hit.body = target->getParent();
+        hit.fraction = bestFraction;
+        hit.normal = {localNormal.x * cos - localNormal.y * sin, localNormal.x * sin + localNormal.y * cos};
+        hit.point = target->getPosition() +
+                    Vector2(localPoint.x * cos - localPoint.y * sin, localPoint.x * sin + localPoint.y * cos);
+
+        return true;
     }
 
-    //Sorts into respective function based on body shapes
-    Collision* CollisionDetection::checkCollision(PhysicsBody* bodyA, PhysicsBody* bodyB)
+    //Sweeps a circle against a polygon by casting its center against the polygon rounded by the radius
+    bool CollisionDetection::shapeCastCirclePolygon(const Vector2& center,
+        float radius,
+        const Vector2& displacement,
+        const PolygonCollider* target,
+        ShapeCastHit& hit)
     {
-        //Get colliders
-        Collider* colliderA = bodyA->getCollider();
-        Collider* colliderB = bodyB->getCollider();
+        ConvexPolygon polygon;
+        if (!makeConvexPolygon(target, polygon))
+            return false;
 
-        //Check if they should collide based on layers and masks
-        if (!shouldCollide(colliderA, colliderB))
-            return nullptr;
+        float bestFraction = std::numeric_limits<float>::infinity();
+        Vector2 bestNormal;
 
-        //Get collider shapes
-        ColliderShape shapeA = colliderA->getShape();
-        ColliderShape shapeB = colliderB->getShape();
+        //Already overlapping
+        Vector2 closest;
+        Vector2 normal;
 
-        //First collider is a rectangle
-        if (shapeA == ColliderShape::Rectangle)
+        if (findClosestPointOnPolygon(polygon, center, closest, normal) <= radius)
         {
-            RectCollider* rectA = static_cast<RectCollider*>(colliderA);
+            hit.body = target->getParent();
+            hit.fraction = 0.0f;
+            hit.normal = normal;
+            hit.point = closest;
 
-            //Second collider is also a rectangle
-            if (shapeB == ColliderShape::Rectangle)
-            {
-                RectCollider* rectB = static_cast<RectCollider*>(colliderB);
-
-                //Check for polygon collision
-                return checkPolygonCollision(rectA, rectB);
-            }
-
-            //Second collider is a circle
-            else if (shapeB == ColliderShape::Circle)
-            {
-                CircleCollider* circleB = static_cast<CircleCollider*>(colliderB);
-
-                //Check for circle-polygon collision
-                return checkCirclePolygonCollision(circleB, rectA);
-            }
+            return true;
         }
 
-        //First collider is a circle
-        else if (shapeA == ColliderShape::Circle)
+        //The rounded polygon is the union of the edges pushed out by the radius and circles around the vertices
+        for (int i = 0; i < polygon.count; i++)
         {
-            CircleCollider* circleA = static_cast<CircleCollider*>(colliderA);
+            const Vector2& edgeNormal = polygon.normals[i];
+            const Vector2& vertexA = polygon.vertices[i];
+            const Vector2& vertexB = polygon.vertices[(i + 1) % polygon.count];
 
-            //Second collider is also a circle
-            if (shapeB == ColliderShape::Circle)
+            //Only edges the circle moves towards can be hit on their face
+            float speed = displacement.projectOntoAxis(edgeNormal);
+            if (speed < 0.0f)
             {
-                CircleCollider* circleB = static_cast<CircleCollider*>(colliderB);
+                float fraction = (radius - (center - vertexA).projectOntoAxis(edgeNormal)) / speed;
 
-                //Check for circle-circle collision
-                return checkCircleCollision(circleA, circleB);
+                //Touching point must lie between the edge's vertices
+                Vector2 edge = vertexB - vertexA;
+                Vector2 touching = center + displacement * fraction - edgeNormal * radius;
+                float along = (touching - vertexA).projectOntoAxis(edge);
+
+                if (fraction >= 0.0f && fraction < bestFraction && along >= 0.0f && along <= edge.getSquare())
+                {
+                    bestFraction = fraction;
+                    bestNormal = edgeNormal;
+                }
             }
 
-            //Second collider is a rectangle
-            else if (shapeB == ColliderShape::Rectangle)
+            float fraction;
+            if (sweepPointVsCircle(center, displacement, vertexA, radius, fraction, normal) && fraction < bestFraction)
             {
-                RectCollider* rectB = static_cast<RectCollider*>(colliderB);
-
-                //Check for rect-circle collision
-                return checkCirclePolygonCollision(circleA, rectB);
+                bestFraction = fraction;
+                bestNormal = normal;
             }
         }
 
-        return nullptr;
-    }
+        if (bestFraction > 1.0f)
+            return false;
 
-    //Calculate collision between two circle colliders
-    Collision* CollisionDetection::checkCircleCollision(CircleCollider* circleA, CircleCollider* circleB)
-    {
-        //Get positions of centers
-        Vector2 circleAPos = circleA->getPosition();
-        Vector2 circleBPos = circleB->getPosition();
+        //Contact lies one radius behind the circle center along the normal
+        hit.body = target->getParent();
+        hit.fraction = bestFraction;
+        hit.normal = bestNormal;
+        hit.point = center + displacement * bestFraction - bestNormal * radius;
 
-        //Get radii
-        float circleARadius = circleA->getRadius();
-        float circleBRadius = circleB->getRadius();
+        return true;
+    }
 
-        float sumRadii = circleARadius + circleBRadius;
+    //Sweeps a circle against a capsule by casting its center against the capsule grown by the radius
+    bool CollisionDetection::shapeCastCircleCapsule(const Vector2& center,
+        float radius,
+        const Vector2& displacement,
+        const CapsuleCollider* target,
+        ShapeCastHit& hit)
+    {
+        float sumRadii = radius + target->getRadius();
 
-        //Calculate distance squared between circles
-        Vector2 vectorBetweenCenters = circleAPos.getVectorTo(circleBPos);
-        float distanceSquared = vectorBetweenCenters.getSquare();
+        //Already overlapping
+        Vector2 closest = findClosestPointOnCapsuleSegment(target, center);
+        Vector2 offset = center - closest;
 
-        //Check if distance squared is less than sum of radii squared
-        if (distanceSquared <= (sumRadii * sumRadii))
+        if (offset.getSquare() <= sumRadii * sumRadii)
         {
-            //Get the normal and penetration depth of the collision
-            Vector2 normal = circleAPos.getDirectionTo(circleBPos);
-            float penDepth = sumRadii - (circleAPos.getVectorTo(circleBPos)).getLength();
-
-            //Find contact points
-            std::vector<Vector2> contactPoints = findCircleContactPoints(circleAPos, circleARadius, circleBPos, normal);
-            int contactCount = contactPoints.size();
+            hit.body = target->getParent();
+            hit.fraction = 0.0f;
+            hit.normal = offset.getSquare() > 0.0f ? offset.getNormal() : -displacement.getNormal();
+            hit.point = closest + hit.normal * target->getRadius();
 
-            //Return a collision object
-            return new Collision(
-                circleA->getParent(), circleB->getParent(), normal, penDepth, contactPoints, contactCount);
+            return true;
         }
 
-        //If no collision is detected
-        return nullptr;
+        float fraction;
+        Vector2 normal;
+        if (!sweepPointVsCapsule(center, displacement, target, sumRadii, fraction, normal))
+            return false;
+
+        //Contact lies one radius behind the circle center along the normal
+        hit.body = target->getParent();
+        hit.fraction = fraction;
+        hit.normal = normal;
+        hit.point = center + displacement * fraction - normal * radius;
+
+        return true;
     }
 
-    //Find contact point between two circles
-    std::vector<Vector2> CollisionDetection::findCircleContactPoints(
-        const Vector2& centerA, float radiusA, const Vector2& centerB, const Vector2& normal)
+    //Sweeps a circle against the front of the segments of a chain
+    bool CollisionDetection::shapeCastCircleChain(const Vector2& center,
+        float radius,
+        const Vector2& displacement,
+        const ChainCollider* target,
+        ShapeCastHit& hit)
     {
-        std::vector<Vector2> contactPoints;
+        Vector2 extents = {radius, radius};
+        Vector2 moved = center + displacement;
+        AABB sweptBox({std::min(center.x, moved.x), std::min(center.y, moved.y)},
+            {std::max(center.x, moved.x), std::max(center.y, moved.y)});
+        sweptBox = AABB(sweptBox.min - extents, sweptBox.max + extents);
 
-        Vector2 contact = centerA + normal * radiusA;
-        contactPoints.push_back(contact);
+        bool found = false;
 
-        return contactPoints;
+        target->querySegments(sweptBox,
+            [target, &center, radius, &displacement, &hit, &found](int segment)
+            {
+                Vector2 start;
+                Vector2 end;
+                target->getSegment(segment, start, end);
+
+                //Circles centered behind a segment pass through it
+                Vector2 tangent = (end - start).getNormal();
+                Vector2 faceNormal = {-tangent.y, tangent.x};
+                if ((center - start).projectOntoAxis(faceNormal) < 0.0f)
+                    return true;
+
+                //Already overlapping
+                Vector2 closest = findClosestPointOnSegment(center, start, end);
+                Vector2 offset = center - closest;
+
+                if (offset.getSquare() <= radius * radius)
+                {
+                    hit.body = target->getParent();
+                    hit.fraction = 0.0f;
+                    hit.normal = offset.getSquare() > 0.0f ? offset.getNormal() : faceNormal;
+                    hit.point = closest;
+                    found = true;
+
+                    return false;
+                }
+
+                float fraction;
+                Vector2 normal;
+                if (sweepPointVsSegment(center, displacement, start, end, radius, fraction, normal) &&
+                    (!found || fraction < hit.fraction))
+                {
+                    hit.body = target->getParent();
+                    hit.fraction = fraction;
+                    hit.normal = normal;
+                    hit.point = center + displacement * fraction - normal * radius;
+                    found = true;
+                }
+
+                return true;
+            });
+
+        return found;
     }
 
-    //Find contact point between a circle and polygon
-    std::vector<Vector2> CollisionDetection::findCirclePolygonContactPoints(
-        const Vector2& circleCenter, float circleRadius, const std::vector<Vector2>& polygonVertices)
+    //Sweeps a circle, capsule, rectangle or polygon against another by conservative advancement on their GJK distance
+    bool CollisionDetection::shapeCastConvex(
+        const Collider* shape, const Vector2& displacement, const Collider* target, ShapeCastHit& hit)
     {
-        std::vector<Vector2> contactPoints;
-        Vector2 contact;
+        SupportShape swept;
+        SupportShape other;
 
-        float minDistanceSquared = std::numeric_limits<float>::infinity();
+        if (!makeSupportShape(shape, swept) || !makeSupportShape(target, other))
+            return false;
 
-        //Loop through edges of polygon and find closest point to circle center
-        for (int i = 0; i < polygonVertices.size(); i++)
-        {
-            Vector2 vertexA = polygonVertices[i];
-            Vector2 vertexB = polygonVertices[(i + 1) % polygonVertices.size()];
+        //Cores overlapping at the start have no closest points, push back against the motion
+        Vector2 overlapNormal = displacement.getSquare() > 0.0f ? -displacement.getNormal() : Vector2(0.0f, 1.0f);
 
-            Vector2 closestPointOnEdge = findClosestPointOnSegment(circleCenter, vertexA, vertexB);
-            float distanceSquared = (circleCenter - closestPointOnEdge).getSquare();
+        float fraction;
+        Vector2 normal;
+        Vector2 point;
+        if (!sweepSupportShapes(swept, displacement, other, overlapNormal, fraction, normal, point))
+            return false;
 
-            if (distanceSquared < minDistanceSquared)
-            {
-                minDistanceSquared = distanceSquared;
-                contact = closestPointOnEdge;
-            }
-        }
+        hit.body = target->getParent();
+        hit.fraction = fraction;
+        hit.normal = normal;
+        hit.point = point;
 
-        contactPoints.push_back(contact);
+        return true;
+    }
 
-        return contactPoints;
+    //Sweeps a capsule, rectangle or polygon against the front of the segments of a chain
+    bool CollisionDetection::shapeCastConvexChain(
+        const Collider* shape, const Vector2& displacement, const ChainCollider* target, ShapeCastHit& hit)
+    {
+        SupportShape swept;
+        if (!makeSupportShape(shape, swept))
+            return false;
+
+        const AABB& box = shape->getAABB();
+        AABB sweptBox = AABB::combine(box, AABB(box.min + displacement, box.max + displacement));
+        Vector2 center = shape->getPosition();
+        bool found = false;
+
+        target->querySegments(sweptBox,
+            [target, &swept, &center, &displacement, &hit, &found](int segment)
+            {
+                Vector2 start;
+                Vector2 end;
+                target->getSegment(segment, start, end);
+
+                //Shapes centered behind a segment pass through it
+                Vector2 tangent = (end - start).getNormal();
+                Vector2 faceNormal = {-tangent.y, tangent.x};
+                if ((center - start).projectOntoAxis(faceNormal) < 0.0f)
+                    return true;
+
+                //The segment is a two vertex core with both sides as faces
+                SupportShape segmentShape;
+                segmentShape.radius = 0.0f;
+                segmentShape.core.count = 2;
+                segmentShape.core.vertices[0] = start;
+                segmentShape.core.vertices[1] = end;
+                segmentShape.core.normals[0] = -faceNormal;
+                segmentShape.core.normals[1] = faceNormal;
+
+                float fraction;
+                Vector2 normal;
+                Vector2 point;
+                if (!sweepSupportShapes(swept, displacement, segmentShape, faceNormal, fraction, normal, point) ||
+                    (found && fraction >= hit.fraction))
+                    return true;
+
+                hit.body = target->getParent();
+                hit.fraction = fraction;
+                hit.normal = normal;
+                hit.point = point;
+                found = true;
+
+                //Nothing comes before a shape that starts touching
+                return fraction > 0.0f;
+            });
+
+        return found;
     }
 
-    //Find contact points between two polygons
-    std::vector<Vector2> CollisionDetection::findPolygonContactPoints(
-        std::vector<Vector2>& verticesA, std::vector<Vector2>& verticesB)
+    //Sweeps a rectangle or polygon against a rectangle or polygon using the separating axis theorem over time
+    bool CollisionDetection::shapeCastPolygonPolygon(
+        const Collider* shape, const Vector2& displacement, const Collider* target, ShapeCastHit& hit)
     {
-        std::vector<Vector2> contactPoints;
-        Vector2 contact1;
-        Vector2 contact2;
-        int contactCount = 0;
+        ConvexPolygon polygonA;
+        ConvexPolygon polygonB;
 
-        float minDistanceSquared = std::numeric_limits<float>::infinity();
+        if (!makeConvexPolygon(shape, polygonA) || !makeConvexPolygon(target, polygonB))
+            return false;
+
+        //Face normals of both polygons, the first ones belong to the swept shape
+        Vector2 axes[PolygonCollider::MAX_VERTICES * 2];
+        int axisCount = polygonA.count + polygonB.count;
+        std::copy(polygonA.normals, polygonA.normals + polygonA.count, axes);
+        std::copy(polygonB.normals, polygonB.normals + polygonB.count, axes + polygonA.count);
 
-        //Loop through points of polygon A
-        for (int i = 0; i < verticesA.size(); i++)
+        float enterTime = -std::numeric_limits<float>::infinity();
+        float exitTime = std::numeric_limits<float>::infinity();
+        int enterAxis = -1;
+        Vector2 enterNormal;
+
+        //Axis of least penetration in case the shapes start overlapping
+        float minPenetration = std::numeric_limits<float>::infinity();
+        Vector2 penetrationNormal;
+
+        for (int i = 0; i < axisCount; i++)
         {
-            Vector2 point = verticesA[i];
+            const Vector2& axis = axes[i];
+            Projection projectionA = projectPolygonOntoAxis(polygonA.vertices, polygonA.count, axis);
+            Projection projectionB = projectPolygonOntoAxis(polygonB.vertices, polygonB.count, axis);
+            float speed = displacement.projectOntoAxis(axis);
 
-            //Check against edges of polygon B and find closest point on edge
-            for (int j = 0; j < verticesB.size(); j++)
-            {
-                Vector2 vertexA = verticesB[j];
-                Vector2 vertexB = verticesB[(i + 1) % verticesB.size()];
+            float axisEnter;
+            float axisExit;
+            Vector2 axisNormal;
 
-                Vector2 edge = vertexB - vertexA;
-                Vector2 closestPointOnEdge = findClosestPointOnSegment(point, vertexA, vertexB);
-                float distanceSquared = (point - closestPointOnEdge).getSquare();
+            //Shape is on the negative side of the target along this axis
+            if (projectionA.max < projectionB.min)
+            {
+                if (speed <= 0.0f)
+                    return false;
 
-                if (distanceSquared == minDistanceSquared && closestPointOnEdge != contact1)
-                {
-                    contact2 = closestPointOnEdge;
-                    contactCount = 2;
-                }
-                else if (distanceSquared < minDistanceSquared)
-                {
-                    minDistanceSquared = distanceSquared;
-                    contact1 = closestPointOnEdge;
-                    contactCount = 1;
-                }
+                axisEnter = (projectionB.min - projectionA.max) / speed;
+                axisExit = (projectionB.max - projectionA.min) / speed;
+                axisNormal = -axis;
             }
-        }
 
-        //Loop through points of polygon B
-        for (int i = 0; i < verticesB.size(); i++)
-        {
-            Vector2 point = verticesB[i];
+            //Shape is on the positive side of the target along this axis
+            else if (projectionB.max < projectionA.min)
+            {
+                if (speed >= 0.0f)
+                    return false;
 
-            //Check against edges of polygon A and find closest point on edge
-            for (int j = 0; j < verticesA.size(); j++)
+                axisEnter = (projectionB.max - projectionA.min) / speed;
+                axisExit = (projectionB.min - projectionA.max) / speed;
+                axisNormal = axis;
+            }
+
+            //Already overlapping along this axis, find when they separate
+            else
             {
-                Vector2 vertexA = verticesA[j];
-                Vector2 vertexB = verticesA[(i + 1) % verticesA.size()];
+                axisEnter = -std::numeric_limits<float>::infinity();
 
-                Vector2 edge = vertexB - vertexA;
-                Vector2 closestPointOnEdge = findClosestPointOnSegment(point, vertexA, vertexB);
-                float distanceSquared = (point - closestPointOnEdge).getSquare();
+                if (speed > 0.0f)
+                    axisExit = (projectionB.max - projectionA.min) / speed;
+                else if (speed < 0.0f)
+                    axisExit = (projectionB.min - projectionA.max) / speed;
+                else
+                    axisExit = std::numeric_limits<float>::infinity();
+
+                float pushPositive = projectionB.max - projectionA.min;
+                float pushNegative = projectionA.max - projectionB.min;
 
-                if (distanceSquared == minDistanceSquared && closestPointOnEdge != contact1)
+                if (pushPositive < minPenetration)
                 {
-                    contact2 = closestPointOnEdge;
-                    contactCount = 2;
+                    minPenetration = pushPositive;
+                    penetrationNormal = axis;
                 }
-                else if (distanceSquared < minDistanceSquared)
+
+                if (pushNegative < minPenetration)
                 {
-                    minDistanceSquared = distanceSquared;
-                    contact1 = closestPointOnEdge;
-                    contactCount = 1;
+                    minPenetration = pushNegative;
+                    penetrationNormal = -axis;
                 }
             }
-        }
 
-        //Return contact points
-        if (contactCount == 1)
-        {
-            contactPoints.push_back(contact1);
+            if (axisEnter > enterTime)
+            {
+                enterTime = axisEnter;
+                enterAxis = i;
+                enterNormal = axisNormal;
+            }
+
+            exitTime = std::min(exitTime, axisExit);
 
-            return contactPoints;
+            if (enterTime > exitTime)
+                return false;
         }
 
-        else if (contactCount == 2)
+        if (enterTime > 1.0f)
+            return false;
+
+        hit.body = target->getParent();
+
+        //Overlapping on every axis at the start
+        if (enterAxis == -1)
         {
-            contactPoints.push_back(contact1);
-            contactPoints.push_back(contact2);
+            hit.fraction = 0.0f;
+            hit.normal = penetrationNormal;
+            hit.point = shape->getPosition();
 
-            return contactPoints;
+            return true;
         }
-    }
 
-    //Find closest point on a segment to another point
-    const Vector2 CollisionDetection::findClosestPointOnSegment(
-        const Vector2& point, const Vector2& vertexA, const Vector2& vertexB)
-    {
-        Vector2 edge = vertexB - vertexA;
-        Vector2 aToPoint = point - vertexA;
+        hit.fraction = enterTime;
+        hit.normal = enterNormal;
 
-        float projection = aToPoint.projectOntoAxis(edge);
-        float edgeLengthSquared = edge.getSquare();
-        float distance = projection / edgeLengthSquared;
+        //Contact is the feature closest to the other polygon at the time of impact
+        //When the separating face belongs to the target, the shape's leading vertices touch it and vice versa
+        bool targetFace = enterAxis >= polygonA.count;
+        Vector2 offset = displacement * enterTime;
+        const ConvexPolygon& feature = targetFace ? polygonA : polygonB;
+        float direction = targetFace ? 1.0f : -1.0f;
 
-        if (distance < 0)
-        {
-            return vertexA;
-        }
-        else if (distance > 1)
-        {
-            return vertexB;
-        }
-        else
+        float best = std::numeric_limits<float>::infinity();
+        for (int i = 0; i < feature.count; i++)
+            best = std::min(best, feature.vertices[i].projectOntoAxis(enterNormal) * direction);
+
+        Vector2 sum;
+        int count = 0;
+        for (int i = 0; i < feature.count; i++)
         {
-            return vertexA + edge * distance;
+            if (feature.vertices[i].projectOntoAxis(enterNormal) * direction <= best + 1e-4f)
+            {
+                sum += feature.vertices[i];
+                count++;
+            }
         }
-    }
 
+        hit.point = sum / static_cast<float>(count);
+        if (targetFace)
+            hit.point += offset;
+
+        return true;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,266 @@
+//Class implementation for compound colliders
+
+#include "collisions/CompoundCollider.hpp"
+#include "collisions/RectCollider.hpp"
+#include "collisions/CircleCollider.hpp"
+#include "collisions/PolygonCollider.hpp"
+#include "collisions/CapsuleCollider.hpp"
+#include <algorithm>
+
+namespace phys
+{
+    //Returns the area of a child, its rotational inertia about its own position for a mass of 1,
+    //and the distance of its farthest point from its position
+    static float getChildMassProperties(const Collider* child, float& unitInertia, float& radius)
+    {
+        const float PI = 3.14159265f;
+        ColliderShape shape = child->getShape();
+
+        if (shape == ColliderShape::Circle)
+        {
+            float circleRadius = static_cast<const CircleCollider*>(child)->getRadius();
+            unitInertia = circleRadius * circleRadius / 2.0f;
+            radius = circleRadius;
+
+            return PI * circleRadius * circleRadius;
+        }
+
+        else if (shape == ColliderShape::Rectangle)
+        {
+            const RectCollider* rect = static_cast<const RectCollider*>(child);
+            float width = rect->getWidth();
+            float height = rect->getHeight();
+
+            unitInertia = (width * width + height * height) / 12.0f;
+            radius = std::sqrt(width * width + height * height) / 2.0f;
+
+            return width * height;
+        }
+
+        else if (shape == ColliderShape::Polygon)
+        {
+            const PolygonCollider* polygon = static_cast<const PolygonCollider*>(child);
+            unitInertia = polygon->getUnitInertia();
+            radius = polygon->getRadius();
+
+            return polygon->getArea();
+        }
+
+        else if (shape == ColliderShape::Capsule)
+        {
+            const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(child);
+            unitInertia = capsule->getUnitInertia();
+            radius = capsule->getHalfLength() + capsule->getRadius();
+
+            return capsule->getArea();
+        }
+
+        unitInertia = 0.0f;
+        radius = 0.0f;
+
+        return 0.0f;
+    }
+
+    //Constructor to create a compound without children
+    CompoundCollider::CompoundCollider(ColliderType colliderType) :
+        Collider(ColliderShape::Compound, colliderType),
+        m_centroid({0, 0}),
+        m_area(0),
+        m_unitInertia(0),
+        m_radius(0),
+        m_cos(1),
+        m_sin(0)
+    {
+    }
+
+    //Destructor to delete the children
+    CompoundCollider::~CompoundCollider()
+    {
+        for (Collider* child : m_children)
+            delete child;
+    }
+
+    //Adds a child at an offset and rotation relative to the body
+    bool CompoundCollider::addChild(Collider* child, const Vector2& offset, float rotation)
+    {
+        if (!child)
+            return false;
+
+        ColliderShape shape = child->getShape();
+        if (shape == ColliderShape::Compound || shape == ColliderShape::Chain || shape == ColliderShape::TileMap)
+            return false;
+
+        child->setParent(m_parent);
+
+        m_children.push_back(child);
+        m_childOffsets.push_back(offset);
+        m_childRotations.push_back(rotation);
+
+        rebuild();
+
+        return true;
+    }
+
+    //Getters for member variables
+    int CompoundCollider::getChildCount() const
+    {
+        return static_cast<int>(m_children.size());
+    }
+
+    Collider* CompoundCollider::getChild(int index) const
+    {
+        return m_children[index];
+    }
+
+    const Vector2& CompoundCollider::getChildOffset(int index) const
+    {
+        return m_childOffsets[index];
+    }
+
+    float CompoundCollider::getChildRotation(int index) const
+    {
+        return m_childRotations[index];
+    }
+
+    const Vector2& CompoundCollider::getCentroid() const
+    {
+        return m_centroid;
+    }
+
+    float CompoundCollider::getArea() const
+    {
+        return m_area;
+    }
+
+    float CompoundCollider::getUnitInertia() const
+    {
+        return m_unitInertia;
+    }
+
+    float CompoundCollider::getRadius() const
+    {
+        return m_radius;
+    }
+
+    //Children share the body of the compound
+    void CompoundCollider::setParent(PhysicsBody* newParent)
+    {
+        Collider::setParent(newParent);
+
+        for (Collider* child : m_children)
+            child->setParent(newParent);
+    }
+
+    //Recomputes the centroid, mass properties, local boxes and hierarchy after the children change
+    void CompoundCollider::rebuild()
+    {
+        int childCount = getChildCount();
+
+        std::vector<float> areas(childCount);
+        std::vector<float> inertias(childCount);
+        std::vector<float> radii(childCount);
+
+        //Area weighted centroid of the children as given
+        Vector2 weightedCenter;
+        m_area = 0.0f;
+
+        for (int i = 0; i < childCount; i++)
+        {
+            areas[i] = getChildMassProperties(m_children[i], inertias[i], radii[i]);
+            weightedCenter += m_childOffsets[i] * areas[i];
+            m_area += areas[i];
+        }
+
+        m_centroid = m_area > 0.0f ? weightedCenter / m_area : Vector2(0, 0);
+
+        //Each child's inertia moved to the centroid by the parallel axis theorem
+        float inertia = 0.0f;
+        m_radius = 0.0f;
+        m_childBoxes.resize(childCount);
+
+        for (int i = 0; i < childCount; i++)
+        {
+            Vector2 localOffset = m_childOffsets[i] - m_centroid;
+            inertia += areas[i] * (inertias[i] + localOffset.getSquare());
+            m_radius = std::max(m_radius, localOffset.getLength() + radii[i]);
+
+            //Place the child at its local transform once to find its local box
+            m_children[i]->setOffset(localOffset);
+            m_children[i]->setTransform(localOffset, m_childRotations[i]);
+            m_childBoxes[i] = m_children[i]->getAABB();
+        }
+
+        m_unitInertia = m_area > 0.0f ? inertia / m_area : 0.0f;
+
+        //Rebuild the hierarchy over the local boxes
+        m_childOrder.resize(childCount);
+        for (int i = 0; i < childCount; i++)
+            m_childOrder[i] = i;
+
+        m_nodes.clear();
+        if (childCount > 0)
+            buildNode(0, childCount);
+
+        updateAABB();
+    }
+
+    //Builds the subtree over m_childOrder[first, first + count), returns the index of its root
+    int CompoundCollider::buildNode(int first, int count)
+    {
+        int nodeId = static_cast<int>(m_nodes.size());
+        m_nodes.push_back(CompoundNode());
+
+        AABB box = m_childBoxes[m_childOrder[first]];
+        for (int entry = first + 1; entry < first + count; entry++)
+            box = AABB::combine(box, m_childBoxes[m_childOrder[entry]]);
+
+        if (count <= MAX_LEAF_CHILDREN)
+        {
+            m_nodes[nodeId] = {box, first, count};
+            return nodeId;
+        }
+
+        //Split at the median child center along the longer side of the node
+        bool splitX = box.max.x - box.min.x >= box.max.y - box.min.y;
+        auto center = [this, splitX](int child)
+        {
+            const AABB& childBox = m_childBoxes[child];
+            return splitX ? childBox.min.x + childBox.max.x : childBox.min.y + childBox.max.y;
+        };
+
+        int half = count / 2;
+        std::nth_element(m_childOrder.begin() + first,
+            m_childOrder.begin() + first + half,
+            m_childOrder.begin() + first + count,
+            [&center](int a, int b) { return center(a) < center(b); });
+
+        //The first child is the next node, the index points at the second
+        buildNode(first, half);
+        int second = buildNode(first + half, count - half);
+
+        m_nodes[nodeId] = {box, second, 0};
+        return nodeId;
+    }
+
+    //Update AABB mins and maxes, and the positions and rotations of every child
+    void CompoundCollider::updateAABB()
+    {
+        m_cos = std::cos(m_rotation);
+        m_sin = std::sin(m_rotation);
+
+        m_boundingBox.min = m_position;
+        m_boundingBox.max = m_position;
+
+        for (size_t i = 0; i < m_children.size(); i++)
+        {
+            Collider* child = m_children[i];
+            const Vector2& offset = child->getOffset();
+
+            child->setTransform(
+                m_position + Vector2(offset.x * m_cos - offset.y * m_sin, offset.x * m_sin + offset.y * m_cos),
+                m_rotation + m_childRotations[i]);
+
+            m_boundingBox = i == 0 ? child->getAABB() : AABB::combine(m_boundingBox, child->getAABB());
+        }
+    }
+}
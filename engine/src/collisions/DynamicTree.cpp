@@ -0,0 +1,450 @@
+//Implementation of the dynamic bounding volume tree
+
+#include "collisions/DynamicTree.hpp"
+#include <algorithm>
+
+namespace phys
+{
+    //Constructor to create an empty tree
+    DynamicTree::DynamicTree() : m_root(NULL_NODE), m_freeList(NULL_NODE), m_leafCount(0) {}
+
+    //Takes a node from the free list, growing the pool when empty
+    int DynamicTree::allocateNode()
+    {
+        if (m_freeList == NULL_NODE)
+        {
+            TreeNode node;
+            node.body = nullptr;
+            node.parent = NULL_NODE;
+            node.child1 = NULL_NODE;
+            node.child2 = NULL_NODE;
+            node.height = 0;
+            m_nodes.push_back(node);
+
+            return static_cast<int>(m_nodes.size()) - 1;
+        }
+
+        int nodeId = m_freeList;
+        TreeNode& node = m_nodes[nodeId];
+        m_freeList = node.parent;
+
+        node.body = nullptr;
+        node.parent = NULL_NODE;
+        node.child1 = NULL_NODE;
+        node.child2 = NULL_NODE;
+        node.height = 0;
+
+        return nodeId;
+    }
+
+    //Returns a node to the free list
+    void DynamicTree::freeNode(int nodeId)
+    {
+        m_nodes[nodeId].parent = m_freeList;
+        m_nodes[nodeId].height = -1;
+        m_freeList = nodeId;
+    }
+
+    //Creates a leaf for a body with the given fat box
+    int DynamicTree::createProxy(const AABB& fatBox, PhysicsBody* body)
+    {
+        int proxyId = allocateNode();
+        m_nodes[proxyId].box = fatBox;
+        m_nodes[proxyId].body = body;
+
+        insertLeaf(proxyId);
+        m_leafCount++;
+
+        return proxyId;
+    }
+
+    //Creates leaves for many bodies at once
+    void DynamicTree::createProxies(const AABB* fatBoxes, PhysicsBody* const* bodies, int count, int* proxyIds)
+    {
+        if (count <= 0)
+            return;
+
+        bool buildTree = m_root == NULL_NODE;
+        m_nodes.reserve(m_nodes.size() + 2 * static_cast<size_t>(count));
+
+        for (int i = 0; i < count; i++)
+        {
+            int proxyId = allocateNode();
+            m_nodes[proxyId].box = fatBoxes[i];
+            m_nodes[proxyId].body = bodies[i];
+            proxyIds[i] = proxyId;
+
+            if (!buildTree)
+                insertLeaf(proxyId);
+        }
+
+        m_leafCount += count;
+
+        if (buildTree)
+        {
+            std::vector<int> leaves(proxyIds, proxyIds + count);
+            m_root = buildTopDown(leaves.data(), count);
+            m_nodes[m_root].parent = NULL_NODE;
+        }
+    }
+
+    //Removes a leaf from the tree
+    void DynamicTree::destroyProxy(int proxyId)
+    {
+        removeLeaf(proxyId);
+        freeNode(proxyId);
+        m_leafCount--;
+    }
+
+    //Moves a leaf to a new fat box
+    void DynamicTree::moveProxy(int proxyId, const AABB& fatBox)
+    {
+        removeLeaf(proxyId);
+        m_nodes[proxyId].box = fatBox;
+        insertLeaf(proxyId);
+    }
+
+    //Moves every box by -shift
+    void DynamicTree::shiftOrigin(const Vector2& shift)
+    {
+        //Subtracting the same value keeps the order of every bound, so parents still enclose their children
+        for (TreeNode& node : m_nodes)
+        {
+            if (node.height < 0)
+                continue;
+
+            node.box.min -= shift;
+            node.box.max -= shift;
+        }
+    }
+
+    //Builds a subtree over leaves by splitting them at the median of the widest axis
+    int DynamicTree::buildTopDown(int* leaves, int count)
+    {
+        if (count == 1)
+            return leaves[0];
+
+        //Split along the axis where the leaf centers are spread the most
+        AABB centerBounds(m_nodes[leaves[0]].box.min + m_nodes[leaves[0]].box.max,
+            m_nodes[leaves[0]].box.min + m_nodes[leaves[0]].box.max);
+
+        for (int i = 1; i < count; i++)
+        {
+            Vector2 center = m_nodes[leaves[i]].box.min + m_nodes[leaves[i]].box.max;
+            centerBounds = AABB::combine(centerBounds, AABB(center, center));
+        }
+
+        bool splitX = centerBounds.max.x - centerBounds.min.x >= centerBounds.max.y - centerBounds.min.y;
+        int half = count / 2;
+
+        std::nth_element(leaves,
+            leaves + half,
+            leaves + count,
+            [this, splitX](int leafA, int leafB)
+            {
+                const AABB& boxA = m_nodes[leafA].box;
+                const AABB& boxB = m_nodes[leafB].box;
+
+                return splitX ? boxA.min.x + boxA.max.x < boxB.min.x + boxB.max.x
+                              : boxA.min.y + boxA.max.y < boxB.min.y + boxB.max.y;
+            });
+
+        int child1 = buildTopDown(leaves, half);
+        int child2 = buildTopDown(leaves + half, count - half);
+
+        //Allocating may grow the pool, so node references are taken afterwards
+        int parent = allocateNode();
+        TreeNode& node = m_nodes[parent];
+        node.child1 = child1;
+        node.child2 = child2;
+        node.box = AABB::combine(m_nodes[child1].box, m_nodes[child2].box);
+        node.height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+
+        m_nodes[child1].parent = parent;
+        m_nodes[child2].parent = parent;
+
+        return parent;
+    }
+
+    //Inserts a leaf by descending along the cheapest perimeter path
+    void DynamicTree::insertLeaf(int leaf)
+    {
+        if (m_root == NULL_NODE)
+        {
+            m_root = leaf;
+            m_nodes[m_root].parent = NULL_NODE;
+            return;
+        }
+
+        //Find the best sibling for the leaf
+        AABB leafBox = m_nodes[leaf].box;
+        int index = m_root;
+
+        while (!m_nodes[index].isLeaf())
+        {
+            int child1 = m_nodes[index].child1;
+            int child2 = m_nodes[index].child2;
+
+            float area = m_nodes[index].box.getPerimeter();
+            float combinedArea = AABB::combine(m_nodes[index].box, leafBox).getPerimeter();
+
+            //Cost of creating a new parent for this node and the new leaf
+            float cost = 2.0f * combinedArea;
+
+            //Minimum cost of pushing the leaf further down the tree
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            //Cost of descending into each child
+            float cost1 = AABB::combine(leafBox, m_nodes[child1].box).getPerimeter() + inheritanceCost;
+            if (!m_nodes[child1].isLeaf())
+                cost1 -= m_nodes[child1].box.getPerimeter();
+
+            float cost2 = AABB::combine(leafBox, m_nodes[child2].box).getPerimeter() + inheritanceCost;
+            if (!m_nodes[child2].isLeaf())
+                cost2 -= m_nodes[child2].box.getPerimeter();
+
+            //Stop descending if creating a parent here is cheapest
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? child1 : child2;
+        }
+
+        int sibling = index;
+
+        //Create a new parent enclosing the sibling and the leaf
+        int oldParent = m_nodes[sibling].parent;
+        int newParent = allocateNode();
+        m_nodes[newParent].parent = oldParent;
+        m_nodes[newParent].box = AABB::combine(leafBox, m_nodes[sibling].box);
+        m_nodes[newParent].height = m_nodes[sibling].height + 1;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (m_nodes[oldParent].child1 == sibling)
+                m_nodes[oldParent].child1 = newParent;
+            else
+                m_nodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            m_root = newParent;
+        }
+
+        m_nodes[newParent].child1 = sibling;
+        m_nodes[newParent].child2 = leaf;
+        m_nodes[sibling].parent = newParent;
+        m_nodes[leaf].parent = newParent;
+
+        //Walk back up the tree fixing heights and boxes
+        index = m_nodes[leaf].parent;
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            int child1 = m_nodes[index].child1;
+            int child2 = m_nodes[index].child2;
+
+            m_nodes[index].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+            m_nodes[index].box = AABB::combine(m_nodes[child1].box, m_nodes[child2].box);
+
+            index = m_nodes[index].parent;
+        }
+    }
+
+    //Detaches a leaf and collapses its parent
+    void DynamicTree::removeLeaf(int leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = NULL_NODE;
+            return;
+        }
+
+        int parent = m_nodes[leaf].parent;
+        int grandParent = m_nodes[parent].parent;
+        int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+        if (grandParent != NULL_NODE)
+        {
+            //Connect the sibling to the grandparent and destroy the parent
+            if (m_nodes[grandParent].child1 == parent)
+                m_nodes[grandParent].child1 = sibling;
+            else
+                m_nodes[grandParent].child2 = sibling;
+
+            m_nodes[sibling].parent = grandParent;
+            freeNode(parent);
+
+            //Adjust ancestor boxes and heights
+            int index = grandParent;
+            while (index != NULL_NODE)
+            {
+                index = balance(index);
+
+                int child1 = m_nodes[index].child1;
+                int child2 = m_nodes[index].child2;
+
+                m_nodes[index].box = AABB::combine(m_nodes[child1].box, m_nodes[child2].box);
+                m_nodes[index].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+
+                index = m_nodes[index].parent;
+            }
+        }
+        else
+        {
+            m_root = sibling;
+            m_nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+    }
+
+    //Performs a left or right rotation if the node is unbalanced, returns the new subtree root
+    int DynamicTree::balance(int iA)
+    {
+        TreeNode* A = &m_nodes[iA];
+        if (A->isLeaf() || A->height < 2)
+            return iA;
+
+        int iB = A->child1;
+        int iC = A->child2;
+        TreeNode* B = &m_nodes[iB];
+        TreeNode* C = &m_nodes[iC];
+
+        int balanceFactor = C->height - B->height;
+
+        //Rotate C up
+        if (balanceFactor > 1)
+        {
+            int iF = C->child1;
+            int iG = C->child2;
+            TreeNode* F = &m_nodes[iF];
+            TreeNode* G = &m_nodes[iG];
+
+            //Swap A and C
+            C->child1 = iA;
+            C->parent = A->parent;
+            A->parent = iC;
+
+            //A's old parent should point to C
+            if (C->parent != NULL_NODE)
+            {
+                if (m_nodes[C->parent].child1 == iA)
+                    m_nodes[C->parent].child1 = iC;
+                else
+                    m_nodes[C->parent].child2 = iC;
+            }
+            else
+            {
+                m_root = iC;
+            }
+
+            //Rotate the taller grandchild up
+            if (F->height > G->height)
+            {
+                C->child2 = iF;
+                A->child2 = iG;
+                G->parent = iA;
+                A->box = AABB::combine(B->box, G->box);
+                C->box = AABB::combine(A->box, F->box);
+
+                A->height = 1 + std::max(B->height, G->height);
+                C->height = 1 + std::max(A->height, F->height);
+            }
+            else
+            {
+                C->child2 = iG;
+                A->child2 = iF;
+                F->parent = iA;
+                A->box = AABB::combine(B->box, F->box);
+                C->box = AABB::combine(A->box, G->box);
+
+                A->height = 1 + std::max(B->height, F->height);
+                C->height = 1 + std::max(A->height, G->height);
+            }
+
+            return iC;
+        }
+
+        //Rotate B up
+        if (balanceFactor < -1)
+        {
+            int iD = B->child1;
+            int iE = B->child2;
+            TreeNode* D = &m_nodes[iD];
+            TreeNode* E = &m_nodes[iE];
+
+            //Swap A and B
+            B->child1 = iA;
+            B->parent = A->parent;
+            A->parent = iB;
+
+            //A's old parent should point to B
+            if (B->parent != NULL_NODE)
+            {
+                if (m_nodes[B->parent].child1 == iA)
+                    m_nodes[B->parent].child1 = iB;
+                else
+                    m_nodes[B->parent].child2 = iB;
+            }
+            else
+            {
+                m_root = iB;
+            }
+
+            //Rotate the taller grandchild up
+            if (D->height > E->height)
+            {
+                B->child2 = iD;
+                A->child1 = iE;
+                E->parent = iA;
+                A->box = AABB::combine(C->box, E->box);
+                B->box = AABB::combine(A->box, D->box);
+
+                A->height = 1 + std::max(C->height, E->height);
+                B->height = 1 + std::max(A->height, D->height);
+            }
+            else
+            {
+                B->child2 = iE;
+                A->child1 = iD;
+                D->parent = iA;
+                A->box = AABB::combine(C->box, D->box);
+                B->box = AABB::combine(A->box, E->box);
+
+                A->height = 1 + std::max(C->height, D->height);
+                B->height = 1 + std::max(A->height, E->height);
+            }
+
+            return iB;
+        }
+
+        return iA;
+    }
+
+    //Getters for leaf data
+    PhysicsBody* DynamicTree::getBody(int proxyId) const
+    {
+        return m_nodes[proxyId].body;
+    }
+
+    const AABB& DynamicTree::getFatAABB(int proxyId) const
+    {
+        return m_nodes[proxyId].box;
+    }
+
+    //Returns the number of leaves in the tree
+    int DynamicTree::getLeafCount() const
+    {
+        return m_leafCount;
+    }
+
+    //Returns the height of the tree
+    int DynamicTree::getHeight() const
+    {
+        if (m_root == NULL_NODE)
+            return 0;
+
+        return m_nodes[m_root].height;
+    }
+}
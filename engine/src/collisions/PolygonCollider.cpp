@@ -0,0 +1,192 @@
+//Class implementation for convex polygon shape colliders
+
+#include "collisions/PolygonCollider.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace phys
+{
+    //Constructor to set vertices and collider type
+    PolygonCollider::PolygonCollider(const std::vector<Vector2>& points, ColliderType colliderType) :
+        Collider(ColliderShape::Polygon, colliderType),
+        m_vertexCount(0),
+        m_centroid({0, 0}),
+        m_area(0),
+        m_unitInertia(0),
+        m_radius(0)
+    {
+        setVertices(points);
+    }
+
+    //Getters for member variables
+    int PolygonCollider::getVertexCount() const
+    {
+        return m_vertexCount;
+    }
+
+    const Vector2* PolygonCollider::getPoints() const
+    {
+        return m_points;
+    }
+
+    const Vector2* PolygonCollider::getLocalVertices() const
+    {
+        return m_localVertices;
+    }
+
+    const Vector2* PolygonCollider::getVertices() const
+    {
+        return m_vertices;
+    }
+
+    const Vector2* PolygonCollider::getNormals() const
+    {
+        return m_normals;
+    }
+
+    const Vector2& PolygonCollider::getCentroid() const
+    {
+        return m_centroid;
+    }
+
+    float PolygonCollider::getArea() const
+    {
+        return m_area;
+    }
+
+    float PolygonCollider::getUnitInertia() const
+    {
+        return m_unitInertia;
+    }
+
+    float PolygonCollider::getRadius() const
+    {
+        return m_radius;
+    }
+
+    //Replaces the polygon with the convex hull of the points
+    void PolygonCollider::setVertices(const std::vector<Vector2>& points)
+    {
+        std::vector<Vector2> sorted(points);
+        std::sort(sorted.begin(),
+            sorted.end(),
+            [](const Vector2& a, const Vector2& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+
+        //Monotone chain, lower hull then upper hull, dropping points that do not turn left
+        std::vector<Vector2> hull(sorted.size() * 2);
+        int hullCount = 0;
+
+        for (int pass = 0; pass < 2 && sorted.size() >= 3; pass++)
+        {
+            int start = hullCount;
+
+            for (size_t i = 0; i < sorted.size(); i++)
+            {
+                const Vector2& point = pass == 0 ? sorted[i] : sorted[sorted.size() - 1 - i];
+
+                while (hullCount >= start + 2 &&
+                       (hull[hullCount - 1] - hull[hullCount - 2]).crossProduct(point - hull[hullCount - 2]) <= 0.0f)
+                    hullCount--;
+
+                hull[hullCount++] = point;
+            }
+
+            //Last point of each chain starts the other one
+            hullCount--;
+        }
+
+        //Too many vertices, drop the one whose triangle with its neighbours is smallest until the rest fit
+        //The hull keeps as much of its area as one vertex at a time allows and stays convex
+        while (hullCount > MAX_VERTICES)
+        {
+            int smallest = 0;
+            float smallestArea = std::numeric_limits<float>::infinity();
+
+            for (int i = 0; i < hullCount; i++)
+            {
+                const Vector2& previous = hull[(i + hullCount - 1) % hullCount];
+                const Vector2& next = hull[(i + 1) % hullCount];
+                float area = (hull[i] - previous).crossProduct(next - previous);
+
+                if (area < smallestArea)
+                {
+                    smallest = i;
+                    smallestArea = area;
+                }
+            }
+
+            hull.erase(hull.begin() + smallest);
+            hullCount--;
+        }
+
+        m_vertexCount = hullCount >= 3 ? hullCount : 0;
+
+        //Area, centroid and inertia from a fan of triangles around the first vertex
+        Vector2 reference = m_vertexCount > 0 ? hull[0] : Vector2(0, 0);
+        Vector2 center;
+        float area = 0.0f;
+        float inertia = 0.0f;
+
+        for (int i = 0; i < m_vertexCount; i++)
+        {
+            Vector2 edgeA = hull[i] - reference;
+            Vector2 edgeB = hull[(i + 1) % m_vertexCount] - reference;
+
+            float cross = edgeA.crossProduct(edgeB);
+            float triangleArea = cross / 2.0f;
+            area += triangleArea;
+            center += (edgeA + edgeB) * (triangleArea / 3.0f);
+
+            float integralX = edgeA.x * edgeA.x + edgeB.x * edgeA.x + edgeB.x * edgeB.x;
+            float integralY = edgeA.y * edgeA.y + edgeB.y * edgeA.y + edgeB.y * edgeB.y;
+            inertia += (cross / 12.0f) * (integralX + integralY);
+        }
+
+        m_area = area;
+        m_centroid = area > 0.0f ? reference + center / area : reference;
+
+        //Move the inertia from the reference vertex to the centroid
+        m_unitInertia = area > 0.0f ? inertia / area - (center / area).getSquare() : 0.0f;
+
+        m_radius = 0.0f;
+        for (int i = 0; i < m_vertexCount; i++)
+        {
+            m_points[i] = hull[i];
+            m_localVertices[i] = hull[i] - m_centroid;
+            m_radius = std::max(m_radius, m_localVertices[i].getLength());
+        }
+
+        for (int i = 0; i < m_vertexCount; i++)
+        {
+            Vector2 edge = m_localVertices[(i + 1) % m_vertexCount] - m_localVertices[i];
+            m_localNormals[i] = Vector2(edge.y, -edge.x).getNormal();
+        }
+
+        updateAABB();
+    }
+
+    //Update AABB mins and maxes, and the world vertices and normals
+    void PolygonCollider::updateAABB()
+    {
+        float cos = std::cos(m_rotation);
+        float sin = std::sin(m_rotation);
+
+        m_boundingBox.min = m_position;
+        m_boundingBox.max = m_position;
+
+        for (int i = 0; i < m_vertexCount; i++)
+        {
+            const Vector2& vertex = m_localVertices[i];
+            const Vector2& normal = m_localNormals[i];
+
+            m_vertices[i] = m_position + Vector2(vertex.x * cos - vertex.y * sin, vertex.x * sin + vertex.y * cos);
+            m_normals[i] = {normal.x * cos - normal.y * sin, normal.x * sin + normal.y * cos};
+
+            m_boundingBox.min.x = std::min(m_boundingBox.min.x, m_vertices[i].x);
+            m_boundingBox.min.y = std::min(m_boundingBox.min.y, m_vertices[i].y);
+            m_boundingBox.max.x = std::max(m_boundingBox.max.x, m_vertices[i].x);
+            m_boundingBox.max.y = std::max(m_boundingBox.max.y, m_vertices[i].y);
+        }
+    }
+}
@@ -15,7 +15,7 @@ namespace phys
     }
 
     //Returns the verticies of the collider in its current state
-    const std::vector<Vector2> RectCollider::calculateVertcies()
+    const std::vector<Vector2> RectCollider::calculateVertcies() const
     {
         float cos = std::cos(m_rotation);
         float sin = std::sin(m_rotation);
@@ -54,12 +54,20 @@ namespace phys
     void RectCollider::setDimensions(const Vector2& newDimensions)
     {
         m_dimensions = newDimensions;
+
+        updateAABB();
     }
 
-    //Update AABB mins and maxes
+    //Update AABB mins and maxes, enclosing the rotated rectangle
     void RectCollider::updateAABB()
     {
-        m_boundingBox.min = {m_position.x - m_dimensions.x / 2, m_position.y - m_dimensions.y / 2};
-        m_boundingBox.max = {m_position.x + m_dimensions.x / 2, m_position.y + m_dimensions.y / 2};
+        float cos = std::abs(std::cos(m_rotation));
+        float sin = std::abs(std::sin(m_rotation));
+
+        float halfExtentX = (m_dimensions.x * cos + m_dimensions.y * sin) / 2;
+        float halfExtentY = (m_dimensions.x * sin + m_dimensions.y * cos) / 2;
+
+        m_boundingBox.min = {m_position.x - halfExtentX, m_position.y - halfExtentY};
+        m_boundingBox.max = {m_position.x + halfExtentX, m_position.y + halfExtentY};
     }
 }
\ No newline at end of file
@@ -0,0 +1,53 @@
+//Class implementation for the simplex caches of collider pairs
+
+#include "collisions/SimplexCache.hpp"
+
+namespace phys
+{
+    //Hashes a pair of colliders
+    size_t SimplexCacheTable::PairHash::operator()(const std::pair<const Collider*, const Collider*>& pair) const
+    {
+        size_t hashA = std::hash<const Collider*>()(pair.first);
+        size_t hashB = std::hash<const Collider*>()(pair.second);
+
+        return hashA ^ (hashB + 0x9E3779B9 + (hashA << 6) + (hashA >> 2));
+    }
+
+    //Constructor to create an empty table
+    SimplexCacheTable::SimplexCacheTable() : m_step(0) {}
+
+    //Returns the cache of a pair of colliders, adding an empty one if the pair has none
+    SimplexCache* SimplexCacheTable::find(const Collider* colliderA, const Collider* colliderB)
+    {
+        Entry& entry = m_entries[{colliderA, colliderB}];
+        entry.step = m_step;
+
+        return &entry.cache;
+    }
+
+    //Starts a step, dropping the caches of pairs that were not looked up during the last one
+    void SimplexCacheTable::beginStep()
+    {
+        for (auto entry = m_entries.begin(); entry != m_entries.end();)
+        {
+            if (entry->second.step != m_step)
+                entry = m_entries.erase(entry);
+            else
+                entry++;
+        }
+
+        m_step++;
+    }
+
+    //Removes every cache
+    void SimplexCacheTable::clear()
+    {
+        m_entries.clear();
+    }
+
+    //Returns the number of cached pairs
+    size_t SimplexCacheTable::getSize() const
+    {
+        return m_entries.size();
+    }
+}
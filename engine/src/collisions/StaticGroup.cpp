@@ -0,0 +1,101 @@
+//Implementation of the StaticGroup class
+
+#include "collisions/StaticGroup.hpp"
+#include "physics/PhysicsBody.hpp"
+
+namespace phys
+{
+    //Constructor to create an empty group
+    StaticGroup::StaticGroup() {}
+
+    //Destructor to delete the bodies
+    StaticGroup::~StaticGroup()
+    {
+        for (PhysicsBody* body : m_bodies)
+            delete body;
+    }
+
+    //Takes ownership of the bodies and builds the layer trees over them
+    bool StaticGroup::build(const std::vector<PhysicsBody*>& bodies)
+    {
+        if (!m_bodies.empty())
+            return false;
+
+        for (const PhysicsBody* body : bodies)
+        {
+            if (body->getType() != BodyType::StaticBody)
+                return false;
+        }
+
+        m_bodies = bodies;
+
+        //Gather the bodies of every layer so each tree is built in one pass
+        std::map<unsigned int, std::vector<PhysicsBody*>> layerBodies;
+
+        for (PhysicsBody* body : m_bodies)
+        {
+            const AABB& box = body->getCollider()->getAABB();
+            m_bounds = body == m_bodies.front() ? box : AABB::combine(m_bounds, box);
+
+            for (unsigned int layer : body->getCollider()->getCollisionLayers())
+                layerBodies[layer].push_back(body);
+        }
+
+        //Static bodies never move, so their boxes are not fattened
+        std::vector<AABB> boxes;
+
+        for (const auto& layer : layerBodies)
+        {
+            const std::vector<PhysicsBody*>& treeBodies = layer.second;
+
+            boxes.resize(treeBodies.size());
+            for (size_t i = 0; i < treeBodies.size(); i++)
+                boxes[i] = treeBodies[i]->getCollider()->getAABB();
+
+            m_layerTrees[layer.first].build(boxes.data(), treeBodies.data(), static_cast<int>(treeBodies.size()));
+        }
+
+        return true;
+    }
+
+    //Moves every body and box by -shift
+    void StaticGroup::shiftOrigin(const Vector2& shift)
+    {
+        for (PhysicsBody* body : m_bodies)
+            body->setPosition(body->getPosition() - shift);
+
+        for (auto& layerTree : m_layerTrees)
+            layerTree.second.shiftOrigin(shift);
+
+        m_bounds.min -= shift;
+        m_bounds.max -= shift;
+    }
+
+    //Returns the bodies of the group
+    const std::vector<PhysicsBody*>& StaticGroup::getBodies() const
+    {
+        return m_bodies;
+    }
+
+    //Returns the trees of every layer
+    const std::map<unsigned int, StaticTree>& StaticGroup::getLayerTrees() const
+    {
+        return m_layerTrees;
+    }
+
+    //Returns the tree of a layer
+    const StaticTree* StaticGroup::getLayerTree(unsigned int layer) const
+    {
+        auto it = m_layerTrees.find(layer);
+        if (it == m_layerTrees.end())
+            return nullptr;
+
+        return &it->second;
+    }
+
+    //Returns the box enclosing every body
+    const AABB& StaticGroup::getBounds() const
+    {
+        return m_bounds;
+    }
+}
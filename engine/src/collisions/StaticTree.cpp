@@ -0,0 +1,243 @@
+//Implementation of the StaticTree class
+
+#include "collisions/StaticTree.hpp"
+#include <algorithm>
+
+namespace phys
+{
+    //Constructor to create an empty tree
+    StaticTree::StaticTree() : m_removedCount(0) {}
+
+    //Replaces the tree with one built over the boxes
+    void StaticTree::build(const AABB* boxes, PhysicsBody* const* bodies, int count)
+    {
+        clear();
+
+        if (count <= 0)
+            return;
+
+        //Splits only move indices around, the items are gathered in leaf order at the end
+        std::vector<int> order(count);
+        std::vector<Vector2> centers(count);
+
+        for (int i = 0; i < count; i++)
+        {
+            order[i] = i;
+            centers[i] = (boxes[i].min + boxes[i].max) * 0.5f;
+        }
+
+        //A binary tree with at least one item per leaf has fewer than twice as many nodes as items
+        m_nodes.reserve(2 * count);
+        buildNode(order, centers, boxes, 0, count, 0);
+
+        m_boxes.resize(count);
+        m_bodies.resize(count);
+
+        for (int i = 0; i < count; i++)
+        {
+            m_boxes[i] = boxes[order[i]];
+            m_bodies[i] = bodies[order[i]];
+        }
+    }
+
+    //Builds the subtree over order[first, first + count)
+    int StaticTree::buildNode(std::vector<int>& order,
+        const std::vector<Vector2>& centers,
+        const AABB* boxes,
+        int first,
+        int count,
+        int depth)
+    {
+        int nodeId = static_cast<int>(m_nodes.size());
+        m_nodes.emplace_back();
+
+        AABB box = boxes[order[first]];
+        AABB centerBounds(centers[order[first]], centers[order[first]]);
+
+        for (int i = first + 1; i < first + count; i++)
+        {
+            box = AABB::combine(box, boxes[order[i]]);
+            centerBounds = AABB::combine(centerBounds, AABB(centers[order[i]], centers[order[i]]));
+        }
+
+        m_nodes[nodeId].box = box;
+
+        Vector2 centerExtent = centerBounds.max - centerBounds.min;
+
+        //Items sharing one center cannot be told apart by any split
+        if (count <= MAX_LEAF_ITEMS || (centerExtent.x <= 0.0f && centerExtent.y <= 0.0f))
+        {
+            m_nodes[nodeId].index = first;
+            m_nodes[nodeId].count = count;
+            return nodeId;
+        }
+
+        int* begin = order.data() + first;
+        int* end = begin + count;
+        int* middle = nullptr;
+
+        if (depth >= MEDIAN_SPLIT_DEPTH)
+        {
+            //Badly clustered items could make the tree too deep to traverse, split them in half instead
+            int axis = centerExtent.x >= centerExtent.y ? 0 : 1;
+            middle = begin + count / 2;
+            std::nth_element(begin,
+                middle,
+                end,
+                [&](int a, int b) { return axis == 0 ? centers[a].x < centers[b].x : centers[a].y < centers[b].y; });
+        }
+        else
+        {
+            //Sort the centers into bins along both axes and pick the split with the lowest perimeter cost
+            float bestCost = -1.0f;
+            int bestAxis = 0;
+            int bestSplit = 0;
+
+            for (int axis = 0; axis < 2; axis++)
+            {
+                float minimum = axis == 0 ? centerBounds.min.x : centerBounds.min.y;
+                float extent = axis == 0 ? centerExtent.x : centerExtent.y;
+                if (extent <= 0.0f)
+                    continue;
+
+                int binCounts[BIN_COUNT] = {};
+                AABB binBoxes[BIN_COUNT];
+                float scale = BIN_COUNT / extent;
+
+                for (int i = first; i < first + count; i++)
+                {
+                    float center = axis == 0 ? centers[order[i]].x : centers[order[i]].y;
+                    int bin = std::min(static_cast<int>((center - minimum) * scale), BIN_COUNT - 1);
+
+                    const AABB& itemBox = boxes[order[i]];
+                    binBoxes[bin] = binCounts[bin] == 0 ? itemBox : AABB::combine(binBoxes[bin], itemBox);
+                    binCounts[bin]++;
+                }
+
+                //Sweep from the right to know the cost of every right side, then from the left
+                float rightCosts[BIN_COUNT];
+                int rightCount = 0;
+                AABB rightBox;
+
+                for (int bin = BIN_COUNT - 1; bin > 0; bin--)
+                {
+                    if (binCounts[bin] > 0)
+                    {
+                        rightBox = rightCount == 0 ? binBoxes[bin] : AABB::combine(rightBox, binBoxes[bin]);
+                        rightCount += binCounts[bin];
+                    }
+
+                    rightCosts[bin] = rightCount * (rightCount > 0 ? rightBox.getPerimeter() : 0.0f);
+                }
+
+                int leftCount = 0;
+                AABB leftBox;
+
+                for (int split = 1; split < BIN_COUNT; split++)
+                {
+                    int bin = split - 1;
+                    if (binCounts[bin] > 0)
+                    {
+                        leftBox = leftCount == 0 ? binBoxes[bin] : AABB::combine(leftBox, binBoxes[bin]);
+                        leftCount += binCounts[bin];
+                    }
+
+                    //Both sides need at least one item
+                    if (leftCount == 0 || leftCount == count)
+                        continue;
+
+                    float cost = leftCount * leftBox.getPerimeter() + rightCosts[split];
+                    if (bestCost < 0.0f || cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+
+            float minimum = bestAxis == 0 ? centerBounds.min.x : centerBounds.min.y;
+            float scale = BIN_COUNT / (bestAxis == 0 ? centerExtent.x : centerExtent.y);
+
+            middle = std::partition(begin,
+                end,
+                [&](int item)
+                {
+                    float center = bestAxis == 0 ? centers[item].x : centers[item].y;
+                    return std::min(static_cast<int>((center - minimum) * scale), BIN_COUNT - 1) < bestSplit;
+                });
+        }
+
+        int leftCount = static_cast<int>(middle - begin);
+
+        //The first child directly follows its parent, the second child's index is stored on the parent
+        buildNode(order, centers, boxes, first, leftCount, depth + 1);
+        m_nodes[nodeId].index = buildNode(order, centers, boxes, first + leftCount, count - leftCount, depth + 1);
+        m_nodes[nodeId].count = 0;
+
+        return nodeId;
+    }
+
+    //Removes every item
+    void StaticTree::clear()
+    {
+        m_nodes.clear();
+        m_boxes.clear();
+        m_bodies.clear();
+        m_removedCount = 0;
+    }
+
+    //Removes an item so it is never reported again
+    void StaticTree::removeItem(int item)
+    {
+        if (!m_bodies[item])
+            return;
+
+        m_bodies[item] = nullptr;
+        m_removedCount++;
+    }
+
+    //Moves every box by -shift
+    void StaticTree::shiftOrigin(const Vector2& shift)
+    {
+        for (StaticTreeNode& node : m_nodes)
+        {
+            node.box.min -= shift;
+            node.box.max -= shift;
+        }
+
+        for (AABB& box : m_boxes)
+        {
+            box.min -= shift;
+            box.max -= shift;
+        }
+    }
+
+    PhysicsBody* StaticTree::getBody(int item) const
+    {
+        return m_bodies[item];
+    }
+
+    const AABB& StaticTree::getAABB(int item) const
+    {
+        return m_boxes[item];
+    }
+
+    //Returns the number of items, including removed ones
+    int StaticTree::getItemCount() const
+    {
+        return static_cast<int>(m_bodies.size());
+    }
+
+    //Returns the number of removed items
+    int StaticTree::getRemovedCount() const
+    {
+        return m_removedCount;
+    }
+
+    //Returns the number of nodes
+    int StaticTree::getNodeCount() const
+    {
+        return static_cast<int>(m_nodes.size());
+    }
+}
@@ -0,0 +1,301 @@
+//Class implementation for tile map colliders
+
+#include "collisions/TileMapCollider.hpp"
+
+namespace phys
+{
+    //Constructor to set the grid size, tile size, whether tiles are merged, and collider type
+    TileMapCollider::TileMapCollider(int columns, int rows, float tileSize, bool merged, ColliderType colliderType) :
+        Collider(ColliderShape::TileMap, colliderType),
+        m_columns(std::max(columns, 0)),
+        m_rows(std::max(rows, 0)),
+        m_tileSize(std::max(tileSize, 0.0f)),
+        m_merged(merged),
+        m_cos(1),
+        m_sin(0)
+    {
+        size_t tileCount = static_cast<size_t>(m_columns) * m_rows;
+        m_tiles.assign((tileCount + 63) / 64, 0);
+
+        mergeTiles();
+        updateAABB();
+    }
+
+    //Getters for member variables
+    int TileMapCollider::getColumns() const
+    {
+        return m_columns;
+    }
+
+    int TileMapCollider::getRows() const
+    {
+        return m_rows;
+    }
+
+    float TileMapCollider::getTileSize() const
+    {
+        return m_tileSize;
+    }
+
+    bool TileMapCollider::isMerged() const
+    {
+        return m_merged;
+    }
+
+    //Returns the number of boxes the solid tiles form, one per tile unless merged
+    int TileMapCollider::getBoxCount() const
+    {
+        if (m_merged)
+            return static_cast<int>(m_boxes.size());
+
+        int count = 0;
+        for (uint64_t word : m_tiles)
+        {
+            for (; word != 0; word &= word - 1)
+                count++;
+        }
+
+        return count;
+    }
+
+    //Distance of the farthest corner of the grid from the collider position
+    float TileMapCollider::getRadius() const
+    {
+        return Vector2(m_columns * m_tileSize, m_rows * m_tileSize).getLength();
+    }
+
+    //Returns true if a tile is solid, tiles outside the grid are empty
+    bool TileMapCollider::isSolid(int column, int row) const
+    {
+        if (column < 0 || column >= m_columns || row < 0 || row >= m_rows)
+            return false;
+
+        size_t tile = static_cast<size_t>(row) * m_columns + column;
+        return (m_tiles[tile / 64] >> (tile % 64)) & 1;
+    }
+
+    //Sets one tile, rebuilding the merged boxes, so prefer setTiles when changing many
+    void TileMapCollider::setSolid(int column, int row, bool solid)
+    {
+        if (column < 0 || column >= m_columns || row < 0 || row >= m_rows || isSolid(column, row) == solid)
+            return;
+
+        size_t tile = static_cast<size_t>(row) * m_columns + column;
+        m_tiles[tile / 64] ^= uint64_t(1) << (tile % 64);
+
+        if (m_merged)
+            mergeTiles();
+    }
+
+    //Replaces every tile, row by row from the bottom, returns false if the count does not match the grid
+    bool TileMapCollider::setTiles(const std::vector<bool>& tiles)
+    {
+        if (tiles.size() != static_cast<size_t>(m_columns) * m_rows)
+            return false;
+
+        std::fill(m_tiles.begin(), m_tiles.end(), 0);
+        for (size_t tile = 0; tile < tiles.size(); tile++)
+        {
+            if (tiles[tile])
+                m_tiles[tile / 64] |= uint64_t(1) << (tile % 64);
+        }
+
+        mergeTiles();
+
+        return true;
+    }
+
+    //Returns the world space corners of the grid
+    const std::vector<Vector2> TileMapCollider::calculateCorners() const
+    {
+        float width = m_columns * m_tileSize;
+        float height = m_rows * m_tileSize;
+
+        return {m_position,
+            m_position + toWorldDirection({width, 0}),
+            m_position + toWorldDirection({width, height}),
+            m_position + toWorldDirection({0, height})};
+    }
+
+    //Returns a box of tiles in the grid's space, in meters from the bottom left corner
+    const AABB TileMapCollider::getLocalBounds(const TileBox& box) const
+    {
+        return AABB({box.column * m_tileSize, box.row * m_tileSize},
+            {(box.column + box.width) * m_tileSize, (box.row + box.height) * m_tileSize});
+    }
+
+    //Returns a world space direction in the grid's space, and back
+    const Vector2 TileMapCollider::toLocalDirection(const Vector2& direction) const
+    {
+        return {direction.x * m_cos + direction.y * m_sin, -direction.x * m_sin + direction.y * m_cos};
+    }
+
+    const Vector2 TileMapCollider::toWorldDirection(const Vector2& direction) const
+    {
+        return {direction.x * m_cos - direction.y * m_sin, direction.x * m_sin + direction.y * m_cos};
+    }
+
+    //Returns true if the face of a box along a local axis direction is covered by solid tiles
+    //everywhere beside a region in world space
+    bool TileMapCollider::isFaceCovered(const TileBox& box, const Vector2& localDirection, const AABB& region) const
+    {
+        //Only the part of a long face beside the region is looked at
+        int firstColumn;
+        int firstRow;
+        int lastColumn;
+        int lastRow;
+
+        if (!findTileRange(region, firstColumn, firstRow, lastColumn, lastRow))
+            return false;
+
+        //Only the face the direction mostly points through
+        if (std::abs(localDirection.x) >= std::abs(localDirection.y))
+        {
+            int column = localDirection.x > 0.0f ? box.column + box.width : box.column - 1;
+            int first = std::max(box.row, firstRow);
+            int last = std::min(box.row + box.height - 1, lastRow);
+
+            for (int row = first; row <= last; row++)
+            {
+                if (!isSolid(column, row))
+                    return false;
+            }
+
+            return first <= last;
+        }
+
+        int row = localDirection.y > 0.0f ? box.row + box.height : box.row - 1;
+        int first = std::max(box.column, firstColumn);
+        int last = std::min(box.column + box.width - 1, lastColumn);
+
+        for (int column = first; column <= last; column++)
+        {
+            if (!isSolid(column, row))
+                return false;
+        }
+
+        return first <= last;
+    }
+
+    //Rebuilds the merged boxes after the tiles change
+    //Each box starts at the lowest, leftmost solid tile not yet covered, grows right as far as the row allows,
+    //then grows up while the whole width of the next row is solid and uncovered
+    void TileMapCollider::mergeTiles()
+    {
+        m_boxes.clear();
+        m_rowStarts.clear();
+        m_rowBoxes.clear();
+
+        if (!m_merged)
+            return;
+
+        size_t tileCount = static_cast<size_t>(m_columns) * m_rows;
+        std::vector<bool> covered(tileCount, false);
+
+        auto isFree = [this, &covered](int column, int row)
+        { return isSolid(column, row) && !covered[static_cast<size_t>(row) * m_columns + column]; };
+
+        for (int row = 0; row < m_rows; row++)
+        {
+            for (int column = 0; column < m_columns; column++)
+            {
+                if (!isFree(column, row))
+                    continue;
+
+                int width = 1;
+                while (column + width < m_columns && isFree(column + width, row))
+                    width++;
+
+                int height = 1;
+                while (row + height < m_rows)
+                {
+                    bool rowFree = true;
+                    for (int other = column; other < column + width && rowFree; other++)
+                        rowFree = isFree(other, row + height);
+
+                    if (!rowFree)
+                        break;
+
+                    height++;
+                }
+
+                for (int coveredRow = row; coveredRow < row + height; coveredRow++)
+                {
+                    for (int coveredColumn = column; coveredColumn < column + width; coveredColumn++)
+                        covered[static_cast<size_t>(coveredRow) * m_columns + coveredColumn] = true;
+                }
+
+                m_boxes.push_back({column, row, width, height});
+            }
+        }
+
+        //Count the boxes covering each row, then fill them in
+        m_rowStarts.assign(m_rows + 1, 0);
+        for (const TileBox& box : m_boxes)
+        {
+            for (int row = box.row; row < box.row + box.height; row++)
+                m_rowStarts[row + 1]++;
+        }
+
+        for (int row = 0; row < m_rows; row++)
+            m_rowStarts[row + 1] += m_rowStarts[row];
+
+        m_rowBoxes.resize(m_rowStarts[m_rows]);
+        std::vector<int> next(m_rowStarts.begin(), m_rowStarts.end() - 1);
+
+        for (size_t boxIndex = 0; boxIndex < m_boxes.size(); boxIndex++)
+        {
+            const TileBox& box = m_boxes[boxIndex];
+            for (int row = box.row; row < box.row + box.height; row++)
+                m_rowBoxes[next[row]++] = static_cast<int>(boxIndex);
+        }
+
+        for (int row = 0; row < m_rows; row++)
+        {
+            std::sort(m_rowBoxes.begin() + m_rowStarts[row],
+                m_rowBoxes.begin() + m_rowStarts[row + 1],
+                [this](int a, int b) { return m_boxes[a].column < m_boxes[b].column; });
+        }
+    }
+
+    //Finds the tiles under a box in world space, returns false if it misses the grid
+    bool TileMapCollider::findTileRange(
+        const AABB& box, int& firstColumn, int& firstRow, int& lastColumn, int& lastRow) const
+    {
+        if (m_columns == 0 || m_rows == 0 || m_tileSize <= 0.0f || !m_boundingBox.overlaps(box))
+            return false;
+
+        //Box in local space, grown to enclose the world box rotated against the grid
+        Vector2 center = toLocalDirection((box.min + box.max) / 2.0f - m_position);
+        Vector2 half = (box.max - box.min) / 2.0f;
+        Vector2 localHalf = {half.x * std::abs(m_cos) + half.y * std::abs(m_sin),
+            half.x * std::abs(m_sin) + half.y * std::abs(m_cos)};
+
+        Vector2 localMin = (center - localHalf) / m_tileSize;
+        Vector2 localMax = (center + localHalf) / m_tileSize;
+
+        if (localMax.x < 0.0f || localMax.y < 0.0f || localMin.x > m_columns || localMin.y > m_rows)
+            return false;
+
+        //Clamped before converting, so huge boxes cannot overflow
+        firstColumn = static_cast<int>(std::floor(std::max(localMin.x, 0.0f)));
+        firstRow = static_cast<int>(std::floor(std::max(localMin.y, 0.0f)));
+        lastColumn = static_cast<int>(std::floor(std::min(localMax.x, static_cast<float>(m_columns - 1))));
+        lastRow = static_cast<int>(std::floor(std::min(localMax.y, static_cast<float>(m_rows - 1))));
+
+        return true;
+    }
+
+    //Update AABB mins and maxes around the whole grid
+    void TileMapCollider::updateAABB()
+    {
+        m_cos = std::cos(m_rotation);
+        m_sin = std::sin(m_rotation);
+
+        std::vector<Vector2> corners = calculateCorners();
+
+        m_boundingBox = AABB(corners[0], corners[0]);
+        for (const Vector2& corner : corners)
+            m_boundingBox = AABB::combine(m_boundingBox, AABB(corner, corner));
+    }
+}
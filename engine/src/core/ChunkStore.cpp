@@ -0,0 +1,240 @@
+//Implementation of the ChunkStore class
+
+#include "core/ChunkStore.hpp"
+#include "core/PhysicsWorld.hpp"
+#include "core/Snapshot.hpp"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <utility>
+
+namespace phys
+{
+    //Constructor to stream chunks of a given size from a directory into a world
+    ChunkStore::ChunkStore(PhysicsWorld& world, const std::string& directory, float chunkSize) :
+        m_world(&world), m_directory(directory), m_chunkSize(chunkSize), m_loadDistance(chunkSize / 2),
+        m_unloadDistance(chunkSize)
+    {
+    }
+
+    //Destructor to unload every chunk
+    ChunkStore::~ChunkStore()
+    {
+        unloadAll();
+    }
+
+    //Packs chunk coordinates into a key
+    uint64_t ChunkStore::makeKey(int x, int y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    //Returns the coordinate of the chunk holding an absolute position along one axis
+    int ChunkStore::getChunkCoordinate(double position) const
+    {
+        return static_cast<int>(std::floor(position / m_chunkSize));
+    }
+
+    //Returns the path of a chunk's file
+    std::string ChunkStore::getChunkPath(const std::string& directory, int x, int y)
+    {
+        return directory + "/chunk_" + std::to_string(x) + "_" + std::to_string(y) + ".snap";
+    }
+
+    //Splits the static bodies into chunks and writes one snapshot file per chunk
+    bool ChunkStore::writeChunks(const std::vector<PhysicsBody*>& bodies, const std::string& directory, float chunkSize)
+    {
+        std::map<std::pair<int, int>, std::vector<PhysicsBody*>> chunkBodies;
+
+        for (PhysicsBody* body : bodies)
+        {
+            if (body->getType() != BodyType::StaticBody)
+                continue;
+
+            int x = static_cast<int>(std::floor(body->getPosition().x / chunkSize));
+            int y = static_cast<int>(std::floor(body->getPosition().y / chunkSize));
+            chunkBodies[{x, y}].push_back(body);
+        }
+
+        std::vector<unsigned char> buffer;
+
+        for (const auto& chunk : chunkBodies)
+        {
+            //Positions are stored relative to the chunk's corner, which is kept as the snapshot's origin
+            Snapshot::Header header;
+            std::memset(&header, 0, sizeof(Snapshot::Header));
+            header.originX = static_cast<double>(chunk.first.first) * chunkSize;
+            header.originY = static_cast<double>(chunk.first.second) * chunkSize;
+
+            Snapshot::write(chunk.second, header, buffer);
+
+            Snapshot::BodyRecord* records =
+                reinterpret_cast<Snapshot::BodyRecord*>(buffer.data() + header.bodiesOffset);
+
+            for (uint32_t i = 0; i < header.bodyCount; i++)
+            {
+                records[i].positionX = static_cast<float>(records[i].positionX - header.originX);
+                records[i].positionY = static_cast<float>(records[i].positionY - header.originY);
+            }
+
+            std::ofstream file(getChunkPath(directory, chunk.first.first, chunk.first.second),
+                std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+
+            file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            if (!file)
+                return false;
+        }
+
+        return true;
+    }
+
+    //Reads a chunk file into a built static group
+    StaticGroup* ChunkStore::loadChunk(int x, int y) const
+    {
+        Snapshot::MappedFile file(getChunkPath(m_directory, x, y));
+        if (!file.isOpen())
+            return nullptr;
+
+        const Snapshot::Header* header = Snapshot::validate(file.getData(), file.getSize());
+        if (header == nullptr)
+            return nullptr;
+
+        const Snapshot::BodyRecord* records =
+            reinterpret_cast<const Snapshot::BodyRecord*>(file.getData() + header->bodiesOffset);
+        const uint32_t* layerTable = reinterpret_cast<const uint32_t*>(file.getData() + header->layersOffset);
+        const float* shapeTable = reinterpret_cast<const float*>(file.getData() + header->shapesOffset);
+
+        //Move the bodies from the chunk's origin to the world's, in double precision
+        double offsetX = header->originX - m_world->getOriginX();
+        double offsetY = header->originY - m_world->getOriginY();
+
+        std::vector<PhysicsBody*> bodies;
+        bodies.reserve(header->bodyCount);
+
+        for (uint32_t i = 0; i < header->bodyCount; i++)
+        {
+            PhysicsBody* body =
+                Snapshot::createBody(records[i], layerTable, header->layerCount, shapeTable, header->shapeCount);
+            if (body == nullptr || body->getType() != BodyType::StaticBody)
+            {
+                delete body;
+                for (PhysicsBody* createdBody : bodies)
+                    delete createdBody;
+
+                return nullptr;
+            }
+
+            body->setPosition({static_cast<float>(records[i].positionX + offsetX),
+                static_cast<float>(records[i].positionY + offsetY)});
+            bodies.push_back(body);
+        }
+
+        StaticGroup* group = new StaticGroup();
+        group->build(bodies);
+
+        return group;
+    }
+
+    //Loads chunks near the focus and unloads chunks far from it
+    int ChunkStore::update(const AABB& focus)
+    {
+        double originX = m_world->getOriginX();
+        double originY = m_world->getOriginY();
+
+        int unloadMinX = getChunkCoordinate(focus.min.x + originX - m_unloadDistance);
+        int unloadMinY = getChunkCoordinate(focus.min.y + originY - m_unloadDistance);
+        int unloadMaxX = getChunkCoordinate(focus.max.x + originX + m_unloadDistance);
+        int unloadMaxY = getChunkCoordinate(focus.max.y + originY + m_unloadDistance);
+
+        for (auto it = m_chunks.begin(); it != m_chunks.end();)
+        {
+            const StaticChunk& chunk = it->second;
+            if (chunk.x >= unloadMinX && chunk.x <= unloadMaxX && chunk.y >= unloadMinY && chunk.y <= unloadMaxY)
+            {
+                ++it;
+                continue;
+            }
+
+            if (chunk.group)
+            {
+                m_world->removeStaticGroup(chunk.group);
+                delete chunk.group;
+            }
+
+            it = m_chunks.erase(it);
+        }
+
+        int loadMinX = getChunkCoordinate(focus.min.x + originX - m_loadDistance);
+        int loadMinY = getChunkCoordinate(focus.min.y + originY - m_loadDistance);
+        int loadMaxX = getChunkCoordinate(focus.max.x + originX + m_loadDistance);
+        int loadMaxY = getChunkCoordinate(focus.max.y + originY + m_loadDistance);
+
+        int loaded = 0;
+
+        for (int x = loadMinX; x <= loadMaxX; x++)
+        {
+            for (int y = loadMinY; y <= loadMaxY; y++)
+            {
+                uint64_t key = makeKey(x, y);
+                if (m_chunks.count(key))
+                    continue;
+
+                StaticGroup* group = loadChunk(x, y);
+                if (group)
+                {
+                    m_world->addStaticGroup(group);
+                    loaded++;
+                }
+
+                m_chunks.emplace(key, StaticChunk{x, y, group});
+            }
+        }
+
+        return loaded;
+    }
+
+    //Unloads every chunk
+    void ChunkStore::unloadAll()
+    {
+        for (auto& entry : m_chunks)
+        {
+            if (entry.second.group)
+            {
+                m_world->removeStaticGroup(entry.second.group);
+                delete entry.second.group;
+            }
+        }
+
+        m_chunks.clear();
+    }
+
+    //Sets the load and unload distances
+    void ChunkStore::setDistances(float loadDistance, float unloadDistance)
+    {
+        m_loadDistance = loadDistance;
+        m_unloadDistance = unloadDistance < loadDistance ? loadDistance : unloadDistance;
+    }
+
+    //Returns a loaded chunk's group
+    const StaticGroup* ChunkStore::getChunk(int x, int y) const
+    {
+        auto it = m_chunks.find(makeKey(x, y));
+        return it == m_chunks.end() ? nullptr : it->second.group;
+    }
+
+    //Returns the number of loaded chunks that have bodies
+    int ChunkStore::getLoadedChunkCount() const
+    {
+        int count = 0;
+        for (const auto& entry : m_chunks)
+        {
+            if (entry.second.group)
+                count++;
+        }
+
+        return count;
+    }
+}
@@ -0,0 +1,53 @@
+//Implementation of the CommandQueue class
+
+#include "core/CommandQueue.hpp"
+
+namespace phys
+{
+    //Constructor to create an empty queue, which starts out with a stub node
+    CommandQueue::CommandQueue()
+    {
+        Node* stub = new Node();
+        stub->next.store(nullptr, std::memory_order_relaxed);
+
+        m_head.store(stub, std::memory_order_relaxed);
+        m_tail = stub;
+    }
+
+    //Destructor to free the remaining nodes
+    CommandQueue::~CommandQueue()
+    {
+        while (m_tail)
+        {
+            Node* next = m_tail->next.load(std::memory_order_relaxed);
+            delete m_tail;
+            m_tail = next;
+        }
+    }
+
+    //Adds a command
+    void CommandQueue::push(const WorldCommand& command)
+    {
+        Node* node = new Node();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->command = command;
+
+        //Claim the head first, then link the previous head to the new node
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    //Takes out the oldest command
+    bool CommandQueue::pop(WorldCommand& command)
+    {
+        Node* next = m_tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+
+        delete m_tail;
+        m_tail = next;
+        command = next->command;
+
+        return true;
+    }
+}
@@ -1,28 +1,115 @@
 //Implementation of PhysicsWorld class: manages and updates physics bodies within it
 
 #include "core/PhysicsWorld.hpp"
+#include "core/Snapshot.hpp"
+#include "core/StepThread.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/WorldRecorder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
 
 namespace phys
 {
+    //Inserts a body into a list sorted by id and returns where it went
+    //Bodies usually arrive in id order, but a body queued with a reserved id can be passed by one added directly
+    static std::vector<PhysicsBody*>::iterator insertById(std::vector<PhysicsBody*>& bodies, PhysicsBody* body)
+    {
+        if (bodies.empty() || bodies.back()->getId() < body->getId())
+        {
+            bodies.push_back(body);
+            return bodies.end() - 1;
+        }
+
+        return bodies.insert(std::upper_bound(bodies.begin(),
+                                 bodies.end(),
+                                 body->getId(),
+                                 [](unsigned int id, const PhysicsBody* other) { return id < other->getId(); }),
+            body);
+    }
+
+    //Collects bodies from the broad phase that pass an overlap test into a caller buffer without allocating
+    //Returns the number of bodies written
+    template <typename OverlapTest>
+    static int collectOverlaps(const BroadPhase& broadPhase,
+        const AABB& bounds,
+        PhysicsBody** results,
+        int maxResults,
+        const QueryFilter& filter,
+        OverlapTest&& overlapTest)
+    {
+        int count = 0;
+        if (maxResults <= 0)
+            return 0;
+
+        //Bodies on more than one searched layer are only reported from the first, so no result is looked up
+        broadPhase.queryOnce(bounds,
+            filter,
+            [&](PhysicsBody* body)
+            {
+                const Collider* collider = body->getCollider();
+                if (collider->getType() == ColliderType::Trigger && !filter.includeTriggers)
+                    return true;
+
+                if (!overlapTest(collider))
+                    return true;
+
+                results[count++] = body;
+                return count < maxResults; //Stop once the buffer is full
+            });
+
+        return count;
+    }
+
     //Constructor to set boundary dimensions and default world settings
     PhysicsWorld::PhysicsWorld(const Vector2& boundaryDimensions) :
         m_boundary(boundaryDimensions, BoundaryType::Delete),
         m_gravityScale(1.0f),
         m_processPhysics(true),
         m_processCollisions(true),
-        m_rotationalPhysics(true)
+        m_rotationalPhysics(true),
+        m_deterministic(false),
+        m_nextBodyId(1),
+        m_stateHash(0),
+        m_recorder(nullptr),
+        m_exportRenderState(false),
+        m_stepThread(nullptr),
+        m_originX(0.0),
+        m_originY(0.0),
+        m_rebaseDistance(0.0f),
+        m_regionIndexStale(false)
     {
     }
 
     //Destructor to delete all dynamically allocated objects
     PhysicsWorld::~PhysicsWorld()
     {
+        //Finish the running step before anything it uses is deleted
+        delete m_stepThread;
+
+        //Queued bodies were never added but already belong to the world
+        m_commands.drain(
+            [](const WorldCommand& command)
+            {
+                if (command.type == WorldCommandType::AddBody)
+                    delete command.body;
+            });
+
+        if (m_recorder)
+            m_recorder->close();
+
         for (PhysicsBody* body : m_physicsBodies)
         {
             delete body;
         }
 
         m_physicsBodies.clear();
+        m_movingBodies.clear();
     }
 
     //Sets world boundary dimensions
@@ -37,13 +124,144 @@ namespace phys
         m_boundary.setType(type);
     }
 
+    //Sets the point the simulation is centered on
+    void PhysicsWorld::setFocus(const Vector2& focus)
+    {
+        m_focus = focus;
+    }
+
+    const Vector2& PhysicsWorld::getFocus() const
+    {
+        return m_focus;
+    }
+
+    //Sets how far the focus may get from the origin
+    void PhysicsWorld::setRebaseDistance(float distance)
+    {
+        if (distance >= 0.0f)
+            m_rebaseDistance = distance;
+    }
+
+    //Moves the origin of the world by shift
+    bool PhysicsWorld::rebaseOrigin(const Vector2& shift)
+    {
+        if (m_boundary.getType() != BoundaryType::None)
+            return false;
+
+        if (m_recorder)
+            m_recorder->recordRebaseOrigin(shift);
+
+        for (PhysicsBody* body : m_physicsBodies)
+            body->setPosition(body->getPosition() - shift);
+
+        for (StaticGroup* group : m_staticGroups)
+            group->shiftOrigin(shift);
+
+        m_broadPhase.shiftOrigin(shift);
+
+        //A shift by whole regions moves every body to the same neighbouring region, so only the keys change
+        float regionsX = shift.x / m_regionIndex.getRegionSize();
+        float regionsY = shift.y / m_regionIndex.getRegionSize();
+
+        if (regionsX == std::floor(regionsX) && regionsY == std::floor(regionsY))
+        {
+            m_regionIndex.shift(static_cast<int>(regionsX), static_cast<int>(regionsY));
+        }
+        else
+        {
+            m_regionIndex.clear(); //Rebuilt from every body when next asked for
+        }
+
+        m_focus -= shift;
+        m_originX += shift.x;
+        m_originY += shift.y;
+
+        return true;
+    }
+
+    double PhysicsWorld::getOriginX() const
+    {
+        return m_originX;
+    }
+
+    double PhysicsWorld::getOriginY() const
+    {
+        return m_originY;
+    }
+
+    //Returns the index of regions occupied by bodies, refiling the bodies that may have moved
+    const RegionIndex& PhysicsWorld::getRegionIndex()
+    {
+        if (m_boundary.getType() != BoundaryType::None)
+        {
+            if (m_regionIndex.getRegionCount() > 0)
+                m_regionIndex.clear();
+        }
+        else if (m_regionIndexStale || m_regionIndex.getRegionCount() == 0)
+        {
+            //Static bodies never change region, so once everything is filed only moving bodies are refiled
+            m_regionIndex.update(m_regionIndex.getRegionCount() == 0 ? m_physicsBodies : m_movingBodies);
+        }
+
+        m_regionIndexStale = false;
+        return m_regionIndex;
+    }
+
+    //Sets the side length of the regions in the region index
+    void PhysicsWorld::setRegionSize(float regionSize)
+    {
+        if (regionSize > 0.0f)
+            m_regionIndex.setRegionSize(regionSize);
+    }
+
     //Adds a physics body to the world
     void PhysicsWorld::addBody(PhysicsBody* body)
     {
-        m_physicsBodies.push_back(body);
+        body->setId(m_nextBodyId++);
+        insertBody(body);
+    }
+
+    //Adds a body that keeps its id
+    void PhysicsWorld::restoreBody(PhysicsBody* body)
+    {
+        raiseNextBodyId(body->getId());
+        insertBody(body);
+    }
+
+    //Moves the next id past a body id
+    void PhysicsWorld::raiseNextBodyId(unsigned int id)
+    {
+        //Retried until no other thread reserved an id between the read and the store
+        unsigned int next = m_nextBodyId.load();
+        while (next <= id && !m_nextBodyId.compare_exchange_weak(next, id + 1))
+        {
+        }
+    }
+
+    //Adds a body that already has its id, keeping the body lists in id order
+    void PhysicsWorld::insertBody(PhysicsBody* body)
+    {
+        //Recorded before boundary placement, which the replay repeats
+        if (m_recorder)
+            m_recorder->recordAddBody(body);
+
+        //Placed before the broad phase sees the body, static proxies are not refit once added
+        if (m_boundary.placementEnforce(body))
+        {
+            delete body; //Boundary type is delete and the body is beyond the boundary
+            return;
+        }
+
+        insertById(m_physicsBodies, body);
+        m_broadPhase.addBody(body);
 
-        if (m_boundary.placementEnforce(body)) //Enforce world boundary on body when added
-            removeBody(body);                  //Delete the body if boundary type is delete and beyond boundary
+        if (body->getType() != BodyType::StaticBody)
+        {
+            insertById(m_movingBodies, body);
+            m_regionIndexStale = true; //Filed with the other moving bodies when the index is next asked for
+        }
+        else if (m_boundary.getType() == BoundaryType::None)
+            m_regionIndex.clear(); //Static bodies are only filed when the whole index is rebuilt
     }
 
     //Removes a physics body from the world
@@ -52,167 +270,1380 @@ namespace phys
         auto it = std::find(m_physicsBodies.begin(), m_physicsBodies.end(), body);
         if (it != m_physicsBodies.end())
         {
-            delete *it;
-            m_physicsBodies.erase(it);
+            if (m_recorder)
+                m_recorder->recordRemoveBody(body);
+
+            eraseBody(it);
+        }
+    }
+
+    //Deletes a body and forgets everything the world tracked about it
+    void PhysicsWorld::eraseBody(std::vector<PhysicsBody*>::iterator it)
+    {
+        PhysicsBody* body = *it;
+
+        //Forget trigger overlaps and pending events involving the body
+        m_triggerOverlaps.erase(std::remove_if(m_triggerOverlaps.begin(),
+                                    m_triggerOverlaps.end(),
+                                    [body](const BroadPhasePair& pair)
+                                    { return pair.bodyA == body || pair.bodyB == body; }),
+            m_triggerOverlaps.end());
+
+        m_triggerEvents.erase(std::remove_if(m_triggerEvents.begin(),
+                                  m_triggerEvents.end(),
+                                  [body](const TriggerEvent& event)
+                                  { return event.trigger == body || event.other == body; }),
+            m_triggerEvents.end());
+
+        m_broadPhase.removeBody(body);
+        m_regionIndex.removeBody(body);
+
+        if (body->getType() != BodyType::StaticBody)
+        {
+            auto moving = std::lower_bound(m_movingBodies.begin(),
+                m_movingBodies.end(),
+                body->getId(),
+                [](const PhysicsBody* other, unsigned int id) { return other->getId() < id; });
+            m_movingBodies.erase(moving);
         }
+
+        delete body;
+        m_physicsBodies.erase(it);
     }
 
     //Updates physics bodies and checks for collisions
     void PhysicsWorld::update(float deltaTime)
     {
+        applyCommands();
+
+        //Move the origin once the focus wandered far enough from it for positions around the focus to lose precision
+        if (m_rebaseDistance > 0.0f && m_boundary.getType() == BoundaryType::None &&
+            m_focus.getLength() > m_rebaseDistance)
+        {
+            //Snapped to whole regions so the region index only has to shift its keys
+            float regionSize = m_regionIndex.getRegionSize();
+            Vector2 shift = {std::round(m_focus.x / regionSize) * regionSize,
+                std::round(m_focus.y / regionSize) * regionSize};
+            rebaseOrigin(shift);
+        }
+
         updatePhysics(deltaTime);
         updateCollisions();
+
+        //Refit bodies moved by the solver so queries between updates see final positions
+        m_broadPhase.update();
+
+        //The region index is refiled when next asked for
+        m_regionIndexStale = true;
+
+        if (m_deterministic)
+            m_stateHash = calculateStateHash();
+
+        if (m_recorder)
+            m_recorder->recordUpdate(deltaTime, m_deterministic ? m_stateHash : calculateStateHash());
+
+        if (m_exportRenderState)
+        {
+            writeRenderState(m_renderBuffer.getWriteSlot());
+            m_renderBuffer.publish();
+        }
     }
 
-    //Updates physics bodies and applies gravity
-    void PhysicsWorld::updatePhysics(float deltaTime)
+    //Runs update on the world's step thread
+    std::shared_future<void> PhysicsWorld::stepAsync(float deltaTime)
     {
-        //If physics processing is disabled, return early
-        if (!m_processPhysics)
-            return;
-
-        //Loop through all physics bodies
-        for (size_t i = 0; i < m_physicsBodies.size();)
+        if (!m_stepThread)
         {
-            PhysicsBody* body = m_physicsBodies[i];
+            //Publish every finished step so it can be read while the next one runs
+            if (!m_renderBuffer.isConcurrent())
+                m_renderBuffer.setConcurrent(true);
 
-            //Extra logic for dynamic bodies
-            if (body->getType() == BodyType::DynamicBody)
-            {
-                DynamicBody* dynamicBody = static_cast<DynamicBody*>(body);
+            m_exportRenderState = true;
+            m_stepThread = new StepThread();
+        }
 
-                if (dynamicBody->isAffectedByGravity())
-                    applyGravity(dynamicBody); //Apply gravity to dynamic bodies
+        return m_stepThread->submit([this, deltaTime] { update(deltaTime); });
+    }
 
-                //Enforce boundaries on dynamic body
-                if (m_boundary.dynamicEnforce(dynamicBody))
-                {
-                    removeBody(dynamicBody); //Delete the body if boundary type is delete and beyond boundary
-                    continue;                //Do not increment index since body was deleted
-                }
-            }
+    //Waits for the last asynchronous step to finish
+    void PhysicsWorld::waitForStep()
+    {
+        if (m_stepThread)
+            m_stepThread->wait();
+    }
 
-            body->update(deltaTime); //Update all bodies
-            i++;                     //Increment index
-        }
+    //Queues a body to be added, reserving its id
+    unsigned int PhysicsWorld::queueAddBody(PhysicsBody* body)
+    {
+        body->setId(m_nextBodyId++);
+        m_commands.push({WorldCommandType::AddBody, body, body->getId(), {}});
+
+        return body->getId();
     }
 
-    //Detect and resolve collisions of physics bodies
-    void PhysicsWorld::updateCollisions()
+    //Queues the removal of a body
+    void PhysicsWorld::queueRemoveBody(unsigned int id)
     {
-        //If collisions processing is disabled, return early
-        if (!m_processCollisions)
-            return;
+        m_commands.push({WorldCommandType::RemoveBody, nullptr, id, {}});
+    }
 
-        //Iterate many times to resolve deep interpenetration
-        const int ITERATIONS = 10;
+    //Queues a force on a dynamic body
+    void PhysicsWorld::queueForce(unsigned int id, const Vector2& force)
+    {
+        m_commands.push({WorldCommandType::ApplyForce, nullptr, id, force});
+    }
+
+    //Queues an impulse on a dynamic body
+    void PhysicsWorld::queueImpulse(unsigned int id, const Vector2& impulse)
+    {
+        m_commands.push({WorldCommandType::ApplyImpulse, nullptr, id, impulse});
+    }
+
+    //Queues setting the velocity of a dynamic body
+    void PhysicsWorld::queueVelocity(unsigned int id, const Vector2& velocity)
+    {
+        m_commands.push({WorldCommandType::SetVelocity, nullptr, id, velocity});
+    }
 
-        for (int i = 0; i < ITERATIONS; i++)
+    //Applies the commands queued since the last update
+    void PhysicsWorld::applyCommands()
+    {
+        m_commands.drain([this](const WorldCommand& command) { applyCommand(command); });
+    }
+
+    //Applies one queued command through the public functions so recordings capture it
+    void PhysicsWorld::applyCommand(const WorldCommand& command)
+    {
+        if (command.type == WorldCommandType::AddBody)
         {
-            //Nested for loop to check every body against every other body
-            for (size_t i = 0; i < m_physicsBodies.size(); i++)
-            {
-                PhysicsBody* bodyA = m_physicsBodies[i];
+            insertBody(command.body);
+            return;
+        }
 
-                for (size_t j = i + 1; j < m_physicsBodies.size(); j++)
-                {
-                    PhysicsBody* bodyB = m_physicsBodies[j];
+        //The body may have left the world since the command was queued
+        PhysicsBody* body = getBody(command.bodyId);
+        if (!body)
+            return;
 
-                    //Get the colliders of the bodies
-                    Collider* colliderA = bodyA->getCollider();
-                    Collider* colliderB = bodyB->getCollider();
+        if (command.type == WorldCommandType::RemoveBody)
+            removeBody(body);
+        else if (command.type == WorldCommandType::ApplyForce)
+            applyForce(body, command.value);
+        else if (command.type == WorldCommandType::ApplyImpulse)
+            applyImpulse(body, command.value);
+        else
+            setVelocity(body, command.value);
+    }
 
-                    //Get collider types
-                    ColliderType colliderTypeA = colliderA->getType();
-                    ColliderType colliderTypeB = colliderB->getType();
+    //Adds a group of static bodies with prebuilt broad phase trees
+    bool PhysicsWorld::addStaticGroup(StaticGroup* group)
+    {
+        if (std::find(m_staticGroups.begin(), m_staticGroups.end(), group) != m_staticGroups.end())
+            return false;
 
-                    //Get the body types
-                    BodyType typeA = bodyA->getType();
-                    BodyType typeB = bodyB->getType();
+        //Ids are handed out in group order, which keeps the group's bodies sorted by id
+        for (PhysicsBody* body : group->getBodies())
+            body->setId(m_nextBodyId++);
 
-                    //If both are static bodies, no need to check for a collision
-                    if (typeA == BodyType::StaticBody && typeB == BodyType::StaticBody)
-                        continue;
+        attachStaticGroup(group);
 
-                    //If one of the bodies has a trigger collider, no need to resolve collision
-                    if (colliderTypeA == ColliderType::Trigger || colliderTypeB == ColliderType::Trigger)
-                        continue;
+        return true;
+    }
 
-                    //First check if AABBs are intersecting (Broad phase)
-                    const AABB boundingBoxA = colliderA->getAABB();
-                    const AABB boundingBoxB = colliderB->getAABB();
+    //Adds a group of static bodies that keep their ids
+    bool PhysicsWorld::restoreStaticGroup(StaticGroup* group)
+    {
+        if (std::find(m_staticGroups.begin(), m_staticGroups.end(), group) != m_staticGroups.end())
+            return false;
 
-                    if (!CollisionDetection::checkAABBvsAABB(boundingBoxA, boundingBoxB))
-                        continue;
+        //A group recorded as it was added holds exactly the ids the world would hand out next
+        for (PhysicsBody* body : group->getBodies())
+            raiseNextBodyId(body->getId());
 
-                    //Check collision between colliders (Narrow phase)
-                    Collision* collision = CollisionDetection::checkCollision(bodyA, bodyB);
-                    if (collision)
-                    {
-                        if (m_rotationalPhysics)
-                            CollisionResolution::resolveAdvancedCollision(*collision);
-                        else
-                            CollisionResolution::resolveBasicCollision(*collision);
-                    }
+        attachStaticGroup(group);
 
-                    delete collision; //Delete collision data after resolution
-                }
-            }
-        }
+        return true;
     }
 
-    //Applies the force of gravity to a dynamic body
-    void PhysicsWorld::applyGravity(DynamicBody* body) const
+    //Attaches a group to the broad phase and records it
+    void PhysicsWorld::attachStaticGroup(StaticGroup* group)
     {
-        body->applyForce(m_gravity * m_gravityScale * body->getMass());
+        m_staticGroups.push_back(group);
+        m_broadPhase.attachGroup(group);
+
+        if (m_recorder)
+            m_recorder->recordAttachGroup(group);
     }
 
-    //Return true if given physics bodies are colliding
-    bool PhysicsWorld::checkIfColliding(PhysicsBody* bodyA, PhysicsBody* bodyB)
+    //Removes a group of static bodies without deleting it
+    void PhysicsWorld::removeStaticGroup(StaticGroup* group)
     {
-        Collision* collision = CollisionDetection::checkCollision(bodyA, bodyB);
+        auto it = std::find(m_staticGroups.begin(), m_staticGroups.end(), group);
+        if (it == m_staticGroups.end())
+            return;
 
-        if (collision != nullptr)
-            return true;
-        else
-            return false;
+        if (m_recorder)
+            m_recorder->recordDetachGroup(group);
+
+        forgetTriggerState(group->getBodies());
+        m_broadPhase.detachGroup(group);
+        m_staticGroups.erase(it);
     }
 
-    bool PhysicsWorld::checkIfOnFloor(const PhysicsBody* body) const
+    //Returns the static groups in the world
+    const std::vector<StaticGroup*>& PhysicsWorld::getStaticGroups() const
     {
-        return m_boundary.checkIfOnFloor(body);
+        return m_staticGroups;
     }
 
-    //Pauses or resumes the physics processing
-    void PhysicsWorld::setPhysicsProcess(bool processPhysics)
+    //Returns the body with the given id
+    PhysicsBody* PhysicsWorld::getBody(unsigned int id) const
     {
-        m_processPhysics = processPhysics;
+        //Bodies are kept in id order
+        auto it = std::lower_bound(m_physicsBodies.begin(),
+            m_physicsBodies.end(),
+            id,
+            [](const PhysicsBody* body, unsigned int bodyId) { return body->getId() < bodyId; });
+
+        if (it == m_physicsBodies.end() || (*it)->getId() != id)
+            return nullptr;
+
+        return *it;
     }
 
-    //Pauses or resumes the collision detection
-    void PhysicsWorld::setCollisionProcess(bool processCollisions)
+    //Applies a force to a dynamic body
+    bool PhysicsWorld::applyForce(PhysicsBody* body, const Vector2& force)
     {
-        m_processCollisions = processCollisions;
+        if (body->getType() != BodyType::DynamicBody)
+            return false;
+
+        if (m_recorder)
+            m_recorder->recordApplyForce(body, force);
+
+        static_cast<DynamicBody*>(body)->applyForce(force);
+
+        return true;
     }
 
-    //Enables or disables rotational physics in the world
-    void PhysicsWorld::setRotationalPhysics(bool rotationalPhysics)
+    //Applies an impulse to a dynamic body
+    bool PhysicsWorld::applyImpulse(PhysicsBody* body, const Vector2& impulse)
     {
-        m_rotationalPhysics = rotationalPhysics;
+        if (body->getType() != BodyType::DynamicBody)
+            return false;
+
+        if (m_recorder)
+            m_recorder->recordApplyImpulse(body, impulse);
+
+        static_cast<DynamicBody*>(body)->applyImpulse(impulse);
+
+        return true;
     }
 
-    //Sets the gravity scale of the world
-    void PhysicsWorld::setGravityScale(float newScaleValue)
+    //Sets the velocity of a dynamic body
+    bool PhysicsWorld::setVelocity(PhysicsBody* body, const Vector2& velocity)
     {
-        if (newScaleValue >= 0) //Ensure non-negative gravity scale
+        if (body->getType() != BodyType::DynamicBody)
+            return false;
+
+        if (m_recorder)
+            m_recorder->recordSetVelocity(body, velocity);
+
+        static_cast<DynamicBody*>(body)->setVelocity(velocity);
+
+        return true;
+    }
+
+    //Updates physics bodies and applies gravity
+    void PhysicsWorld::updatePhysics(float deltaTime)
+    {
+        //If physics processing is disabled, return early
+        if (!m_processPhysics)
+            return;
+
+        //Loop through all bodies that can move
+        for (PhysicsBody* body : m_movingBodies)
         {
-            m_gravityScale = newScaleValue;
+            //Extra logic for dynamic bodies
+            if (body->getType() == BodyType::DynamicBody)
+            {
+                DynamicBody* dynamicBody = static_cast<DynamicBody*>(body);
+
+                if (dynamicBody->isAffectedByGravity())
+                    applyGravity(dynamicBody); //Apply gravity to dynamic bodies
+            }
+
+            body->update(deltaTime); //Update all bodies
         }
+
+        //Delete or push back bodies that moved beyond the boundary
+        updateBoundary();
     }
 
-    //Returns the vector of physics bodies in the world
-    const std::vector<PhysicsBody*>& PhysicsWorld::getBodies() const
+    //Enforces the boundary on bodies that moved beyond it
+    void PhysicsWorld::updateBoundary()
     {
-        return m_physicsBodies;
+        if (m_boundary.getType() == BoundaryType::None)
+            return;
+
+        //Without collisions there is nothing else to refit the broad phase for
+        if (!m_processCollisions)
+        {
+            enforceBoundaryBatch();
+            return;
+        }
+
+        //Collidable edges are solved within the collision iterations, which find the candidates themselves
+        if (m_boundary.getType() != BoundaryType::Delete)
+            return;
+
+        //Fat boxes must contain the moved bodies before the edges are queried
+        m_broadPhase.update();
+        findBoundaryCandidates();
+
+        //Candidates are sorted by id, a body beyond two edges shows up twice
+        m_deletedBodies.clear();
+
+        for (const std::pair<PhysicsBody*, int>& candidate : m_boundaryCandidates)
+        {
+            if (!m_deletedBodies.empty() && m_deletedBodies.back() == candidate.first)
+                continue;
+
+            if (m_boundary.isBeyondEdge(candidate.first, candidate.second))
+                m_deletedBodies.push_back(candidate.first);
+        }
+
+        m_boundaryCandidates.clear();
+        eraseBodies(m_deletedBodies);
+    }
+
+    //Checks every dynamic body against the boundary in one batched pass
+    void PhysicsWorld::enforceBoundaryBatch()
+    {
+        m_boundaryBodies.clear();
+
+        for (PhysicsBody* body : m_movingBodies)
+        {
+            if (body->getType() == BodyType::DynamicBody)
+                m_boundaryBodies.push_back(static_cast<DynamicBody*>(body));
+        }
+
+        //Pack the boxes so the boundary can check several at once
+        m_boundaryBatch.resize(m_boundaryBodies.size());
+
+        for (size_t i = 0; i < m_boundaryBodies.size(); i++)
+        {
+            const AABB& box = m_boundaryBodies[i]->getCollider()->getAABB();
+            m_boundaryBatch.minX[i] = box.min.x;
+            m_boundaryBatch.minY[i] = box.min.y;
+            m_boundaryBatch.maxX[i] = box.max.x;
+            m_boundaryBatch.maxY[i] = box.max.y;
+        }
+
+        m_boundary.enforceBatch(m_boundaryBatch);
+
+        if (m_boundary.getType() == BoundaryType::Delete)
+        {
+            //Bodies are in id order, so the deletions are too
+            m_deletedBodies.clear();
+
+            for (size_t i = 0; i < m_boundaryBodies.size(); i++)
+            {
+                if (m_boundaryBatch.beyond[i])
+                    m_deletedBodies.push_back(m_boundaryBodies[i]);
+            }
+
+            eraseBodies(m_deletedBodies);
+            return;
+        }
+
+        for (size_t i = 0; i < m_boundaryBodies.size(); i++)
+        {
+            Vector2 correction = {m_boundaryBatch.correctionX[i], m_boundaryBatch.correctionY[i]};
+            if (correction.x == 0.0f && correction.y == 0.0f)
+                continue;
+
+            DynamicBody* body = m_boundaryBodies[i];
+            body->move(correction);
+
+            //Bounce off the edges the body is still moving into
+            Vector2 velocity = body->getVelocity();
+            float restitution = body->getRestitution();
+
+            if ((correction.x > 0.0f && velocity.x < 0.0f) || (correction.x < 0.0f && velocity.x > 0.0f))
+                velocity.x = -velocity.x * restitution;
+
+            if ((correction.y > 0.0f && velocity.y < 0.0f) || (correction.y < 0.0f && velocity.y > 0.0f))
+                velocity.y = -velocity.y * restitution;
+
+            body->setVelocity(velocity);
+        }
+    }
+
+    //Finds dynamic bodies whose fat boxes reach beyond a boundary edge
+    void PhysicsWorld::findBoundaryCandidates()
+    {
+        m_boundaryCandidates.clear();
+
+        for (int edge = 0; edge < WorldBoundary::EDGE_COUNT; edge++)
+        {
+            m_broadPhase.query(m_boundary.getEdgeRegion(edge),
+                QueryFilter(),
+                [&](PhysicsBody* body)
+                {
+                    if (body->getType() == BodyType::DynamicBody)
+                        m_boundaryCandidates.emplace_back(body, edge);
+
+                    return true;
+                });
+        }
+
+        //Body id order keeps resolution independent of the tree layout, and drops bodies found on several layers
+        std::sort(m_boundaryCandidates.begin(),
+            m_boundaryCandidates.end(),
+            [](const std::pair<PhysicsBody*, int>& a, const std::pair<PhysicsBody*, int>& b)
+            {
+                if (a.first->getId() != b.first->getId())
+                    return a.first->getId() < b.first->getId();
+
+                return a.second < b.second;
+            });
+
+        m_boundaryCandidates.erase(std::unique(m_boundaryCandidates.begin(), m_boundaryCandidates.end()),
+            m_boundaryCandidates.end());
+    }
+
+    //Resolves collisions between the boundary candidates and the edges they cross
+    void PhysicsWorld::resolveBoundaryCollisions()
+    {
+        for (const std::pair<PhysicsBody*, int>& candidate : m_boundaryCandidates)
+        {
+            if (!m_boundary.checkEdgeCollision(candidate.first, candidate.second, m_edgeCollision))
+                continue;
+
+            if (m_rotationalPhysics)
+                CollisionResolution::resolveAdvancedCollision(m_edgeCollision);
+            else
+                CollisionResolution::resolveBasicCollision(m_edgeCollision);
+        }
+    }
+
+    //Detect and resolve collisions of physics bodies
+    void PhysicsWorld::updateCollisions()
+    {
+        //If collisions processing is disabled, return early
+        if (!m_processCollisions)
+            return;
+
+        //Events from the previous update have been read by now
+        m_triggerEvents.clear();
+
+        //Forget the simplices of pairs that stopped being checked
+        m_simplexCaches.beginStep();
+
+        //Refit moved bodies and find pairs whose layers and fat AABBs overlap (Broad phase)
+        m_broadPhase.update();
+        m_broadPhase.findPairs(m_pairs);
+
+        //Proxy ids and fat boxes depend on the order bodies were added, removed and moved, body ids do not
+        if (m_deterministic)
+            makePairsDeterministic();
+
+        //Pairs of the same shapes are checked together, so each group keeps one routine hot
+        groupPairsByShape();
+
+        //Bodies pushed towards an edge by other bodies are pushed back within the same iterations
+        if (m_boundary.getType() == BoundaryType::Collidable)
+            findBoundaryCandidates();
+        else
+            m_boundaryCandidates.clear();
+
+        //Iterate many times to resolve deep interpenetration
+        for (int i = 0; i < COLLISION_ITERATIONS; i++)
+        {
+            for (const PairGroup& group : m_pairGroups)
+            {
+                for (size_t p = group.first; p < group.last; p++)
+                {
+                    const BroadPhasePair& pair = m_pairs[p];
+
+                    //Get the colliders of the bodies
+                    Collider* colliderA = pair.bodyA->getCollider();
+                    Collider* colliderB = pair.bodyB->getCollider();
+
+                    //If one of the bodies has a trigger collider, no need to resolve collision
+                    if (colliderA->getType() == ColliderType::Trigger || colliderB->getType() == ColliderType::Trigger)
+                        continue;
+
+                    //Bodies may have moved apart during earlier iterations, recheck the tight AABBs
+                    if (!CollisionDetection::checkAABBvsAABB(colliderA->getAABB(), colliderB->getAABB()))
+                        continue;
+
+                    if (!CollisionDetection::shouldCollide(colliderA, colliderB))
+                        continue;
+
+                    //Check collision between colliders (Narrow phase)
+                    m_pairCollisions.clear();
+                    group.function(colliderA, colliderB, m_pairCollisions, &m_simplexCaches);
+
+                    for (Collision* collision : m_pairCollisions)
+                    {
+                        if (m_rotationalPhysics)
+                            CollisionResolution::resolveAdvancedCollision(*collision);
+                        else
+                            CollisionResolution::resolveBasicCollision(*collision);
+
+                        delete collision; //Delete collision data after resolution
+                    }
+                }
+            }
+
+            resolveBoundaryCollisions();
+        }
+
+        //Triggers are checked once against the resolved positions
+        updateTriggers();
+    }
+
+    //Finds trigger overlaps among the broad phase pairs and emits enter and exit events
+    void PhysicsWorld::updateTriggers()
+    {
+        m_newTriggerOverlaps.clear();
+
+        for (const BroadPhasePair& pair : m_pairs)
+        {
+            Collider* colliderA = pair.bodyA->getCollider();
+            Collider* colliderB = pair.bodyB->getCollider();
+
+            //Solid pairs were handled by the solver
+            if (colliderA->getType() != ColliderType::Trigger && colliderB->getType() != ColliderType::Trigger)
+                continue;
+
+            if (!CollisionDetection::checkAABBvsAABB(colliderA->getAABB(), colliderB->getAABB()))
+                continue;
+
+            Collision* collision = CollisionDetection::checkCollision(pair.bodyA, pair.bodyB);
+            if (collision)
+                m_newTriggerOverlaps.push_back(pair);
+
+            delete collision;
+        }
+
+        //Sort by body ids, which unlike proxy ids are never reused, then walk both lists together
+        //to find started and ended overlaps
+        auto pairKey = [](const BroadPhasePair& pair)
+        {
+            unsigned int idA = pair.bodyA->getId();
+            unsigned int idB = pair.bodyB->getId();
+
+            return idA < idB ? std::make_pair(idA, idB) : std::make_pair(idB, idA);
+        };
+
+        auto pairLess = [&pairKey](const BroadPhasePair& a, const BroadPhasePair& b)
+        { return pairKey(a) < pairKey(b); };
+
+        std::sort(m_newTriggerOverlaps.begin(), m_newTriggerOverlaps.end(), pairLess);
+
+        auto makeEvent = [](const BroadPhasePair& pair, TriggerEventType type) -> TriggerEvent
+        {
+            if (pair.bodyA->getCollider()->getType() == ColliderType::Trigger)
+                return {pair.bodyA, pair.bodyB, type};
+
+            return {pair.bodyB, pair.bodyA, type};
+        };
+
+        size_t oldIndex = 0;
+        size_t newIndex = 0;
+
+        while (oldIndex < m_triggerOverlaps.size() || newIndex < m_newTriggerOverlaps.size())
+        {
+            if (newIndex == m_newTriggerOverlaps.size() ||
+                (oldIndex < m_triggerOverlaps.size() &&
+                    pairLess(m_triggerOverlaps[oldIndex], m_newTriggerOverlaps[newIndex])))
+            {
+                //Overlap from last update no longer exists
+                m_triggerEvents.push_back(makeEvent(m_triggerOverlaps[oldIndex++], TriggerEventType::Exit));
+            }
+            else if (oldIndex == m_triggerOverlaps.size() ||
+                     pairLess(m_newTriggerOverlaps[newIndex], m_triggerOverlaps[oldIndex]))
+            {
+                //New overlap this update
+                m_triggerEvents.push_back(makeEvent(m_newTriggerOverlaps[newIndex++], TriggerEventType::Enter));
+            }
+            else
+            {
+                //Overlap continues
+                oldIndex++;
+                newIndex++;
+            }
+        }
+
+        m_triggerOverlaps.swap(m_newTriggerOverlaps);
+    }
+
+    //Applies the force of gravity to a dynamic body
+    void PhysicsWorld::applyGravity(DynamicBody* body) const
+    {
+        body->applyForce(m_gravity * m_gravityScale * body->getMass());
+    }
+
+    //Casts a normalized ray through the broad phase, keeping the closest hit
+    bool PhysicsWorld::castClosestRay(const Vector2& origin,
+        const Vector2& direction,
+        float maxDistance,
+        const QueryFilter& filter,
+        RayHit& hit) const
+    {
+        hit.body = nullptr;
+
+        m_broadPhase.rayCast(origin,
+            direction,
+            maxDistance,
+            filter,
+            [&](PhysicsBody* body, float distance)
+            {
+                Collider* collider = body->getCollider();
+                if (collider->getType() == ColliderType::Trigger && !filter.includeTriggers)
+                    return distance;
+
+                //Clip the ray to the new closest hit so farther nodes are skipped
+                RayHit candidate;
+                if (CollisionDetection::rayCastCollider(origin, direction, distance, collider, candidate))
+                {
+                    hit = candidate;
+                    return candidate.distance;
+                }
+
+                return distance;
+            });
+
+        return hit.body != nullptr;
+    }
+
+    //Casts a ray and fills hit with the closest body it enters
+    bool PhysicsWorld::raycast(const Ray& ray, RayHit& hit, const QueryFilter& filter) const
+    {
+        hit.body = nullptr;
+
+        float length = ray.direction.getLength();
+        if (length == 0.0f)
+            return false;
+
+        return castClosestRay(ray.origin, ray.direction / length, ray.maxDistance, filter, hit);
+    }
+
+    //Casts a ray and fills hits with every body it enters, sorted by distance
+    int PhysicsWorld::raycastAll(const Ray& ray, std::vector<RayHit>& hits, const QueryFilter& filter) const
+    {
+        hits.clear();
+
+        float length = ray.direction.getLength();
+        if (length == 0.0f)
+            return 0;
+
+        Vector2 direction = ray.direction / length;
+
+        m_broadPhase.rayCast(ray.origin,
+            direction,
+            ray.maxDistance,
+            filter,
+            [&](PhysicsBody* body, float distance)
+            {
+                Collider* collider = body->getCollider();
+                if (collider->getType() == ColliderType::Trigger && !filter.includeTriggers)
+                    return distance;
+
+                RayHit hit;
+                if (CollisionDetection::rayCastCollider(ray.origin, direction, distance, collider, hit))
+                    hits.push_back(hit);
+
+                return distance; //Never clip, every hit is wanted
+            });
+
+        //Sort by distance and drop bodies found through more than one layer
+        std::sort(hits.begin(),
+            hits.end(),
+            [](const RayHit& a, const RayHit& b)
+            { return a.distance != b.distance ? a.distance < b.distance : a.body->getId() < b.body->getId(); });
+
+        hits.erase(std::unique(hits.begin(),
+                       hits.end(),
+                       [](const RayHit& a, const RayHit& b) { return a.body == b.body; }),
+            hits.end());
+
+        return static_cast<int>(hits.size());
+    }
+
+    //Casts many rays at once, sharing ranges of them with a pool when one is given
+    void PhysicsWorld::raycastBatch(
+        const std::vector<Ray>& rays, std::vector<RayHit>& results, const QueryFilter& filter, ThreadPool* pool) const
+    {
+        results.resize(rays.size());
+
+        size_t rayCount = rays.size();
+        if (!pool || rayCount <= RAYCAST_BATCH_RANGE)
+        {
+            for (size_t i = 0; i < rayCount; i++)
+                raycast(rays[i], results[i], filter);
+
+            return;
+        }
+
+        //Progress shared with the pool tasks, which may only start once every range was claimed and the call returned
+        struct BatchProgress
+        {
+            std::atomic<size_t> nextRange{0};
+            size_t finishedRanges = 0;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+
+        std::shared_ptr<BatchProgress> progress = std::make_shared<BatchProgress>();
+        size_t rangeCount = (rayCount + RAYCAST_BATCH_RANGE - 1) / RAYCAST_BATCH_RANGE;
+
+        //Claims ranges until none are left, the rays are only touched through a claimed range
+        //which the calling thread waits for, so a task starting late never reaches them
+        auto castRanges = [this, progress, rangeCount, &rays, &results, &filter]
+        {
+            size_t range;
+            while ((range = progress->nextRange.fetch_add(1)) < rangeCount)
+            {
+                size_t end = std::min((range + 1) * RAYCAST_BATCH_RANGE, rays.size());
+                for (size_t i = range * RAYCAST_BATCH_RANGE; i < end; i++)
+                    raycast(rays[i], results[i], filter);
+
+                std::lock_guard<std::mutex> lock(progress->mutex);
+                if (++progress->finishedRanges == rangeCount)
+                    progress->finished.notify_one();
+            }
+        };
+
+        //The calling thread casts too, so the batch finishes even if every worker is busy
+        size_t taskCount = std::min(rangeCount - 1, static_cast<size_t>(pool->getThreadCount()));
+        for (size_t i = 0; i < taskCount; i++)
+            pool->submit(castRanges);
+
+        castRanges();
+
+        std::unique_lock<std::mutex> lock(progress->mutex);
+        progress->finished.wait(lock, [&] { return progress->finishedRanges == rangeCount; });
+    }
+
+    //Finds bodies overlapping a region
+    int PhysicsWorld::queryRegion(
+        const AABB& region, PhysicsBody** results, int maxResults, const QueryFilter& filter, bool exact) const
+    {
+        return collectOverlaps(m_broadPhase,
+            region,
+            results,
+            maxResults,
+            filter,
+            [&](const Collider* collider)
+            {
+                if (exact)
+                    return CollisionDetection::checkColliderOverlapsAABB(collider, region);
+
+                return collider->getAABB().overlaps(region);
+            });
+    }
+
+    //Finds bodies under a point
+    int PhysicsWorld::queryPoint(
+        const Vector2& point, PhysicsBody** results, int maxResults, const QueryFilter& filter, bool exact) const
+    {
+        return collectOverlaps(m_broadPhase,
+            AABB(point, point),
+            results,
+            maxResults,
+            filter,
+            [&](const Collider* collider)
+            {
+                if (exact)
+                    return CollisionDetection::checkColliderContainsPoint(collider, point);
+
+                return collider->getAABB().overlaps(AABB(point, point));
+            });
+    }
+
+    //Finds bodies overlapping a circle
+    int PhysicsWorld::queryCircle(const Vector2& center,
+        float radius,
+        PhysicsBody** results,
+        int maxResults,
+        const QueryFilter& filter,
+        bool exact) const
+    {
+        AABB bounds({center.x - radius, center.y - radius}, {center.x + radius, center.y + radius});
+
+        return collectOverlaps(m_broadPhase,
+            bounds,
+            results,
+            maxResults,
+            filter,
+            [&](const Collider* collider)
+            {
+                if (exact)
+                    return CollisionDetection::checkColliderOverlapsCircle(collider, center, radius);
+
+                //Closest point of the AABB to the center must be within the radius
+                const AABB& box = collider->getAABB();
+                Vector2 closest = {
+                    std::clamp(center.x, box.min.x, box.max.x), std::clamp(center.y, box.min.y, box.max.y)};
+
+                return (center - closest).getSquare() <= radius * radius;
+            });
+    }
+
+    //Sweeps a collider along a displacement and finds the first body touched
+    bool PhysicsWorld::shapeCast(
+        const Collider* shape, const Vector2& displacement, ShapeCastHit& hit, const QueryFilter& filter) const
+    {
+        hit.body = nullptr;
+        hit.fraction = 1.0f;
+
+        //Only bodies overlapping the box swept by the shape can be hit
+        const AABB& start = shape->getAABB();
+        AABB sweptBox = AABB::combine(start, AABB(start.min + displacement, start.max + displacement));
+
+        m_broadPhase.query(sweptBox,
+            filter,
+            [&](PhysicsBody* body)
+            {
+                const Collider* collider = body->getCollider();
+
+                if (body == shape->getParent())
+                    return true;
+
+                if (collider->getType() == ColliderType::Trigger && !filter.includeTriggers)
+                    return true;
+
+                if (!collider->getAABB().overlaps(sweptBox))
+                    return true;
+
+                ShapeCastHit candidate;
+                if (CollisionDetection::shapeCastCollider(shape, displacement, collider, candidate) &&
+                    (hit.body == nullptr || candidate.fraction < hit.fraction))
+                {
+                    hit = candidate;
+                }
+
+                //Nothing can be hit earlier than an initial overlap
+                return hit.body == nullptr || hit.fraction > 0.0f;
+            });
+
+        return hit.body != nullptr;
+    }
+
+    //Sweeps a body's collider along a displacement, only hitting bodies on layers the collider masks
+    bool PhysicsWorld::shapeCast(const PhysicsBody* body, const Vector2& displacement, ShapeCastHit& hit) const
+    {
+        QueryFilter filter;
+        filter.layerSpan = &body->getCollider()->getCollisionMasks();
+
+        return shapeCast(body->getCollider(), displacement, hit, filter);
+    }
+
+    //Return true if given physics bodies are colliding
+    bool PhysicsWorld::checkIfColliding(PhysicsBody* bodyA, PhysicsBody* bodyB)
+    {
+        Collision* collision = CollisionDetection::checkCollision(bodyA, bodyB);
+        bool colliding = collision != nullptr;
+
+        delete collision; //Only the result is needed
+
+        return colliding;
+    }
+
+    bool PhysicsWorld::checkIfOnFloor(const PhysicsBody* body) const
+    {
+        return m_boundary.checkIfOnFloor(body);
+    }
+
+    //Pauses or resumes the physics processing
+    void PhysicsWorld::setPhysicsProcess(bool processPhysics)
+    {
+        m_processPhysics = processPhysics;
+    }
+
+    //Pauses or resumes the collision detection
+    void PhysicsWorld::setCollisionProcess(bool processCollisions)
+    {
+        m_processCollisions = processCollisions;
+    }
+
+    //Enables or disables rotational physics in the world
+    void PhysicsWorld::setRotationalPhysics(bool rotationalPhysics)
+    {
+        m_rotationalPhysics = rotationalPhysics;
+    }
+
+    //Enables or disables deterministic mode
+    void PhysicsWorld::setDeterministic(bool deterministic)
+    {
+        m_deterministic = deterministic;
+    }
+
+    //Mixes a 32 bit word into an FNV-1a style hash
+    static uint64_t hashWord(uint64_t hash, uint32_t word)
+    {
+        const uint64_t FNV_PRIME = 1099511628211ULL;
+
+        return (hash ^ word) * FNV_PRIME;
+    }
+
+    //Mixes the exact bits of a float into the hash
+    static uint64_t hashFloat(uint64_t hash, float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+
+        return hashWord(hash, bits);
+    }
+
+    //Returns a 64 bit hash of all body state
+    uint64_t PhysicsWorld::calculateStateHash() const
+    {
+        const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+        uint64_t hash = FNV_OFFSET_BASIS;
+
+        //Bodies are kept in id order
+        for (const PhysicsBody* body : m_physicsBodies)
+        {
+            hash = hashWord(hash, body->getId());
+            hash = hashFloat(hash, body->getPosition().x);
+            hash = hashFloat(hash, body->getPosition().y);
+            hash = hashFloat(hash, body->getRotation());
+
+            if (body->getType() == BodyType::DynamicBody)
+            {
+                const DynamicBody* dynamicBody = static_cast<const DynamicBody*>(body);
+                hash = hashFloat(hash, dynamicBody->getVelocity().x);
+                hash = hashFloat(hash, dynamicBody->getVelocity().y);
+                hash = hashFloat(hash, dynamicBody->getAngularVelocity());
+            }
+        }
+
+        return hash;
+    }
+
+    //Returns the state hash calculated at the end of the last update
+    uint64_t PhysicsWorld::getStateHash() const
+    {
+        return m_stateHash;
+    }
+
+    //Sets the gravity scale of the world
+    void PhysicsWorld::setGravityScale(float newScaleValue)
+    {
+        if (newScaleValue >= 0) //Ensure non-negative gravity scale
+        {
+            m_gravityScale = newScaleValue;
+        }
+    }
+
+    //Forgets trigger overlaps and pending events involving bodies sorted by id
+    void PhysicsWorld::forgetTriggerState(const std::vector<PhysicsBody*>& bodies)
+    {
+        auto isErased = [&bodies](const PhysicsBody* body)
+        {
+            return std::binary_search(bodies.begin(),
+                bodies.end(),
+                body,
+                [](const PhysicsBody* a, const PhysicsBody* b) { return a->getId() < b->getId(); });
+        };
+
+        //Forget trigger overlaps and pending events involving the bodies
+        m_triggerOverlaps.erase(std::remove_if(m_triggerOverlaps.begin(),
+                                    m_triggerOverlaps.end(),
+                                    [&](const BroadPhasePair& pair)
+                                    { return isErased(pair.bodyA) || isErased(pair.bodyB); }),
+            m_triggerOverlaps.end());
+
+        m_triggerEvents.erase(std::remove_if(m_triggerEvents.begin(),
+                                  m_triggerEvents.end(),
+                                  [&](const TriggerEvent& event)
+                                  { return isErased(event.trigger) || isErased(event.other); }),
+            m_triggerEvents.end());
+    }
+
+    //Deletes many bodies in one pass over the body list
+    void PhysicsWorld::eraseBodies(const std::vector<PhysicsBody*>& bodies)
+    {
+        if (bodies.empty())
+            return;
+
+        forgetTriggerState(bodies);
+
+        for (PhysicsBody* body : bodies)
+        {
+            m_broadPhase.removeBody(body);
+            m_regionIndex.removeBody(body);
+        }
+
+        //Both lists are in id order, so one walk finds every erased body while compacting the rest
+        size_t next = 0;
+        m_physicsBodies.erase(std::remove_if(m_physicsBodies.begin(),
+                                  m_physicsBodies.end(),
+                                  [&](const PhysicsBody* body)
+                                  {
+                                      if (next == bodies.size() || bodies[next] != body)
+                                          return false;
+
+                                      next++;
+                                      return true;
+                                  }),
+            m_physicsBodies.end());
+
+        next = 0;
+        m_movingBodies.erase(std::remove_if(m_movingBodies.begin(),
+                                 m_movingBodies.end(),
+                                 [&](const PhysicsBody* body)
+                                 {
+                                     while (next < bodies.size() && bodies[next]->getId() < body->getId())
+                                         next++;
+
+                                     return next < bodies.size() && bodies[next] == body;
+                                 }),
+            m_movingBodies.end());
+
+        for (PhysicsBody* body : bodies)
+            delete body;
+    }
+
+    //Deletes every body and forgets all pairs and trigger state
+    void PhysicsWorld::clearBodies()
+    {
+        m_broadPhase.clear();
+        m_regionIndex.clear();
+
+        //Static groups belong to whoever added them and stay in the world
+        for (StaticGroup* group : m_staticGroups)
+            m_broadPhase.attachGroup(group);
+
+        for (PhysicsBody* body : m_physicsBodies)
+        {
+            delete body;
+        }
+
+        m_physicsBodies.clear();
+        m_movingBodies.clear();
+        m_pairs.clear();
+        m_pairGroups.clear();
+        m_simplexCaches.clear();
+        m_triggerOverlaps.clear();
+        m_newTriggerOverlaps.clear();
+        m_triggerEvents.clear();
+    }
+
+    //Keeps only pairs whose tight AABBs overlap and orders them by body ids
+    void PhysicsWorld::makePairsDeterministic()
+    {
+        m_pairs.erase(std::remove_if(m_pairs.begin(),
+                          m_pairs.end(),
+                          [](const BroadPhasePair& pair)
+                          {
+                              return !CollisionDetection::checkAABBvsAABB(
+                                  pair.bodyA->getCollider()->getAABB(), pair.bodyB->getCollider()->getAABB());
+                          }),
+            m_pairs.end());
+
+        for (BroadPhasePair& pair : m_pairs)
+        {
+            if (pair.bodyA->getId() > pair.bodyB->getId())
+            {
+                std::swap(pair.bodyA, pair.bodyB);
+                std::swap(pair.proxyA, pair.proxyB);
+            }
+        }
+
+        std::sort(m_pairs.begin(),
+            m_pairs.end(),
+            [](const BroadPhasePair& a, const BroadPhasePair& b)
+            {
+                unsigned int idA = a.bodyA->getId();
+                unsigned int idB = b.bodyA->getId();
+
+                return idA != idB ? idA < idB : a.bodyB->getId() < b.bodyB->getId();
+            });
+    }
+
+    //Sorts pairs by the shapes of their colliders and finds the groups sharing a pair of shapes
+    void PhysicsWorld::groupPairsByShape()
+    {
+        const int KEY_COUNT = COLLIDER_SHAPE_COUNT * COLLIDER_SHAPE_COUNT;
+
+        auto pairKey = [](const BroadPhasePair& pair)
+        {
+            int shapeA = static_cast<int>(pair.bodyA->getCollider()->getShape());
+            int shapeB = static_cast<int>(pair.bodyB->getCollider()->getShape());
+
+            return shapeA * COLLIDER_SHAPE_COUNT + shapeB;
+        };
+
+        //Counting sort, the start of each key's group is the number of pairs with smaller keys
+        size_t starts[KEY_COUNT + 1] = {};
+        for (const BroadPhasePair& pair : m_pairs)
+            starts[pairKey(pair) + 1]++;
+
+        for (int key = 0; key < KEY_COUNT; key++)
+            starts[key + 1] += starts[key];
+
+        m_pairGroups.clear();
+        for (int key = 0; key < KEY_COUNT; key++)
+        {
+            if (starts[key] == starts[key + 1])
+                continue;
+
+            ColliderShape shapeA = static_cast<ColliderShape>(key / COLLIDER_SHAPE_COUNT);
+            ColliderShape shapeB = static_cast<ColliderShape>(key % COLLIDER_SHAPE_COUNT);
+            CollisionDetection::PairFunction function = CollisionDetection::findPairFunction(shapeA, shapeB);
+            m_pairGroups.push_back({starts[key], starts[key + 1], function});
+        }
+
+        m_groupedPairs.resize(m_pairs.size());
+        for (const BroadPhasePair& pair : m_pairs)
+            m_groupedPairs[starts[pairKey(pair)]++] = pair;
+
+        m_pairs.swap(m_groupedPairs);
+    }
+
+    //Writes the whole world state into a binary snapshot
+    void PhysicsWorld::writeSnapshot(std::vector<unsigned char>& buffer) const
+    {
+        Snapshot::Header header;
+        std::memset(&header, 0, sizeof(Snapshot::Header));
+
+        header.gravityScale = m_gravityScale;
+        header.boundaryWidth = m_boundary.getWidth();
+        header.boundaryHeight = m_boundary.getHeight();
+        header.boundaryType = static_cast<uint32_t>(m_boundary.getType());
+        header.processPhysics = m_processPhysics ? 1 : 0;
+        header.processCollisions = m_processCollisions ? 1 : 0;
+        header.rotationalPhysics = m_rotationalPhysics ? 1 : 0;
+        header.deterministic = m_deterministic ? 1 : 0;
+        header.nextBodyId = m_nextBodyId;
+        header.originX = m_originX;
+        header.originY = m_originY;
+
+        Snapshot::write(m_physicsBodies, header, buffer);
+    }
+
+    //Replaces the world state with a snapshot held in memory
+    bool PhysicsWorld::readSnapshot(const void* data, size_t size)
+    {
+        const Snapshot::Header* header = Snapshot::validate(data, size);
+        if (header == nullptr)
+            return false;
+
+        if (header->boundaryType > static_cast<uint32_t>(BoundaryType::None))
+            return false;
+
+        //Records and layers are read in place
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        const Snapshot::BodyRecord* records =
+            reinterpret_cast<const Snapshot::BodyRecord*>(bytes + header->bodiesOffset);
+        const uint32_t* layerTable = reinterpret_cast<const uint32_t*>(bytes + header->layersOffset);
+        const float* shapeTable = reinterpret_cast<const float*>(bytes + header->shapesOffset);
+
+        //Build every body before touching the world so a bad record leaves it unchanged
+        std::vector<PhysicsBody*> bodies;
+        bodies.reserve(header->bodyCount);
+        uint32_t previousId = 0;
+
+        for (uint32_t i = 0; i < header->bodyCount; i++)
+        {
+            //Lookups search the bodies by id, so ids must strictly increase and stay below the next id
+            PhysicsBody* body = nullptr;
+            if (records[i].id > previousId && records[i].id < header->nextBodyId)
+                body = Snapshot::createBody(records[i], layerTable, header->layerCount, shapeTable, header->shapeCount);
+
+            previousId = records[i].id;
+            if (body == nullptr)
+            {
+                for (PhysicsBody* createdBody : bodies)
+                    delete createdBody;
+
+                return false;
+            }
+
+            bodies.push_back(body);
+        }
+
+        clearBodies();
+
+        Vector2 boundaryDimensions = {header->boundaryWidth, header->boundaryHeight};
+        m_boundary.setDimensions(boundaryDimensions);
+        m_boundary.setType(static_cast<BoundaryType>(header->boundaryType));
+
+        m_gravityScale = header->gravityScale;
+        m_processPhysics = header->processPhysics != 0;
+        m_processCollisions = header->processCollisions != 0;
+        m_rotationalPhysics = header->rotationalPhysics != 0;
+        m_deterministic = header->deterministic != 0;
+        m_nextBodyId = header->nextBodyId;
+        m_originX = header->originX;
+        m_originY = header->originY;
+        m_stateHash = 0;
+
+        //Static groups stay attached, new bodies must not take their ids
+        for (const StaticGroup* group : m_staticGroups)
+        {
+            if (!group->getBodies().empty())
+                raiseNextBodyId(group->getBodies().back()->getId());
+        }
+
+        //Bodies are restored exactly as saved, so boundary placement is not enforced again
+        m_physicsBodies.swap(bodies);
+
+        for (PhysicsBody* body : m_physicsBodies)
+        {
+            if (body->getType() != BodyType::StaticBody)
+                m_movingBodies.push_back(body);
+        }
+
+        m_broadPhase.addBodies(m_physicsBodies);
+
+        return true;
+    }
+
+    //Saves the world state to a snapshot file
+    bool PhysicsWorld::saveSnapshot(const std::string& path) const
+    {
+        std::vector<unsigned char> buffer;
+        writeSnapshot(buffer);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+        return static_cast<bool>(file);
+    }
+
+    //Replaces the world state with a snapshot file
+    bool PhysicsWorld::loadSnapshot(const std::string& path)
+    {
+        Snapshot::MappedFile file(path);
+        if (!file.isOpen())
+            return false;
+
+        return readSnapshot(file.getData(), file.getSize());
+    }
+
+    //Sets the recorder that logs external mutations
+    void PhysicsWorld::setRecorder(WorldRecorder* recorder)
+    {
+        m_recorder = recorder;
+    }
+
+    //Enables or disables writing the render state after every update
+    void PhysicsWorld::setRenderStateExport(bool exportRenderState)
+    {
+        m_exportRenderState = exportRenderState;
+    }
+
+    //Enables or disables reading the render state from another thread
+    void PhysicsWorld::setRenderStateConcurrent(bool concurrent)
+    {
+        m_renderBuffer.setConcurrent(concurrent);
+    }
+
+    //Writes the transform and extents of every body into instances
+    void PhysicsWorld::writeRenderState(std::vector<RenderInstance>& instances) const
+    {
+        instances.resize(m_physicsBodies.size());
+        RenderInstance* instance = instances.data();
+
+        for (const PhysicsBody* body : m_physicsBodies)
+        {
+            const Collider* collider = body->getCollider();
+
+            instance->id = body->getId();
+            instance->shape = static_cast<uint16_t>(collider->getShape());
+            instance->bodyType = static_cast<uint16_t>(body->getType());
+            instance->positionX = body->getPosition().x;
+            instance->positionY = body->getPosition().y;
+            instance->rotation = body->getRotation();
+
+            if (collider->getShape() == ColliderShape::Rectangle)
+            {
+                const RectCollider* rect = static_cast<const RectCollider*>(collider);
+                instance->extentX = rect->getWidth() / 2;
+                instance->extentY = rect->getHeight() / 2;
+            }
+            else if (collider->getShape() == ColliderShape::Polygon)
+            {
+                float radius = static_cast<const PolygonCollider*>(collider)->getRadius();
+                instance->extentX = radius;
+                instance->extentY = radius;
+            }
+            else if (collider->getShape() == ColliderShape::Capsule)
+            {
+                const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+                instance->extentX = capsule->getRadius();
+                instance->extentY = capsule->getHeight() / 2;
+            }
+            else if (collider->getShape() == ColliderShape::Compound)
+            {
+                float radius = static_cast<const CompoundCollider*>(collider)->getRadius();
+                instance->extentX = radius;
+                instance->extentY = radius;
+            }
+            else if (collider->getShape() == ColliderShape::Chain)
+            {
+                float radius = static_cast<const ChainCollider*>(collider)->getRadius();
+                instance->extentX = radius;
+                instance->extentY = radius;
+            }
+            else if (collider->getShape() == ColliderShape::TileMap)
+            {
+                //The grid grows from its corner at the body position, so the instance is moved to the grid's center
+                const TileMapCollider* map = static_cast<const TileMapCollider*>(collider);
+                Vector2 half = {map->getColumns() * map->getTileSize() / 2, map->getRows() * map->getTileSize() / 2};
+                Vector2 center = body->getPosition() + map->toWorldDirection(half);
+                instance->positionX = center.x;
+                instance->positionY = center.y;
+                instance->extentX = half.x;
+                instance->extentY = half.y;
+            }
+            else
+            {
+                float radius = static_cast<const CircleCollider*>(collider)->getRadius();
+                instance->extentX = radius;
+                instance->extentY = radius;
+            }
+
+            instance++;
+        }
+    }
+
+    //Returns the render state published by the newest update
+    const std::vector<RenderInstance>& PhysicsWorld::acquireRenderState()
+    {
+        return m_renderBuffer.acquire();
+    }
+
+    //Returns the vector of physics bodies in the world
+    const std::vector<PhysicsBody*>& PhysicsWorld::getBodies() const
+    {
+        return m_physicsBodies;
+    }
+
+    //Returns the trigger enter and exit events generated by the last update
+    const std::vector<TriggerEvent>& PhysicsWorld::getTriggerEvents() const
+    {
+        return m_triggerEvents;
+    }
+
+    //Returns every pair currently overlapping where at least one collider is a trigger
+    const std::vector<BroadPhasePair>& PhysicsWorld::getTriggerOverlaps() const
+    {
+        return m_triggerOverlaps;
+    }
+
+    //Returns the broad phase of the world
+    const BroadPhase& PhysicsWorld::getBroadPhase() const
+    {
+        return m_broadPhase;
     }
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+//Implementation of the RegionIndex class
+
+#include "core/RegionIndex.hpp"
+#include "physics/PhysicsBody.hpp"
+#include <cmath>
+
+namespace phys
+{
+    //Constructor to set the side length of a region
+    RegionIndex::RegionIndex(float regionSize) : m_regionSize(regionSize) {}
+
+    //Packs region coordinates into a key
+    uint64_t RegionIndex::makeKey(int x, int y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    //Takes a body out of a region, dropping the region once it is empty
+    void RegionIndex::detach(const PhysicsBody* body, uint64_t key)
+    {
+        auto it = m_regions.find(key);
+        if (it == m_regions.end())
+            return;
+
+        std::vector<PhysicsBody*>& bodies = it->second.bodies;
+
+        for (size_t i = 0; i < bodies.size(); i++)
+        {
+            if (bodies[i] == body)
+            {
+                bodies[i] = bodies.back();
+                bodies.pop_back();
+                break;
+            }
+        }
+
+        if (bodies.empty())
+            m_regions.erase(it);
+    }
+
+    //Files every body under the region its center lies in
+    void RegionIndex::update(const std::vector<PhysicsBody*>& bodies)
+    {
+        for (PhysicsBody* body : bodies)
+        {
+            int x;
+            int y;
+            getRegionCoordinates(body->getPosition(), x, y);
+            uint64_t key = makeKey(x, y);
+
+            auto filed = m_bodyRegions.find(body);
+            if (filed != m_bodyRegions.end())
+            {
+                //Most bodies stay in their region from one update to the next
+                if (filed->second == key)
+                    continue;
+
+                detach(body, filed->second);
+                filed->second = key;
+            }
+            else
+            {
+                m_bodyRegions.emplace(body, key);
+            }
+
+            Region& region = m_regions[key];
+            region.x = x;
+            region.y = y;
+            region.bodies.push_back(body);
+        }
+    }
+
+    //Removes a body from the index
+    void RegionIndex::removeBody(const PhysicsBody* body)
+    {
+        auto filed = m_bodyRegions.find(body);
+        if (filed == m_bodyRegions.end())
+            return;
+
+        detach(body, filed->second);
+        m_bodyRegions.erase(filed);
+    }
+
+    //Removes every body and region
+    void RegionIndex::clear()
+    {
+        m_regions.clear();
+        m_bodyRegions.clear();
+    }
+
+    //Moves every region by whole regions
+    void RegionIndex::shift(int regionsX, int regionsY)
+    {
+        if (regionsX == 0 && regionsY == 0)
+            return;
+
+        std::unordered_map<uint64_t, Region> shifted;
+        shifted.reserve(m_regions.size());
+
+        for (auto& entry : m_regions)
+        {
+            Region& region = entry.second;
+            region.x -= regionsX;
+            region.y -= regionsY;
+
+            uint64_t key = makeKey(region.x, region.y);
+            for (const PhysicsBody* body : region.bodies)
+                m_bodyRegions[body] = key;
+
+            shifted.emplace(key, std::move(region));
+        }
+
+        m_regions.swap(shifted);
+    }
+
+    //Returns the coordinates of the region holding a point
+    void RegionIndex::getRegionCoordinates(const Vector2& point, int& x, int& y) const
+    {
+        x = static_cast<int>(std::floor(point.x / m_regionSize));
+        y = static_cast<int>(std::floor(point.y / m_regionSize));
+    }
+
+    //Returns the occupied region at the coordinates
+    const Region* RegionIndex::getRegion(int x, int y) const
+    {
+        auto it = m_regions.find(makeKey(x, y));
+        return it == m_regions.end() ? nullptr : &it->second;
+    }
+
+    //Fills regions with the occupied regions overlapping an area
+    int RegionIndex::queryRegions(const AABB& area, std::vector<const Region*>& regions) const
+    {
+        regions.clear();
+
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+        getRegionCoordinates(area.min, minX, minY);
+        getRegionCoordinates(area.max, maxX, maxY);
+
+        //Look up every cell of a small area, but scan the occupied regions when the area covers more cells than that
+        double cellCount = (static_cast<double>(maxX) - minX + 1) * (static_cast<double>(maxY) - minY + 1);
+
+        if (cellCount <= static_cast<double>(m_regions.size()))
+        {
+            for (int x = minX; x <= maxX; x++)
+            {
+                for (int y = minY; y <= maxY; y++)
+                {
+                    const Region* region = getRegion(x, y);
+                    if (region)
+                        regions.push_back(region);
+                }
+            }
+        }
+        else
+        {
+            for (const auto& entry : m_regions)
+            {
+                const Region& region = entry.second;
+                if (region.x >= minX && region.x <= maxX && region.y >= minY && region.y <= maxY)
+                    regions.push_back(&region);
+            }
+        }
+
+        return static_cast<int>(regions.size());
+    }
+
+    //Changes the side length of a region, clearing the index
+    void RegionIndex::setRegionSize(float regionSize)
+    {
+        m_regionSize = regionSize;
+        clear();
+    }
+
+    float RegionIndex::getRegionSize() const
+    {
+        return m_regionSize;
+    }
+
+    //Returns the number of occupied regions
+    size_t RegionIndex::getRegionCount() const
+    {
+        return m_regions.size();
+    }
+}
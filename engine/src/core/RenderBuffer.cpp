@@ -0,0 +1,62 @@
+//Implementation of the RenderBuffer class
+//Concurrent mode is a triple buffer: the writer and reader each own a slot and swap through a shared one,
+//so neither ever waits and the reader never sees a list that is being written
+
+#include "core/RenderBuffer.hpp"
+
+namespace phys
+{
+    //Constructor to create an empty, non concurrent buffer
+    RenderBuffer::RenderBuffer() : m_writeSlot(0), m_readSlot(0), m_sharedSlot(0), m_concurrent(false) {}
+
+    //Enables or disables concurrent reading
+    void RenderBuffer::setConcurrent(bool concurrent)
+    {
+        m_concurrent = concurrent;
+
+        for (std::vector<RenderInstance>& slot : m_slots)
+            slot.clear();
+
+        m_writeSlot = 0;
+        m_readSlot = concurrent ? 1 : 0;
+        m_sharedSlot.store(concurrent ? 2 : 0, std::memory_order_release);
+    }
+
+    bool RenderBuffer::isConcurrent() const
+    {
+        return m_concurrent;
+    }
+
+    //Returns the list to fill with the next instances
+    std::vector<RenderInstance>& RenderBuffer::getWriteSlot()
+    {
+        return m_slots[m_writeSlot];
+    }
+
+    //Makes the written instances available to the reader
+    void RenderBuffer::publish()
+    {
+        if (!m_concurrent)
+            return;
+
+        //Hand the written slot over and take back whichever slot was shared
+        int previous = m_sharedSlot.exchange(m_writeSlot | FRESH, std::memory_order_acq_rel);
+        m_writeSlot = previous & ~FRESH;
+    }
+
+    //Returns the newest published instances
+    const std::vector<RenderInstance>& RenderBuffer::acquire()
+    {
+        if (!m_concurrent)
+            return m_slots[0];
+
+        //Only swap when the writer published something new, otherwise keep reading the current slot
+        if (m_sharedSlot.load(std::memory_order_relaxed) & FRESH)
+        {
+            int previous = m_sharedSlot.exchange(m_readSlot, std::memory_order_acq_rel);
+            m_readSlot = previous & ~FRESH;
+        }
+
+        return m_slots[m_readSlot];
+    }
+}
@@ -0,0 +1,116 @@
+//Implementation of the shared replication helpers
+
+#include "core/Replication.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace phys
+{
+    namespace Replication
+    {
+        //Converts a value to a whole number of precision steps
+        int32_t quantize(float value, float precision)
+        {
+            //Clamped in double precision, the nearest float to the limit lies above it
+            const double LIMIT = MAX_QUANTIZED;
+            double steps = std::round(static_cast<double>(value / precision));
+
+            if (!(steps >= -LIMIT)) //Also catches NaN
+                steps = -LIMIT;
+            if (steps > LIMIT)
+                steps = LIMIT;
+
+            return static_cast<int32_t>(steps);
+        }
+
+        //Converts a whole number of precision steps back to a value
+        float dequantize(int32_t value, float precision)
+        {
+            return static_cast<float>(value) * precision;
+        }
+
+        //Returns the rotation wrapped into [-pi, pi)
+        float wrapAngle(float radians)
+        {
+            const float PI = 3.14159265358979f;
+            const float TWO_PI = 2.0f * PI;
+
+            float wrapped = std::fmod(radians + PI, TWO_PI);
+            if (wrapped < 0.0f)
+                wrapped += TWO_PI;
+
+            return wrapped - PI;
+        }
+
+        //Appends an unsigned varint
+        void writeVarint(std::vector<unsigned char>& buffer, uint32_t value)
+        {
+            while (value >= 0x80)
+            {
+                buffer.push_back(static_cast<unsigned char>(value | 0x80));
+                value >>= 7;
+            }
+
+            buffer.push_back(static_cast<unsigned char>(value));
+        }
+
+        //Appends a signed value zigzag encoded
+        void writeZigzag(std::vector<unsigned char>& buffer, int32_t value)
+        {
+            uint32_t bits = static_cast<uint32_t>(value);
+            writeVarint(buffer, (bits << 1) ^ (value < 0 ? 0xFFFFFFFFu : 0u));
+        }
+
+        //Appends the raw bytes of a float
+        void writeFloat(std::vector<unsigned char>& buffer, float value)
+        {
+            unsigned char bytes[sizeof(float)];
+            std::memcpy(bytes, &value, sizeof(float));
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(float));
+        }
+
+        //Reads an unsigned varint
+        bool readVarint(const unsigned char* data, int size, int& cursor, uint32_t& value)
+        {
+            value = 0;
+
+            //A 32 bit value takes at most 5 bytes
+            for (int shift = 0; shift < 35; shift += 7)
+            {
+                if (cursor >= size)
+                    return false;
+
+                unsigned char byte = data[cursor++];
+                value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+
+                if (!(byte & 0x80))
+                    return true;
+            }
+
+            return false;
+        }
+
+        //Reads a zigzag encoded signed value
+        bool readZigzag(const unsigned char* data, int size, int& cursor, int32_t& value)
+        {
+            uint32_t bits;
+            if (!readVarint(data, size, cursor, bits))
+                return false;
+
+            value = static_cast<int32_t>((bits >> 1) ^ (~(bits & 1) + 1));
+            return true;
+        }
+
+        //Reads the raw bytes of a float
+        bool readFloat(const unsigned char* data, int size, int& cursor, float& value)
+        {
+            if (size - cursor < static_cast<int>(sizeof(float)))
+                return false;
+
+            std::memcpy(&value, data + cursor, sizeof(float));
+            cursor += sizeof(float);
+
+            return true;
+        }
+    }
+}
@@ -0,0 +1,156 @@
+//Implementation of the ReplicationDecoder class
+
+#include "core/ReplicationDecoder.hpp"
+
+namespace phys
+{
+    //Constructor to set the precision of replicated values
+    ReplicationDecoder::ReplicationDecoder(const ReplicationSettings& settings) : m_settings(settings) {}
+
+    //Applies a packet on top of the state it was encoded against
+    bool ReplicationDecoder::decode(const unsigned char* data, int size)
+    {
+        int cursor = 0;
+        uint32_t sequence;
+        uint32_t baselineSequence;
+        uint32_t entryCount;
+
+        if (!Replication::readVarint(data, size, cursor, sequence) ||
+            !Replication::readVarint(data, size, cursor, baselineSequence) ||
+            !Replication::readVarint(data, size, cursor, entryCount))
+            return false;
+
+        //Packets arriving after a newer one carry nothing new
+        if (sequence <= getSequence())
+            return false;
+
+        static const std::vector<Replication::QuantizedBody> EMPTY_STATE;
+        const std::vector<Replication::QuantizedBody>* baseline = baselineSequence == 0 ? &EMPTY_STATE : nullptr;
+
+        for (const Replication::QuantizedState& state : m_history)
+        {
+            if (state.sequence == baselineSequence)
+                baseline = &state.bodies;
+        }
+
+        if (!baseline)
+            return false;
+
+        //Merge the id sorted entries into a copy of the baseline
+        Replication::QuantizedState next;
+        next.sequence = sequence;
+        next.bodies.reserve(baseline->size() + entryCount);
+
+        size_t baselineIndex = 0;
+        unsigned int id = 0;
+
+        for (uint32_t entry = 0; entry < entryCount; entry++)
+        {
+            uint32_t idDelta;
+            if (!Replication::readVarint(data, size, cursor, idDelta) || cursor >= size)
+                return false;
+
+            //Ids must strictly increase after the first entry
+            if (entry > 0 && idDelta == 0)
+                return false;
+
+            id += idDelta;
+            uint8_t mask = data[cursor++];
+
+            //Bodies before this entry did not change
+            while (baselineIndex < baseline->size() && (*baseline)[baselineIndex].id < id)
+                next.bodies.push_back((*baseline)[baselineIndex++]);
+
+            bool inBaseline = baselineIndex < baseline->size() && (*baseline)[baselineIndex].id == id;
+
+            if (mask & Replication::REMOVED)
+            {
+                if (!inBaseline)
+                    return false;
+
+                baselineIndex++;
+                continue;
+            }
+
+            //New bodies start from zero and must carry their shape
+            Replication::QuantizedBody body = {};
+            if (inBaseline)
+                body = (*baseline)[baselineIndex++];
+            else if (!(mask & Replication::SHAPE))
+                return false;
+
+            body.id = id;
+
+            if (mask & Replication::SHAPE)
+            {
+                if (cursor >= size)
+                    return false;
+
+                body.shape = data[cursor++];
+                if (!Replication::readFloat(data, size, cursor, body.extentX) ||
+                    !Replication::readFloat(data, size, cursor, body.extentY))
+                    return false;
+            }
+
+            for (int value = 0; value < Replication::VALUE_COUNT; value++)
+            {
+                if (!(mask & (1 << value)))
+                    continue;
+
+                int32_t delta;
+                if (!Replication::readZigzag(data, size, cursor, delta))
+                    return false;
+
+                //The encoder never leaves the quantized range, a packet that does is corrupt
+                int64_t sum = static_cast<int64_t>(body.values[value]) + delta;
+                if (sum < -Replication::MAX_QUANTIZED || sum > Replication::MAX_QUANTIZED)
+                    return false;
+
+                body.values[value] = static_cast<int32_t>(sum);
+            }
+
+            next.bodies.push_back(body);
+        }
+
+        while (baselineIndex < baseline->size())
+            next.bodies.push_back((*baseline)[baselineIndex++]);
+
+        //Publish the dequantized state
+        m_bodies.resize(next.bodies.size());
+
+        for (size_t i = 0; i < next.bodies.size(); i++)
+        {
+            const Replication::QuantizedBody& body = next.bodies[i];
+            ReplicatedBody& replicated = m_bodies[i];
+
+            replicated.id = body.id;
+            replicated.shape = static_cast<ColliderShape>(body.shape);
+            replicated.extents = {body.extentX, body.extentY};
+            replicated.position = {Replication::dequantize(body.values[0], m_settings.positionPrecision),
+                Replication::dequantize(body.values[1], m_settings.positionPrecision)};
+            replicated.rotation = Replication::dequantize(body.values[2], m_settings.rotationPrecision);
+            replicated.velocity = {Replication::dequantize(body.values[3], m_settings.velocityPrecision),
+                Replication::dequantize(body.values[4], m_settings.velocityPrecision)};
+            replicated.angularVelocity = Replication::dequantize(body.values[5], m_settings.velocityPrecision);
+        }
+
+        m_history.push_back(std::move(next));
+
+        while (static_cast<int>(m_history.size()) > m_settings.historySize)
+            m_history.pop_front();
+
+        return true;
+    }
+
+    //Returns the sequence of the newest decoded packet
+    uint32_t ReplicationDecoder::getSequence() const
+    {
+        return m_history.empty() ? 0 : m_history.back().sequence;
+    }
+
+    //Returns the bodies of the newest decoded state
+    const std::vector<ReplicatedBody>& ReplicationDecoder::getBodies() const
+    {
+        return m_bodies;
+    }
+}
@@ -0,0 +1,234 @@
+//Implementation of the ReplicationEncoder class
+
+#include "core/ReplicationEncoder.hpp"
+#include "core/PhysicsWorld.hpp"
+#include <cstring>
+
+namespace phys
+{
+    //Constructor to set the precision of replicated values
+    ReplicationEncoder::ReplicationEncoder(const ReplicationSettings& settings) :
+        m_settings(settings), m_sequence(0), m_acknowledged(0)
+    {
+    }
+
+    //Quantizes every body in the world, in id order
+    void ReplicationEncoder::captureState(
+        const PhysicsWorld& world, std::vector<Replication::QuantizedBody>& bodies) const
+    {
+        const std::vector<PhysicsBody*>& worldBodies = world.getBodies();
+        bodies.resize(worldBodies.size());
+
+        for (size_t i = 0; i < worldBodies.size(); i++)
+        {
+            const PhysicsBody* body = worldBodies[i];
+            const Collider* collider = body->getCollider();
+            Replication::QuantizedBody& quantized = bodies[i];
+
+            quantized.id = body->getId();
+            quantized.shape = static_cast<uint8_t>(collider->getShape());
+
+            if (collider->getShape() == ColliderShape::Rectangle)
+            {
+                const RectCollider* rect = static_cast<const RectCollider*>(collider);
+                quantized.extentX = rect->getWidth();
+                quantized.extentY = rect->getHeight();
+            }
+            else if (collider->getShape() == ColliderShape::Polygon)
+            {
+                quantized.extentX = static_cast<const PolygonCollider*>(collider)->getRadius();
+                quantized.extentY = 0.0f;
+            }
+            else if (collider->getShape() == ColliderShape::Capsule)
+            {
+                const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+                quantized.extentX = capsule->getRadius();
+                quantized.extentY = capsule->getHeight();
+            }
+            else if (collider->getShape() == ColliderShape::Compound)
+            {
+                quantized.extentX = static_cast<const CompoundCollider*>(collider)->getRadius();
+                quantized.extentY = 0.0f;
+            }
+            else if (collider->getShape() == ColliderShape::Chain)
+            {
+                quantized.extentX = static_cast<const ChainCollider*>(collider)->getRadius();
+                quantized.extentY = 0.0f;
+            }
+            else if (collider->getShape() == ColliderShape::TileMap)
+            {
+                const TileMapCollider* map = static_cast<const TileMapCollider*>(collider);
+                quantized.extentX = map->getColumns() * map->getTileSize();
+                quantized.extentY = map->getRows() * map->getTileSize();
+            }
+            else
+            {
+                quantized.extentX = static_cast<const CircleCollider*>(collider)->getRadius();
+                quantized.extentY = 0.0f;
+            }
+
+            Vector2 velocity;
+            float angularVelocity = 0.0f;
+
+            if (body->getType() == BodyType::DynamicBody)
+            {
+                const DynamicBody* dynamicBody = static_cast<const DynamicBody*>(body);
+                velocity = dynamicBody->getVelocity();
+                angularVelocity = dynamicBody->getAngularVelocity();
+            }
+
+            quantized.values[0] = Replication::quantize(body->getPosition().x, m_settings.positionPrecision);
+            quantized.values[1] = Replication::quantize(body->getPosition().y, m_settings.positionPrecision);
+            quantized.values[2] =
+                Replication::quantize(Replication::wrapAngle(body->getRotation()), m_settings.rotationPrecision);
+            quantized.values[3] = Replication::quantize(velocity.x, m_settings.velocityPrecision);
+            quantized.values[4] = Replication::quantize(velocity.y, m_settings.velocityPrecision);
+            quantized.values[5] = Replication::quantize(angularVelocity, m_settings.velocityPrecision);
+        }
+    }
+
+    //Writes a packet with the world's changes since the acknowledged state
+    int ReplicationEncoder::encode(const PhysicsWorld& world, unsigned char* buffer, int capacity)
+    {
+        Replication::QuantizedState current;
+        current.sequence = m_sequence + 1;
+        captureState(world, current.bodies);
+
+        //Encode against the acknowledged state, or everything if the receiver has nothing yet
+        const std::vector<Replication::QuantizedBody>* baseline = nullptr;
+        for (const Replication::QuantizedState& state : m_history)
+        {
+            if (state.sequence == m_acknowledged)
+                baseline = &state.bodies;
+        }
+
+        static const std::vector<Replication::QuantizedBody> EMPTY_STATE;
+        if (!baseline)
+            baseline = &EMPTY_STATE;
+
+        //Walk both id sorted lists together, writing changed, new and removed bodies
+        m_entries.clear();
+        uint32_t entryCount = 0;
+        unsigned int previousId = 0;
+        size_t currentIndex = 0;
+        size_t baselineIndex = 0;
+
+        while (currentIndex < current.bodies.size() || baselineIndex < baseline->size())
+        {
+            const Replication::QuantizedBody* now =
+                currentIndex < current.bodies.size() ? &current.bodies[currentIndex] : nullptr;
+            const Replication::QuantizedBody* before =
+                baselineIndex < baseline->size() ? &(*baseline)[baselineIndex] : nullptr;
+
+            uint8_t mask = 0;
+            unsigned int id;
+
+            if (now && (!before || now->id < before->id))
+            {
+                //New body, send every value against zero
+                before = nullptr;
+                id = now->id;
+                mask = Replication::SHAPE;
+                currentIndex++;
+            }
+            else if (!now || before->id < now->id)
+            {
+                id = before->id;
+                mask = Replication::REMOVED;
+                now = nullptr;
+                baselineIndex++;
+            }
+            else
+            {
+                id = now->id;
+                if (now->shape != before->shape || now->extentX != before->extentX || now->extentY != before->extentY)
+                    mask = Replication::SHAPE;
+
+                currentIndex++;
+                baselineIndex++;
+            }
+
+            if (now)
+            {
+                for (int value = 0; value < Replication::VALUE_COUNT; value++)
+                {
+                    int32_t previous = before ? before->values[value] : 0;
+                    if (now->values[value] != previous)
+                        mask |= 1 << value;
+                }
+            }
+
+            //Body did not change beyond the precision, nothing to send
+            if (mask == 0)
+                continue;
+
+            Replication::writeVarint(m_entries, id - previousId);
+            m_entries.push_back(mask);
+            previousId = id;
+            entryCount++;
+
+            if (mask & Replication::SHAPE)
+            {
+                m_entries.push_back(now->shape);
+                Replication::writeFloat(m_entries, now->extentX);
+                Replication::writeFloat(m_entries, now->extentY);
+            }
+
+            for (int value = 0; value < Replication::VALUE_COUNT; value++)
+            {
+                if (mask & (1 << value))
+                {
+                    int32_t previous = before ? before->values[value] : 0;
+                    Replication::writeZigzag(m_entries, now->values[value] - previous);
+                }
+            }
+        }
+
+        //Header: sequence, baseline sequence, entry count
+        m_packet.clear();
+        Replication::writeVarint(m_packet, current.sequence);
+        Replication::writeVarint(m_packet, baseline == &EMPTY_STATE ? 0 : m_acknowledged);
+        Replication::writeVarint(m_packet, entryCount);
+        m_packet.insert(m_packet.end(), m_entries.begin(), m_entries.end());
+
+        if (static_cast<int>(m_packet.size()) > capacity)
+            return -1;
+
+        std::memcpy(buffer, m_packet.data(), m_packet.size());
+
+        //Keep the state so it can become the baseline once acknowledged
+        m_sequence = current.sequence;
+        m_history.push_back(std::move(current));
+
+        while (static_cast<int>(m_history.size()) > m_settings.historySize)
+            m_history.pop_front();
+
+        return static_cast<int>(m_packet.size());
+    }
+
+    //Marks a packet as received
+    void ReplicationEncoder::acknowledge(uint32_t sequence)
+    {
+        //Late acknowledgements of older packets are ignored
+        if (sequence <= m_acknowledged || sequence > m_sequence)
+            return;
+
+        m_acknowledged = sequence;
+
+        //States older than the acknowledged one can never become a baseline again
+        while (!m_history.empty() && m_history.front().sequence < sequence)
+            m_history.pop_front();
+    }
+
+    //Returns the sequence of the last packet written
+    uint32_t ReplicationEncoder::getSequence() const
+    {
+        return m_sequence;
+    }
+
+    //Returns the sequence of the newest acknowledged packet
+    uint32_t ReplicationEncoder::getAcknowledged() const
+    {
+        return m_acknowledged;
+    }
+}
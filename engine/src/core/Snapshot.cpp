@@ -0,0 +1,577 @@
+//Implementation of the binary snapshot format
+
+#include "core/Snapshot.hpp"
+#include "physics/StaticBody.hpp"
+#include "physics/DynamicBody.hpp"
+#include "collisions/RectCollider.hpp"
+#include "collisions/CircleCollider.hpp"
+#include "collisions/PolygonCollider.hpp"
+#include "collisions/CapsuleCollider.hpp"
+#include "collisions/CompoundCollider.hpp"
+#include "collisions/ChainCollider.hpp"
+#include "collisions/TileMapCollider.hpp"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_USE_MMAP
+#endif
+
+namespace phys
+{
+    namespace Snapshot
+    {
+        static_assert(std::numeric_limits<float>::is_iec559, "Snapshots store IEEE 754 floats");
+
+        //Returns true if the host is little endian
+        bool isHostLittleEndian()
+        {
+            const uint32_t value = 1;
+            unsigned char firstByte;
+            std::memcpy(&firstByte, &value, 1);
+
+            return firstByte == 1;
+        }
+
+        //Floats before the points of each compound child, the shape, offset x and y, rotation, dimensions x and y,
+        //and the point float count
+        static const uint32_t CHILD_HEADER_FLOATS = 7;
+
+        //Tiles of a tile map packed into each float of the shape table, a float holds every 16 bit integer exactly
+        static const int TILES_PER_FLOAT = 16;
+
+        //Appends a compound child to the shape table
+        static void writeChild(const CompoundCollider* compound, int index, std::vector<float>& shapeTable)
+        {
+            const Collider* child = compound->getChild(index);
+            float dimensionX = 0.0f;
+            float dimensionY = 0.0f;
+            int pointCount = 0;
+            const Vector2* points = nullptr;
+
+            if (child->getShape() == ColliderShape::Rectangle)
+            {
+                const RectCollider* rect = static_cast<const RectCollider*>(child);
+                dimensionX = rect->getWidth();
+                dimensionY = rect->getHeight();
+            }
+            else if (child->getShape() == ColliderShape::Circle)
+            {
+                dimensionX = static_cast<const CircleCollider*>(child)->getRadius();
+            }
+            else if (child->getShape() == ColliderShape::Capsule)
+            {
+                const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(child);
+                dimensionX = capsule->getRadius();
+                dimensionY = capsule->getHeight();
+            }
+            else if (child->getShape() == ColliderShape::Polygon)
+            {
+                const PolygonCollider* polygon = static_cast<const PolygonCollider*>(child);
+                pointCount = polygon->getVertexCount();
+                points = polygon->getPoints();
+            }
+
+            shapeTable.push_back(static_cast<float>(child->getShape()));
+            shapeTable.push_back(compound->getChildOffset(index).x);
+            shapeTable.push_back(compound->getChildOffset(index).y);
+            shapeTable.push_back(compound->getChildRotation(index));
+            shapeTable.push_back(dimensionX);
+            shapeTable.push_back(dimensionY);
+            shapeTable.push_back(static_cast<float>(pointCount * 2));
+
+            for (int i = 0; i < pointCount; i++)
+            {
+                shapeTable.push_back(points[i].x);
+                shapeTable.push_back(points[i].y);
+            }
+        }
+
+        //Allocates a compound from its floats in the shape table
+        //Returns null if a child runs past the floats or holds an unknown or compound shape
+        static Collider* createCompound(const float* data, uint32_t count, ColliderType colliderType)
+        {
+            //Each child takes at least its header, which also rules out counts that do not fit an integer
+            if (count == 0 || !(data[0] >= 0.0f && data[0] <= count / CHILD_HEADER_FLOATS))
+                return nullptr;
+
+            CompoundCollider* compound = new CompoundCollider(colliderType);
+            uint32_t childCount = static_cast<uint32_t>(data[0]);
+            uint32_t index = 1;
+
+            for (uint32_t i = 0; i < childCount; i++)
+            {
+                if (index + CHILD_HEADER_FLOATS > count)
+                    break;
+
+                const float* header = data + index;
+                float pointFloats = header[6];
+                index += CHILD_HEADER_FLOATS;
+
+                if (!(pointFloats >= 0.0f && pointFloats <= PolygonCollider::MAX_VERTICES * 2) ||
+                    index + static_cast<uint32_t>(pointFloats) > count)
+                    break;
+
+                uint32_t pointFloatCount = static_cast<uint32_t>(pointFloats);
+                const float* points = data + index;
+                index += pointFloatCount;
+
+                Collider* child = nullptr;
+
+                if (header[0] == static_cast<float>(ColliderShape::Rectangle))
+                    child = new RectCollider({header[4], header[5]}, colliderType);
+                else if (header[0] == static_cast<float>(ColliderShape::Circle))
+                    child = new CircleCollider(header[4], colliderType);
+                else if (header[0] == static_cast<float>(ColliderShape::Capsule))
+                    child = new CapsuleCollider(header[4], header[5], colliderType);
+                else if (header[0] == static_cast<float>(ColliderShape::Polygon) && pointFloatCount >= 6)
+                {
+                    std::vector<Vector2> polygonPoints(pointFloatCount / 2);
+                    for (size_t j = 0; j < polygonPoints.size(); j++)
+                        polygonPoints[j] = {points[j * 2], points[j * 2 + 1]};
+
+                    child = new PolygonCollider(polygonPoints, colliderType);
+                }
+                else
+                    break;
+
+                compound->addChild(child, {header[1], header[2]}, header[3]);
+            }
+
+            //Every child must have been read, with no floats left over
+            if (compound->getChildCount() != static_cast<int>(childCount) || index != count)
+            {
+                delete compound;
+                return nullptr;
+            }
+
+            return compound;
+        }
+
+        //Allocates a tile map from its record and its floats in the shape table
+        //Returns null if the grid size is not whole, or the floats do not hold exactly its tiles
+        static Collider* createTileMap(const BodyRecord& record, const float* data, ColliderType colliderType)
+        {
+            const float MAX_TILES_PER_SIDE = 16777216.0f;
+            float columns = record.dimensionX;
+            float rows = record.dimensionY;
+
+            if (!(columns >= 1.0f && columns <= MAX_TILES_PER_SIDE && columns == std::floor(columns)) ||
+                !(rows >= 1.0f && rows <= MAX_TILES_PER_SIDE && rows == std::floor(rows)))
+                return nullptr;
+
+            //The tile size and merge flag, then the tiles
+            uint64_t tileCount = static_cast<uint64_t>(columns) * static_cast<uint64_t>(rows);
+            if (record.shapeCount != 2 + (tileCount + TILES_PER_FLOAT - 1) / TILES_PER_FLOAT || !(data[0] > 0.0f))
+                return nullptr;
+
+            std::vector<bool> tiles(tileCount);
+            for (uint64_t first = 0; first < tileCount; first += TILES_PER_FLOAT)
+            {
+                float packed = data[2 + first / TILES_PER_FLOAT];
+                if (!(packed >= 0.0f && packed <= 65535.0f))
+                    return nullptr;
+
+                uint32_t bits = static_cast<uint32_t>(packed);
+                for (uint64_t tile = first; tile < tileCount && tile < first + TILES_PER_FLOAT; tile++)
+                    tiles[tile] = (bits >> (tile - first)) & 1;
+            }
+
+            TileMapCollider* map = new TileMapCollider(
+                static_cast<int>(columns), static_cast<int>(rows), data[0], data[1] != 0.0f, colliderType);
+            map->setTiles(tiles);
+
+            return map;
+        }
+
+        //Fills a record from a body, appending its layers, masks and shape to the tables
+        void writeBody(const PhysicsBody* body,
+            BodyRecord& record,
+            std::vector<uint32_t>& layerTable,
+            std::vector<float>& shapeTable)
+        {
+            const Collider* collider = body->getCollider();
+
+            //Zero the whole record so unused fields and padding are deterministic
+            std::memset(&record, 0, sizeof(BodyRecord));
+
+            record.bodyType = static_cast<uint8_t>(body->getType());
+            record.colliderShape = static_cast<uint8_t>(collider->getShape());
+            record.colliderType = static_cast<uint8_t>(collider->getType());
+            record.id = body->getId();
+
+            record.positionX = body->getPosition().x;
+            record.positionY = body->getPosition().y;
+            record.rotation = body->getRotation();
+
+            if (body->getType() == BodyType::DynamicBody)
+            {
+                const DynamicBody* dynamicBody = static_cast<const DynamicBody*>(body);
+
+                record.affectedByGravity = dynamicBody->isAffectedByGravity() ? 1 : 0;
+                record.velocityX = dynamicBody->getVelocity().x;
+                record.velocityY = dynamicBody->getVelocity().y;
+                record.angularVelocity = dynamicBody->getAngularVelocity();
+                record.forceX = dynamicBody->getForce().x;
+                record.forceY = dynamicBody->getForce().y;
+                record.accelerationX = dynamicBody->getAcceleration().x;
+                record.accelerationY = dynamicBody->getAcceleration().y;
+                record.restitution = dynamicBody->getRestitution();
+                record.mass = dynamicBody->getMass();
+            }
+
+            if (collider->getShape() == ColliderShape::Rectangle)
+            {
+                const RectCollider* rect = static_cast<const RectCollider*>(collider);
+                record.dimensionX = rect->getWidth();
+                record.dimensionY = rect->getHeight();
+            }
+            else if (collider->getShape() == ColliderShape::Circle)
+            {
+                record.dimensionX = static_cast<const CircleCollider*>(collider)->getRadius();
+            }
+            else if (collider->getShape() == ColliderShape::Capsule)
+            {
+                const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+                record.dimensionX = capsule->getRadius();
+                record.dimensionY = capsule->getHeight();
+            }
+            else if (collider->getShape() == ColliderShape::Polygon)
+            {
+                //The hull as given, so the recreated polygon is centered exactly as this one
+                const PolygonCollider* polygon = static_cast<const PolygonCollider*>(collider);
+
+                record.shapeIndex = static_cast<uint32_t>(shapeTable.size());
+                record.shapeCount = static_cast<uint32_t>(polygon->getVertexCount() * 2);
+
+                for (int i = 0; i < polygon->getVertexCount(); i++)
+                {
+                    shapeTable.push_back(polygon->getPoints()[i].x);
+                    shapeTable.push_back(polygon->getPoints()[i].y);
+                }
+            }
+            else if (collider->getShape() == ColliderShape::Compound)
+            {
+                //The children as given, so the recreated compound is centered exactly as this one
+                const CompoundCollider* compound = static_cast<const CompoundCollider*>(collider);
+
+                record.shapeIndex = static_cast<uint32_t>(shapeTable.size());
+                shapeTable.push_back(static_cast<float>(compound->getChildCount()));
+
+                for (int i = 0; i < compound->getChildCount(); i++)
+                    writeChild(compound, i, shapeTable);
+
+                record.shapeCount = static_cast<uint32_t>(shapeTable.size()) - record.shapeIndex;
+            }
+            else if (collider->getShape() == ColliderShape::Chain)
+            {
+                const ChainCollider* chain = static_cast<const ChainCollider*>(collider);
+
+                record.dimensionX = chain->isLoop() ? 1.0f : 0.0f;
+                record.shapeIndex = static_cast<uint32_t>(shapeTable.size());
+                record.shapeCount = static_cast<uint32_t>(chain->getPointCount() * 2);
+
+                for (const Vector2& point : chain->getPoints())
+                {
+                    shapeTable.push_back(point.x);
+                    shapeTable.push_back(point.y);
+                }
+            }
+            else if (collider->getShape() == ColliderShape::TileMap)
+            {
+                const TileMapCollider* map = static_cast<const TileMapCollider*>(collider);
+
+                record.dimensionX = static_cast<float>(map->getColumns());
+                record.dimensionY = static_cast<float>(map->getRows());
+                record.shapeIndex = static_cast<uint32_t>(shapeTable.size());
+
+                shapeTable.push_back(map->getTileSize());
+                shapeTable.push_back(map->isMerged() ? 1.0f : 0.0f);
+
+                uint32_t bits = 0;
+                int bitCount = 0;
+
+                for (int row = 0; row < map->getRows(); row++)
+                {
+                    for (int column = 0; column < map->getColumns(); column++)
+                    {
+                        bits |= static_cast<uint32_t>(map->isSolid(column, row)) << bitCount;
+                        if (++bitCount == TILES_PER_FLOAT)
+                        {
+                            shapeTable.push_back(static_cast<float>(bits));
+                            bits = 0;
+                            bitCount = 0;
+                        }
+                    }
+                }
+
+                if (bitCount > 0)
+                    shapeTable.push_back(static_cast<float>(bits));
+
+                record.shapeCount = static_cast<uint32_t>(shapeTable.size()) - record.shapeIndex;
+            }
+
+            record.offsetX = collider->getOffset().x;
+            record.offsetY = collider->getOffset().y;
+
+            //Layers then masks, stored next to each other in the shared table
+            const std::vector<unsigned int>& layers = collider->getCollisionLayers();
+            const std::vector<unsigned int>& masks = collider->getCollisionMasks();
+
+            record.layersIndex = static_cast<uint32_t>(layerTable.size());
+            record.layerCount = static_cast<uint16_t>(layers.size());
+            record.maskCount = static_cast<uint16_t>(masks.size());
+
+            layerTable.insert(layerTable.end(), layers.begin(), layers.end());
+            layerTable.insert(layerTable.end(), masks.begin(), masks.end());
+        }
+
+        //Allocates a body from a record
+        PhysicsBody* createBody(const BodyRecord& record,
+            const uint32_t* layerTable,
+            uint32_t layerTableSize,
+            const float* shapeTable,
+            uint32_t shapeTableSize)
+        {
+            //Layers and shape data must lie inside their tables
+            uint64_t layersEnd = static_cast<uint64_t>(record.layersIndex) + record.layerCount + record.maskCount;
+            uint64_t shapeEnd = static_cast<uint64_t>(record.shapeIndex) + record.shapeCount;
+            if (layersEnd > layerTableSize || shapeEnd > shapeTableSize)
+                return nullptr;
+
+            ColliderType colliderType =
+                record.colliderType == static_cast<uint8_t>(ColliderType::Trigger) ? ColliderType::Trigger
+                                                                                   : ColliderType::Solid;
+
+            Collider* collider = nullptr;
+
+            if (record.colliderShape == static_cast<uint8_t>(ColliderShape::Rectangle))
+                collider = new RectCollider({record.dimensionX, record.dimensionY}, colliderType);
+            else if (record.colliderShape == static_cast<uint8_t>(ColliderShape::Circle))
+                collider = new CircleCollider(record.dimensionX, colliderType);
+            else if (record.colliderShape == static_cast<uint8_t>(ColliderShape::Capsule))
+                collider = new CapsuleCollider(record.dimensionX, record.dimensionY, colliderType);
+            else if (record.colliderShape == static_cast<uint8_t>(ColliderShape::Polygon) &&
+                     record.shapeCount >= 6 && record.shapeCount <= PolygonCollider::MAX_VERTICES * 2)
+            {
+                std::vector<Vector2> points(record.shapeCount / 2);
+                for (size_t i = 0; i < points.size(); i++)
+                    points[i] = {shapeTable[record.shapeIndex + i * 2], shapeTable[record.shapeIndex + i * 2 + 1]};
+
+                collider = new PolygonCollider(points, colliderType);
+            }
+            else if (record.colliderShape == static_cast<uint8_t>(ColliderShape::Compound))
+                collider = createCompound(shapeTable + record.shapeIndex, record.shapeCount, colliderType);
+            else if (record.colliderShape == static_cast<uint8_t>(ColliderShape::Chain) && record.shapeCount >= 4 &&
+                     record.shapeCount % 2 == 0)
+            {
+                std::vector<Vector2> points(record.shapeCount / 2);
+                for (size_t i = 0; i < points.size(); i++)
+                    points[i] = {shapeTable[record.shapeIndex + i * 2], shapeTable[record.shapeIndex + i * 2 + 1]};
+
+                ChainCollider* chain = new ChainCollider(points, record.dimensionX != 0.0f, colliderType);
+                if (chain->getSegmentCount() == 0)
+                {
+                    delete chain;
+                    return nullptr;
+                }
+
+                collider = chain;
+            }
+            else if (record.colliderShape == static_cast<uint8_t>(ColliderShape::TileMap))
+                collider = createTileMap(record, shapeTable + record.shapeIndex, colliderType);
+
+            if (!collider)
+                return nullptr;
+
+            //Offset must be set before the body positions the collider
+            collider->setOffset({record.offsetX, record.offsetY});
+
+            const uint32_t* layers = layerTable + record.layersIndex;
+            collider->setCollisionLayers(std::vector<unsigned int>(layers, layers + record.layerCount));
+            collider->setCollisionMasks(
+                std::vector<unsigned int>(layers + record.layerCount, layers + record.layerCount + record.maskCount));
+
+            Vector2 position = {record.positionX, record.positionY};
+            PhysicsBody* body = nullptr;
+
+            if (record.bodyType == static_cast<uint8_t>(BodyType::StaticBody))
+            {
+                body = new StaticBody(position, collider);
+            }
+            else if (record.bodyType == static_cast<uint8_t>(BodyType::DynamicBody))
+            {
+                DynamicBody* dynamicBody = new DynamicBody(position, collider);
+
+                dynamicBody->setAffectedByGravity(record.affectedByGravity != 0);
+                dynamicBody->setVelocity({record.velocityX, record.velocityY});
+                dynamicBody->setAngularVelocity(record.angularVelocity);
+                dynamicBody->setForce({record.forceX, record.forceY});
+                dynamicBody->setAcceleration({record.accelerationX, record.accelerationY});
+                dynamicBody->setRestitution(record.restitution);
+                dynamicBody->setMass(record.mass);
+
+                body = dynamicBody;
+            }
+            else
+            {
+                delete collider;
+                return nullptr;
+            }
+
+            body->setId(record.id);
+            body->setRotation(record.rotation);
+
+            return body;
+        }
+
+        //Writes bodies into a snapshot
+        void write(const std::vector<PhysicsBody*>& bodies, Header& header, std::vector<unsigned char>& buffer)
+        {
+            //Flatten every body first so the table sizes are known
+            std::vector<BodyRecord> records(bodies.size());
+            std::vector<uint32_t> layerTable;
+            std::vector<float> shapeTable;
+
+            for (size_t i = 0; i < bodies.size(); i++)
+                writeBody(bodies[i], records[i], layerTable, shapeTable);
+
+            header.magic = MAGIC;
+            header.version = VERSION;
+            header.bodyCount = static_cast<uint32_t>(records.size());
+            header.layerCount = static_cast<uint32_t>(layerTable.size());
+            header.shapeCount = static_cast<uint32_t>(shapeTable.size());
+
+            //Sections follow the header, each starting on an 8 byte boundary
+            uint64_t bodiesSize = records.size() * sizeof(BodyRecord);
+            uint64_t layersSize = layerTable.size() * sizeof(uint32_t);
+            uint64_t shapesSize = shapeTable.size() * sizeof(float);
+            header.bodiesOffset = sizeof(Header);
+            header.layersOffset = (header.bodiesOffset + bodiesSize + 7) & ~static_cast<uint64_t>(7);
+            header.shapesOffset = (header.layersOffset + layersSize + 7) & ~static_cast<uint64_t>(7);
+            header.size = header.shapesOffset + shapesSize;
+
+            buffer.assign(static_cast<size_t>(header.size), 0);
+            std::memcpy(buffer.data(), &header, sizeof(Header));
+
+            if (!records.empty())
+                std::memcpy(buffer.data() + header.bodiesOffset, records.data(), bodiesSize);
+
+            if (!layerTable.empty())
+                std::memcpy(buffer.data() + header.layersOffset, layerTable.data(), layersSize);
+
+            if (!shapeTable.empty())
+                std::memcpy(buffer.data() + header.shapesOffset, shapeTable.data(), shapesSize);
+        }
+
+        //Checks the header and section bounds of a snapshot
+        const Header* validate(const void* data, size_t size)
+        {
+            if (data == nullptr || size < sizeof(Header) || !isHostLittleEndian())
+                return nullptr;
+
+            //Records are read in place, so the data must be aligned for them
+            if (reinterpret_cast<uintptr_t>(data) % alignof(Header) != 0)
+                return nullptr;
+
+            const Header* header = static_cast<const Header*>(data);
+
+            if (header->magic != MAGIC || header->version != VERSION || header->size != size)
+                return nullptr;
+
+            //Sections must be aligned and lie completely inside the data
+            uint64_t bodiesEnd = header->bodiesOffset + static_cast<uint64_t>(header->bodyCount) * sizeof(BodyRecord);
+            uint64_t layersEnd = header->layersOffset + static_cast<uint64_t>(header->layerCount) * sizeof(uint32_t);
+            uint64_t shapesEnd = header->shapesOffset + static_cast<uint64_t>(header->shapeCount) * sizeof(float);
+
+            if (header->bodiesOffset < sizeof(Header) || header->bodiesOffset % alignof(BodyRecord) != 0 ||
+                header->layersOffset % alignof(uint32_t) != 0 || header->shapesOffset % alignof(float) != 0 ||
+                bodiesEnd > size || layersEnd > size || shapesEnd > size || header->layersOffset < bodiesEnd ||
+                header->shapesOffset < layersEnd)
+                return nullptr;
+
+            return header;
+        }
+
+        //Constructor to map a file
+        MappedFile::MappedFile(const std::string& path) : m_data(nullptr), m_size(0), m_mapped(false)
+        {
+#ifdef SNAPSHOT_USE_MMAP
+            int file = open(path.c_str(), O_RDONLY);
+            if (file >= 0)
+            {
+                struct stat fileStats;
+                if (fstat(file, &fileStats) == 0 && fileStats.st_size > 0)
+                {
+                    size_t size = static_cast<size_t>(fileStats.st_size);
+                    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+                    if (mapping != MAP_FAILED)
+                    {
+                        m_data = static_cast<const unsigned char*>(mapping);
+                        m_size = size;
+                        m_mapped = true;
+                    }
+                }
+
+                close(file);
+
+                if (m_mapped)
+                    return;
+            }
+#endif
+
+            //Read the whole file when it cannot be mapped
+            std::ifstream stream(path, std::ios::binary | std::ios::ate);
+            if (!stream)
+                return;
+
+            std::streamsize size = stream.tellg();
+            if (size <= 0)
+                return;
+
+            m_buffer.resize(static_cast<size_t>(size));
+            stream.seekg(0);
+
+            if (!stream.read(reinterpret_cast<char*>(m_buffer.data()), size))
+            {
+                m_buffer.clear();
+                return;
+            }
+
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+        }
+
+        //Destructor to release the mapping
+        MappedFile::~MappedFile()
+        {
+#ifdef SNAPSHOT_USE_MMAP
+            if (m_mapped)
+                munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+        }
+
+        //Returns true if the file was opened
+        bool MappedFile::isOpen() const
+        {
+            return m_data != nullptr;
+        }
+
+        //Getters for the file contents
+        const unsigned char* MappedFile::getData() const
+        {
+            return m_data;
+        }
+
+        size_t MappedFile::getSize() const
+        {
+            return m_size;
+        }
+    }
+}
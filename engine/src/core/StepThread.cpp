@@ -0,0 +1,69 @@
+//Implementation of the StepThread class
+
+#include "core/StepThread.hpp"
+
+namespace phys
+{
+    //Constructor to start the thread
+    StepThread::StepThread() : m_stopping(false), m_thread(&StepThread::run, this) {}
+
+    //Destructor to finish the running task and join the thread
+    StepThread::~StepThread()
+    {
+        wait();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+
+        m_condition.notify_one();
+        m_thread.join();
+    }
+
+    //Waits for tasks and runs them until stopped
+    void StepThread::run()
+    {
+        while (true)
+        {
+            std::packaged_task<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_stopping || m_task.valid(); });
+
+                if (m_stopping)
+                    return;
+
+                task = std::move(m_task);
+            }
+
+            task();
+        }
+    }
+
+    //Runs a task on the thread
+    std::shared_future<void> StepThread::submit(std::function<void()> task)
+    {
+        wait();
+
+        std::packaged_task<void()> packaged(std::move(task));
+        m_lastTask = packaged.get_future().share();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = std::move(packaged);
+        }
+
+        m_condition.notify_one();
+
+        return m_lastTask;
+    }
+
+    //Waits for the last submitted task to finish
+    void StepThread::wait()
+    {
+        if (m_lastTask.valid())
+            m_lastTask.wait();
+    }
+}
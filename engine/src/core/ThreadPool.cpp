@@ -0,0 +1,134 @@
+//Implementation of the ThreadPool class
+
+#include "core/ThreadPool.hpp"
+
+namespace phys
+{
+    //Constructor to start the workers
+    ThreadPool::ThreadPool(int threadCount) : m_unclaimed(0), m_unfinished(0), m_nextQueue(0), m_stopping(false)
+    {
+        if (threadCount <= 0)
+            threadCount = static_cast<int>(std::thread::hardware_concurrency());
+
+        if (threadCount <= 0)
+            threadCount = 1;
+
+        for (int i = 0; i < threadCount; i++)
+            m_queues.push_back(new WorkerQueue());
+
+        for (int i = 0; i < threadCount; i++)
+            m_threads.emplace_back(&ThreadPool::run, this, static_cast<size_t>(i));
+    }
+
+    //Destructor to finish all submitted tasks and join the workers
+    ThreadPool::~ThreadPool()
+    {
+        wait();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+
+        m_wake.notify_all();
+
+        for (std::thread& thread : m_threads)
+            thread.join();
+
+        for (WorkerQueue* queue : m_queues)
+            delete queue;
+    }
+
+    //Claims tasks and runs them until the pool stops
+    void ThreadPool::run(size_t index)
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stopping || m_unclaimed > 0; });
+
+                if (m_unclaimed == 0)
+                    return;
+
+                //Every claim is backed by a queued task, so the search below always ends
+                m_unclaimed--;
+            }
+
+            std::function<void()> task;
+            while (!takeTask(index, task))
+                std::this_thread::yield();
+
+            task();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_unfinished == 0)
+                m_idle.notify_all();
+        }
+    }
+
+    //Takes a task from the worker's own queue, or steals one from another queue
+    bool ThreadPool::takeTask(size_t index, std::function<void()>& task)
+    {
+        {
+            WorkerQueue* own = m_queues[index];
+            std::lock_guard<std::mutex> lock(own->mutex);
+
+            if (!own->tasks.empty())
+            {
+                task = std::move(own->tasks.back());
+                own->tasks.pop_back();
+                return true;
+            }
+        }
+
+        //Steal the oldest task of the next queue that has one
+        for (size_t offset = 1; offset < m_queues.size(); offset++)
+        {
+            WorkerQueue* victim = m_queues[(index + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim->mutex);
+
+            if (!victim->tasks.empty())
+            {
+                task = std::move(victim->tasks.front());
+                victim->tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //Queues a task to run on any worker
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        //Spread tasks over the queues so workers start on their own before stealing
+        WorkerQueue* queue = m_queues[m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size()];
+
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->tasks.push_back(std::move(task));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_unclaimed++;
+            m_unfinished++;
+        }
+
+        m_wake.notify_one();
+    }
+
+    //Waits until every submitted task has finished
+    void ThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_unfinished == 0; });
+    }
+
+    //Returns the number of worker threads
+    int ThreadPool::getThreadCount() const
+    {
+        return static_cast<int>(m_threads.size());
+    }
+}
@@ -0,0 +1,110 @@
+//Implementation of the WorldBatch class
+
+#include "core/WorldBatch.hpp"
+#include "core/PhysicsWorld.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace phys
+{
+    //Constructor to create an empty batch
+    WorldBatch::WorldBatch(int threadCount) : m_pool(threadCount) {}
+
+    //Adds a world to be stepped with the batch
+    void WorldBatch::addWorld(PhysicsWorld* world)
+    {
+        m_worlds.push_back(world);
+        m_stepTimes.push_back(0.0f);
+    }
+
+    //Removes a world from the batch
+    void WorldBatch::removeWorld(PhysicsWorld* world)
+    {
+        auto it = std::find(m_worlds.begin(), m_worlds.end(), world);
+        if (it == m_worlds.end())
+            return;
+
+        m_stepTimes.erase(m_stepTimes.begin() + (it - m_worlds.begin()));
+        m_worlds.erase(it);
+    }
+
+    //Updates every world once and waits until all have finished
+    void WorldBatch::step(float deltaTime)
+    {
+        if (m_worlds.empty())
+            return;
+
+        //Body count stands in for the cost of a step
+        size_t totalBodies = 0;
+        for (const PhysicsWorld* world : m_worlds)
+            totalBodies += world->getBodies().size() + 1;
+
+        size_t taskCount = static_cast<size_t>(m_pool.getThreadCount()) * TASKS_PER_THREAD;
+        size_t taskBodies = totalBodies / taskCount;
+        if (taskBodies < MIN_TASK_BODIES)
+            taskBodies = MIN_TASK_BODIES;
+
+        //Biggest worlds first, so they start early and the small ones fill in around them
+        m_order.resize(m_worlds.size());
+        for (size_t i = 0; i < m_order.size(); i++)
+            m_order[i] = i;
+
+        std::sort(m_order.begin(),
+            m_order.end(),
+            [this](size_t a, size_t b)
+            { return m_worlds[a]->getBodies().size() > m_worlds[b]->getBodies().size(); });
+
+        //Steps a range of m_order and times each world
+        auto stepRange = [this, deltaTime](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                size_t index = m_order[i];
+                auto start = std::chrono::steady_clock::now();
+
+                m_worlds[index]->update(deltaTime);
+
+                m_stepTimes[index] = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+            }
+        };
+
+        //Pack consecutive worlds into a task until it holds enough bodies
+        size_t begin = 0;
+        size_t bodies = 0;
+
+        for (size_t i = 0; i < m_order.size(); i++)
+        {
+            bodies += m_worlds[m_order[i]]->getBodies().size() + 1;
+
+            if (bodies >= taskBodies || i + 1 == m_order.size())
+            {
+                m_pool.submit([stepRange, begin, end = i + 1] { stepRange(begin, end); });
+                begin = i + 1;
+                bodies = 0;
+            }
+        }
+
+        m_pool.wait();
+    }
+
+    //Returns the worlds in the batch
+    const std::vector<PhysicsWorld*>& WorldBatch::getWorlds() const
+    {
+        return m_worlds;
+    }
+
+    //Returns the seconds each world's last step took
+    const std::vector<float>& WorldBatch::getStepTimes() const
+    {
+        return m_stepTimes;
+    }
+
+    //Returns the index of the world whose last step took longest
+    int WorldBatch::getSlowestWorld() const
+    {
+        if (m_stepTimes.empty())
+            return -1;
+
+        return static_cast<int>(std::max_element(m_stepTimes.begin(), m_stepTimes.end()) - m_stepTimes.begin());
+    }
+}
@@ -3,9 +3,25 @@
 #include "core/WorldBoundary.hpp"
 #include "collisions/RectCollider.hpp"
 #include "collisions/CircleCollider.hpp"
+#include "collisions/PolygonCollider.hpp"
+#include "collisions/CapsuleCollider.hpp"
+#include "collisions/CompoundCollider.hpp"
+#include "collisions/ChainCollider.hpp"
+#include "collisions/TileMapCollider.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BOUNDARY_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace phys
 {
+    //Direction from the world into each edge
+    static const Vector2 EDGE_NORMALS[WorldBoundary::EDGE_COUNT] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
     //Constructor to set dimensions and boundary type
     WorldBoundary::WorldBoundary(const Vector2& dimensions, BoundaryType boundaryType) :
         m_dimensions(dimensions), m_type(boundaryType)
@@ -23,12 +39,53 @@ namespace phys
 
         if (m_dimensions.y > MAX_WORLD_HEIGHT)
             m_dimensions.y = MAX_WORLD_HEIGHT;
+
+        for (StaticBody*& edge : m_edges)
+            edge = new StaticBody({0, 0}, new RectCollider({1, 1}, ColliderType::Solid));
+
+        placeEdges();
+    }
+
+    //Destructor to delete the edge bodies
+    WorldBoundary::~WorldBoundary()
+    {
+        for (StaticBody* edge : m_edges)
+            delete edge;
+    }
+
+    //Moves and resizes the edge bodies to fit around the world
+    void WorldBoundary::placeEdges()
+    {
+        float halfWorldWidth = m_dimensions.x / 2;
+        float halfWorldHeight = m_dimensions.y / 2;
+
+        //Edges are as thick as the world and overlap at the corners
+        float thickness = std::max(m_dimensions.x, m_dimensions.y);
+        float offset = thickness / 2;
+
+        const Vector2 positions[EDGE_COUNT] = {{-halfWorldWidth - offset, 0},
+            {halfWorldWidth + offset, 0},
+            {0, -halfWorldHeight - offset},
+            {0, halfWorldHeight + offset}};
+
+        const Vector2 sideDimensions = {thickness, m_dimensions.y + 2 * thickness};
+        const Vector2 floorDimensions = {m_dimensions.x + 2 * thickness, thickness};
+
+        for (int edge = 0; edge < EDGE_COUNT; edge++)
+        {
+            RectCollider* collider = static_cast<RectCollider*>(m_edges[edge]->getCollider());
+            collider->setDimensions(edge < 2 ? sideDimensions : floorDimensions);
+            m_edges[edge]->setPosition(positions[edge]);
+        }
     }
 
     //Enforce boundaries on a body when it is first placed or moved
     //Returns true if body has gone beyond the boundary so the engine knows to delete it
     bool WorldBoundary::placementEnforce(PhysicsBody* body) const
     {
+        if (m_type == BoundaryType::None)
+            return false;
+
         //Get world half dimensions
         float halfWorldWidth = m_dimensions.x / 2;
         float halfWorldHeight = m_dimensions.y / 2;
@@ -147,170 +204,44 @@ namespace phys
             }
         }
 
-        //Update the body position to stay within bounds
-        body->setPosition(newBodyPos);
-
-        //Return false because body type is not delete and calculations already made
-        return false;
-    }
-
-    //Enforce boundaries on a dynamic body every frame
-    bool WorldBoundary::dynamicEnforce(DynamicBody* body) const
-    {
-        //Get world half dimensions
-        float halfWorldWidth = m_dimensions.x / 2;
-        float halfWorldHeight = m_dimensions.y / 2;
-
-        //Get collider shape
-        ColliderShape bodyShape = body->getCollider()->getShape();
-
-        //Get body center position
-        Vector2 bodyPos = body->getPosition();
-
-        //Get the body restitution
-        float bodyRestitution = body->getRestitution();
-
-        //For storing new position after calculations
-        Vector2 newBodyPos = bodyPos;
-
-        //For storing new velocity after calculations
-        Vector2 newVelocity = body->getVelocity();
-
-        //If body is a rectangle
-        if (bodyShape == ColliderShape::Rectangle)
-        {
-            RectCollider* bodyCollider = static_cast<RectCollider*>(body->getCollider());
-
-            //Get rectangle half width and height
-            float halfBodyWidth = bodyCollider->getWidth() / 2;
-            float halfBodyHeight = bodyCollider->getHeight() / 2;
-
-            //If we want the dynamic body to collide with the boundary
-            if (m_type == BoundaryType::Collidable)
-            {
-                //Left boundary
-                if (bodyPos.x - halfBodyWidth < -halfWorldWidth)
-                {
-                    newBodyPos.x = -halfWorldWidth + halfBodyWidth;
-                    newVelocity.x = -newVelocity.x * bodyRestitution;
-                }
-
-                //Right boundary
-                if (bodyPos.x + halfBodyWidth > halfWorldWidth)
-                {
-                    newBodyPos.x = halfWorldWidth - halfBodyWidth;
-                    newVelocity.x = -newVelocity.x * bodyRestitution;
-                }
-
-                //Bottom boundary
-                if (bodyPos.y - halfBodyHeight < -halfWorldHeight)
-                {
-                    newBodyPos.y = -halfWorldHeight + halfBodyHeight;
-                    newVelocity.y = -newVelocity.y * bodyRestitution;
-                }
-
-                //Top boundary
-                if (bodyPos.y + halfBodyHeight > halfWorldHeight)
-                {
-                    newBodyPos.y = halfWorldHeight - halfBodyHeight;
-                    newVelocity.y = -newVelocity.y * bodyRestitution;
-                }
-            }
-
-            //If we want the dynamic body to be deleted if it goes beyond the boundary
-            if (m_type == BoundaryType::Delete)
-            {
-                //Left boundary
-                if (bodyPos.x + halfBodyWidth < -halfWorldWidth)
-                    return true;
-
-                //Right boundary
-                if (bodyPos.x - halfBodyWidth > halfWorldWidth)
-                    return true;
-
-                //Bottom boundary
-                if (bodyPos.y + halfBodyHeight < -halfWorldHeight)
-                    return true;
-
-                //Top boundary
-                if (bodyPos.y - halfBodyHeight > halfWorldHeight)
-                    return true;
-
-                //Body is still within boundaries, do not delete
-                return false;
-            }
-        }
-
-        //If body is a circle
-        if (bodyShape == ColliderShape::Circle)
+        //If body is a polygon, capsule, compound, chain or tile map, its bounding box is kept inside
+        if (bodyShape == ColliderShape::Polygon || bodyShape == ColliderShape::Capsule ||
+            bodyShape == ColliderShape::Compound || bodyShape == ColliderShape::Chain ||
+            bodyShape == ColliderShape::TileMap)
         {
-            CircleCollider* bodyCollider = static_cast<CircleCollider*>(body->getCollider());
-
-            //Get circle radius
-            float bodyRadius = bodyCollider->getRadius();
+            const AABB& box = body->getCollider()->getAABB();
 
-            //If we want the dynamic body to collide with the boundary
+            //if we want the body to stay inside the boundary
             if (m_type == BoundaryType::Collidable)
             {
                 //Left boundary
-                if (bodyPos.x - bodyRadius < -halfWorldWidth)
-                {
-                    newBodyPos.x = -halfWorldWidth + bodyRadius;
-                    newVelocity.x = -newVelocity.x * bodyRestitution;
-                }
+                if (box.min.x < -halfWorldWidth)
+                    newBodyPos.x += -halfWorldWidth - box.min.x;
 
                 //Right boundary
-                if (bodyPos.x + bodyRadius > halfWorldWidth)
-                {
-                    newBodyPos.x = halfWorldWidth - bodyRadius;
-                    newVelocity.x = -newVelocity.x * bodyRestitution;
-                }
+                if (box.max.x > halfWorldWidth)
+                    newBodyPos.x -= box.max.x - halfWorldWidth;
 
                 //Bottom boundary
-                if (bodyPos.y - bodyRadius < -halfWorldHeight)
-                {
-                    newBodyPos.y = -halfWorldHeight + bodyRadius;
-                    newVelocity.y = -newVelocity.y * bodyRestitution;
-                }
+                if (box.min.y < -halfWorldHeight)
+                    newBodyPos.y += -halfWorldHeight - box.min.y;
 
                 //Top boundary
-                if (bodyPos.y + bodyRadius > halfWorldHeight)
-                {
-                    newBodyPos.y = halfWorldHeight - bodyRadius;
-                    newVelocity.y = -newVelocity.y * bodyRestitution;
-                }
+                if (box.max.y > halfWorldHeight)
+                    newBodyPos.y -= box.max.y - halfWorldHeight;
             }
 
-            //If we want the dynamic body to be deleted if it goes beyond the boundary
+            //If we want to delete the body if it is beyond the boundary
             if (m_type == BoundaryType::Delete)
             {
-                //Left boundary
-                if (bodyPos.x + bodyRadius < -halfWorldWidth)
-                    return true;
-
-                //Right boundary
-                if (bodyPos.x - bodyRadius > halfWorldWidth)
-                    return true;
-
-                //Bottom boundary
-                if (bodyPos.y + bodyRadius < -halfWorldHeight)
-                    return true;
-
-                //Top boundary
-                if (bodyPos.y - bodyRadius > halfWorldHeight)
-                    return true;
-
-                //Body is still within boundaries, do not delete
-                return false;
+                return box.max.x < -halfWorldWidth || box.min.x > halfWorldWidth || box.max.y < -halfWorldHeight ||
+                       box.min.y > halfWorldHeight;
             }
         }
 
         //Update the body position to stay within bounds
         body->setPosition(newBodyPos);
 
-        //Update the body velocity when boundaries are hit
-        body->setVelocity(newVelocity);
-
         //Return false because body type is not delete and calculations already made
         return false;
     }
@@ -318,6 +249,9 @@ namespace phys
     //Checks if a body is on the boundary floor
     bool WorldBoundary::checkIfOnFloor(const PhysicsBody* body) const
     {
+        if (m_type == BoundaryType::None)
+            return false;
+
         //Get world half dimensions
         float halfWorldWidth = m_dimensions.x / 2;
         float halfWorldHeight = m_dimensions.y / 2;
@@ -360,9 +294,253 @@ namespace phys
                 return true;
         }
 
+        //Check if the lowest point of a polygon, capsule, compound, chain or tile map is touching the floor
+        else if (shape == ColliderShape::Polygon || shape == ColliderShape::Capsule ||
+                 shape == ColliderShape::Compound || shape == ColliderShape::Chain || shape == ColliderShape::TileMap)
+        {
+            float polygonBottomPos = collider->getAABB().min.y;
+
+            if (polygonBottomPos <= upperThreshold && polygonBottomPos >= lowerThreshold)
+                return true;
+        }
+
         return false;
     }
 
+    //Returns the region beyond an edge
+    AABB WorldBoundary::getEdgeRegion(int edge) const
+    {
+        const float FAR = std::numeric_limits<float>::max();
+
+        float halfWorldWidth = m_dimensions.x / 2;
+        float halfWorldHeight = m_dimensions.y / 2;
+
+        if (edge == 0)
+            return AABB({-FAR, -FAR}, {-halfWorldWidth, FAR});
+
+        if (edge == 1)
+            return AABB({halfWorldWidth, -FAR}, {FAR, FAR});
+
+        if (edge == 2)
+            return AABB({-FAR, -FAR}, {FAR, -halfWorldHeight});
+
+        return AABB({-FAR, halfWorldHeight}, {FAR, FAR});
+    }
+
+    //Returns true if the body's AABB lies entirely beyond an edge
+    bool WorldBoundary::isBeyondEdge(const PhysicsBody* body, int edge) const
+    {
+        const AABB& box = body->getCollider()->getAABB();
+        const Vector2& normal = EDGE_NORMALS[edge];
+        float edgeDistance = edge < 2 ? m_dimensions.x / 2 : m_dimensions.y / 2;
+
+        //Nearest reach of the box towards the world along the edge normal
+        float nearest = std::min(box.min.projectOntoAxis(normal), box.max.projectOntoAxis(normal));
+
+        return nearest > edgeDistance;
+    }
+
+    //Deepest two points of a collider along an edge normal, deepest first, kept without allocating
+    struct EdgeCorners
+    {
+        Vector2 points[2];
+        float depths[2];
+        int count = 0;
+
+        //Keeps the point if it is among the two deepest so far
+        void add(const Vector2& point, const Vector2& normal)
+        {
+            float depth = point.projectOntoAxis(normal);
+            if (count == 2 && depth <= depths[1])
+                return;
+
+            //Shallower points move down a slot, the shallowest of three drops out
+            int slot = count < 2 ? count++ : 1;
+            while (slot > 0 && depths[slot - 1] < depth)
+            {
+                points[slot] = points[slot - 1];
+                depths[slot] = depths[slot - 1];
+                slot--;
+            }
+
+            points[slot] = point;
+            depths[slot] = depth;
+        }
+    };
+
+    //Adds the points of a collider that can reach furthest along an edge normal
+    //Vertices of rectangles and polygons, the deepest points of circles and of a capsule's rounded ends,
+    //those of every child of a compound, the vertices of a chain, and the corners of a tile map's grid
+    static void addEdgeCorners(const Collider* collider, const Vector2& normal, EdgeCorners& corners)
+    {
+        ColliderShape shape = collider->getShape();
+
+        if (shape == ColliderShape::Circle)
+        {
+            float radius = static_cast<const CircleCollider*>(collider)->getRadius();
+            corners.add(collider->getPosition() + normal * radius, normal);
+        }
+        else if (shape == ColliderShape::Polygon)
+        {
+            const PolygonCollider* polygon = static_cast<const PolygonCollider*>(collider);
+            for (int i = 0; i < polygon->getVertexCount(); i++)
+                corners.add(polygon->getVertices()[i], normal);
+        }
+        else if (shape == ColliderShape::Capsule)
+        {
+            const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+            corners.add(capsule->getPointA() + normal * capsule->getRadius(), normal);
+            corners.add(capsule->getPointB() + normal * capsule->getRadius(), normal);
+        }
+        else if (shape == ColliderShape::Compound)
+        {
+            const CompoundCollider* compound = static_cast<const CompoundCollider*>(collider);
+            for (int i = 0; i < compound->getChildCount(); i++)
+                addEdgeCorners(compound->getChild(i), normal, corners);
+        }
+        else if (shape == ColliderShape::Chain)
+        {
+            for (const Vector2& vertex : static_cast<const ChainCollider*>(collider)->getVertices())
+                corners.add(vertex, normal);
+        }
+        else if (shape == ColliderShape::TileMap)
+        {
+            //Grid corners, from the bottom left one at the collider position
+            const TileMapCollider* tileMap = static_cast<const TileMapCollider*>(collider);
+            float width = tileMap->getColumns() * tileMap->getTileSize();
+            float height = tileMap->getRows() * tileMap->getTileSize();
+
+            corners.add(collider->getPosition(), normal);
+            corners.add(collider->getPosition() + tileMap->toWorldDirection({width, 0.0f}), normal);
+            corners.add(collider->getPosition() + tileMap->toWorldDirection({width, height}), normal);
+            corners.add(collider->getPosition() + tileMap->toWorldDirection({0.0f, height}), normal);
+        }
+        else
+        {
+            const RectCollider* rectangle = static_cast<const RectCollider*>(collider);
+            float cos = std::cos(collider->getRotation());
+            float sin = std::sin(collider->getRotation());
+            Vector2 halfWidth = Vector2(cos, sin) * (rectangle->getWidth() / 2.0f);
+            Vector2 halfHeight = Vector2(-sin, cos) * (rectangle->getHeight() / 2.0f);
+
+            corners.add(collider->getPosition() - halfWidth + halfHeight, normal);
+            corners.add(collider->getPosition() + halfWidth + halfHeight, normal);
+            corners.add(collider->getPosition() + halfWidth - halfHeight, normal);
+            corners.add(collider->getPosition() - halfWidth - halfHeight, normal);
+        }
+    }
+
+    //Fills the collision between a body and an edge
+    bool WorldBoundary::checkEdgeCollision(PhysicsBody* body, int edge, Collision& collision) const
+    {
+        Collider* collider = body->getCollider();
+        const AABB& box = collider->getAABB();
+        const Vector2& normal = EDGE_NORMALS[edge];
+        float edgeDistance = edge < 2 ? m_dimensions.x / 2 : m_dimensions.y / 2;
+
+        //The deepest point of a convex shape along an axis aligned normal lies on its AABB
+        float reach = std::max(box.min.projectOntoAxis(normal), box.max.projectOntoAxis(normal));
+        float penDepth = reach - edgeDistance;
+
+        if (penDepth <= 0.0f)
+            return false;
+
+        //Corners beyond the edge, deepest first, a flat side resting on the edge gives two
+        EdgeCorners corners;
+        addEdgeCorners(collider, normal, corners);
+
+        int contactCount = 0;
+        while (contactCount < corners.count && corners.depths[contactCount] > edgeDistance)
+            contactCount++;
+
+        //The AABB and the corners may round differently for corners right at the edge
+        if (contactCount == 0)
+            contactCount = 1;
+
+        collision.bodyA = body;
+        collision.bodyB = m_edges[edge];
+        collision.normal = normal;
+        collision.penDepth = penDepth;
+        collision.contactPoints.assign(corners.points, corners.points + contactCount);
+        collision.contactCount = contactCount;
+
+        return true;
+    }
+
+    //Resizes every array of the batch
+    void BoundaryBatch::resize(size_t count)
+    {
+        minX.resize(count);
+        minY.resize(count);
+        maxX.resize(count);
+        maxY.resize(count);
+        correctionX.resize(count);
+        correctionY.resize(count);
+        beyond.resize(count);
+    }
+
+    //Fills the corrections and beyond flags of every box in the batch
+    void WorldBoundary::enforceBatch(BoundaryBatch& batch) const
+    {
+        float right = m_dimensions.x / 2;
+        float top = m_dimensions.y / 2;
+        float left = -right;
+        float bottom = -top;
+
+        size_t count = batch.minX.size();
+        size_t i = 0;
+
+#ifdef BOUNDARY_USE_SSE2
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 leftEdge = _mm_set1_ps(left);
+        const __m128 rightEdge = _mm_set1_ps(right);
+        const __m128 bottomEdge = _mm_set1_ps(bottom);
+        const __m128 topEdge = _mm_set1_ps(top);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 minX = _mm_loadu_ps(&batch.minX[i]);
+            __m128 minY = _mm_loadu_ps(&batch.minY[i]);
+            __m128 maxX = _mm_loadu_ps(&batch.maxX[i]);
+            __m128 maxY = _mm_loadu_ps(&batch.maxY[i]);
+
+            //Push right by how far the box crosses the left edge, push left by how far it crosses the right edge
+            __m128 correctionX =
+                _mm_add_ps(_mm_max_ps(_mm_sub_ps(leftEdge, minX), zero), _mm_min_ps(_mm_sub_ps(rightEdge, maxX), zero));
+            __m128 correctionY = _mm_add_ps(
+                _mm_max_ps(_mm_sub_ps(bottomEdge, minY), zero), _mm_min_ps(_mm_sub_ps(topEdge, maxY), zero));
+
+            _mm_storeu_ps(&batch.correctionX[i], correctionX);
+            _mm_storeu_ps(&batch.correctionY[i], correctionY);
+
+            //Entirely beyond any one edge
+            __m128 outside = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(maxX, leftEdge), _mm_cmpgt_ps(minX, rightEdge)),
+                _mm_or_ps(_mm_cmplt_ps(maxY, bottomEdge), _mm_cmpgt_ps(minY, topEdge)));
+
+            int mask = _mm_movemask_ps(outside);
+            batch.beyond[i] = mask & 1;
+            batch.beyond[i + 1] = (mask >> 1) & 1;
+            batch.beyond[i + 2] = (mask >> 2) & 1;
+            batch.beyond[i + 3] = (mask >> 3) & 1;
+        }
+#endif
+
+        //Remaining boxes, or all of them without SSE2
+        for (; i < count; i++)
+        {
+            batch.correctionX[i] = std::max(left - batch.minX[i], 0.0f) + std::min(right - batch.maxX[i], 0.0f);
+            batch.correctionY[i] = std::max(bottom - batch.minY[i], 0.0f) + std::min(top - batch.maxY[i], 0.0f);
+            batch.beyond[i] = batch.maxX[i] < left || batch.minX[i] > right || batch.maxY[i] < bottom ||
+                              batch.minY[i] > top;
+        }
+    }
+
+    //Returns the static body standing in for an edge
+    StaticBody* WorldBoundary::getEdge(int edge) const
+    {
+        return m_edges[edge];
+    }
+
     //Getters for member variables
     float WorldBoundary::getWidth() const
     {
@@ -374,6 +552,11 @@ namespace phys
         return m_dimensions.y;
     }
 
+    BoundaryType WorldBoundary::getType() const
+    {
+        return m_type;
+    }
+
     //Sets new dimensions for world boundaries, cannot be less than minimums
     void WorldBoundary::setDimensions(Vector2& newDimensions)
     {
@@ -393,6 +576,7 @@ namespace phys
 
         //Set new dimensions
         m_dimensions = newDimensions;
+        placeEdges();
     }
 
     //Set a new boundary type
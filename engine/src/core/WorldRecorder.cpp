@@ -0,0 +1,195 @@
+//Implementation of the WorldRecorder class
+
+#include "core/WorldRecorder.hpp"
+#include "core/PhysicsWorld.hpp"
+#include "core/Snapshot.hpp"
+#include "collisions/StaticGroup.hpp"
+#include <vector>
+
+namespace phys
+{
+    //Constructor to create a recorder that is not recording
+    WorldRecorder::WorldRecorder() : m_world(nullptr), m_frameCount(0) {}
+
+    //Destructor to finish the recording
+    WorldRecorder::~WorldRecorder()
+    {
+        close();
+    }
+
+    //Appends raw bytes to the log
+    void WorldRecorder::write(const void* data, size_t size)
+    {
+        m_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+
+    //Appends an operation with a body id
+    void WorldRecorder::writeOp(RecordOp op, unsigned int bodyId)
+    {
+        uint32_t id = bodyId;
+        write(&op, sizeof(RecordOp));
+        write(&id, sizeof(uint32_t));
+    }
+
+    //Appends a body's snapshot record, layers and masks, and shape
+    void WorldRecorder::writeBody(const PhysicsBody* body)
+    {
+        Snapshot::BodyRecord record;
+        std::vector<uint32_t> layerTable;
+        std::vector<float> shapeTable;
+        Snapshot::writeBody(body, record, layerTable, shapeTable);
+
+        write(&record, sizeof(Snapshot::BodyRecord));
+        write(layerTable.data(), layerTable.size() * sizeof(uint32_t));
+        write(shapeTable.data(), shapeTable.size() * sizeof(float));
+    }
+
+    //Starts recording a world to a new log file
+    bool WorldRecorder::open(const std::string& path, PhysicsWorld& world)
+    {
+        close();
+
+        if (!Snapshot::isHostLittleEndian())
+            return false;
+
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+            return false;
+
+        //Replays rebuild the broad phase from scratch, so results must not depend on its history
+        world.setDeterministic(true);
+
+        std::vector<unsigned char> snapshot;
+        world.writeSnapshot(snapshot);
+
+        RecordingHeader header = {RECORDING_MAGIC, RECORDING_VERSION, snapshot.size()};
+        write(&header, sizeof(RecordingHeader));
+        write(snapshot.data(), snapshot.size());
+
+        //Snapshots leave out static groups, their bodies keep the ids they were given before recording
+        for (const StaticGroup* group : world.getStaticGroups())
+            recordAttachGroup(group);
+
+        m_file.flush();
+
+        if (!m_file)
+        {
+            m_file.close();
+            return false;
+        }
+
+        m_world = &world;
+        m_frameCount = 0;
+        world.setRecorder(this);
+
+        return true;
+    }
+
+    //Stops recording and flushes the log
+    void WorldRecorder::close()
+    {
+        if (m_world)
+        {
+            m_world->setRecorder(nullptr);
+            m_world = nullptr;
+        }
+
+        if (m_file.is_open())
+            m_file.close();
+    }
+
+    //Returns true while recording
+    bool WorldRecorder::isRecording() const
+    {
+        return m_world != nullptr;
+    }
+
+    //Returns the number of updates recorded
+    unsigned int WorldRecorder::getFrameCount() const
+    {
+        return m_frameCount;
+    }
+
+    //Records a body added to the world, with its full state so it can be recreated
+    void WorldRecorder::recordAddBody(const PhysicsBody* body)
+    {
+        RecordOp op = RecordOp::AddBody;
+        write(&op, sizeof(RecordOp));
+        writeBody(body);
+    }
+
+    //Records a body removed from the world
+    void WorldRecorder::recordRemoveBody(const PhysicsBody* body)
+    {
+        writeOp(RecordOp::RemoveBody, body->getId());
+    }
+
+    //Records a force applied to a body
+    void WorldRecorder::recordApplyForce(const PhysicsBody* body, const Vector2& force)
+    {
+        writeOp(RecordOp::ApplyForce, body->getId());
+        write(&force.x, sizeof(float));
+        write(&force.y, sizeof(float));
+    }
+
+    //Records an impulse applied to a body
+    void WorldRecorder::recordApplyImpulse(const PhysicsBody* body, const Vector2& impulse)
+    {
+        writeOp(RecordOp::ApplyImpulse, body->getId());
+        write(&impulse.x, sizeof(float));
+        write(&impulse.y, sizeof(float));
+    }
+
+    //Records a velocity set on a body
+    void WorldRecorder::recordSetVelocity(const PhysicsBody* body, const Vector2& velocity)
+    {
+        writeOp(RecordOp::SetVelocity, body->getId());
+        write(&velocity.x, sizeof(float));
+        write(&velocity.y, sizeof(float));
+    }
+
+    //Records the origin of the world moving
+    void WorldRecorder::recordRebaseOrigin(const Vector2& shift)
+    {
+        RecordOp op = RecordOp::RebaseOrigin;
+        write(&op, sizeof(RecordOp));
+        write(&shift.x, sizeof(float));
+        write(&shift.y, sizeof(float));
+    }
+
+    //Records a static group attached to the world, with every body so it can be rebuilt with the same ids
+    //Empty groups change nothing in the world and are not recorded
+    void WorldRecorder::recordAttachGroup(const StaticGroup* group)
+    {
+        const std::vector<PhysicsBody*>& bodies = group->getBodies();
+        if (bodies.empty())
+            return;
+
+        RecordOp op = RecordOp::AttachGroup;
+        uint32_t count = static_cast<uint32_t>(bodies.size());
+        write(&op, sizeof(RecordOp));
+        write(&count, sizeof(uint32_t));
+
+        for (const PhysicsBody* body : bodies)
+            writeBody(body);
+    }
+
+    //Records a static group detached from the world, known by the id of its first body
+    void WorldRecorder::recordDetachGroup(const StaticGroup* group)
+    {
+        if (!group->getBodies().empty())
+            writeOp(RecordOp::DetachGroup, group->getBodies().front()->getId());
+    }
+
+    //Records an update, flushing so a crash loses at most the current frame
+    void WorldRecorder::recordUpdate(float deltaTime, uint64_t stateHash)
+    {
+        RecordOp op = RecordOp::Update;
+        write(&op, sizeof(RecordOp));
+        write(&deltaTime, sizeof(float));
+        write(&stateHash, sizeof(uint64_t));
+        m_file.flush();
+
+        m_frameCount++;
+    }
+}
@@ -0,0 +1,278 @@
+//Implementation of the WorldReplayer class
+
+#include "core/WorldReplayer.hpp"
+#include "core/WorldRecorder.hpp"
+#include "core/PhysicsWorld.hpp"
+#include "collisions/StaticGroup.hpp"
+#include <cstring>
+#include <vector>
+
+namespace phys
+{
+    //Constructor to create a replayer with no recording
+    WorldReplayer::WorldReplayer() :
+        m_file(nullptr), m_cursor(0), m_frame(0), m_divergedFrame(-1), m_groupWorld(nullptr)
+    {
+    }
+
+    //Destructor to release the recording and the static groups it attached
+    WorldReplayer::~WorldReplayer()
+    {
+        releaseGroups();
+        delete m_file;
+    }
+
+    //Reads bytes at the cursor and advances it
+    bool WorldReplayer::read(void* data, size_t size)
+    {
+        if (m_file->getSize() - m_cursor < size)
+            return false;
+
+        //Operations are packed without alignment, so copy instead of reading in place
+        std::memcpy(data, m_file->getData() + m_cursor, size);
+        m_cursor += size;
+
+        return true;
+    }
+
+    //Reads a body's record, layers and masks, and shape and creates it
+    PhysicsBody* WorldReplayer::readBody()
+    {
+        Snapshot::BodyRecord record;
+        if (!read(&record, sizeof(Snapshot::BodyRecord)))
+            return nullptr;
+
+        std::vector<uint32_t> layerTable(record.layerCount + record.maskCount);
+        if (!read(layerTable.data(), layerTable.size() * sizeof(uint32_t)))
+            return nullptr;
+
+        //Checked against the rest of the file before allocating for it
+        if (record.shapeCount > (m_file->getSize() - m_cursor) / sizeof(float))
+            return nullptr;
+
+        std::vector<float> shapeTable(record.shapeCount);
+        if (!read(shapeTable.data(), shapeTable.size() * sizeof(float)))
+            return nullptr;
+
+        return Snapshot::createBody(record,
+            layerTable.data(),
+            static_cast<uint32_t>(layerTable.size()),
+            shapeTable.data(),
+            static_cast<uint32_t>(shapeTable.size()));
+    }
+
+    //Detaches and deletes the static groups attached by the replay
+    void WorldReplayer::releaseGroups()
+    {
+        for (StaticGroup* group : m_groups)
+        {
+            m_groupWorld->removeStaticGroup(group);
+            delete group;
+        }
+
+        m_groups.clear();
+        m_groupWorld = nullptr;
+    }
+
+    //Opens a recording file
+    bool WorldReplayer::open(const std::string& path)
+    {
+        delete m_file;
+        m_file = new Snapshot::MappedFile(path);
+
+        RecordingHeader header;
+        m_cursor = 0;
+
+        if (!m_file->isOpen() || !read(&header, sizeof(RecordingHeader)) || header.magic != RECORDING_MAGIC ||
+            header.version != RECORDING_VERSION || header.snapshotSize > m_file->getSize() - m_cursor)
+        {
+            delete m_file;
+            m_file = nullptr;
+            return false;
+        }
+
+        return true;
+    }
+
+    //Replaces the world state with the recorded snapshot
+    bool WorldReplayer::start(PhysicsWorld& world)
+    {
+        if (!m_file)
+            return false;
+
+        releaseGroups();
+
+        //The snapshot follows the header, which keeps it 8 byte aligned for reading in place
+        const RecordingHeader* header = reinterpret_cast<const RecordingHeader*>(m_file->getData());
+        if (!world.readSnapshot(m_file->getData() + sizeof(RecordingHeader), header->snapshotSize))
+            return false;
+
+        m_cursor = sizeof(RecordingHeader) + header->snapshotSize;
+        m_frame = 0;
+        m_divergedFrame = -1;
+
+        return true;
+    }
+
+    //Applies operations up to and including the next update
+    bool WorldReplayer::step(PhysicsWorld& world)
+    {
+        if (!m_file)
+            return false;
+
+        RecordOp op;
+        while (read(&op, sizeof(RecordOp)))
+        {
+            if (op == RecordOp::AddBody)
+            {
+                PhysicsBody* body = readBody();
+                if (!body)
+                    return false;
+
+                //Bodies keep their recorded ids, which queued bodies reserve before they are added
+                world.restoreBody(body);
+                continue;
+            }
+
+            if (op == RecordOp::AttachGroup)
+            {
+                uint32_t count;
+                if (!read(&count, sizeof(uint32_t)) || count == 0)
+                    return false;
+
+                std::vector<PhysicsBody*> bodies;
+                PhysicsBody* body = nullptr;
+                while (bodies.size() < count && (body = readBody()) != nullptr)
+                    bodies.push_back(body);
+
+                //The group's bodies keep their recorded ids, so later operations find them
+                StaticGroup* group = new StaticGroup();
+                if (bodies.size() < count || !group->build(bodies) || !world.restoreStaticGroup(group))
+                {
+                    //The group only owns the bodies once it is built
+                    if (group->getBodies().empty())
+                    {
+                        for (PhysicsBody* created : bodies)
+                            delete created;
+                    }
+
+                    delete group;
+                    return false;
+                }
+
+                m_groups.push_back(group);
+                m_groupWorld = &world;
+                continue;
+            }
+
+            if (op == RecordOp::DetachGroup)
+            {
+                uint32_t id;
+                if (!read(&id, sizeof(uint32_t)))
+                    return false;
+
+                std::vector<StaticGroup*>::iterator it = m_groups.begin();
+                while (it != m_groups.end() && (*it)->getBodies().front()->getId() != id)
+                    ++it;
+
+                if (it == m_groups.end())
+                    return false;
+
+                world.removeStaticGroup(*it);
+                delete *it;
+                m_groups.erase(it);
+                continue;
+            }
+
+            if (op == RecordOp::Update)
+            {
+                float deltaTime;
+                uint64_t stateHash;
+                if (!read(&deltaTime, sizeof(float)) || !read(&stateHash, sizeof(uint64_t)))
+                    return false;
+
+                world.update(deltaTime);
+
+                if (m_divergedFrame < 0 && world.getStateHash() != stateHash)
+                    m_divergedFrame = static_cast<int>(m_frame);
+
+                m_frame++;
+                return true;
+            }
+
+            if (op == RecordOp::RebaseOrigin)
+            {
+                Vector2 shift;
+                if (!read(&shift.x, sizeof(float)) || !read(&shift.y, sizeof(float)))
+                    return false;
+
+                world.rebaseOrigin(shift);
+                continue;
+            }
+
+            if (op != RecordOp::RemoveBody && op != RecordOp::ApplyForce && op != RecordOp::ApplyImpulse &&
+                op != RecordOp::SetVelocity)
+                return false;
+
+            //Remaining operations all target an existing body
+            uint32_t id;
+            if (!read(&id, sizeof(uint32_t)))
+                return false;
+
+            PhysicsBody* body = world.getBody(id);
+            if (!body)
+                return false;
+
+            if (op == RecordOp::RemoveBody)
+            {
+                world.removeBody(body);
+                continue;
+            }
+
+            Vector2 value;
+            if (!read(&value.x, sizeof(float)) || !read(&value.y, sizeof(float)))
+                return false;
+
+            if (op == RecordOp::ApplyForce)
+                world.applyForce(body, value);
+            else if (op == RecordOp::ApplyImpulse)
+                world.applyImpulse(body, value);
+            else
+                world.setVelocity(body, value);
+        }
+
+        //No update left in the log, isFinished tells a complete log from a truncated one
+        return false;
+    }
+
+    //Starts the replay and steps through the whole recording
+    unsigned int WorldReplayer::run(PhysicsWorld& world)
+    {
+        if (!start(world))
+            return 0;
+
+        while (step(world))
+        {
+        }
+
+        return m_frame;
+    }
+
+    //Returns true once every operation has been applied
+    bool WorldReplayer::isFinished() const
+    {
+        return m_file != nullptr && m_cursor == m_file->getSize();
+    }
+
+    //Returns the number of updates replayed since start
+    unsigned int WorldReplayer::getFrame() const
+    {
+        return m_frame;
+    }
+
+    //Returns the first frame whose state hash differed from the recording
+    int WorldReplayer::getDivergedFrame() const
+    {
+        return m_divergedFrame;
+    }
+}
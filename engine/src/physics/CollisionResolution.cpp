@@ -4,124 +4,125 @@
 
 namespace phys
 {
-    //Sort collision to respective solver for collisions without rotation
-    void CollisionResolution::resolveBasicCollision(const Collision& collision)
-    {
-        //Get body types
-        BodyType typeA = collision.bodyA->getType();
-        BodyType typeB = collision.bodyB->getType();
+    //Resolves a collision between bodies of the types it was looked up for
+    typedef void (*ResolveFunction)(const Collision& collision);
 
-        //If the first body is dynamic
-        if (typeA == BodyType::DynamicBody)
-        {
-            DynamicBody* dynamicBodyA = static_cast<DynamicBody*>(collision.bodyA);
+    //Functions resolving each pair of body types, indexed by the types of body A and body B
+    //Pairs with no entry are not resolved
+    struct ResolveTables
+    {
+        ResolveFunction basic[BODY_TYPE_COUNT][BODY_TYPE_COUNT];
+        ResolveFunction advanced[BODY_TYPE_COUNT][BODY_TYPE_COUNT];
+    };
 
-            //If the second body is also dynamic
-            if (typeB == BodyType::DynamicBody)
-            {
-                DynamicBody* dynamicBodyB = static_cast<DynamicBody*>(collision.bodyB);
+    //Resolve collision between two dynamic bodies, no rotations
+    static void resolveBasicDynamicPair(const Collision& collision)
+    {
+        CollisionResolution::resolveBasicDynamicCollision(static_cast<DynamicBody*>(collision.bodyA),
+            static_cast<DynamicBody*>(collision.bodyB),
+            collision.normal,
+            collision.penDepth);
+    }
 
-                //Resolve collision between two dynamic bodies
-                resolveBasicDynamicCollision(dynamicBodyA,
-                    dynamicBodyB,
-                    collision.normal,
-                    collision.penDepth);
-            }
+    //Resolve collision between a dynamic body and a static body, no rotations
+    static void resolveBasicDynamicStaticPair(const Collision& collision)
+    {
+        CollisionResolution::resolveBasicDynamicStaticCollision(static_cast<DynamicBody*>(collision.bodyA),
+            static_cast<StaticBody*>(collision.bodyB),
+            collision.normal,
+            collision.penDepth);
+    }
 
-            //If second body is a static body
-            else if (typeB == BodyType::StaticBody)
-            {
-                StaticBody* staticBodyB = static_cast<StaticBody*>(collision.bodyB);
+    //Resolve collision between a static body and a dynamic body, no rotations
+    //Flip the normal since we switched the order of bodies
+    static void resolveBasicStaticDynamicPair(const Collision& collision)
+    {
+        CollisionResolution::resolveBasicDynamicStaticCollision(static_cast<DynamicBody*>(collision.bodyB),
+            static_cast<StaticBody*>(collision.bodyA),
+            -collision.normal,
+            collision.penDepth);
+    }
 
-                //Resolve collision between a dynamic body and a static body
-                resolveBasicDynamicStaticCollision(dynamicBodyA,
-                    staticBodyB,
-                    collision.normal,
-                    collision.penDepth);
-            }
-        }
+    //Resolve collision between two dynamic bodies, with rotations
+    static void resolveAdvancedDynamicPair(const Collision& collision)
+    {
+        CollisionResolution::resolveAdvancedDynamicCollision(static_cast<DynamicBody*>(collision.bodyA),
+            static_cast<DynamicBody*>(collision.bodyB),
+            collision.normal,
+            collision.penDepth,
+            collision.contactPoints,
+            collision.contactCount);
+    }
 
-        //If the first body is a static body
-        else if (typeA == BodyType::StaticBody)
-        {
-            StaticBody* staticBodyA = static_cast<StaticBody*>(collision.bodyA);
+    //Resolve collision between a dynamic body and a static body, with rotations
+    static void resolveAdvancedDynamicStaticPair(const Collision& collision)
+    {
+        CollisionResolution::resolveAdvancedDynamicStaticCollision(static_cast<DynamicBody*>(collision.bodyA),
+            static_cast<StaticBody*>(collision.bodyB),
+            collision.normal,
+            collision.penDepth,
+            collision.contactPoints,
+            collision.contactCount);
+    }
 
-            //If the second body is a dynamic body
-            if (typeB == BodyType::DynamicBody)
-            {
-                DynamicBody* dynamicBodyB = static_cast<DynamicBody*>(collision.bodyB);
-
-                //Resolve collision between a dynamic body and a static body
-                //Flip the normal since we switched the order of bodies
-                resolveBasicDynamicStaticCollision(dynamicBodyB,
-                    staticBodyA,
-                    -collision.normal,
-                    collision.penDepth);
-            }
-        }
+    //Resolve collision between a static body and a dynamic body, with rotations
+    //Flip the normal since we switched the order of bodies
+    static void resolveAdvancedStaticDynamicPair(const Collision& collision)
+    {
+        CollisionResolution::resolveAdvancedDynamicStaticCollision(static_cast<DynamicBody*>(collision.bodyB),
+            static_cast<StaticBody*>(collision.bodyA),
+            -collision.normal,
+            collision.penDepth,
+            collision.contactPoints,
+            collision.contactCount);
     }
 
-    //Sort collision to respective solver for collisions with rotation
-    void CollisionResolution::resolveAdvancedCollision(const Collision& collision)
+    //Fills the tables once, leaving pairs of static bodies and controllable bodies unresolved
+    static ResolveTables makeResolveTables()
     {
-        //Get body types
-        BodyType typeA = collision.bodyA->getType();
-        BodyType typeB = collision.bodyB->getType();
+        ResolveTables tables = {};
 
-        //If the first body is dynamic
-        if (typeA == BodyType::DynamicBody)
-        {
-            DynamicBody* dynamicBodyA = static_cast<DynamicBody*>(collision.bodyA);
+        const int dynamicType = static_cast<int>(BodyType::DynamicBody);
+        const int staticType = static_cast<int>(BodyType::StaticBody);
 
-            //If the second body is also dynamic
-            if (typeB == BodyType::DynamicBody)
-            {
-                DynamicBody* dynamicBodyB = static_cast<DynamicBody*>(collision.bodyB);
-
-                //Resolve collision between two dynamic bodies
-                resolveAdvancedDynamicCollision(dynamicBodyA,
-                    dynamicBodyB,
-                    collision.normal,
-                    collision.penDepth,
-                    collision.contactPoints,
-                    collision.contactCount);
-            }
+        tables.basic[dynamicType][dynamicType] = resolveBasicDynamicPair;
+        tables.basic[dynamicType][staticType] = resolveBasicDynamicStaticPair;
+        tables.basic[staticType][dynamicType] = resolveBasicStaticDynamicPair;
 
-            //If second body is a static body
-            else if (typeB == BodyType::StaticBody)
-            {
-                StaticBody* staticBodyB = static_cast<StaticBody*>(collision.bodyB);
-
-                //Resolve collision between a dynamic body and a static body
-                resolveAdvancedDynamicStaticCollision(dynamicBodyA,
-                    staticBodyB,
-                    collision.normal,
-                    collision.penDepth,
-                    collision.contactPoints,
-                    collision.contactCount);
-            }
-        }
+        tables.advanced[dynamicType][dynamicType] = resolveAdvancedDynamicPair;
+        tables.advanced[dynamicType][staticType] = resolveAdvancedDynamicStaticPair;
+        tables.advanced[staticType][dynamicType] = resolveAdvancedStaticDynamicPair;
 
-        //If the first body is a static body
-        else if (typeA == BodyType::StaticBody)
-        {
-            StaticBody* staticBodyA = static_cast<StaticBody*>(collision.bodyA);
+        return tables;
+    }
 
-            //If the second body is a dynamic body
-            if (typeB == BodyType::DynamicBody)
-            {
-                DynamicBody* dynamicBodyB = static_cast<DynamicBody*>(collision.bodyB);
-
-                //Resolve collision between a dynamic body and a static body
-                //Flip the normal since we switched the order of bodies
-                resolveAdvancedDynamicStaticCollision(dynamicBodyB,
-                    staticBodyA,
-                    -collision.normal,
-                    collision.penDepth,
-                    collision.contactPoints,
-                    collision.contactCount);
-            }
-        }
+    //Returns the tables, filled on first use
+    static const ResolveTables& getResolveTables()
+    {
+        static const ResolveTables tables = makeResolveTables();
+        return tables;
+    }
+
+    //Sort collision to respective solver for collisions without rotation
+    void CollisionResolution::resolveBasicCollision(const Collision& collision)
+    {
+        int typeA = static_cast<int>(collision.bodyA->getType());
+        int typeB = static_cast<int>(collision.bodyB->getType());
+
+        ResolveFunction resolve = getResolveTables().basic[typeA][typeB];
+        if (resolve)
+            resolve(collision);
+    }
+
+    //Sort collision to respective solver for collisions with rotation
+    void CollisionResolution::resolveAdvancedCollision(const Collision& collision)
+    {
+        int typeA = static_cast<int>(collision.bodyA->getType());
+        int typeB = static_cast<int>(collision.bodyB->getType());
+
+        ResolveFunction resolve = getResolveTables().advanced[typeA][typeB];
+        if (resolve)
+            resolve(collision);
     }
 
     //Resolve a collision between a dynamic body and a static body
@@ -3,6 +3,9 @@
 #include "physics/DynamicBody.hpp"
 #include "collisions/CircleCollider.hpp"
 #include "collisions/RectCollider.hpp"
+#include "collisions/PolygonCollider.hpp"
+#include "collisions/CapsuleCollider.hpp"
+#include "collisions/CompoundCollider.hpp"
 
 namespace phys
 {
@@ -24,6 +27,12 @@ namespace phys
         m_force += forceToAdd;
     }
 
+    //Applies an impulse to the body, changing its velocity immediately
+    void DynamicBody::applyImpulse(const Vector2& impulse)
+    {
+        m_velocity += impulse * getInvMass();
+    }
+
     //Update the physics of the body in the world
     void DynamicBody::update(float deltaTime)
     {
@@ -63,6 +72,30 @@ namespace phys
             return (1.0f / 12.0f) * m_mass * (width * width + height * height);
         }
 
+        //Polygon intertia calculation, precomputed by the collider for a unit mass
+        else if (shape == ColliderShape::Polygon)
+        {
+            PolygonCollider* collider = static_cast<PolygonCollider*>(m_collider);
+
+            return m_mass * collider->getUnitInertia();
+        }
+
+        //Capsule intertia calculation, a rectangle and two half discs precomputed by the collider for a unit mass
+        else if (shape == ColliderShape::Capsule)
+        {
+            CapsuleCollider* collider = static_cast<CapsuleCollider*>(m_collider);
+
+            return m_mass * collider->getUnitInertia();
+        }
+
+        //Compound intertia calculation, the children about the centroid precomputed by the collider for a unit mass
+        else if (shape == ColliderShape::Compound)
+        {
+            CompoundCollider* collider = static_cast<CompoundCollider*>(m_collider);
+
+            return m_mass * collider->getUnitInertia();
+        }
+
         //Unknown shape
         else
         {
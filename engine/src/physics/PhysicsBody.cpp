@@ -6,7 +6,7 @@ namespace phys
 {
     //Constructor to set position, collider, and body type
     PhysicsBody::PhysicsBody(const Vector2& position, Collider* collider, BodyType bodyType) :
-        m_position(position), m_collider(collider), m_type(bodyType), m_rotation(0)
+        m_position(position), m_collider(collider), m_type(bodyType), m_rotation(0), m_proxyId(-1), m_id(0)
     {
         collider->setParent(this);                                   //Attach the collider to body
         collider->setPosition(m_position + m_collider->getOffset()); //Set the position of the collider to body position
@@ -52,6 +52,16 @@ namespace phys
         return m_type;
     }
 
+    int PhysicsBody::getProxyId() const
+    {
+        return m_proxyId;
+    }
+
+    unsigned int PhysicsBody::getId() const
+    {
+        return m_id;
+    }
+
     //Setters for member variables
     void PhysicsBody::setPosition(const Vector2& newPosition)
     {
@@ -74,4 +84,14 @@ namespace phys
 
         m_collider = newCollider;
     }
+
+    void PhysicsBody::setProxyId(int newProxyId)
+    {
+        m_proxyId = newProxyId;
+    }
+
+    void PhysicsBody::setId(unsigned int newId)
+    {
+        m_id = newId;
+    }
 }
\ No newline at end of file
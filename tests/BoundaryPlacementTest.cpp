@@ -0,0 +1,45 @@
+//Tests that bodies moved back inside the boundary when added are found where they were placed
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+
+using namespace phys;
+
+int main()
+{
+    PhysicsWorld world({100.0f, 100.0f});
+    world.setBoundaryType(BoundaryType::Collidable);
+
+    //Enough statics for the broad phase to build its static trees
+    for (int i = 0; i < 40; i++)
+        world.addBody(createStaticRectangle({-40.0f + i * 2.0f, -45.0f}, {1.0f, 1.0f}));
+
+    world.update(1.0f / 60.0f);
+
+    //Reaches past the right edge at 50, so it is moved back to 45
+    StaticBody* box = createStaticRectangle({60.0f, 0.0f}, {10.0f, 10.0f});
+    world.addBody(box);
+    test::check(box->getPosition().x == 45.0f, "static box is moved inside the boundary");
+
+    PhysicsBody* found[4];
+    int count = world.queryPoint({45.0f, 0.0f}, found, 4);
+    test::check(count == 1 && found[0] == box, "static box is found where it was placed");
+
+    //A ball dropped on the box rests on its top face
+    DynamicBody* ball = createDynamicCircle({45.0f, 20.0f}, 1.0f);
+    world.addBody(ball);
+
+    for (int frame = 0; frame < 300; frame++)
+        world.update(1.0f / 60.0f);
+
+    test::check(ball->getPosition().y > 5.5f && ball->getPosition().y < 6.5f, "ball rests on the placed box");
+
+    //Delete boundaries drop bodies added fully outside without inserting them
+    world.setBoundaryType(BoundaryType::Delete);
+    size_t bodyCount = world.getBodies().size();
+    world.addBody(createStaticRectangle({200.0f, 0.0f}, {1.0f, 1.0f}));
+    test::check(world.getBodies().size() == bodyCount, "body beyond a delete boundary is not added");
+    test::check(world.getBroadPhase().getProxyCount() == static_cast<int>(bodyCount), "nor left in the broad phase");
+
+    return test::finish("BoundaryPlacementTest");
+}
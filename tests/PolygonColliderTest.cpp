@@ -0,0 +1,70 @@
+//Tests building convex polygon colliders from more points than a polygon can hold
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace phys;
+
+//Returns true if every edge of the polygon turns left and every vertex lies within a distance of the origin
+static bool isConvexWithin(const PolygonCollider& polygon, float radius)
+{
+    int count = polygon.getVertexCount();
+    const Vector2* points = polygon.getPoints();
+
+    for (int i = 0; i < count; i++)
+    {
+        const Vector2& a = points[i];
+        const Vector2& b = points[(i + 1) % count];
+        const Vector2& c = points[(i + 2) % count];
+
+        if ((b - a).crossProduct(c - b) <= 0.0f || a.getLength() > radius + 0.0001f)
+            return false;
+    }
+
+    return true;
+}
+
+int main()
+{
+    const float pi = 3.14159265f;
+
+    //Twelve points on a unit circle, more than a polygon can hold
+    std::vector<Vector2> circle;
+    for (int i = 0; i < 12; i++)
+        circle.push_back({std::cos(2.0f * pi * i / 12.0f), std::sin(2.0f * pi * i / 12.0f)});
+
+    PolygonCollider reduced(circle, ColliderType::Solid);
+    test::check(reduced.getVertexCount() == PolygonCollider::MAX_VERTICES, "12 point circle reduces to MAX_VERTICES");
+    test::check(isConvexWithin(reduced, 1.0f), "reduced circle stays convex and inside the points");
+
+    //Dropping four vertices of a regular 12-gon loses four of its thin corner triangles
+    float twelveGonArea = 3.0f;
+    float cornerArea = 0.5f * 2.0f * std::sin(2.0f * pi / 12.0f) * (1.0f - std::cos(2.0f * pi / 12.0f));
+    test::check(std::abs(reduced.getArea() - (twelveGonArea - 4.0f * cornerArea)) < 0.001f,
+        "reduced circle keeps all but the four smallest corners");
+
+    //The hull comes from every point, not only the first ones given
+    std::vector<Vector2> square;
+    for (int i = 0; i < 8; i++)
+        square.push_back({0.2f * std::cos(2.0f * pi * i / 8.0f), 0.2f * std::sin(2.0f * pi * i / 8.0f)});
+
+    square.push_back({-1.0f, -1.0f});
+    square.push_back({1.0f, -1.0f});
+    square.push_back({1.0f, 1.0f});
+    square.push_back({-1.0f, 1.0f});
+
+    PolygonCollider hull(square, ColliderType::Solid);
+    test::check(hull.getVertexCount() == 4, "corners given after eight inner points form the hull");
+    test::check(std::abs(hull.getArea() - 4.0f) < 0.0001f, "hull of the late corners is the full square");
+
+    //The factories build the same hull
+    DynamicBody* body = createDynamicPolygon({0, 0}, circle);
+    test::check(body != nullptr && static_cast<PolygonCollider*>(body->getCollider())->getVertexCount() ==
+                                       PolygonCollider::MAX_VERTICES,
+        "factory reduces the 12 point circle");
+    delete body;
+
+    return test::finish("PolygonColliderTest");
+}
@@ -0,0 +1,91 @@
+//Tests that overlap queries report bodies on several collision layers once
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace phys;
+
+//Returns true if every body appears exactly once in the results
+static bool isEachOnce(PhysicsBody** results, int count, const std::vector<PhysicsBody*>& bodies)
+{
+    if (count != static_cast<int>(bodies.size()))
+        return false;
+
+    for (PhysicsBody* body : bodies)
+    {
+        if (std::count(results, results + count, body) != 1)
+            return false;
+    }
+
+    return true;
+}
+
+int main()
+{
+    PhysicsWorld world({200.0f, 200.0f});
+    std::vector<PhysicsBody*> bodies;
+
+    //Dynamic bodies, statics built into the static trees, and statics still waiting in the layer trees
+    for (int i = 0; i < 60; i++)
+    {
+        PhysicsBody* body;
+        if (i % 3 == 0)
+        {
+            DynamicBody* dynamicBody = createDynamicCircle({i * 1.5f - 45.0f, 0.0f}, 0.5f);
+            dynamicBody->setAffectedByGravity(false);
+            body = dynamicBody;
+        }
+        else
+        {
+            body = createStaticRectangle({i * 1.5f - 45.0f, 5.0f}, {1.0f, 1.0f});
+        }
+
+        if (i % 2 == 0)
+            body->getCollider()->setCollisionLayers({3, 1, 2});
+        else
+            body->getCollider()->setCollisionLayers({2});
+
+        world.addBody(body);
+        bodies.push_back(body);
+
+        if (i == 40)
+            world.update(1.0f / 60.0f);
+    }
+
+    //Group bodies on several layers
+    StaticGroup group;
+    StaticBody* groupBody = createStaticRectangle({0.0f, -5.0f}, {4.0f, 1.0f});
+    groupBody->getCollider()->setCollisionLayers({2, 1});
+    group.build({groupBody});
+    world.addStaticGroup(&group);
+    bodies.push_back(groupBody);
+
+    PhysicsBody* results[128];
+    AABB region({-100.0f, -100.0f}, {100.0f, 100.0f});
+
+    int count = world.queryRegion(region, results, 128);
+    test::check(isEachOnce(results, count, bodies), "every layer searched reports each body once");
+
+    QueryFilter filter;
+    filter.layers = {2, 1};
+    count = world.queryRegion(region, results, 128, filter);
+    test::check(isEachOnce(results, count, bodies), "filter layers report each body once");
+
+    //Only bodies on layer 1 or 3
+    std::vector<PhysicsBody*> layered;
+    for (PhysicsBody* body : bodies)
+    {
+        const std::vector<unsigned int>& layers = body->getCollider()->getCollisionLayers();
+        if (std::find(layers.begin(), layers.end(), 1u) != layers.end())
+            layered.push_back(body);
+    }
+
+    filter.layers = {3, 1};
+    count = world.queryRegion(region, results, 128, filter);
+    test::check(isEachOnce(results, count, layered), "bodies are only reported from searched layers");
+
+    world.removeStaticGroup(&group);
+    return test::finish("QueryTest");
+}
@@ -0,0 +1,49 @@
+//Tests that queued bodies get their ids when queued, and keep them through the update and a replay
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+#include <filesystem>
+
+using namespace phys;
+
+int main()
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "phys_queue_add_body_test.rec";
+    PhysicsWorld world({100.0f, 100.0f});
+    WorldRecorder recorder;
+    test::check(recorder.open(path.string(), world), "session is recorded");
+
+    //The queued body reserves its id, then a body added directly takes the next one before the queue is applied
+    DynamicBody* queued = createDynamicCircle({0.0f, 0.0f}, 0.5f);
+    unsigned int queuedId = world.queueAddBody(queued);
+    world.queueForce(queuedId, {100.0f, 0.0f});
+
+    DynamicBody* added = createDynamicCircle({5.0f, 0.0f}, 0.5f);
+    world.addBody(added);
+    test::check(added->getId() == queuedId + 1, "direct add takes the id after the reserved one");
+
+    world.update(1.0f / 60.0f);
+    test::check(world.getBody(queuedId) == queued, "queued body is found by its reserved id");
+    test::check(world.getBody(added->getId()) == added, "direct body is still found by its id");
+    test::check(world.getBodies().size() == 2 && world.getBodies()[0] == queued, "bodies stay in id order");
+    test::check(queued->getVelocity().x > 0.0f, "force queued by the reserved id is applied");
+
+    for (int frame = 0; frame < 10; frame++)
+        world.update(1.0f / 60.0f);
+
+    Vector2 recorded = queued->getPosition();
+    recorder.close();
+
+    //The recording adds the direct body first, the replay must still give each body its own id
+    PhysicsWorld replayWorld({100.0f, 100.0f});
+    WorldReplayer replayer;
+    test::check(replayer.open(path.string()) && replayer.run(replayWorld) == 11, "every frame is replayed");
+    test::check(replayer.getDivergedFrame() == -1, "replay matches the recorded state hashes");
+
+    PhysicsBody* replayed = replayWorld.getBody(queuedId);
+    test::check(replayed != nullptr && (replayed->getPosition() - recorded).getLength() < 0.0001f,
+        "queued body ends where it was recorded");
+
+    std::filesystem::remove(path);
+    return test::finish("QueueAddBodyTest");
+}
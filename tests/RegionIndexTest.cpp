@@ -0,0 +1,58 @@
+//Tests that the region index of an unbounded world files bodies when it is asked for
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+
+using namespace phys;
+
+//Returns true if the region holding the body's center lists the body
+static bool isFiled(PhysicsWorld& world, const PhysicsBody* body)
+{
+    const RegionIndex& index = world.getRegionIndex();
+    int x, y;
+    index.getRegionCoordinates(body->getPosition(), x, y);
+
+    const Region* region = index.getRegion(x, y);
+    if (!region)
+        return false;
+
+    for (const PhysicsBody* filed : region->bodies)
+    {
+        if (filed == body)
+            return true;
+    }
+
+    return false;
+}
+
+int main()
+{
+    PhysicsWorld world({100.0f, 100.0f});
+    world.setBoundaryType(BoundaryType::None);
+
+    StaticBody* ground = createStaticRectangle({0.0f, 0.0f}, {10.0f, 1.0f});
+    world.addBody(ground);
+    world.update(1.0f / 60.0f);
+    test::check(world.getRegionIndex().getRegionCount() == 1 && isFiled(world, ground), "static body is filed");
+
+    //Added between updates, the index must not wait for the next one
+    DynamicBody* added = createDynamicCircle({500.0f, 500.0f}, 0.5f);
+    world.addBody(added);
+    test::check(world.getRegionIndex().getRegionCount() == 2 && isFiled(world, added), "added body is filed at once");
+
+    DynamicBody* queued = createDynamicCircle({-500.0f, 500.0f}, 0.5f);
+    world.queueAddBody(queued);
+    world.update(1.0f / 60.0f);
+    test::check(isFiled(world, queued), "queued body is filed after the update applying it");
+
+    //Moving bodies are refiled after they change region
+    world.setVelocity(added, {6000.0f, 0.0f});
+    world.update(1.0f / 60.0f);
+    test::check(isFiled(world, added), "moved body is refiled in its new region");
+
+    //Bodies are dropped from the index with the boundary
+    world.setBoundaryType(BoundaryType::Collidable);
+    test::check(world.getRegionIndex().getRegionCount() == 0, "index is empty with a boundary");
+
+    return test::finish("RegionIndexTest");
+}
@@ -0,0 +1,45 @@
+//Tests that the render state places every shape at its center with half extents
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace phys;
+
+//Returns true if an instance is centered at a point with the given half extents
+static bool isPlaced(const RenderInstance& instance, const Vector2& center, const Vector2& extents)
+{
+    return std::abs(instance.positionX - center.x) < 0.0001f && std::abs(instance.positionY - center.y) < 0.0001f &&
+           std::abs(instance.extentX - extents.x) < 0.0001f && std::abs(instance.extentY - extents.y) < 0.0001f;
+}
+
+int main()
+{
+    PhysicsWorld world({100.0f, 100.0f});
+    world.setRenderStateExport(true);
+
+    world.addBody(createStaticRectangle({-5.0f, 0.0f}, {2.0f, 1.0f}));
+
+    //Four by two tiles of half a meter, growing from its corner at (2, 3)
+    std::vector<bool> tiles(8, true);
+    world.addBody(createStaticTileMap({2.0f, 3.0f}, 4, 2, 0.5f, tiles));
+
+    //The same grid turned a quarter turn, so it grows left and up from its corner
+    StaticBody* turned = createStaticTileMap({-10.0f, -10.0f}, 4, 2, 0.5f, tiles);
+    turned->setRotation(3.14159265f / 2);
+    world.addBody(turned);
+
+    world.update(1.0f / 60.0f);
+    const std::vector<RenderInstance>& instances = world.acquireRenderState();
+
+    test::check(instances.size() == 3, "every body is exported");
+    test::check(instances.size() == 3 && isPlaced(instances[0], {-5.0f, 0.0f}, {1.0f, 0.5f}),
+        "rectangle is exported at its center with half extents");
+    test::check(instances.size() == 3 && isPlaced(instances[1], {3.0f, 3.5f}, {1.0f, 0.5f}),
+        "tile map is exported at its center with half extents");
+    test::check(instances.size() == 3 && isPlaced(instances[2], {-10.5f, -9.0f}, {1.0f, 0.5f}),
+        "rotated tile map is exported at its rotated center");
+
+    return test::finish("RenderStateTest");
+}
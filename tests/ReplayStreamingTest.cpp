@@ -0,0 +1,75 @@
+//Tests replaying a recording of a world that streams static chunks in and out while it runs
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+using namespace phys;
+
+//Records a few frames of a ball falling onto a streamed floor, the floor being loaded after recording started
+static bool record(const std::string& directory, const std::string& path, Vector2& ballPosition)
+{
+    PhysicsWorld world({100.0f, 100.0f});
+    WorldRecorder recorder;
+    if (!recorder.open(path, world))
+        return false;
+
+    ChunkStore chunks(world, directory, 10.0f);
+    chunks.update(AABB({-1.0f, -1.0f}, {1.0f, 1.0f}));
+
+    //Added after the chunk, so its id comes after the floor's ids
+    DynamicBody* ball = createDynamicCircle({0.0f, 2.0f}, 0.5f);
+    world.addBody(ball);
+
+    for (int frame = 0; frame < 60; frame++)
+    {
+        world.applyForce(ball, {1.0f, 0.0f});
+        world.update(1.0f / 60.0f);
+    }
+
+    //Moving the focus away unloads the floor, the ball then falls freely
+    chunks.update(AABB({200.0f, 200.0f}, {201.0f, 201.0f}));
+    for (int frame = 0; frame < 10; frame++)
+        world.update(1.0f / 60.0f);
+
+    ballPosition = ball->getPosition();
+    recorder.close();
+    return true;
+}
+
+int main()
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "phys_replay_streaming_test";
+    std::filesystem::create_directories(directory);
+    std::string path = (directory / "session.rec").string();
+
+    //Floor under the origin, written as a chunk file
+    std::vector<PhysicsBody*> floor = {createStaticRectangle({0.0f, 0.0f}, {8.0f, 1.0f}),
+        createStaticRectangle({3.0f, 1.0f}, {1.0f, 1.0f})};
+    test::check(ChunkStore::writeChunks(floor, directory.string(), 10.0f), "chunk files are written");
+    for (PhysicsBody* body : floor)
+        delete body;
+
+    Vector2 recorded;
+    test::check(record(directory.string(), path, recorded), "session is recorded");
+
+    PhysicsWorld world({100.0f, 100.0f});
+    WorldReplayer replayer;
+    test::check(replayer.open(path), "recording opens");
+
+    unsigned int frames = replayer.run(world);
+    test::check(frames == 70, "every frame is replayed");
+    test::check(replayer.isFinished(), "replay reaches the end of the log");
+    test::check(replayer.getDivergedFrame() == -1, "replay matches the recorded state hashes");
+    test::check(world.getStaticGroups().empty(), "unloaded chunk is detached again");
+
+    //The ball's id follows the floor's, so it is only found if the floor was attached with the same ids
+    PhysicsBody* ball = world.getBody(3);
+    test::check(ball != nullptr && (ball->getPosition() - recorded).getLength() < 0.0001f,
+        "ball ends where it was recorded");
+
+    std::filesystem::remove_all(directory);
+    return test::finish("ReplayStreamingTest");
+}
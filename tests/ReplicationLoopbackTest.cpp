@@ -0,0 +1,146 @@
+//Tests replicating a world through a loopback encoder and decoder pair that loses packets and acknowledgements
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace phys;
+
+//Returns true if every decoded body matches its body in the world to within half a precision step
+static bool matchesWorld(
+    const PhysicsWorld& world, const ReplicationDecoder& decoder, const ReplicationSettings& settings)
+{
+    const std::vector<PhysicsBody*>& bodies = world.getBodies();
+    const std::vector<ReplicatedBody>& replicated = decoder.getBodies();
+    if (bodies.size() != replicated.size())
+        return false;
+
+    float positionError = settings.positionPrecision * 0.5f + 0.00001f;
+    float rotationError = settings.rotationPrecision * 0.5f + 0.00001f;
+
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        const PhysicsBody* body = bodies[i];
+        const ReplicatedBody& copy = replicated[i];
+
+        if (copy.id != body->getId() || copy.shape != body->getCollider()->getShape())
+            return false;
+
+        if (std::abs(copy.position.x - body->getPosition().x) > positionError ||
+            std::abs(copy.position.y - body->getPosition().y) > positionError ||
+            std::abs(copy.rotation - Replication::wrapAngle(body->getRotation())) > rotationError)
+            return false;
+    }
+
+    return true;
+}
+
+//Returns the baseline sequence a packet was encoded against
+static uint32_t getBaseline(const unsigned char* packet, int size)
+{
+    int cursor = 0;
+    uint32_t sequence;
+    uint32_t baseline = 0;
+    Replication::readVarint(packet, size, cursor, sequence);
+    Replication::readVarint(packet, size, cursor, baseline);
+
+    return baseline;
+}
+
+int main()
+{
+    PhysicsWorld world({100.0f, 100.0f});
+    world.setBoundaryType(BoundaryType::Collidable);
+    world.addBody(createStaticRectangle({0.0f, -20.0f}, {60.0f, 2.0f}));
+
+    std::vector<DynamicBody*> movers;
+    for (int i = 0; i < 12; i++)
+    {
+        DynamicBody* body = i % 2 == 0 ? createDynamicRectangle({i * 3.0f - 18.0f, 10.0f}, {1.0f, 1.0f})
+                                       : createDynamicCircle({i * 3.0f - 18.0f, 15.0f}, 0.5f);
+        world.addBody(body);
+        world.setVelocity(body, {i * 0.5f - 3.0f, 0.0f});
+        movers.push_back(body);
+    }
+
+    ReplicationSettings settings;
+    settings.historySize = 8;
+    ReplicationEncoder encoder(settings);
+    ReplicationDecoder decoder(settings);
+
+    unsigned char packet[4096];
+    bool matched = true;
+    int decoded = 0;
+
+    //One packet in five and one acknowledgement in four are lost
+    for (int frame = 1; frame <= 120; frame++)
+    {
+        world.update(1.0f / 60.0f);
+
+        int size = encoder.encode(world, packet, sizeof(packet));
+        if (size < 0 || frame % 5 == 0)
+            continue;
+
+        if (!decoder.decode(packet, size))
+        {
+            matched = false;
+            continue;
+        }
+
+        decoded++;
+        matched = matched && matchesWorld(world, decoder, settings);
+
+        if (frame % 4 != 0)
+            encoder.acknowledge(decoder.getSequence());
+    }
+
+    test::check(decoded == 96, "every delivered packet decodes");
+    test::check(matched, "decoded state stays within half a step of the world");
+    test::check(encoder.getAcknowledged() > 0, "acknowledged states become baselines");
+
+    //Removed bodies are dropped by the decoder
+    world.removeBody(movers.back());
+    movers.pop_back();
+    world.update(1.0f / 60.0f);
+
+    int size = encoder.encode(world, packet, sizeof(packet));
+    test::check(size > 0 && decoder.decode(packet, size), "packet with a removal decodes");
+    test::check(matchesWorld(world, decoder, settings) && decoder.getBodies().size() == movers.size() + 1,
+        "removed body is dropped");
+    encoder.acknowledge(decoder.getSequence());
+
+    //Stale and truncated packets are rejected, and leave the decoded state alone
+    std::vector<unsigned char> stale(packet, packet + size);
+    world.update(1.0f / 60.0f);
+    size = encoder.encode(world, packet, sizeof(packet));
+
+    test::check(!decoder.decode(packet, size - 1), "truncated packet is rejected");
+    test::check(decoder.decode(packet, size), "packet decodes once it arrives whole");
+    test::check(!decoder.decode(stale.data(), static_cast<int>(stale.size())), "stale packet is rejected");
+    test::check(matchesWorld(world, decoder, settings), "rejected packets leave the state alone");
+    encoder.acknowledge(decoder.getSequence());
+
+    //With every acknowledgement lost, the acknowledged state leaves the encoder's history
+    for (int frame = 0; frame <= settings.historySize; frame++)
+    {
+        world.update(1.0f / 60.0f);
+        size = encoder.encode(world, packet, sizeof(packet));
+    }
+
+    test::check(size > 0 && getBaseline(packet, size) == 0, "encoder falls back to the full state");
+    test::check(decoder.decode(packet, size) && matchesWorld(world, decoder, settings), "full state decodes");
+
+    //A delta taking a value past the quantized range is rejected instead of overflowing
+    std::vector<unsigned char> hostile;
+    Replication::writeVarint(hostile, decoder.getSequence() + 1);
+    Replication::writeVarint(hostile, decoder.getSequence());
+    Replication::writeVarint(hostile, 1);
+    Replication::writeVarint(hostile, movers.front()->getId());
+    hostile.push_back(Replication::POSITION_X);
+    Replication::writeZigzag(hostile, 2147483647);
+    test::check(!decoder.decode(hostile.data(), static_cast<int>(hostile.size())), "overflowing delta is rejected");
+    test::check(matchesWorld(world, decoder, settings), "overflowing delta leaves the state alone");
+
+    return test::finish("ReplicationLoopbackTest");
+}
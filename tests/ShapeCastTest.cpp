@@ -0,0 +1,94 @@
+//Tests sweeping capsules and chains against and with shapes that have no closed form sweep
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+#include <cmath>
+
+using namespace phys;
+
+//Returns true if a hit matches the expected fraction and normal, allowing for the skin swept shapes stop short by
+static bool isHit(bool found, const ShapeCastHit& hit, float fraction, const Vector2& normal)
+{
+    return found && std::abs(hit.fraction - fraction) < 0.001f && (hit.normal - normal).getLength() < 0.001f;
+}
+
+int main()
+{
+    //Upright capsule reaching half a meter to each side, swept four meters to the right
+    DynamicBody* capsule = createDynamicCapsule({0, 0}, 0.5f, 2.0f);
+    Vector2 right = {4.0f, 0.0f};
+    ShapeCastHit hit;
+
+    //Box with its left face at 2.5, two meters away
+    StaticBody* box = createStaticRectangle({3.0f, 0.0f}, {1.0f, 1.0f});
+    bool found = CollisionDetection::shapeCastCollider(capsule->getCollider(), right, box->getCollider(), hit);
+    test::check(isHit(found, hit, 0.5f, {-1.0f, 0.0f}), "capsule hits a box");
+    test::check(found && hit.body == box && std::abs(hit.point.x - 2.5f) < 0.001f, "capsule hit lies on the box");
+
+    //Same box swept the other way into the capsule
+    found = CollisionDetection::shapeCastCollider(box->getCollider(), -right, capsule->getCollider(), hit);
+    test::check(isHit(found, hit, 0.5f, {1.0f, 0.0f}), "box hits a capsule");
+
+    //Capsule against a capsule two meters away
+    StaticBody* other = createStaticCapsule({3.0f, 0.0f}, 0.5f, 2.0f);
+    found = CollisionDetection::shapeCastCollider(capsule->getCollider(), right, other->getCollider(), hit);
+    test::check(isHit(found, hit, 0.5f, {-1.0f, 0.0f}), "capsule hits a capsule");
+
+    //Capsule against a triangle pointing at it, the tip at 2.5
+    StaticBody* triangle = createStaticPolygon({0, 0}, {{2.5f, 0.0f}, {4.0f, -1.0f}, {4.0f, 1.0f}});
+    found = CollisionDetection::shapeCastCollider(capsule->getCollider(), right, triangle->getCollider(), hit);
+    test::check(isHit(found, hit, 0.5f, {-1.0f, 0.0f}), "capsule hits a polygon's vertex");
+
+    //Passing above the box misses it
+    capsule->setPosition({0.0f, 3.0f});
+    found = CollisionDetection::shapeCastCollider(capsule->getCollider(), right, box->getCollider(), hit);
+    test::check(!found, "capsule passing above the box misses it");
+
+    //Starting inside the box hits at once
+    capsule->setPosition({3.0f, 0.0f});
+    found = CollisionDetection::shapeCastCollider(capsule->getCollider(), right, box->getCollider(), hit);
+    test::check(found && hit.fraction == 0.0f, "capsule starting inside the box hits at once");
+
+    //Through a world, which used to report no hit
+    PhysicsWorld world({100.0f, 100.0f});
+    DynamicBody* walker = createDynamicCapsule({-3.0f, 0.0f}, 0.5f, 2.0f);
+    walker->setAffectedByGravity(false);
+    world.addBody(walker);
+    world.addBody(createStaticRectangle({3.0f, 0.0f}, {1.0f, 1.0f}));
+
+    found = world.shapeCast(walker, {8.0f, 0.0f}, hit);
+    test::check(isHit(found, hit, 0.625f, {-1.0f, 0.0f}), "world shape cast of a capsule hits a box");
+
+    //Only layers the walker masks are searched
+    walker->getCollider()->setCollisionMasks({1});
+    test::check(!world.shapeCast(walker, {8.0f, 0.0f}, hit), "world shape cast skips layers the body does not mask");
+    walker->getCollider()->addCollisionMask(0);
+    test::check(world.shapeCast(walker, {8.0f, 0.0f}, hit), "world shape cast searches every masked layer");
+
+    //Floor of two segments at y = -5, solid from above
+    StaticBody* floor = createStaticChain({0, 0}, {{-10.0f, -5.0f}, {0.0f, -5.0f}, {10.0f, -5.0f}});
+    Vector2 down = {0.0f, -8.0f};
+
+    DynamicBody* crate = createDynamicRectangle({0.5f, 0.0f}, {1.0f, 1.0f});
+    found = CollisionDetection::shapeCastCollider(crate->getCollider(), down, floor->getCollider(), hit);
+    test::check(isHit(found, hit, 4.5f / 8.0f, {0.0f, 1.0f}), "box lands on a chain");
+    test::check(found && hit.body == floor, "box hit reports the chain");
+
+    capsule->setPosition({3.0f, 0.0f});
+    found = CollisionDetection::shapeCastCollider(capsule->getCollider(), down, floor->getCollider(), hit);
+    test::check(isHit(found, hit, 4.0f / 8.0f, {0.0f, 1.0f}), "capsule lands on a chain");
+
+    //From below the chain lets shapes through
+    crate->setPosition({0.5f, -7.0f});
+    found = CollisionDetection::shapeCastCollider(crate->getCollider(), -down, floor->getCollider(), hit);
+    test::check(!found, "box passes up through the back of a chain");
+
+    delete crate;
+    delete floor;
+    delete capsule;
+    delete box;
+    delete other;
+    delete triangle;
+
+    return test::finish("ShapeCastTest");
+}
@@ -0,0 +1,61 @@
+//Tests that snapshots with broken body ids are rejected, and that restored worlds keep clear of static group ids
+
+#include "Engine.hpp"
+#include "TestCheck.hpp"
+#include <vector>
+
+using namespace phys;
+
+//Returns the body records of a snapshot, to corrupt them in place
+static Snapshot::BodyRecord* getRecords(std::vector<unsigned char>& buffer)
+{
+    const Snapshot::Header* header = reinterpret_cast<const Snapshot::Header*>(buffer.data());
+    return reinterpret_cast<Snapshot::BodyRecord*>(buffer.data() + header->bodiesOffset);
+}
+
+int main()
+{
+    PhysicsWorld world({100.0f, 100.0f});
+    for (int i = 0; i < 3; i++)
+        world.addBody(createDynamicCircle({i * 2.0f, 0.0f}, 0.5f));
+
+    std::vector<unsigned char> snapshot;
+    world.writeSnapshot(snapshot);
+    test::check(world.readSnapshot(snapshot.data(), snapshot.size()), "valid snapshot is read");
+
+    //Repeated, decreasing and unassigned ids would break the id searches
+    std::vector<unsigned char> corrupt = snapshot;
+    getRecords(corrupt)[2].id = getRecords(corrupt)[1].id;
+    test::check(!world.readSnapshot(corrupt.data(), corrupt.size()), "repeated id is rejected");
+
+    corrupt = snapshot;
+    getRecords(corrupt)[0].id = 3;
+    getRecords(corrupt)[2].id = 1;
+    test::check(!world.readSnapshot(corrupt.data(), corrupt.size()), "decreasing ids are rejected");
+
+    corrupt = snapshot;
+    getRecords(corrupt)[2].id = 4;
+    test::check(!world.readSnapshot(corrupt.data(), corrupt.size()), "id past the next id is rejected");
+
+    corrupt = snapshot;
+    getRecords(corrupt)[0].id = 0;
+    test::check(!world.readSnapshot(corrupt.data(), corrupt.size()), "id zero is rejected");
+
+    test::check(world.getBodies().size() == 3 && world.getBody(2) != nullptr, "rejected snapshots leave the world");
+
+    //Groups stay attached through a restore, so the ids they took must not be handed out again
+    StaticGroup group;
+    group.build({createStaticRectangle({0.0f, -10.0f}, {20.0f, 1.0f}),
+        createStaticRectangle({0.0f, 10.0f}, {20.0f, 1.0f})});
+    world.addStaticGroup(&group);
+    unsigned int lastGroupId = group.getBodies().back()->getId();
+
+    test::check(world.readSnapshot(snapshot.data(), snapshot.size()), "snapshot taken before the group is read");
+
+    DynamicBody* added = createDynamicCircle({0.0f, 5.0f}, 0.5f);
+    world.addBody(added);
+    test::check(added->getId() > lastGroupId, "new body takes an id after the group's");
+
+    world.removeStaticGroup(&group);
+    return test::finish("SnapshotTest");
+}
@@ -0,0 +1,40 @@
+//Minimal checks shared by the engine tests
+//A failed check prints its message and the test keeps going, main returns the failure count
+
+#ifndef TEST_CHECK_HPP
+#define TEST_CHECK_HPP
+
+#include <cstdio>
+
+namespace test
+{
+    //Number of checks that failed so far
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    //Counts and reports a failed check
+    inline void check(bool condition, const char* message)
+    {
+        if (condition)
+            return;
+
+        std::printf("FAILED: %s\n", message);
+        failures()++;
+    }
+
+    //Returns the exit code of a test, zero when every check passed
+    inline int finish(const char* name)
+    {
+        if (failures() == 0)
+            std::printf("%s passed\n", name);
+        else
+            std::printf("%s: %d checks failed\n", name, failures());
+
+        return failures() == 0 ? 0 : 1;
+    }
+}
+
+#endif